@@ -5710,6 +5710,263 @@ extern "C" enum icp_result handler_index_cond_check(void* h_arg)
   return res;
 }
 
+/**
+  Check if an argument of a pushed index condition is a column whose
+  ordering by Field::cmp() is the ordering of the comparison.
+
+  @param item   argument of a comparison
+  @param table  the table of the handler
+
+  @return the column, or NULL
+*/
+static Field *idx_cond_field(Item *item, const TABLE *table)
+{
+  item= item->real_item();
+  if (item->type() != Item::FIELD_ITEM)
+    return NULL;
+
+  Field *field= ((Item_field *) item)->field;
+  if (field->table != table || !field->stored_in_db())
+    return NULL;
+
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+  case MYSQL_TYPE_NEWDATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_DATETIME2:
+    return field;
+  case MYSQL_TYPE_STRING:
+    /* BINARY(N) */
+    return field->charset() == &my_charset_bin ? field : NULL;
+  default:
+    return NULL;
+  }
+}
+
+
+/**
+  Store a constant of a pushed index condition in the record format of
+  a column, if the value can be represented exactly.
+
+  @param item   constant
+  @param field  the column that the constant is compared to
+  @param to     field->pack_length() bytes
+
+  @retval false  the value was stored
+  @retval true   the constant cannot be stored exactly
+*/
+static bool idx_cond_store_value(Item *item, Field *field, uchar *to)
+{
+  if (!item->basic_const_item() || item->is_null())
+    return true;
+
+  uint length= field->pack_length();
+
+  if (field->real_type() == MYSQL_TYPE_STRING)
+  {
+    char buff[MAX_FIELD_WIDTH];
+    String tmp(buff, sizeof(buff), &my_charset_bin);
+    String *str;
+    if (item->cmp_type() != STRING_RESULT ||
+        !(str= item->val_str(&tmp)) || str->length() != length)
+      return true;
+    memcpy(to, str->ptr(), length);
+    return false;
+  }
+
+  THD *thd= field->table->in_use;
+  Field *tmp_field= field->new_key_field(thd->mem_root, field->table,
+                                         to, length, NULL, 0);
+  if (!tmp_field)
+    return true;
+
+  my_bitmap_map *old_maps[2];
+  enum_check_fields save_count_cuted_fields= thd->count_cuted_fields;
+  bool exact;
+
+  dbug_tmp_use_all_columns(field->table, old_maps,
+                           field->table->read_set, field->table->write_set);
+  thd->count_cuted_fields= CHECK_FIELD_IGNORE;
+
+  if (field->cmp_type() == INT_RESULT)
+  {
+    exact= item->cmp_type() == INT_RESULT &&
+           !item->save_in_field(tmp_field, true) &&
+           tmp_field->val_int() == item->val_int();
+  }
+  else
+  {
+    const ulonglong fuzzydate= TIME_NO_ZERO_IN_DATE | TIME_NO_ZERO_DATE;
+    MYSQL_TIME item_time, field_time;
+    exact= (item->cmp_type() == STRING_RESULT ||
+            item->cmp_type() == TIME_RESULT) &&
+           !item->get_date(&item_time, fuzzydate) &&
+           !item->save_in_field(tmp_field, true) &&
+           !tmp_field->get_date(&field_time, fuzzydate) &&
+           item_time.neg == field_time.neg &&
+           pack_time(&item_time) == pack_time(&field_time);
+  }
+
+  thd->count_cuted_fields= save_count_cuted_fields;
+  dbug_tmp_restore_column_maps(field->table->read_set,
+                               field->table->write_set, old_maps);
+  return !exact;
+}
+
+
+/**
+  Extract the comparisons from a conjunct of a pushed index condition.
+
+  @param cond   conjunct of the pushed index condition
+  @param table  the table of the handler
+  @param cmp    comparisons (at most 2)
+
+  @return number of comparisons
+*/
+static uint idx_cond_comparison(Item *cond, TABLE *table,
+                                Idx_cond_comparison *cmp)
+{
+  if (cond->type() != Item::FUNC_ITEM)
+    return 0;
+
+  Item_func *func= (Item_func *) cond;
+  Item **args= func->arguments();
+  Item **values;
+  Field *field;
+  uint n_values;
+  Idx_cond_comparison::enum_op op;
+
+  switch (func->functype()) {
+  case Item_func::EQ_FUNC: op= Idx_cond_comparison::EQ; break;
+  case Item_func::NE_FUNC: op= Idx_cond_comparison::NE; break;
+  case Item_func::LT_FUNC: op= Idx_cond_comparison::LT; break;
+  case Item_func::LE_FUNC: op= Idx_cond_comparison::LE; break;
+  case Item_func::GT_FUNC: op= Idx_cond_comparison::GT; break;
+  case Item_func::GE_FUNC: op= Idx_cond_comparison::GE; break;
+  case Item_func::BETWEEN: op= Idx_cond_comparison::GE; break;
+  case Item_func::IN_FUNC: op= Idx_cond_comparison::IN; break;
+  default:
+    return 0;
+  }
+
+  if (func->functype() == Item_func::BETWEEN ||
+      func->functype() == Item_func::IN_FUNC)
+  {
+    Item_func_opt_neg *f= (Item_func_opt_neg *) func;
+    if (f->negated || !(field= idx_cond_field(args[0], table)) ||
+        (field->cmp_type() == STRING_RESULT &&
+         f->compare_collation() != &my_charset_bin))
+      return 0;
+    values= args + 1;
+    n_values= func->argument_count() - 1;
+  }
+  else
+  {
+    Item_bool_rowready_func2 *f= (Item_bool_rowready_func2 *) func;
+    switch (f->compare_type_handler()->cmp_type()) {
+    case STRING_RESULT:
+      if (f->compare_collation() != &my_charset_bin)
+        return 0;
+      break;
+    case INT_RESULT:
+    case TIME_RESULT:
+      break;
+    default:
+      return 0;
+    }
+
+    if ((field= idx_cond_field(args[0], table)))
+      values= args + 1;
+    else if ((field= idx_cond_field(args[1], table)))
+    {
+      /* constant <op> column */
+      values= args;
+      switch (op) {
+      case Idx_cond_comparison::LT: op= Idx_cond_comparison::GT; break;
+      case Idx_cond_comparison::LE: op= Idx_cond_comparison::GE; break;
+      case Idx_cond_comparison::GT: op= Idx_cond_comparison::LT; break;
+      case Idx_cond_comparison::GE: op= Idx_cond_comparison::LE; break;
+      default: break;
+      }
+    }
+    else
+      return 0;
+    n_values= 1;
+  }
+
+  uint length= field->pack_length();
+  uchar *buf= (uchar *) thd_alloc(table->in_use, n_values * length);
+  if (!buf)
+    return 0;
+
+  for (uint i= 0; i < n_values; i++)
+  {
+    if (idx_cond_store_value(values[i], field, buf + i * length))
+      return 0;
+  }
+
+  cmp->field= field;
+  cmp->op= op;
+  cmp->values= buf;
+
+  if (func->functype() == Item_func::BETWEEN)
+  {
+    cmp->n_values= 1;
+    cmp[1]= cmp[0];
+    cmp[1].op= Idx_cond_comparison::LE;
+    cmp[1].values= buf + length;
+    return 2;
+  }
+
+  cmp->n_values= n_values;
+  return 1;
+}
+
+
+/**
+  Extract the comparisons of columns with constants that a pushed index
+  condition implies, so that an engine can skip the records that do not
+  match without calling handler_index_cond_check().
+
+  Only comparisons, BETWEEN and IN on integer, DATE, DATETIME and BINARY
+  columns whose constants can be stored exactly in the column are
+  extracted. The engine must still call handler_index_cond_check() for
+  the records that satisfy all the comparisons.
+
+  @param      cond  the pushed index condition
+  @param[out] cmps  the comparisons, allocated from the statement memory
+
+  @return number of comparisons
+*/
+uint handler::get_idx_cond_comparisons(Item *cond, Idx_cond_comparison **cmps)
+{
+  Item_cond *and_cond= NULL;
+  uint n_conds= 1, n= 0;
+
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond *) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    and_cond= (Item_cond *) cond;
+    n_conds= and_cond->argument_list()->elements;
+  }
+
+  if (!(*cmps= (Idx_cond_comparison *)
+        thd_alloc(table->in_use, 2 * n_conds * sizeof(**cmps))))
+    return 0;
+
+  if (!and_cond)
+    return idx_cond_comparison(cond, table, *cmps);
+
+  List_iterator_fast<Item> it(*and_cond->argument_list());
+  while (Item *item= it++)
+    n+= idx_cond_comparison(item, table, *cmps + n);
+  return n;
+}
+
 int handler::index_read_idx_map(uchar * buf, uint index, const uchar * key,
                                 key_part_map keypart_map,
                                 enum ha_rkey_function find_flag)
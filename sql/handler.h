@@ -2767,6 +2767,25 @@ class ha_statistics
 
 extern "C" enum icp_result handler_index_cond_check(void* h_arg);
 
+/**
+  A comparison of a column with constants that is implied by a pushed
+  index condition, in a form that an engine can evaluate on its own
+  records without calling handler_index_cond_check().
+
+  @see handler::get_idx_cond_comparisons()
+*/
+struct Idx_cond_comparison
+{
+  enum enum_op { EQ, NE, LT, LE, GT, GE, IN };
+  /** The column; it is compared to the values in the order of Field::cmp() */
+  Field *field;
+  enum_op op;
+  /** Number of values; more than 1 only for IN */
+  uint n_values;
+  /** n_values * field->pack_length() bytes in the record format of field */
+  const uchar *values;
+};
+
 uint calculate_key_len(TABLE *, uint, const uchar *, key_part_map);
 /*
   bitmap with first N+1 bits set
@@ -3562,6 +3581,13 @@ class handler :public Sql_alloc
   virtual int ft_read(uchar *buf) { return HA_ERR_WRONG_COMMAND; }
   virtual int rnd_next(uchar *buf)=0;
   virtual int rnd_pos(uchar * buf, uchar *pos)=0;
+  /**
+    Hint that the row with the given position is about to be read by
+    rnd_pos(). DS-MRR calls this for each rowid of a sorted batch before
+    reading the batch, so that the engine can start fetching the rows
+    in the background.
+  */
+  virtual void rnd_pos_prefetch(const uchar *pos) {}
   /**
     This function only works for handlers having
     HA_PRIMARY_KEY_REQUIRED_FOR_POSITION set.
@@ -4025,6 +4051,8 @@ class handler :public Sql_alloc
    in_range_check_pushed_down= false;
  }
 
+ uint get_idx_cond_comparisons(Item *cond, Idx_cond_comparison **cmps);
+
  /* Needed for partition / spider */
   virtual TABLE_LIST *get_next_global_for_child() { return NULL; }
 
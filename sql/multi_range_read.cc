@@ -697,6 +697,13 @@ int Mrr_ordered_rndpos_reader::refill_from_index_reader()
 
   rowid_buffer->setup_reading(file->ref_length,
                               is_mrr_assoc ? sizeof(range_id_t) : 0);
+
+  /* Let the engine start reading the rows in the order of the lookups */
+  Lifo_buffer_iterator it;
+  it.init(rowid_buffer);
+  while (!it.read())
+    file->rnd_pos_prefetch(it.read_ptr1);
+
   DBUG_RETURN(rowid_buffer->is_empty()? HA_ERR_END_OF_FILE : 0);
 }
 
@@ -5071,6 +5071,16 @@ extern "C" int thd_non_transactional_update(const MYSQL_THD thd)
   return(thd->transaction.all.modified_non_trans_table);
 }
 
+extern "C" int thd_is_error(const MYSQL_THD thd)
+{
+  return(thd->is_error());
+}
+
+extern "C" int thd_is_explain(const MYSQL_THD thd)
+{
+  return(thd->lex->describe != 0);
+}
+
 extern "C" int thd_binlog_format(const MYSQL_THD thd)
 {
   if (WSREP(thd))
@@ -21560,7 +21560,7 @@ uint find_shortest_key(TABLE *table, const key_map *usable_keys)
     {
       if (usable_keys->is_set(nr))
       {
-        double cost= table->file->keyread_time(nr, 1, table->file->records());
+        double cost= table->file->keyread_time(nr, 1, table->file->stats.records);
         if (cost < min_cost)
         {
           min_cost= cost;
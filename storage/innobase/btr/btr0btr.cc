@@ -1461,6 +1461,56 @@ btr_free(
 	mtr.commit();
 }
 
+/** Empty an index tree, keeping only the root page. This is used for
+rolling back TRX_UNDO_EMPTY (a bulk insert into an empty table).
+@param[in,out]	index	index tree
+@return error code */
+dberr_t
+btr_clear(dict_index_t* index)
+{
+	ut_ad(!index->table->is_temporary());
+	ut_ad(!dict_index_is_ibuf(index));
+
+	dberr_t	err = DB_SUCCESS;
+	mtr_t	mtr;
+	mtr.start();
+	index->set_modified(mtr);
+	mtr_x_lock(&index->lock, &mtr);
+
+	buf_block_t*	root = btr_root_block_get(index, RW_X_LATCH, &mtr);
+
+	if (!root) {
+		err = DB_CORRUPTION;
+	} else {
+		/* Free all pages except the root, and the file segment
+		for the leaf pages. */
+		btr_free_but_not_root(root, MTR_LOG_ALL);
+
+		/* Like in btr_create(), fseg_create() expects to find
+		the segment header on a FIL_PAGE_TYPE_SYS page.
+		btr_page_empty() will restore FIL_PAGE_INDEX. */
+		mlog_write_ulint(root->frame + FIL_PAGE_TYPE,
+				 FIL_PAGE_TYPE_SYS, MLOG_2BYTES, &mtr);
+
+		if (!fseg_create(index->table->space,
+				 root->page.id.page_no(),
+				 PAGE_HEADER + PAGE_BTR_SEG_LEAF, &mtr)) {
+			err = DB_OUT_OF_FILE_SPACE;
+		} else {
+			buf_block_dbg_add_level(root, SYNC_TREE_NODE);
+			btr_page_empty(root, buf_block_get_page_zip(root),
+				       index, 0, &mtr);
+
+			if (!dict_index_is_clust(index)) {
+				ibuf_reset_free_bits(root);
+			}
+		}
+	}
+
+	mtr.commit();
+	return(err);
+}
+
 /** Read the last used AUTO_INCREMENT value from PAGE_ROOT_AUTO_INC.
 @param[in,out]	index	clustered index
 @return	the last used AUTO_INCREMENT value
@@ -28,8 +28,11 @@ Created 03/11/2014 Shaohua Wang
 #include "btr0btr.h"
 #include "btr0cur.h"
 #include "btr0pcur.h"
+#include "gis0rtree.h"
 #include "ibuf0ibuf.h"
 
+#include <algorithm>
+
 /** Innodb B-tree index fill factor for bulk load. */
 uint	innobase_fill_factor;
 
@@ -52,8 +55,12 @@ PageBulk::init()
 		mem_heap_alloc(m_heap, sizeof(mtr_t)));
 	mtr_start(mtr);
 	mtr_x_lock(dict_index_get_lock(m_index), mtr);
-	mtr_set_log_mode(mtr, MTR_LOG_NO_REDO);
-	mtr_set_flush_observer(mtr, m_flush_observer);
+	if (m_flush_observer) {
+		mtr_set_log_mode(mtr, MTR_LOG_NO_REDO);
+		mtr_set_flush_observer(mtr, m_flush_observer);
+	} else {
+		m_index->set_modified(*mtr);
+	}
 
 	if (m_page_no == FIL_NULL) {
 		mtr_t	alloc_mtr;
@@ -92,13 +99,16 @@ PageBulk::init()
 			page_create_zip(new_block, m_index, m_level, 0,
 					NULL, mtr);
 		} else {
-			ut_ad(!dict_index_is_spatial(m_index));
 			page_create(new_block, mtr,
 				    dict_table_is_comp(m_index->table),
-				    false);
+				    dict_index_is_spatial(m_index));
 			btr_page_set_level(new_page, NULL, m_level, mtr);
 		}
 
+		if (dict_index_is_spatial(m_index)) {
+			page_set_ssn_id(new_block, NULL, 0, mtr);
+		}
+
 		btr_page_set_next(new_page, NULL, FIL_NULL, mtr);
 		btr_page_set_prev(new_page, NULL, FIL_NULL, mtr);
 
@@ -170,8 +180,10 @@ PageBulk::insert(
 	ut_d(const bool is_leaf = page_rec_is_leaf(m_cur_rec));
 
 #ifdef UNIV_DEBUG
-	/* Check whether records are in order. */
-	if (!page_rec_is_infimum(m_cur_rec)) {
+	/* Check whether records are in order. The records of an R-tree
+	page are sorted in sortRecs(). */
+	if (!page_rec_is_infimum(m_cur_rec)
+	    && !dict_index_is_spatial(m_index)) {
 		rec_t*	old_rec = m_cur_rec;
 		ulint*	old_offsets = rec_get_offsets(
 			old_rec, m_index, NULL,	is_leaf,
@@ -220,6 +232,87 @@ PageBulk::insert(
 	m_cur_rec = insert_rec;
 }
 
+/** Ordering of the records of an R-tree page, with their offsets */
+struct rec_less
+{
+	/** the R-tree */
+	const dict_index_t*	m_index;
+
+	rec_less(const dict_index_t* index) : m_index(index) {}
+
+	bool operator()(
+		const std::pair<const rec_t*, ulint*>&	a,
+		const std::pair<const rec_t*, ulint*>&	b) const
+	{
+		return(cmp_rec_rec(a.first, b.first, a.second, b.second,
+				   m_index) < 0);
+	}
+};
+
+/** Sort the records of an R-tree page. The records of each R-tree
+level are inserted in the order of a space-filling curve, but the
+records in a page must be in the index order. */
+void
+PageBulk::sortRecs()
+{
+	typedef std::pair<const rec_t*, ulint*>	rec_offs_t;
+
+	ut_ad(dict_index_is_spatial(m_index));
+
+	const bool	is_leaf = page_is_leaf(m_page);
+	byte*		heap_bot = m_page + (m_is_comp
+					     ? PAGE_NEW_SUPREMUM_END
+					     : PAGE_OLD_SUPREMUM_END);
+	const ulint	heap_size = ulint(m_heap_top - heap_bot);
+	const byte*	copy = static_cast<const byte*>(
+		mem_heap_dup(m_heap, heap_bot, heap_size));
+	bool		sorted = true;
+
+	std::vector<rec_offs_t, ut_allocator<rec_offs_t> >	recs;
+	recs.reserve(m_rec_no);
+
+	for (const rec_t* rec = page_rec_get_next_const(
+		     page_get_infimum_rec(m_page));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next_const(rec)) {
+		ulint*		offsets = rec_get_offsets(
+			rec, m_index, NULL, is_leaf, ULINT_UNDEFINED, &m_heap);
+		const rec_t*	copy_rec = copy + (rec - heap_bot);
+
+		rec_offs_make_valid(copy_rec, m_index, is_leaf, offsets);
+
+		if (!recs.empty()
+		    && cmp_rec_rec(copy_rec, recs.back().first,
+				   offsets, recs.back().second, m_index) < 0) {
+			sorted = false;
+		}
+
+		recs.push_back(rec_offs_t(copy_rec, offsets));
+	}
+
+	ut_ad(recs.size() == m_rec_no);
+
+	if (sorted) {
+		return;
+	}
+
+	std::stable_sort(recs.begin(), recs.end(), rec_less(m_index));
+
+	/* Empty the page and insert the records again, so that the
+	heap order of the records is the same as the list order. */
+	page_rec_set_next(page_get_infimum_rec(m_page),
+			  page_get_supremum_rec(m_page));
+	m_cur_rec = page_get_infimum_rec(m_page);
+	m_heap_top = heap_bot;
+	m_rec_no = 0;
+	m_free_space = page_get_free_space_of_empty(m_is_comp);
+	ut_d(m_total_data = 0);
+
+	for (ulint i = 0; i < recs.size(); i++) {
+		insert(recs[i].first, recs[i].second);
+	}
+}
+
 /** Mark end of insertion to the page. Scan all records to set page dirs,
 and set page header members.
 Note: we refer to page_copy_rec_list_end_to_created_page. */
@@ -228,6 +321,10 @@ PageBulk::finish()
 {
 	ut_ad(m_rec_no > 0);
 
+	if (dict_index_is_spatial(m_index)) {
+		sortRecs();
+	}
+
 #ifdef UNIV_DEBUG
 	ut_ad(m_total_data + page_dir_calc_reserved_space(m_rec_no)
 	      <= page_get_free_space_of_empty(m_is_comp));
@@ -285,7 +382,6 @@ PageBulk::finish()
 	page_dir_slot_set_rec(slot, page_get_supremum_rec(m_page));
 	page_dir_slot_set_n_owned(slot, NULL, count + 1);
 
-	ut_ad(!dict_index_is_spatial(m_index));
 	page_dir_set_n_slots(m_page, NULL, 2 + slot_index);
 	page_header_set_ptr(m_page, NULL, PAGE_HEAP_TOP, m_heap_top);
 	page_dir_set_n_heap(m_page, NULL, PAGE_HEAP_NO_USER_LOW + m_rec_no);
@@ -314,6 +410,22 @@ PageBulk::commit(
 			ibuf_set_bitmap_for_bulk_load(
 				m_block, innobase_fill_factor == 100);
 		}
+
+		if (!m_flush_observer && !m_page_zip) {
+			/* The records and the page directory were
+			written without redo logging. Log them now.
+			(ROW_FORMAT=COMPRESSED pages were logged
+			by page_zip_compress().) */
+			mlog_log_string(m_page + PAGE_HEADER,
+					ulint(m_heap_top
+					      - (m_page + PAGE_HEADER)),
+					m_mtr);
+			byte* dir = page_dir_get_nth_slot(
+				m_page, page_dir_get_n_slots(m_page) - 1);
+			mlog_log_string(dir, ulint(m_page + srv_page_size
+						   - PAGE_DIR - dir),
+					m_mtr);
+		}
 	}
 
 	mtr_commit(m_mtr);
@@ -342,8 +454,20 @@ PageBulk::getNodePtr()
 	/* Create node pointer */
 	first_rec = page_rec_get_next(page_get_infimum_rec(m_page));
 	ut_a(page_rec_is_user_rec(first_rec));
-	node_ptr = dict_index_build_node_ptr(m_index, first_rec, m_page_no,
-					     m_heap, m_level);
+
+	if (dict_index_is_spatial(m_index)) {
+		/* The node pointer of an R-tree page covers the
+		minimum bounding rectangle of all its records. */
+		rtr_mbr_t	mbr;
+
+		rtr_page_cal_mbr(m_index, m_block, &mbr, m_heap);
+		node_ptr = rtr_index_build_node_ptr(m_index, &mbr, first_rec,
+						    m_page_no, m_heap);
+	} else {
+		node_ptr = dict_index_build_node_ptr(m_index, first_rec,
+						     m_page_no, m_heap,
+						     m_level);
+	}
 
 	return(node_ptr);
 }
@@ -579,8 +703,6 @@ Note: log_free_check requires holding no lock/latch in current thread. */
 void
 PageBulk::release()
 {
-	ut_ad(!dict_index_is_spatial(m_index));
-
 	/* We fix the block because we will re-pin it soon. */
 	buf_block_buf_fix_inc(m_block, __FILE__, __LINE__);
 
@@ -598,8 +720,12 @@ PageBulk::latch()
 
 	mtr_start(m_mtr);
 	mtr_x_lock(dict_index_get_lock(m_index), m_mtr);
-	mtr_set_log_mode(m_mtr, MTR_LOG_NO_REDO);
-	mtr_set_flush_observer(m_mtr, m_flush_observer);
+	if (m_flush_observer) {
+		mtr_set_log_mode(m_mtr, MTR_LOG_NO_REDO);
+		mtr_set_flush_observer(m_mtr, m_flush_observer);
+	} else {
+		m_index->set_modified(*m_mtr);
+	}
 
 	/* TODO: need a simple and wait version of buf_page_optimistic_get. */
 	ret = buf_page_optimistic_get(RW_X_LATCH, m_block, m_modify_clock,
@@ -725,6 +851,9 @@ BtrBulk::pageCommit(
 void
 BtrBulk::logFreeCheck()
 {
+	DBUG_EXECUTE_IF("btr_bulk_instrument_log_check_flush",
+			log_sys.check_flush_or_checkpoint = true;);
+
 	if (log_sys.check_flush_or_checkpoint) {
 		release();
 
@@ -856,7 +985,8 @@ BtrBulk::insert(
 		/* Important: log_free_check whether we need a checkpoint. */
 		if (page_is_leaf(sibling_page_bulk->getPage())) {
 			/* Check whether trx is interrupted */
-			if (m_flush_observer->check_interrupted()) {
+			if (m_flush_observer
+			    && m_flush_observer->check_interrupted()) {
 				err = DB_INTERRUPTED;
 				goto func_exit;
 			}
@@ -51,6 +51,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "rem0rec.h"
 #include "rem0cmp.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "row0log.h"
@@ -2219,6 +2220,85 @@ btr_cur_search_to_nth_level_func(
 	DBUG_RETURN(err);
 }
 
+/** Start an asynchronous read of the leaf page that a search for a tuple
+would end up on, unless the page is already in the buffer pool.
+@param[in,out]	index	B-tree index
+@param[in]	tuple	search tuple
+@param[in]	prev	page number that was returned for the preceding
+			tuple in key order, or FIL_NULL
+@return page number of the leaf page, or FIL_NULL if the index consists
+of the root page only or a page could not be read */
+ulint
+btr_cur_prefetch_leaf(dict_index_t* index, const dtuple_t* tuple, ulint prev)
+{
+	ut_ad(!dict_index_is_spatial(index));
+
+	mtr_t		mtr;
+	mem_heap_t*	heap	= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets	= offsets_;
+	ulint		page_no	= FIL_NULL;
+
+	rec_offs_init(offsets_);
+
+	mtr.start();
+	/* The index S-latch prevents the node pointers from changing
+	while we descend the non-leaf levels. The leaf page itself is
+	not accessed. */
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	const page_size_t	page_size(index->table->space->flags);
+	buf_block_t*		block = btr_root_block_get(
+		index, RW_S_LATCH, &mtr);
+
+	for (ulint level = block
+		     ? btr_page_get_level(buf_block_get_frame(block)) : 0;
+	     level > 0; level--) {
+		page_cur_t	cur;
+
+		page_cur_search(block, index, tuple, PAGE_CUR_LE, &cur);
+
+		const rec_t*	node_ptr = page_cur_get_rec(&cur);
+
+		offsets = rec_get_offsets(node_ptr, index, offsets, false,
+					  ULINT_UNDEFINED, &heap);
+		page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
+
+		if (level == 1) {
+			break;
+		}
+
+		block = btr_block_get(
+			page_id_t(index->table->space->id, page_no),
+			page_size, RW_S_LATCH, index, &mtr);
+
+		if (!block) {
+			page_no = FIL_NULL;
+			break;
+		}
+	}
+
+	mtr.commit();
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	if (page_no == FIL_NULL || page_no == prev) {
+		return(page_no);
+	}
+
+	const page_id_t	page_id(index->table->space->id, page_no);
+
+	if (!buf_page_peek(page_id)) {
+		buf_read_page_background(page_id, page_size, false);
+		os_aio_simulated_wake_handler_threads();
+		MONITOR_INC(MONITOR_MRR_PREFETCH);
+	}
+
+	return(page_no);
+}
+
 /*****************************************************************//**
 Opens a cursor at either end of an index. */
 dberr_t
@@ -1055,7 +1055,7 @@ btr_search_guess_on_hash(
 #endif
 	if (!ahi_latch && buf_page_peek_if_too_old(&block->page)) {
 
-		buf_page_make_young(&block->page);
+		buf_page_set_referenced(&block->page);
 	}
 
 	/* Increment the page get statistics though we did not really
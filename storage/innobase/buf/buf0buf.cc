@@ -67,6 +67,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "page0zip.h"
 #include "sync0sync.h"
 #include "buf0dump.h"
+#include "buf0stats.h"
 #include "ut0new.h"
 #include <new>
 #include <map>
@@ -1478,6 +1479,7 @@ buf_block_init(
 	block->page.real_size = 0;
 	block->page.write_size = 0;
 	block->modify_clock = 0;
+	block->index_stats = NULL;
 	block->page.slot = NULL;
 
 	ut_d(block->page.file_page_was_freed = FALSE);
@@ -2031,6 +2033,33 @@ buf_pool_free_instance(
 	buf_pool->allocator.~ut_allocator();
 }
 
+#ifdef LINUX_IO_URING
+/** Register the buffer pool chunks as io_uring fixed buffers. */
+static
+void
+buf_pool_register_io_buffers()
+{
+	std::vector<iovec>	bufs;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		const buf_chunk_t*	chunk = buf_pool->chunks;
+
+		for (ulint n = buf_pool->n_chunks; n--; chunk++) {
+			iovec	buf;
+
+			buf.iov_base = chunk->mem;
+			buf.iov_len = chunk->mem_size();
+			bufs.push_back(buf);
+		}
+	}
+
+	if (!bufs.empty()) {
+		os_aio_register_buffers(&bufs[0], bufs.size());
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -2077,6 +2106,12 @@ buf_pool_init(
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_index_stats_create();
+
+#ifdef LINUX_IO_URING
+	buf_pool_register_io_buffers();
+#endif /* LINUX_IO_URING */
+
 	return(DB_SUCCESS);
 }
 
@@ -2088,6 +2123,10 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances)	/*!< in: numbere of instances to free */
 {
+#ifdef LINUX_IO_URING
+	os_aio_unregister_buffers();
+#endif /* LINUX_IO_URING */
+
 	for (ulint i = 0; i < n_instances; i++) {
 		buf_pool_free_instance(buf_pool_from_array(i));
 	}
@@ -2095,6 +2134,8 @@ buf_pool_free(
 	UT_DELETE(buf_chunk_map_reg);
 	buf_chunk_map_reg = buf_chunk_map_ref = NULL;
 
+	buf_index_stats_free();
+
 	ut_free(buf_pool_ptr);
 	buf_pool_ptr = NULL;
 }
@@ -2217,6 +2258,9 @@ buf_page_realloc(
 		new_block->left_side	= TRUE;
 #endif /* BTR_CUR_HASH_ADAPT */
 
+		new_block->index_stats = block->index_stats;
+		block->index_stats = NULL;
+
 		new_block->lock_hash_val = block->lock_hash_val;
 		ut_ad(new_block->lock_hash_val == lock_rec_hash(
 			new_block->page.id.space(),
@@ -2825,6 +2869,11 @@ buf_pool_resize()
 		return;
 	}
 
+#ifdef LINUX_IO_URING
+	/* The chunks are about to be reallocated. */
+	os_aio_unregister_buffers();
+#endif /* LINUX_IO_URING */
+
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
@@ -3055,6 +3104,10 @@ buf_pool_resize()
 
 	buf_pool_resizing = false;
 
+#ifdef LINUX_IO_URING
+	buf_pool_register_io_buffers();
+#endif /* LINUX_IO_URING */
+
 	/* Normalize other components, if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		srv_buf_pool_base_size = srv_buf_pool_size;
@@ -3644,9 +3697,9 @@ buf_page_make_young(
 }
 
 /********************************************************************//**
-Moves a page to the start of the buffer pool LRU list if it is too old.
-This high-level function can be used to prevent an important page from
-slipping out of the buffer pool. */
+Marks a page to be moved to the start of the buffer pool LRU list if it is
+too old. The move is deferred to the next LRU scan that reaches the page,
+so that page hits do not contend on buf_pool->mutex. */
 static
 void
 buf_page_make_young_if_needed(
@@ -3661,7 +3714,7 @@ buf_page_make_young_if_needed(
 	ut_a(buf_page_in_file(bpage));
 
 	if (buf_page_peek_if_too_old(bpage)) {
-		buf_page_make_young(bpage);
+		buf_page_set_referenced(bpage);
 	}
 }
 
@@ -4235,6 +4288,7 @@ buf_page_get_gen(
 	rw_lock_t*	hash_lock;
 	buf_block_t*	fix_block;
 	ulint		retries = 0;
+	bool		read = false;
 	buf_pool_t*	buf_pool = buf_pool_get(page_id);
 
 	ut_ad((mtr == NULL) == (mode == BUF_EVICT_IF_IN_POOL));
@@ -4393,6 +4447,7 @@ buf_page_get_gen(
 					      ibuf_inside(mtr));
 
 			retries = 0;
+			read = true;
 		} else if (mode == BUF_GET_POSSIBLY_FREED) {
 			if (err) {
 				*err = local_err;
@@ -4876,6 +4931,10 @@ buf_page_get_gen(
 
 	mtr_memo_push(mtr, fix_block, fix_type);
 
+	if (mode != BUF_PEEK_IF_IN_POOL && srv_buf_pool_index_stats) {
+		buf_index_stats_access(fix_block, read, !access_time);
+	}
+
 	if (mode != BUF_PEEK_IF_IN_POOL && !access_time) {
 		/* In the case of a first access, try to apply linear
 		read-ahead */
@@ -5120,7 +5179,7 @@ buf_page_get_known_nowait(
 
 /** Given a tablespace id and page number tries to get that page. If the
 page is not in the buffer pool it is not loaded and NULL is returned.
-Suitable for using when holding the lock_sys_t::mutex.
+Suitable for using when holding the lock_sys.latch.
 @param[in]	page_id	page id
 @param[in]	file	file name
 @param[in]	line	line where called
@@ -5220,6 +5279,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->old = 0;
 	bpage->freed_page_clock = 0;
+	bpage->referenced = 0;
 	bpage->access_time = 0;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
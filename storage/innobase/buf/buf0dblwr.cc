@@ -43,6 +43,9 @@ ibool	buf_dblwr_being_created = FALSE;
 
 #define TRX_SYS_DOUBLEWRITE_BLOCKS 2
 
+/** Minimum number of slots in a partition of the batch flush slots */
+#define BUF_DBLWR_MIN_BATCH_SIZE 16
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -72,6 +75,17 @@ buf_dblwr_page_inside(
 	return(FALSE);
 }
 
+/** Get the doublewrite partition that the pages of a buffer pool
+instance are written through.
+@param[in]	instance_no	buffer pool instance number
+@return the partition of the batch flush slots */
+static inline
+buf_dblwr_batch_t*
+buf_dblwr_get_batch(ulint instance_no)
+{
+	return(&buf_dblwr->batches[instance_no % buf_dblwr->n_batches]);
+}
+
 /****************************************************************//**
 Calls buf_page_get() on the TRX_SYS_PAGE and returns a pointer to the
 doublewrite buffer within it.
@@ -134,11 +148,30 @@ buf_dblwr_init(
 
 	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
 
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
 	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
 	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+
+	/* Partition the batch flush slots by buffer pool instance, so
+	that page cleaner threads that flush different instances do not
+	wait for each other's doublewrite batches. */
+	ulint	n = ut_min(ulint(srv_n_page_cleaners),
+			   ulint(srv_buf_pool_instances));
+	n = ut_min(n, srv_doublewrite_batch_size / BUF_DBLWR_MIN_BATCH_SIZE);
+	n = ut_max(n, ulint(1));
+
+	buf_dblwr->n_batches = n;
+	buf_dblwr->batches = static_cast<buf_dblwr_batch_t*>(
+		ut_zalloc_nokey(n * sizeof *buf_dblwr->batches));
+
+	for (ulint i = 0; i < n; i++) {
+		buf_dblwr_batch_t*	batch = &buf_dblwr->batches[i];
+
+		mutex_create(LATCH_ID_BUF_DBLWR, &batch->mutex);
+		batch->b_event = os_event_create("dblwr_batch_event");
+		batch->first = i * srv_doublewrite_batch_size / n;
+		batch->size = (i + 1) * srv_doublewrite_batch_size / n
+			- batch->first;
+	}
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
@@ -540,6 +573,17 @@ buf_dblwr_process()
 	     ++i, ++page_no_dblwr) {
 		byte*	page		= *i;
 		ulint	space_id	= page_get_space_id(page);
+		const ulint	page_no	= page_get_page_no(page);
+
+		if (recv_dblwr.find_page(space_id, page_no) != page) {
+			/* The doublewrite buffer contains a newer copy
+			of the page, possibly in the slots of another
+			partition. Only the newest copy may be written
+			back, because the older ones may predate the
+			latest checkpoint. */
+			continue;
+		}
+
 		fil_space_t*	space = fil_space_get(space_id);
 
 		if (space == NULL) {
@@ -550,7 +594,6 @@ buf_dblwr_process()
 
 		fil_space_open_if_needed(space);
 
-		const ulint		page_no	= page_get_page_no(page);
 		const page_id_t		page_id(space_id, page_no);
 
 		if (page_no >= space->size) {
@@ -692,9 +735,18 @@ buf_dblwr_free()
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
 	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_destroy(buf_dblwr->b_event);
+	for (ulint i = 0; i < buf_dblwr->n_batches; i++) {
+		buf_dblwr_batch_t*	batch = &buf_dblwr->batches[i];
+
+		ut_ad(batch->b_reserved == 0);
+		os_event_destroy(batch->b_event);
+		mutex_free(&batch->mutex);
+	}
+
+	ut_free(buf_dblwr->batches);
+	buf_dblwr->batches = NULL;
+
 	os_event_destroy(buf_dblwr->s_event);
 	ut_free(buf_dblwr->write_buf_unaligned);
 	buf_dblwr->write_buf_unaligned = NULL;
@@ -726,28 +778,34 @@ buf_dblwr_update(
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		{
+			buf_dblwr_batch_t*	batch = buf_dblwr_get_batch(
+				bpage->buf_pool_index);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+			mutex_enter(&batch->mutex);
 
-		buf_dblwr->b_reserved--;
+			ut_ad(batch->batch_running);
+			ut_ad(batch->b_reserved > 0);
+			ut_ad(batch->b_reserved <= batch->first_free);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
-			/* This will finish the batch. Sync data files
-			to the disk. */
-			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			batch->b_reserved--;
 
-			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
-		}
+			if (batch->b_reserved == 0) {
+				mutex_exit(&batch->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. Concurrent calls from
+				other partitions share the fsync. */
+				fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+				mutex_enter(&batch->mutex);
 
-		mutex_exit(&buf_dblwr->mutex);
+				/* We can now reuse the slots: */
+				batch->first_free = 0;
+				batch->batch_running = false;
+				os_event_set(batch->b_event);
+			}
+
+			mutex_exit(&batch->mutex);
+		}
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
@@ -932,39 +990,29 @@ buf_dblwr_write_block_to_datafile(
 	}
 }
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Write the pages that have been posted to a partition to the
+doublewrite buffer, and then post their writes to the data files.
+@param[in,out]	batch	partition of the batch flush slots */
+static
 void
-buf_dblwr_flush_buffered_writes()
+buf_dblwr_flush_batch(buf_dblwr_batch_t* batch)
 {
 	byte*		write_buf;
 	ulint		first_free;
 	ulint		len;
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		/* Now we flush the data to disk (for example, with fsync) */
-		fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-		return;
-	}
-
 	ut_ad(!srv_read_only_mode);
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&batch->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (batch->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&batch->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -975,38 +1023,40 @@ buf_dblwr_flush_buffered_writes()
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (batch->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(batch->b_event);
+		mutex_exit(&batch->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(batch->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_ad(batch->first_free == batch->b_reserved);
 
-	/* Disallow anyone else to post to doublewrite buffer or to
+	/* Disallow anyone else to post to the partition or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	batch->batch_running = true;
+	first_free = batch->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
-	but any threads working on single page flushes are allowed
-	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	but any threads working on single page flushes or on the
+	other partitions are allowed to proceed. */
+	mutex_exit(&batch->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	buf_page_t**	block_arr = buf_dblwr->buf_block_arr + batch->first;
+	write_buf = buf_dblwr->write_buf
+		+ (batch->first << srv_page_size_shift);
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += srv_page_size, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1024,33 +1074,41 @@ buf_dblwr_flush_buffered_writes()
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = std::min<ulint>(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-			      buf_dblwr->first_free) << srv_page_size_shift;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
+	/* The slots of the partition may span both blocks of the
+	doublewrite buffer. */
+	ulint	slot = batch->first;
+	ulint	end = batch->first + first_free;
+
+	if (slot < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+		/* Write out the part in the first block */
+		len = (std::min<ulint>(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE, end)
+		       - slot) << srv_page_size_shift;
+
+		fil_io(IORequestWrite, true,
+		       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1 + slot),
+		       univ_page_size, 0, len,
+		       (void*) (buf_dblwr->write_buf
+				+ (slot << srv_page_size_shift)),
+		       NULL);
 
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
+		slot = TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 	}
 
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       << srv_page_size_shift;
+	if (slot < end) {
+		/* Write out the part in the second block */
+		len = (end - slot) << srv_page_size_shift;
 
-	write_buf = buf_dblwr->write_buf
-		+ (TRX_SYS_DOUBLEWRITE_BLOCK_SIZE << srv_page_size_shift);
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
+		fil_io(IORequestWrite, true,
+		       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2 + slot
+				 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE),
+		       univ_page_size, 0, len,
+		       (void*) (buf_dblwr->write_buf
+				+ (slot << srv_page_size_shift)),
+		       NULL);
+	}
 
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
 	/* Now flush the doublewrite buffer data to disk */
@@ -1060,21 +1118,20 @@ buf_dblwr_flush_buffered_writes()
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and batch->first_free are
+	same because we have set the batch->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access batch->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting batch->first_free to a higher value.
+	If this happens and we are using batch->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == batch->first_free);
 	for (ulint i = 0; i < first_free; i++) {
-		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+		buf_dblwr_write_block_to_datafile(block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1084,6 +1141,43 @@ buf_dblwr_flush_buffered_writes()
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+void
+buf_dblwr_flush_buffered_writes()
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		/* Now we flush the data to disk (for example, with fsync) */
+		fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+		return;
+	}
+
+	for (ulint i = 0; i < buf_dblwr->n_batches; i++) {
+		buf_dblwr_flush_batch(&buf_dblwr->batches[i]);
+	}
+}
+
+/** Flush the buffered writes of the doublewrite partition that the pages
+of a buffer pool instance are written through.
+@see buf_dblwr_flush_buffered_writes()
+@param[in]	instance_no	buffer pool instance number */
+void
+buf_dblwr_flush_buffered_writes(ulint instance_no)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		buf_dblwr_flush_buffered_writes();
+		return;
+	}
+
+	buf_dblwr_flush_batch(buf_dblwr_get_batch(instance_no));
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -1095,36 +1189,39 @@ buf_dblwr_add_to_batch(
 {
 	ut_a(buf_page_in_file(bpage));
 
+	buf_dblwr_batch_t*	batch = buf_dblwr_get_batch(
+		bpage->buf_pool_index);
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&batch->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(batch->first_free <= batch->size);
 
-	if (buf_dblwr->batch_running) {
+	if (batch->batch_running) {
 
-		/* This not nearly as bad as it looks. There is only
-		page_cleaner thread which does background flushing
-		in batches therefore it is unlikely to be a contention
-		point. The only exception is when a user thread is
-		forced to do a flush batch because of a sync
-		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		/* This not nearly as bad as it looks. A page cleaner
+		thread only waits here when another thread is flushing a
+		buffer pool instance that maps to the same partition,
+		which is unlikely unless there are more buffer pool
+		instances than partitions, or a user thread is forced
+		to do a flush batch because of a sync checkpoint. */
+		int64_t	sig_count = os_event_reset(batch->b_event);
+		mutex_exit(&batch->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(batch->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (batch->first_free == batch->size) {
+		mutex_exit(&batch->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_batch(batch);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ srv_page_size * buf_dblwr->first_free;
+	const ulint	slot = batch->first + batch->first_free;
+	byte*	p = buf_dblwr->write_buf + srv_page_size * slot;
 
 	/* We request frame here to get correct buffer in case of
 	encryption and/or page compression */
@@ -1147,24 +1244,24 @@ buf_dblwr_add_to_batch(
 		memcpy(p, frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	buf_dblwr->buf_block_arr[slot] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	batch->first_free++;
+	batch->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!batch->batch_running);
+	ut_ad(batch->first_free == batch->b_reserved);
+	ut_ad(batch->b_reserved <= batch->size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (batch->first_free == batch->size) {
+		mutex_exit(&batch->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_batch(batch);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&batch->mutex);
 }
 
 /********************************************************************//**
@@ -72,6 +72,10 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/** Number of pages in the first batch of buf_load(). Each subsequent
+batch is as big as all the preceding ones together. */
+static const ulint	BUF_LOAD_MIN_BATCH = 256;
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -246,6 +250,18 @@ buf_dump_generate_path(
 	}
 }
 
+/** Free the page lists that were collected by buf_dump().
+@param[in,out]	dumps	page lists of the buffer pool instances */
+static
+void
+buf_dump_free(buf_dump_t** dumps)
+{
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		ut_free(dumps[i]);
+		dumps[i] = NULL;
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -298,6 +314,14 @@ buf_dump(
 	}
 	/* else */
 
+	buf_dump_t*	dumps[MAX_BUFFER_POOLS];
+	ulint		n_dumped[MAX_BUFFER_POOLS];
+	ulint		max_n_dumped = 0;
+	ulint		total_n_dumped = 0;
+
+	memset(dumps, 0, sizeof dumps);
+	memset(n_dumped, 0, sizeof n_dumped);
+
 	/* walk through each buffer pool */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
@@ -350,6 +374,7 @@ buf_dump(
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
+			buf_dump_free(dumps);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
@@ -359,6 +384,7 @@ buf_dump(
 			return;
 		}
 
+		/* The LRU list starts from the most recently used page. */
 		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
 		     bpage != NULL && j < n_pages;
 		     bpage = UT_LIST_GET_NEXT(LRU, bpage)) {
@@ -376,14 +402,28 @@ buf_dump(
 		buf_pool_mutex_exit(buf_pool);
 
 		ut_a(j <= n_pages);
-		n_pages = j;
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
+		dumps[i] = dump;
+		n_dumped[i] = j;
+		total_n_dumped += j;
+		max_n_dumped = std::max(max_n_dumped, j);
+	}
+
+	/* Interleave the buffer pool instances, so that the pages are
+	written in the order of their position in the LRU lists.
+	buf_load() will read the hottest pages first. */
+	for (ulint j = 0, n_written = 0;
+	     j < max_n_dumped && !SHOULD_QUIT(); j++) {
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+			if (j >= n_dumped[i]) {
+				continue;
+			}
+
 			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+				      BUF_DUMP_SPACE(dumps[i][j]),
+				      BUF_DUMP_PAGE(dumps[i][j]));
 			if (ret < 0) {
-				ut_free(dump);
+				buf_dump_free(dumps);
 				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
@@ -391,19 +431,17 @@ buf_dump(
 				/* leave tmp_filename to exist */
 				return;
 			}
-			if ( (j % 1024) == 0) {
+			if ((n_written++ % 1024) == 0) {
 				service_manager_extend_timeout(INNODB_EXTEND_TIMEOUT_INTERVAL,
-					"Dumping buffer pool "
-					ULINTPF "/" ULINTPF ", "
-					"page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
+					"Dumping buffer pool page "
+					ULINTPF "/" ULINTPF,
+					n_written, total_n_dumped);
 			}
 		}
-
-		ut_free(dump);
 	}
 
+	buf_dump_free(dumps);
+
 	ret = fclose(f);
 	if (ret != 0) {
 		buf_dump_status(STATUS_ERR,
@@ -513,6 +551,42 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Wait until the pages that buf_load() requested have been read.
+Other reads that are pending at the same time are not waited for.
+@param[in]	dump	page identifiers of the buffer pool dump
+@param[in]	n	number of entries in dump that were processed */
+static
+void
+buf_load_wait_for_reads(const buf_dump_t* dump, ulint n)
+{
+	for (ulint i = 0; i < n && !SHUTTING_DOWN(); i++) {
+		const page_id_t	page_id(BUF_DUMP_SPACE(dump[i]),
+					BUF_DUMP_PAGE(dump[i]));
+		buf_pool_t*	buf_pool = buf_pool_get(page_id);
+
+		for (;;) {
+			rw_lock_t*	hash_lock;
+			buf_page_t*	bpage = buf_page_hash_get_s_locked(
+				buf_pool, page_id, &hash_lock);
+
+			if (bpage == NULL) {
+				break;
+			}
+
+			const bool	reading = buf_page_get_io_fix(bpage)
+				== BUF_IO_READ;
+
+			rw_lock_s_unlock(hash_lock);
+
+			if (!reading || SHUTTING_DOWN()) {
+				break;
+			}
+
+			os_thread_sleep(10000);
+		}
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -662,16 +736,20 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
-	}
-
 	ulint		last_check_time = 0;
 	ulint		last_activity_cnt = 0;
 
+	/* The dump lists the hottest pages first. It is read in batches
+	that are sorted by (space, page), so that each batch is read in
+	file order. The first batches are small, so that the hottest
+	pages will be loaded first. */
+	ulint		batch_end = std::min(dump_n, BUF_LOAD_MIN_BATCH);
+
+	std::sort(dump, dump + batch_end);
+
 	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
+	page within the same tablespace. Within a batch, all pages from a
+	given tablespace are consecutive. */
 	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
 	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
 	page_size_t	page_size(space ? space->flags : 0);
@@ -688,6 +766,16 @@ buf_load()
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
 
+		if (i == batch_end) {
+			/* Let the I/O handler threads process the
+			previous batch. */
+			os_aio_simulated_wake_handler_threads();
+
+			batch_end = std::min(dump_n, i + std::max(
+						     i, BUF_LOAD_MIN_BATCH));
+			std::sort(dump + i, dump + batch_end);
+		}
+
 		/* space_id for this iteration of the loop */
 		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
 
@@ -720,9 +808,12 @@ buf_load()
 			continue;
 		}
 
+		/* The read is asynchronous. Each page is read with a
+		separate request, which is served by one of the read I/O
+		handler threads. */
 		buf_read_page_background(
 			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
+			page_size, false);
 
 		if (i % 64 == 63) {
 			os_aio_simulated_wake_handler_threads();
@@ -734,6 +825,8 @@ buf_load()
 			}
 			buf_load_abort_flag = FALSE;
 			ut_free(dump);
+			/* Submit the reads that were already posted. */
+			os_aio_simulated_wake_handler_threads();
 			buf_load_status(
 				STATUS_INFO,
 				"Buffer pool(s) load aborted on request");
@@ -764,6 +857,10 @@ buf_load()
 		space->release();
 	}
 
+	os_aio_simulated_wake_handler_threads();
+
+	buf_load_wait_for_reads(dump, i);
+
 	ut_free(dump);
 
 	ut_sprintf_timestamp(now);
@@ -1016,7 +1016,18 @@ buf_flush_write_block_low(
 	bool		sync)		/*!< in: true if sync IO request */
 {
 	fil_space_t* space = fil_space_acquire_for_io(bpage->id.space());
+	if (space && space->stop_new_ops && !space->is_being_truncated) {
+		/* The tablespace is being dropped. A write that is
+		started now would not be waited for by
+		fil_delete_tablespace(). */
+		space->release_for_io();
+		space = NULL;
+	}
 	if (!space) {
+		/* The tablespace was dropped. Discard the page as if
+		it had been written, and evict it. */
+		ut_ad(buf_page_get_io_fix(bpage) == BUF_IO_WRITE);
+		buf_page_io_complete(bpage, false, true);
 		return;
 	}
 	ut_ad(space->purpose == FIL_TYPE_TEMPORARY
@@ -1136,9 +1147,12 @@ buf_flush_write_block_low(
 		buf_page_io_complete(bpage, space->use_doublewrite(), true);
 
 		ut_ad(err == DB_SUCCESS);
+
+		space->release_for_io();
 	}
 
-	space->release_for_io();
+	/* For asynchronous writes, the reference will be released
+	by fil_aio_wait() once the write has completed. */
 
 	/* Increment the counter of I/O operations used
 	for selecting LRU policy. */
@@ -1231,7 +1245,8 @@ buf_flush_page(
 				/* avoiding deadlock possibility involves
 				doublewrite buffer, should flush it, because
 				it might hold the another block->lock. */
-				buf_dblwr_flush_buffered_writes();
+				buf_dblwr_flush_buffered_writes(
+					bpage->buf_pool_index);
 			} else {
 				buf_dblwr_sync_datafiles();
 			}
@@ -1418,9 +1433,26 @@ buf_flush_try_neighbors(
 		}
 	}
 
-	const ulint	space_size = fil_space_get_size(page_id.space());
-	if (high > space_size) {
-		high = space_size;
+	fil_space_t*	space = fil_space_acquire_for_io(page_id.space());
+	bool		dropped = space == NULL;
+
+	if (space) {
+		dropped = space->stop_new_ops && !space->is_being_truncated;
+		space->release_for_io();
+	}
+
+	if (dropped) {
+		/* The tablespace was or is being dropped. Do not
+		flush the neighbours; buf_flush_write_block_low()
+		will discard the victim. */
+		low = page_id.page_no();
+		high = low + 1;
+	} else {
+		const ulint	space_size = fil_space_get_size(
+			page_id.space());
+		if (high > space_size) {
+			high = space_size;
+		}
 	}
 
 	DBUG_PRINT("ib_buf", ("flush %u:%u..%u",
@@ -1670,6 +1702,10 @@ buf_flush_LRU_list_batch(
 		buf_page_t* prev = UT_LIST_GET_PREV(LRU, bpage);
 		buf_pool->lru_hp.set(prev);
 
+		if (buf_LRU_second_chance(bpage, scanned)) {
+			continue;
+		}
+
 		BPageMutex*	block_mutex = buf_page_get_mutex(bpage);
 
 		mutex_enter(block_mutex);
@@ -1972,7 +2008,7 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool->instance_no);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2201,6 +2237,11 @@ buf_flush_single_page_from_LRU(
 
 		buf_page_t*	prev = UT_LIST_GET_PREV(LRU, bpage);
 		buf_pool->single_scan_itr.set(prev);
+
+		if (buf_LRU_second_chance(bpage, scanned)) {
+			continue;
+		}
+
 		BPageMutex*	block_mutex;
 
 		block_mutex = buf_page_get_mutex(bpage);
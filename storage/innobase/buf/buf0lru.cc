@@ -37,6 +37,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0dblwr.h"
 #include "buf0flu.h"
 #include "buf0rea.h"
+#include "buf0stats.h"
 #include "btr0sea.h"
 #include "ibuf0ibuf.h"
 #include "os0file.h"
@@ -678,6 +679,21 @@ buf_flush_dirty_pages(
 	      || buf_pool_get_dirty_pages_count(buf_pool, id, observer) == 0);
 }
 
+#ifdef BTR_CUR_HASH_ADAPT
+/** Drop the adaptive hash index entries of a tablespace that is being
+dropped or discarded, in all buffer pool instances. The dirty pages of
+the tablespace are not removed from the flush lists.
+@param[in]	id	tablespace identifier */
+void
+buf_LRU_drop_page_hash_for_tablespace(ulint id)
+{
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_LRU_drop_page_hash_for_tablespace(
+			buf_pool_from_array(i), id);
+	}
+}
+#endif /* BTR_CUR_HASH_ADAPT */
+
 /** Empty the flush list for all pages belonging to a tablespace.
 @param[in]	id		tablespace identifier
 @param[in]	observer	flush observer,
@@ -685,23 +701,13 @@ buf_flush_dirty_pages(
 void
 buf_LRU_flush_or_remove_pages(
 	ulint		id,
-	FlushObserver*	observer
-#ifdef BTR_CUR_HASH_ADAPT
-	, bool drop_ahi /*!< whether to drop the adaptive hash index */
-#endif /* BTR_CUR_HASH_ADAPT */
-	)
+	FlushObserver*	observer)
 {
 	/* Pages in the system tablespace must never be discarded. */
 	ut_ad(id || observer);
 
 	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
-		buf_pool_t* buf_pool = buf_pool_from_array(i);
-#ifdef BTR_CUR_HASH_ADAPT
-		if (drop_ahi) {
-			buf_LRU_drop_page_hash_for_tablespace(buf_pool, id);
-		}
-#endif /* BTR_CUR_HASH_ADAPT */
-		buf_flush_dirty_pages(buf_pool, id, observer);
+		buf_flush_dirty_pages(buf_pool_from_array(i), id, observer);
 	}
 
 	if (observer && !observer->is_interrupted()) {
@@ -825,6 +831,10 @@ buf_LRU_free_from_common_LRU_list(
 
 		buf_pool->lru_scan_itr.set(prev);
 
+		if (buf_LRU_second_chance(bpage, scanned)) {
+			continue;
+		}
+
 		mutex_enter(mutex);
 
 		ut_ad(buf_page_in_file(bpage));
@@ -1539,10 +1549,39 @@ buf_LRU_make_block_young(
 		buf_pool->stat.n_pages_made_young++;
 	}
 
+	bpage->referenced = 0;
+
 	buf_LRU_remove_block(bpage);
 	buf_LRU_add_block_low(bpage, FALSE);
 }
 
+/** Give a block that was marked by buf_page_set_referenced() a second
+chance: move it to the start of the LRU list instead of evicting it.
+@param[in,out]	bpage	block in the LRU list
+@param[in]	scanned	number of blocks that the LRU scan has visited
+@return whether the block was moved */
+bool
+buf_LRU_second_chance(buf_page_t* bpage, ulint scanned)
+{
+	buf_pool_t*	buf_pool = buf_pool_from_bpage(bpage);
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(bpage->in_LRU_list);
+
+	/* Once the scan has gone around the whole list, evict even
+	referenced blocks, so that a workload that keeps touching every
+	block cannot make the scan spin forever. */
+	if (!my_atomic_load32_explicit(&bpage->referenced,
+				       MY_MEMORY_ORDER_RELAXED)
+	    || scanned >= UT_LIST_GET_LEN(buf_pool->LRU)) {
+		return(false);
+	}
+
+	buf_LRU_make_block_young(bpage);
+	MONITOR_INC(MONITOR_LRU_SECOND_CHANCE);
+	return(true);
+}
+
 /******************************************************************//**
 Try to free a block.  If bpage is a descriptor of a compressed-only
 page, the descriptor object will be freed as well.
@@ -1619,6 +1658,10 @@ buf_LRU_free_page(
 	ut_ad(rw_lock_own(hash_lock, RW_LOCK_X));
 	ut_ad(buf_page_can_relocate(bpage));
 
+	if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE) {
+		buf_index_stats_evict(reinterpret_cast<buf_block_t*>(bpage));
+	}
+
 	if (!buf_LRU_block_remove_hashed(bpage, zip)) {
 		return(true);
 	}
@@ -1921,6 +1964,7 @@ buf_LRU_block_remove_hashed(
 		UNIV_MEM_ASSERT_W(((buf_block_t*) bpage)->frame,
 				  srv_page_size);
 		buf_block_modify_clock_inc((buf_block_t*) bpage);
+		buf_index_stats_release((buf_block_t*) bpage);
 		if (bpage->zip.data) {
 			const page_t*	page = ((buf_block_t*) bpage)->frame;
 
@@ -0,0 +1,383 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file buf/buf0stats.cc
+Per-index buffer pool access statistics
+
+The statistics are kept in an open-addressing hash table that is keyed
+by (space, index_id). An entry is claimed by a compare-and-swap of
+index_id from 0 to BUF_INDEX_STATS_BUSY; after space has been written,
+the real index_id is published. Lookups thus never block, except for
+the short window in which a concurrent thread is publishing the same
+entry.
+
+When an index is removed from the dictionary cache, its entry is marked
+BUF_INDEX_STATS_FREED. The entry stays in the probe sequences, and it
+is reused for another index once no page is accounted to it.
+
+Each buf_block_t points to the entry that its page is accounted to.
+The pointer is updated when an access finds that the page belongs to
+a different index (because the page was freed and reused, for
+example), so that the residency counts cannot drift.
+*******************************************************/
+
+#include "buf0stats.h"
+#include "btr0btr.h"
+#include "buf0buf.h"
+#include "fil0fil.h"
+#include "ut0rnd.h"
+
+/** Number of slots in the hash table; must be a power of 2 */
+#define BUF_INDEX_STATS_SIZE	16384
+
+/** Maximum number of indexes that are tracked separately. Accesses to
+further indexes are accounted to buf_index_stats_other. */
+#define BUF_INDEX_STATS_MAX	(BUF_INDEX_STATS_SIZE / 4 * 3)
+
+/** Value of buf_index_stats_t::index_id while the entry is being claimed */
+#define BUF_INDEX_STATS_BUSY	IB_ID_MAX
+
+/** Value of buf_index_stats_t::index_id after the index was removed */
+#define BUF_INDEX_STATS_FREED	(IB_ID_MAX - 1)
+
+/** The hash table, or NULL if not created */
+static buf_index_stats_t*	buf_index_stats;
+
+/** Number of claimed entries in buf_index_stats */
+static ulint			buf_index_stats_n_used;
+
+/** Statistics of the indexes that did not fit in buf_index_stats */
+static buf_index_stats_t	buf_index_stats_other;
+
+/** Create the statistics. */
+void
+buf_index_stats_create()
+{
+	ut_ad(!buf_index_stats);
+
+	buf_index_stats = static_cast<buf_index_stats_t*>(
+		ut_zalloc_nokey(BUF_INDEX_STATS_SIZE
+				* sizeof *buf_index_stats));
+	buf_index_stats_n_used = 0;
+	memset(&buf_index_stats_other, 0, sizeof buf_index_stats_other);
+}
+
+/** Free the statistics. */
+void
+buf_index_stats_free()
+{
+	ut_free(buf_index_stats);
+	buf_index_stats = NULL;
+}
+
+/** Add to a counter.
+@param[in,out]	counter	counter
+@param[in]	n	amount to add */
+static inline
+void
+buf_index_stats_add(int64* counter, int64 n)
+{
+	my_atomic_add64_explicit(counter, n, MY_MEMORY_ORDER_RELAXED);
+}
+
+/** @return the index_id of an entry, waiting while it is being claimed
+@param[in]	stats	statistics entry */
+static
+index_id_t
+buf_index_stats_load_id(buf_index_stats_t* stats)
+{
+	int64*	id = reinterpret_cast<int64*>(&stats->index_id);
+	int64	cur = my_atomic_load64_explicit(id, MY_MEMORY_ORDER_ACQUIRE);
+
+	while (cur == int64(BUF_INDEX_STATS_BUSY)) {
+		/* Another thread is publishing the entry;
+		it may be the one that we are looking for. */
+		ut_delay(1);
+		cur = my_atomic_load64_explicit(id, MY_MEMORY_ORDER_ACQUIRE);
+	}
+
+	return(index_id_t(cur));
+}
+
+/** Try to claim an entry for an index.
+@param[in,out]	stats		unused or freed statistics entry
+@param[in]	old_id		0 or BUF_INDEX_STATS_FREED
+@param[in]	space		tablespace identifier
+@param[in]	index_id	index identifier
+@return whether the entry was claimed */
+static
+bool
+buf_index_stats_claim(
+	buf_index_stats_t*	stats,
+	index_id_t		old_id,
+	ulint			space,
+	index_id_t		index_id)
+{
+	int64*	id = reinterpret_cast<int64*>(&stats->index_id);
+	int64	cur = int64(old_id);
+
+	if (!my_atomic_cas64_strong_explicit(id, &cur,
+					     int64(BUF_INDEX_STATS_BUSY),
+					     MY_MEMORY_ORDER_ACQUIRE,
+					     MY_MEMORY_ORDER_ACQUIRE)) {
+		return(false);
+	}
+
+	if (old_id) {
+		/* Reset the counters of the removed index. */
+		compile_time_assert(offsetof(buf_index_stats_t, index_id)
+				    == 0);
+		memset(reinterpret_cast<byte*>(stats) + sizeof stats->index_id,
+		       0, sizeof *stats - sizeof stats->index_id);
+	} else {
+		my_atomic_addlong(&buf_index_stats_n_used, 1);
+	}
+
+	stats->space = space;
+	my_atomic_store64_explicit(id, int64(index_id),
+				   MY_MEMORY_ORDER_RELEASE);
+	return(true);
+}
+
+/** Look up or create the entry of an index.
+@param[in]	space		tablespace identifier
+@param[in]	index_id	index identifier
+@return the statistics entry */
+static
+buf_index_stats_t*
+buf_index_stats_lookup(ulint space, index_id_t index_id)
+{
+	ut_ad(index_id != 0);
+	ut_ad(index_id < BUF_INDEX_STATS_FREED);
+
+retry:
+	ulint			i = ut_fold_ulint_pair(space,
+						       ut_fold_ull(index_id));
+	buf_index_stats_t*	freed = NULL;
+
+	for (ulint n = BUF_INDEX_STATS_SIZE; n--; i++) {
+		buf_index_stats_t*	stats = &buf_index_stats[
+			i & (BUF_INDEX_STATS_SIZE - 1)];
+		const index_id_t	cur = buf_index_stats_load_id(stats);
+
+		if (cur == index_id && stats->space == space) {
+			return(stats);
+		}
+
+		if (cur == BUF_INDEX_STATS_FREED) {
+			if (!freed
+			    && !my_atomic_load64_explicit(
+				    &stats->n_resident,
+				    MY_MEMORY_ORDER_RELAXED)) {
+				freed = stats;
+			}
+		} else if (cur == 0) {
+			/* The index is not in the table. Prefer a freed
+			entry, so that the table does not fill up. */
+			if (freed) {
+				stats = freed;
+			} else if (my_atomic_loadlong_explicit(
+					   &buf_index_stats_n_used,
+					   MY_MEMORY_ORDER_RELAXED)
+				   >= BUF_INDEX_STATS_MAX) {
+				break;
+			}
+
+			if (buf_index_stats_claim(stats, freed
+						  ? BUF_INDEX_STATS_FREED : 0,
+						  space, index_id)) {
+				return(stats);
+			}
+
+			/* Another thread claimed the entry, possibly
+			for the same index. */
+			goto retry;
+		}
+	}
+
+	if (freed) {
+		if (buf_index_stats_claim(freed, BUF_INDEX_STATS_FREED,
+					  space, index_id)) {
+			return(freed);
+		}
+
+		goto retry;
+	}
+
+	return(&buf_index_stats_other);
+}
+
+/** Free the entry of an index that is being removed from the
+dictionary cache.
+@param[in]	space		tablespace identifier
+@param[in]	index_id	index identifier */
+void
+buf_index_stats_remove(ulint space, index_id_t index_id)
+{
+	if (!buf_index_stats || index_id >= BUF_INDEX_STATS_FREED) {
+		return;
+	}
+
+	ulint	i = ut_fold_ulint_pair(space, ut_fold_ull(index_id));
+
+	for (ulint n = BUF_INDEX_STATS_SIZE; n--; i++) {
+		buf_index_stats_t*	stats = &buf_index_stats[
+			i & (BUF_INDEX_STATS_SIZE - 1)];
+		const index_id_t	cur = buf_index_stats_load_id(stats);
+
+		if (cur == 0) {
+			return;
+		}
+
+		if (cur == index_id && stats->space == space) {
+			/* The pages that are still accounted to the
+			entry keep it from being reused until they are
+			evicted or accessed by another index. */
+			my_atomic_store64_explicit(
+				reinterpret_cast<int64*>(&stats->index_id),
+				int64(BUF_INDEX_STATS_FREED),
+				MY_MEMORY_ORDER_RELEASE);
+			return;
+		}
+	}
+}
+
+/** Account an access to a page in buf_page_get_gen(). If the page
+now belongs to a different index than the one that the block was
+accounted to, the residency is moved to the new index.
+@param[in,out]	block		buffer-fixed and latched page
+@param[in]	miss		whether the page had to be read
+@param[in]	first_access	whether the page was not accessed before */
+void
+buf_index_stats_access(buf_block_t* block, bool miss, bool first_access)
+{
+	ut_ad(block->page.buf_fix_count > 0);
+
+	const page_t*		page = block->frame;
+	buf_index_stats_t*	stats = NULL;
+
+	switch (fil_page_get_type(page)) {
+	case FIL_PAGE_INDEX:
+	case FIL_PAGE_RTREE:
+		if (index_id_t id = btr_page_get_index_id(page)) {
+			if (id < BUF_INDEX_STATS_FREED) {
+				stats = buf_index_stats_lookup(
+					block->page.id.space(), id);
+			}
+		}
+	}
+
+	void**	ptr = reinterpret_cast<void**>(&block->index_stats);
+	void*	old = my_atomic_loadptr_explicit(ptr,
+						 MY_MEMORY_ORDER_RELAXED);
+
+	if (old != stats
+	    && my_atomic_casptr_strong_explicit(ptr, &old, stats,
+						MY_MEMORY_ORDER_RELAXED,
+						MY_MEMORY_ORDER_RELAXED)) {
+		if (old) {
+			buf_index_stats_add(
+				&static_cast<buf_index_stats_t*>(old)
+				->n_resident, -1);
+		}
+
+		if (stats) {
+			buf_index_stats_add(&stats->n_resident, 1);
+		}
+	}
+
+	if (!stats) {
+		return;
+	}
+
+	if (miss) {
+		buf_index_stats_add(&stats->n_misses, 1);
+	} else {
+		buf_index_stats_add(&stats->n_hits, 1);
+
+		if (first_access) {
+			buf_index_stats_add(&stats->n_read_ahead_used, 1);
+		}
+	}
+}
+
+/** Account the eviction of a page from the buffer pool.
+@param[in]	block	page that is about to be evicted */
+void
+buf_index_stats_evict(const buf_block_t* block)
+{
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+
+	buf_index_stats_t*	stats = block->index_stats;
+
+	if (!stats) {
+		return;
+	}
+
+	buf_index_stats_add(&stats->n_evicted, 1);
+
+	if (unsigned access_time = buf_page_is_accessed(&block->page)) {
+		buf_index_stats_add(&stats->evicted_age_ms,
+				    int64(unsigned(ut_time_ms())
+					  - access_time));
+	} else {
+		buf_index_stats_add(&stats->n_evicted_unused, 1);
+	}
+}
+
+/** Remove a page from the residency statistics when the block stops
+holding the page.
+@param[in,out]	block	page that is being removed from the page_hash */
+void
+buf_index_stats_release(buf_block_t* block)
+{
+	ut_ad(block->page.buf_fix_count == 0);
+
+	if (buf_index_stats_t* stats = block->index_stats) {
+		buf_index_stats_add(&stats->n_resident, -1);
+		block->index_stats = NULL;
+	}
+}
+
+/** Copy the statistics of all indexes that have been accessed.
+@param[out]	snapshot	copies of the statistics */
+void
+buf_index_stats_get(std::vector<buf_index_stats_t>& snapshot)
+{
+	snapshot.clear();
+
+	for (ulint i = 0; i < BUF_INDEX_STATS_SIZE; i++) {
+		const buf_index_stats_t*	stats = &buf_index_stats[i];
+		index_id_t			id = index_id_t(
+			my_atomic_load64_explicit(
+				reinterpret_cast<int64*>(
+					const_cast<index_id_t*>(
+						&stats->index_id)),
+				MY_MEMORY_ORDER_ACQUIRE));
+
+		if (id != 0 && id < BUF_INDEX_STATS_FREED) {
+			snapshot.push_back(*stats);
+			snapshot.back().index_id = id;
+		}
+	}
+
+	if (buf_index_stats_other.n_hits || buf_index_stats_other.n_misses) {
+		snapshot.push_back(buf_index_stats_other);
+	}
+}
@@ -54,6 +54,7 @@ ib_warn_row_too_big(const dict_table_t*	table);
 #include "btr0cur.h"
 #include "btr0sea.h"
 #include "buf0buf.h"
+#include "buf0stats.h"
 #include "data0type.h"
 #include "dict0boot.h"
 #include "dict0crea.h"
@@ -2396,6 +2397,50 @@ void dict_index_remove_from_v_col_list(dict_index_t* index)
 	}
 }
 
+/** Precompute the end offsets of the leading fixed-length NOT NULL fields
+of an index, for rec_get_offsets(). Such fields occupy neither null flags
+nor length bytes in ROW_FORMAT!=REDUNDANT, so their offsets do not depend
+on the record. Fields that are added by instant ADD COLUMN are appended
+after the existing ones and do not invalidate the offsets.
+@param[in,out]	index	index that is being added to the cache */
+static
+void
+dict_index_build_fixed_offsets(dict_index_t* index)
+{
+	index->n_fixed_offsets = 0;
+	index->fixed_offsets = NULL;
+
+	if (!dict_table_is_comp(index->table)
+	    || dict_index_is_spatial(index)
+	    || (index->type & DICT_FTS)) {
+		return;
+	}
+
+	ulint	n = 0;
+
+	while (n < index->n_fields
+	       && index->fields[n].fixed_len
+	       && (index->fields[n].col->prtype & DATA_NOT_NULL)) {
+		n++;
+	}
+
+	if (!n) {
+		return;
+	}
+
+	ulint*	offs = static_cast<ulint*>(
+		mem_heap_alloc(index->heap, n * sizeof *offs));
+	ulint	end = 0;
+
+	for (ulint i = 0; i < n; i++) {
+		end += index->fields[i].fixed_len;
+		offs[i] = end;
+	}
+
+	index->fixed_offsets = offs;
+	index->n_fixed_offsets = unsigned(n);
+}
+
 /** Adds an index to the dictionary cache, with possible indexing newly
 added column.
 @param[in]	index	index; NOTE! The index memory
@@ -2546,6 +2591,7 @@ dict_index_add_to_cache(
 		       SYNC_INDEX_TREE);
 
 	new_index->n_core_fields = new_index->n_fields;
+	dict_index_build_fixed_offsets(new_index);
 
 	dict_mem_index_free(index);
 	if (err) *err = DB_SUCCESS;
@@ -2627,6 +2673,9 @@ dict_index_remove_from_cache_low(
 		mutex_exit(&page_zip_stat_per_index_mutex);
 	}
 
+	/* Let the buffer pool statistics entry be reused. */
+	buf_index_stats_remove(table->space_id, index->id);
+
 	/* Remove the index from the list of indexes of the table */
 	UT_LIST_REMOVE(table->indexes, index);
 
@@ -48,6 +48,14 @@ Created 4/24/1996 Heikki Tuuri
 #include "srv0srv.h"
 #include <stack>
 #include <set>
+#include <vector>
+
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	dict_check_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Minimum number of tablespaces per thread of dict_check_open_spaces() */
+#define DICT_CHECK_SPACES_PER_THREAD	64
 
 /** Following are the InnoDB system tables. The positions in
 this array are referenced by enum dict_system_table_id. */
@@ -1339,11 +1347,127 @@ dict_sys_tables_rec_read(
 	return(true);
 }
 
+/** A tablespace that dict_check_sys_tables() is to open */
+struct dict_check_space_t {
+	/** table name */
+	table_name_t	name;
+	/** tablespace identifier */
+	ulint		id;
+	/** tablespace flags */
+	ulint		flags;
+	/** SYS_DATAFILES.PATH, or NULL */
+	char*		filepath;
+	/** whether the tablespace must be opened by the calling thread */
+	bool		deferred;
+	/** whether the tablespace was opened */
+	bool		opened;
+};
+
+/** Tablespaces that are being opened by dict_check_open_spaces() */
+struct dict_check_t {
+	/** the tablespaces */
+	std::vector<dict_check_space_t>	spaces;
+	/** whether to validate the first page of the files */
+	bool				validate;
+	/** number of elements of spaces that have been assigned */
+	ulint				n_assigned;
+};
+
+/** Open a tablespace without updating the data dictionary.
+@param[in]	validate	whether to validate the first page
+@param[in,out]	space		the tablespace
+@return whether the tablespace must be opened by fil_ibd_open()
+with fix_dict=true instead */
+static
+bool
+dict_check_open_space(bool validate, dict_check_space_t& space)
+{
+	/* fil_ibd_open() may have to correct SYS_DATAFILES or the
+	link file of a tablespace that has a DATA DIRECTORY, or whose
+	file is not in the default location. Leave those to the
+	calling thread. */
+	if (DICT_TF_HAS_DATA_DIR(space.flags)) {
+		return(true);
+	}
+
+	if (space.filepath) {
+		char*	path = fil_make_filepath(
+			NULL, space.name.m_name, IBD, false);
+		const bool	same = path && !strcmp(path, space.filepath);
+		ut_free(path);
+
+		if (!same) {
+			return(true);
+		}
+	}
+
+	char*	link = fil_make_filepath(NULL, space.name.m_name, ISL, false);
+	bool	exists = true;
+	os_file_type_t	type;
+
+	if (link) {
+		os_file_status(link, &exists, &type);
+		ut_free(link);
+	}
+
+	if (exists) {
+		return(true);
+	}
+
+	space.opened = fil_ibd_open(
+		validate, false, FIL_TYPE_TABLESPACE,
+		space.id, dict_tf_to_fsp_flags(space.flags),
+		space.name, space.filepath) != NULL;
+	return(false);
+}
+
+/** Open the tablespaces that have not been assigned to other threads.
+@param[in,out]	arg	dict_check_t */
+static
+void
+dict_check_assigned(void* arg, ulint)
+{
+	dict_check_t*	check = static_cast<dict_check_t*>(arg);
+
+	for (;;) {
+		ulint	i = my_atomic_addlint(&check->n_assigned, 1);
+
+		if (i >= check->spaces.size()) {
+			return;
+		}
+
+		dict_check_space_t&	space = check->spaces[i];
+		space.deferred = dict_check_open_space(check->validate, space);
+	}
+}
+
+/** Open tablespaces using up to innodb_read_io_threads threads
+including the calling thread. The files are opened and, if requested,
+their first pages are read and validated concurrently.
+@param[in,out]	check	tablespaces to open */
+static
+void
+dict_check_open_spaces(dict_check_t& check)
+{
+	ulint	per_thread = DICT_CHECK_SPACES_PER_THREAD;
+
+	DBUG_EXECUTE_IF("dict_check_space_per_thread", per_thread = 1;);
+
+	check.n_assigned = 0;
+
+	const ulint	n = std::min(ulint(srv_n_read_io_threads),
+				     check.spaces.size() / per_thread);
+
+	os_thread_run(dict_check_assigned, &check, n ? n - 1 : 0,
+		      dict_check_thread_key, NULL);
+}
+
 /** Load and check each non-predefined tablespace mentioned in SYS_TABLES.
 Search SYS_TABLES and check each tablespace mentioned that has not
 already been added to the fil_system.  If it is valid, add it to the
 file_system list.  Perform extra validation on the table if recovery from
-the REDO log occurred.
+the REDO log occurred. The tablespace files are opened by multiple
+threads, see dict_check_open_spaces().
 @param[in]	validate	Whether to do validation on the table.
 @return the highest space ID found. */
 UNIV_INLINE
@@ -1355,12 +1479,15 @@ dict_check_sys_tables(
 	btr_pcur_t	pcur;
 	const rec_t*	rec;
 	mtr_t		mtr;
+	dict_check_t	check;
 
 	DBUG_ENTER("dict_check_sys_tables");
 
 	ut_ad(rw_lock_own(dict_operation_lock, RW_LOCK_X));
 	ut_ad(mutex_own(&dict_sys->mutex));
 
+	check.validate = validate;
+
 	mtr_start(&mtr);
 
 	/* Before traversing SYS_TABLES, let's make sure we have
@@ -1445,28 +1572,45 @@ dict_check_sys_tables(
 		location) or this path is the same file but looks different,
 		fil_ibd_open() will update the dictionary with what is
 		opened. */
-		char*	filepath = dict_get_first_path(space_id);
+		dict_check_space_t	space;
+		space.name = table_name;
+		space.id = space_id;
+		space.flags = flags;
+		space.filepath = dict_get_first_path(space_id);
+		space.deferred = false;
+		space.opened = false;
+		check.spaces.push_back(space);
+
+		max_space_id = ut_max(max_space_id, space_id);
+	}
+
+	mtr_commit(&mtr);
+
+	dict_check_open_spaces(check);
+
+	for (std::vector<dict_check_space_t>::iterator it
+		     = check.spaces.begin();
+	     it != check.spaces.end(); ++it) {
+		if (it->deferred) {
+			it->opened = fil_ibd_open(
+				validate,
+				!srv_read_only_mode && srv_log_file_size != 0,
+				FIL_TYPE_TABLESPACE,
+				it->id, dict_tf_to_fsp_flags(it->flags),
+				it->name, it->filepath) != NULL;
+		}
 
 		/* Check that the .ibd file exists. */
-		if (!fil_ibd_open(
-			    validate,
-			    !srv_read_only_mode && srv_log_file_size != 0,
-			    FIL_TYPE_TABLESPACE,
-			    space_id, dict_tf_to_fsp_flags(flags),
-			    table_name, filepath)) {
+		if (!it->opened) {
 			ib::warn() << "Ignoring tablespace for "
-				<< table_name
+				<< it->name
 				<< " because it could not be opened.";
 		}
 
-		max_space_id = ut_max(max_space_id, space_id);
-
-		ut_free(table_name.m_name);
-		ut_free(filepath);
+		ut_free(it->name.m_name);
+		ut_free(it->filepath);
 	}
 
-	mtr_commit(&mtr);
-
 	DBUG_RETURN(max_space_id);
 }
 
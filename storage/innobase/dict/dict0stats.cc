@@ -37,11 +37,16 @@ Created Jan 06, 2010 Vasil Dimov
 #include "ut0new.h"
 #include <mysql_com.h>
 #include "btr0btr.h"
+#include "srv0srv.h"
 
 #include <algorithm>
 #include <map>
 #include <vector>
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	dict_stats_analyze_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /* Sampling algorithm description @{
 
 The algorithm is controlled by one number - N_SAMPLE_PAGES(index),
@@ -138,6 +143,10 @@ data:  b,b,b,b,b,b,g,g,j,j,j, x, y
 then we would store 5,7,10,11,12 in the array. */
 typedef std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> >	boundaries_t;
 
+/** Identifiers of the indexes that dict_stats_update_persistent()
+analyzed, and whose statistics dict_stats_update() will save. */
+typedef std::vector<index_id_t, ut_allocator<index_id_t> >	index_ids_t;
+
 /** Allocator type used for index_map_t. */
 typedef ut_allocator<std::pair<const char* const, dict_index_t*> >
 	index_map_t_allocator;
@@ -2207,16 +2216,122 @@ dict_stats_analyze_index(
 	DBUG_VOID_RETURN;
 }
 
-/*********************************************************************//**
-Calculates new estimates for table and index statistics. This function
+/** State of dict_stats_analyze_indexes() that is shared between the
+threads */
+struct dict_stats_analyze_t {
+	/** the table whose statistics are being calculated */
+	dict_table_t*		table;
+	/** the indexes to analyze; the clustered index, if included,
+	is the first one */
+	dict_index_t**		indexes;
+	/** number of indexes */
+	ulint			n_indexes;
+	/** number of indexes that have been assigned to threads */
+	ulint			n_assigned;
+};
+
+/** Analyze indexes until all of them have been assigned to threads.
+@param[in,out]	arg	dict_stats_analyze_t */
+static
+void
+dict_stats_analyze_assigned(void* arg, ulint)
+{
+	dict_stats_analyze_t*	analyze
+		= static_cast<dict_stats_analyze_t*>(arg);
+
+	for (;;) {
+		ulint	i = my_atomic_addlint(&analyze->n_assigned, 1);
+
+		if (i >= analyze->n_indexes) {
+			return;
+		}
+
+		/* The clustered index is analyzed even when asked to
+		quit, because dict_table_t::stat_n_rows is derived
+		from it. */
+		if (dict_index_is_clust(analyze->indexes[i])
+		    || !(analyze->table->stats_bg_flag
+			 & BG_STAT_SHOULD_QUIT)) {
+			dict_stats_analyze_index(analyze->indexes[i]);
+		}
+	}
+}
+
+/** Analyze indexes of a table, using up to innodb_stats_analyze_threads
+threads including the calling thread.
+@param[in,out]	table		table
+@param[in,out]	indexes		indexes to analyze, starting with the
+				clustered index if it is to be analyzed
+@param[in]	n_indexes	number of indexes */
+static
+void
+dict_stats_analyze_indexes(
+	dict_table_t*	table,
+	dict_index_t**	indexes,
+	ulint		n_indexes)
+{
+	dict_stats_analyze_t	analyze;
+
+	analyze.table = table;
+	analyze.indexes = indexes;
+	analyze.n_indexes = n_indexes;
+	analyze.n_assigned = 0;
+
+	/* In the incremental mode, there may be nothing to analyze. */
+	const ulint	n = std::min(ulint(srv_stats_analyze_threads),
+				     n_indexes);
+
+	os_thread_run(dict_stats_analyze_assigned, &analyze, n ? n - 1 : 0,
+		      dict_stats_analyze_thread_key, NULL);
+}
+
+/** Determine whether the persistent statistics of an index are to be
+calculated again, and if so, reset its modification counter, so that
+the modifications from now on count for the next calculation.
+@param[in,out]	index		index
+@param[in]	incremental	whether to keep the statistics of the index
+				if it was not modified too much
+@param[in]	threshold	number of modifications that must be
+				exceeded in the incremental mode
+@return whether the index is to be analyzed */
+static
+bool
+dict_stats_index_to_analyze(
+	dict_index_t*	index,
+	bool		incremental,
+	ib_uint64_t	threshold)
+{
+	int64*	counter = reinterpret_cast<int64*>(
+		&index->stat_modified_counter);
+
+	if (incremental
+	    && ib_uint64_t(my_atomic_load64_explicit(
+				   counter, MY_MEMORY_ORDER_RELAXED))
+	    <= threshold) {
+		return(false);
+	}
+
+	my_atomic_store64_explicit(counter, 0, MY_MEMORY_ORDER_RELAXED);
+
+	return(true);
+}
+
+/** Calculate new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
-will be saved on disk.
+will be saved on disk. The indexes are analyzed by
+innodb_stats_analyze_threads threads.
+@param[in,out]	table		table
+@param[in]	incremental	whether to keep the statistics of the
+				indexes that were not modified too much
+				since their statistics were calculated
+@param[out]	analyzed	identifiers of the analyzed indexes
 @return DB_SUCCESS or error code */
 static
 dberr_t
 dict_stats_update_persistent(
-/*=========================*/
-	dict_table_t*	table)		/*!< in/out: table */
+	dict_table_t*	table,
+	bool		incremental,
+	index_ids_t*	analyzed)
 {
 	dict_index_t*	index;
 
@@ -2224,8 +2339,6 @@ dict_stats_update_persistent(
 
 	dict_table_stats_lock(table, RW_X_LATCH);
 
-	/* analyze the clustered index first */
-
 	index = dict_table_get_first_index(table);
 
 	if (index == NULL
@@ -2241,17 +2354,29 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_ibuf(index));
 
-	dict_stats_analyze_index(index);
+	/* In the incremental mode, only reanalyze an index if the
+	modifications since its last analysis exceed half of the share of
+	the table that triggers the automatic recalculation (10%), so that
+	the indexes that were modified by the triggering workload are
+	reanalyzed even if the recalculation starts before it ends. */
+	const ib_uint64_t	threshold = table->stat_n_rows / 20;
 
-	ulint	n_unique = dict_index_get_n_unique(index);
+	incremental = incremental && table->stat_initialized;
 
-	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+	dict_index_t**	indexes = UT_NEW_ARRAY_NOKEY(
+		dict_index_t*, UT_LIST_GET_LEN(table->indexes));
+	ulint		n_indexes = 0;
 
-	table->stat_clustered_index_size = index->stat_index_size;
+	analyzed->clear();
 
-	/* analyze other indexes from the table, if any */
+	/* If it is not analyzed, the clustered index keeps its previous
+	statistics, from which the table statistics are derived below. */
+	if (dict_stats_index_to_analyze(index, incremental, threshold)) {
+		indexes[n_indexes++] = index;
+		analyzed->push_back(index->id);
+	}
 
-	table->stat_sum_of_other_index_sizes = 0;
+	/* collect the other indexes from the table, if any */
 
 	for (index = dict_table_get_next_index(index);
 	     index != NULL;
@@ -2263,14 +2388,42 @@ dict_stats_update_persistent(
 			continue;
 		}
 
-		dict_stats_empty_index(index, false);
-
 		if (dict_stats_should_ignore_index(index)) {
+			dict_stats_empty_index(index, false);
 			continue;
 		}
 
-		if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-			dict_stats_analyze_index(index);
+		if (!dict_stats_index_to_analyze(
+			    index, incremental, threshold)) {
+			continue;
+		}
+
+		dict_stats_empty_index(index, false);
+
+		indexes[n_indexes++] = index;
+		analyzed->push_back(index->id);
+	}
+
+	dict_stats_analyze_indexes(table, indexes, n_indexes);
+
+	UT_DELETE_ARRAY(indexes);
+
+	index = dict_table_get_first_index(table);
+
+	ulint	n_unique = dict_index_get_n_unique(index);
+
+	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+
+	table->stat_clustered_index_size = index->stat_index_size;
+
+	table->stat_sum_of_other_index_sizes = 0;
+
+	for (index = dict_table_get_next_index(index);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (index->type & DICT_FTS || dict_index_is_spatial(index)) {
+			continue;
 		}
 
 		table->stat_sum_of_other_index_sizes
@@ -3173,6 +3326,7 @@ dict_stats_update(
 
 	switch (stats_upd_option) {
 	case DICT_STATS_RECALC_PERSISTENT:
+	case DICT_STATS_RECALC_INCREMENTAL:
 
 		if (srv_read_only_mode) {
 			goto transient;
@@ -3194,15 +3348,30 @@ dict_stats_update(
 		prerequisite for dict_stats_save() succeeding */
 		if (dict_stats_persistent_storage_check(false)) {
 
-			dberr_t	err;
+			dberr_t		err;
+			index_ids_t	analyzed;
 
-			err = dict_stats_update_persistent(table);
+			err = dict_stats_update_persistent(
+				table,
+				stats_upd_option
+				== DICT_STATS_RECALC_INCREMENTAL,
+				&analyzed);
 
 			if (err != DB_SUCCESS) {
 				return(err);
 			}
 
-			err = dict_stats_save(table, NULL);
+			if (stats_upd_option != DICT_STATS_RECALC_INCREMENTAL) {
+				return(dict_stats_save(table, NULL));
+			}
+
+			/* Keep the saved statistics of the indexes that
+			were not analyzed, including their last_update. */
+			for (index_ids_t::const_iterator it = analyzed.begin();
+			     err == DB_SUCCESS && it != analyzed.end();
+			     ++it) {
+				err = dict_stats_save(table, &*it);
+			}
 
 			return(err);
 		}
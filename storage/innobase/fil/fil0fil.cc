@@ -1432,6 +1432,33 @@ fil_space_free(
 	return(space != NULL);
 }
 
+/** Remove any dirty pages of a dropped tablespace from the buffer pool
+before its identifier is reused, so that they will not be written to the
+new tablespace.
+@param[in]	id	tablespace identifier */
+void
+fil_space_discard_dropped(ulint id)
+{
+	mutex_enter(&fil_system.mutex);
+
+	fil_system_t::dropped_t::iterator it = fil_system.dropped.find(id);
+
+	if (it == fil_system.dropped.end()) {
+		mutex_exit(&fil_system.mutex);
+		return;
+	}
+
+	const lsn_t	drop_lsn = it->second;
+	fil_system.dropped.erase(it);
+	mutex_exit(&fil_system.mutex);
+
+	const lsn_t	oldest_lsn = buf_pool_get_oldest_modification();
+
+	if (oldest_lsn && oldest_lsn <= drop_lsn) {
+		buf_LRU_flush_or_remove_pages(id, NULL);
+	}
+}
+
 /** Create a space memory object and put it to the fil_system hash table.
 Error messages are issued to the server log.
 @param[in]	name		tablespace name
@@ -1460,6 +1487,8 @@ fil_space_create(
 
 	DBUG_EXECUTE_IF("fil_space_create_failure", return(NULL););
 
+	fil_space_discard_dropped(id);
+
 	mutex_enter(&fil_system.mutex);
 
 	space = fil_space_get_by_id(id);
@@ -1850,6 +1879,7 @@ void fil_system_t::close()
 		m_initialised = false;
 		hash_table_free(spaces);
 		spaces = NULL;
+		dropped.clear();
 		mutex_free(&mutex);
 		fil_space_crypt_cleanup();
 	}
@@ -2456,7 +2486,13 @@ fil_check_pending_io(
 
 	*node = UT_LIST_GET_FIRST(space->chain);
 
-	if (space->n_pending_flushes > 0 || (*node)->n_pending > 0) {
+	/* Page writes hold a reference from buf_flush_write_block_low()
+until their completion. Before a tablespace can be deleted, the
+writes that were initiated before space->stop_new_ops was set
+must complete, because they could not find the tablespace after
+fil_space_detach(). */
+	if (space->n_pending_flushes > 0 || (*node)->n_pending > 0
+	    || (operation == FIL_OPERATION_DELETE && space->pending_io())) {
 
 		ut_a(!(*node)->being_extended);
 
@@ -2679,30 +2715,27 @@ fil_delete_tablespace(
 
 	/* IMPORTANT: Because we have set space::stop_new_ops there
 	can't be any new ibuf merges, reads or flushes. We are here
-	because node::n_pending was zero above. However, it is still
-	possible to have pending read and write requests:
-
-	A read request can happen because the reader thread has
-	gone through the ::stop_new_ops check in buf_page_init_for_read()
-	before the flag was set and has not yet incremented ::n_pending
-	when we checked it above.
-
-	A write request can be issued any time because we don't check
-	the ::stop_new_ops flag when queueing a block for write.
-
-	We deal with pending write requests in the following function
-	where we'd minimally evict all dirty pages belonging to this
-	space from the flush_list. Note that if a block is IO-fixed
-	we'll wait for IO to complete.
+	because node::n_pending and space::n_pending_ios were zero
+	above. However, it is still possible to have pending read
+	requests, because the reader thread may have gone through the
+	::stop_new_ops check in buf_page_init_for_read() before the
+	flag was set and not yet incremented ::n_pending when we
+	checked it above. To deal with them, we will check the
+	::stop_new_ops flag in fil_io().
+
+	We do not scan the flush_list for the dirty pages of this
+	tablespace. While ::stop_new_ops is set, and once the tablespace
+	has been detached, buf_flush_write_block_low() will discard them.
+	If the tablespace identifier is reused before that,
+	fil_space_create() will remove the pages. */
 
-	To deal with potential read requests, we will check the
-	::stop_new_ops flag in fil_io(). */
-
-	buf_LRU_flush_or_remove_pages(id, NULL
 #ifdef BTR_CUR_HASH_ADAPT
-				      , drop_ahi
+	if (drop_ahi) {
+		buf_LRU_drop_page_hash_for_tablespace(id);
+	}
 #endif /* BTR_CUR_HASH_ADAPT */
-				      );
+
+	lsn_t	drop_lsn;
 
 	/* If it is a delete then also delete any generated files, otherwise
 	when we drop the database the remove directory will fail. */
@@ -2715,10 +2748,11 @@ fil_delete_tablespace(
 		mtr_start(&mtr);
 		fil_op_write_log(MLOG_FILE_DELETE, id, 0, path, NULL, 0, &mtr);
 		mtr_commit(&mtr);
+		drop_lsn = mtr.commit_lsn();
 		/* Even if we got killed shortly after deleting the
 		tablespace file, the record must have already been
 		written to the redo log. */
-		log_write_up_to(mtr.commit_lsn(), true);
+		log_write_up_to(drop_lsn, true);
 
 		char*	cfg_name = fil_make_filepath(path, NULL, CFG, false);
 		if (cfg_name != NULL) {
@@ -2732,6 +2766,10 @@ fil_delete_tablespace(
 		RemoteDatafile::delete_link_file(space->name);
 	}
 
+	/* Any dirty page that was modified before the oldest one in
+	the buffer pool has been written or discarded. */
+	const lsn_t	oldest_lsn = buf_pool_get_oldest_modification();
+
 	mutex_enter(&fil_system.mutex);
 
 	/* Double check the sanity of pending ops after reacquiring
@@ -2741,9 +2779,32 @@ fil_delete_tablespace(
 		ut_a(!space->referenced());
 		ut_a(UT_LIST_GET_LEN(space->chain) == 1);
 		fil_node_t* node = UT_LIST_GET_FIRST(space->chain);
+
+		/* buf_flush_write_block_low() may have acquired the
+		tablespace before noticing ::stop_new_ops. It will not
+		write the page, but fil_aio_wait() must not release a
+		freed tablespace. */
+		while (space->pending_io()) {
+			mutex_exit(&fil_system.mutex);
+			os_thread_sleep(20000);
+			mutex_enter(&fil_system.mutex);
+		}
+
 		ut_a(node->n_pending == 0);
 
 		fil_space_detach(space);
+
+		for (fil_system_t::dropped_t::iterator it
+			     = fil_system.dropped.begin();
+		     it != fil_system.dropped.end(); ) {
+			if (!oldest_lsn || it->second < oldest_lsn) {
+				fil_system.dropped.erase(it++);
+			} else {
+				++it;
+			}
+		}
+
+		fil_system.dropped[id] = drop_lsn;
 		mutex_exit(&fil_system.mutex);
 
 		log_mutex_enter();
@@ -4670,9 +4731,10 @@ fil_aio_wait(
 	mutex_enter(&fil_system.mutex);
 
 	fil_node_complete_io(node, type);
-	const fil_type_t	purpose	= node->space->purpose;
-	const ulint		space_id= node->space->id;
-	const bool		dblwr	= node->space->use_doublewrite();
+	fil_space_t*		node_space = node->space;
+	const fil_type_t	purpose	= node_space->purpose;
+	const ulint		space_id= node_space->id;
+	const bool		dblwr	= node_space->use_doublewrite();
 
 	mutex_exit(&fil_system.mutex);
 
@@ -4722,6 +4784,13 @@ fil_aio_wait(
 
 		ulint offset = bpage->id.page_no();
 		dberr_t err = buf_page_io_complete(bpage, dblwr);
+
+		if (type.is_write()) {
+			/* Release the reference that was acquired
+			in buf_flush_write_block_low(). */
+			node_space->release_for_io();
+		}
+
 		if (err == DB_SUCCESS) {
 			return;
 		}
@@ -73,6 +73,88 @@ Updated 14/02/2015
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#include "zstd_errors.h"
+
+/** Number of cached zstd compression or decompression contexts */
+#define FIL_ZSTD_N_CTX	64
+
+/** The dictionary and contexts for innodb_compression_algorithm=zstd */
+static struct
+{
+	/** compression dictionary for each compression level 0..9 */
+	ZSTD_CDict*	cdict[10];
+	/** decompression dictionary */
+	ZSTD_DDict*	ddict;
+	/** identifier of the dictionary, or 0 if none was loaded */
+	unsigned	id;
+	/** compression contexts that are not in use, or NULL */
+	ZSTD_CCtx*	cctx[FIL_ZSTD_N_CTX];
+	/** decompression contexts that are not in use, or NULL */
+	ZSTD_DCtx*	dctx[FIL_ZSTD_N_CTX];
+} fil_zstd;
+
+/** Determine the first slot of the context cache to try. A thread
+tends to get back the context that it released earlier.
+@return	slot number */
+static ulint fil_zstd_ctx_slot()
+{
+	return(ulint(os_thread_pf(os_thread_get_curr_id())) % FIL_ZSTD_N_CTX);
+}
+
+/** Take a context from the cache, or create one. Creating a context
+allocates several hundred kilobytes, which is too expensive for every
+page that is compressed or decompressed.
+@tparam	T		ZSTD_CCtx or ZSTD_DCtx
+@param[in,out]	cache	cached contexts
+@param[in]	create	function for creating a context
+@return	context
+@retval	NULL	if out of memory */
+template<typename T>
+static T* fil_zstd_ctx_get(T** cache, T* (*create)())
+{
+	const ulint	start = fil_zstd_ctx_slot();
+
+	for (ulint i = 0; i < FIL_ZSTD_N_CTX; i++) {
+		void* volatile*	slot = reinterpret_cast<void* volatile*>(
+			&cache[(start + i) % FIL_ZSTD_N_CTX]);
+
+		if (!my_atomic_loadptr_explicit(slot, MY_MEMORY_ORDER_RELAXED)) {
+			continue;
+		}
+
+		if (void* ctx = my_atomic_fasptr(slot, NULL)) {
+			return(static_cast<T*>(ctx));
+		}
+	}
+
+	return(create());
+}
+
+/** Return a context to the cache, or free it if the cache is full.
+@tparam	T		ZSTD_CCtx or ZSTD_DCtx
+@param[in,out]	cache	cached contexts
+@param[in,out]	ctx	context that is no longer in use
+@param[in]	free_ctx	function for freeing a context */
+template<typename T>
+static void fil_zstd_ctx_put(T** cache, T* ctx, size_t (*free_ctx)(T*))
+{
+	const ulint	start = fil_zstd_ctx_slot();
+
+	for (ulint i = 0; i < FIL_ZSTD_N_CTX; i++) {
+		void* volatile*	slot = reinterpret_cast<void* volatile*>(
+			&cache[(start + i) % FIL_ZSTD_N_CTX]);
+		void*		expected = NULL;
+
+		if (my_atomic_casptr(slot, &expected, ctx)) {
+			return;
+		}
+	}
+
+	free_ctx(ctx);
+}
+#endif /* HAVE_ZSTD */
 
 /* Used for debugging */
 //#define UNIV_PAGECOMPRESS_DEBUG 1
@@ -259,6 +341,40 @@ fil_compress_page(
 	}
 #endif /* HAVE_SNAPPY */
 
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+	{
+		size_t	zlen;
+
+		ut_ad(ulint(comp_level) < UT_ARR_SIZE(fil_zstd.cdict));
+
+		ZSTD_CCtx*	cctx = fil_zstd_ctx_get(fil_zstd.cctx,
+						    ZSTD_createCCtx);
+
+		if (!cctx) {
+			goto err_exit;
+		} else if (!fil_zstd.id) {
+			zlen = ZSTD_compressCCtx(
+				cctx, out_buf + header_len, write_size,
+				buf, len, comp_level);
+		} else {
+			zlen = ZSTD_compress_usingCDict(
+				cctx, out_buf + header_len, write_size,
+				buf, len, fil_zstd.cdict[comp_level]);
+		}
+
+		fil_zstd_ctx_put(fil_zstd.cctx, cctx, ZSTD_freeCCtx);
+
+		if (ZSTD_isError(zlen)) {
+			err = int(ZSTD_getErrorCode(zlen));
+			goto err_exit;
+		}
+
+		write_size = zlen;
+		break;
+	}
+#endif /* HAVE_ZSTD */
+
 	case PAGE_ZLIB_ALGORITHM:
 		err = compress2(out_buf+header_len, (ulong*)&write_size, buf,
 				uLong(len), comp_level);
@@ -614,6 +730,52 @@ fil_decompress_page(
 		break;
 	}
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+	{
+		size_t		olen;
+		const unsigned	dict_id = ZSTD_getDictID_fromFrame(
+			buf + header_len, actual_size);
+
+		if (dict_id && dict_id != fil_zstd.id) {
+			ib::error() << "The page was compressed with the zstd"
+				" dictionary " << dict_id
+				    << ", but innodb_zstd_dictionary="
+				    << (srv_zstd_dictionary
+					? srv_zstd_dictionary : "")
+				    << " has the identifier " << fil_zstd.id;
+			goto err_exit;
+		}
+
+		ZSTD_DCtx*	dctx = fil_zstd_ctx_get(fil_zstd.dctx,
+						    ZSTD_createDCtx);
+
+		if (!dctx) {
+			goto err_exit;
+		} else if (!dict_id) {
+			olen = ZSTD_decompressDCtx(
+				dctx, in_buf, len,
+				buf + header_len, actual_size);
+		} else {
+			olen = ZSTD_decompress_usingDDict(
+				dctx, in_buf, len,
+				buf + header_len, actual_size, fil_zstd.ddict);
+		}
+
+		fil_zstd_ctx_put(fil_zstd.dctx, dctx, ZSTD_freeDCtx);
+
+		if (ZSTD_isError(olen) || olen != len) {
+			err = ZSTD_isError(olen)
+				? int(ZSTD_getErrorCode(olen)) : 0;
+			goto err_exit;
+			if (return_error) {
+				goto error_return;
+			}
+		}
+
+		break;
+	}
+#endif /* HAVE_ZSTD */
 	default:
 		goto err_exit;
 		if (return_error) {
@@ -654,3 +816,95 @@ fil_decompress_page(
 	space->release_for_io();
 	ut_ad(0);
 }
+
+/** Load the zstd dictionary that is specified by innodb_zstd_dictionary.
+@return whether the dictionary was loaded or is not needed */
+bool fil_zstd_init()
+{
+	if (!srv_zstd_dictionary || !*srv_zstd_dictionary) {
+		return(true);
+	}
+
+#ifdef HAVE_ZSTD
+	ut_ad(!fil_zstd.id);
+
+	FILE*	f = fopen(srv_zstd_dictionary, "rb");
+
+	if (!f) {
+		ib::error() << "Cannot open innodb_zstd_dictionary="
+			    << srv_zstd_dictionary << ": " << strerror(errno);
+		return(false);
+	}
+
+	std::vector<char>	dict;
+	char			chunk[4096];
+
+	for (size_t n; (n = fread(chunk, 1, sizeof chunk, f)) != 0; ) {
+		dict.insert(dict.end(), chunk, chunk + n);
+	}
+
+	const bool	failed = ferror(f);
+	fclose(f);
+
+	const unsigned	id = failed || dict.empty()
+		? 0 : ZSTD_getDictID_fromDict(&dict[0], dict.size());
+
+	if (!id) {
+		/* A raw content dictionary is not identified in the
+		compressed frames, and fil_decompress_page() could not
+		tell whether it is needed. */
+		ib::error() << "innodb_zstd_dictionary="
+			    << srv_zstd_dictionary
+			    << " is not a dictionary created by zstd --train";
+		return(false);
+	}
+
+	bool	created = true;
+
+	for (ulint level = 0; level < UT_ARR_SIZE(fil_zstd.cdict); level++) {
+		fil_zstd.cdict[level] = ZSTD_createCDict(
+			&dict[0], dict.size(), int(level));
+		created = created && fil_zstd.cdict[level];
+	}
+
+	fil_zstd.ddict = ZSTD_createDDict(&dict[0], dict.size());
+
+	if (!created || !fil_zstd.ddict) {
+		ib::error() << "Cannot create the zstd dictionary of "
+			    << dict.size() << " bytes";
+		fil_zstd_close();
+		return(false);
+	}
+
+	fil_zstd.id = id;
+	ib::info() << "Loaded the zstd dictionary " << id << " from "
+		   << srv_zstd_dictionary;
+	return(true);
+#else
+	ib::error() << "innodb_zstd_dictionary requires InnoDB"
+		" to be compiled with libzstd";
+	return(false);
+#endif /* HAVE_ZSTD */
+}
+
+/** Free the zstd dictionary and the cached contexts. */
+void fil_zstd_close()
+{
+#ifdef HAVE_ZSTD
+	for (ulint i = 0; i < FIL_ZSTD_N_CTX; i++) {
+		ZSTD_freeCCtx(fil_zstd.cctx[i]);
+		fil_zstd.cctx[i] = NULL;
+		ZSTD_freeDCtx(fil_zstd.dctx[i]);
+		fil_zstd.dctx[i] = NULL;
+	}
+
+	for (ulint level = 0; level < UT_ARR_SIZE(fil_zstd.cdict); level++) {
+		ZSTD_freeCDict(fil_zstd.cdict[level]);
+		fil_zstd.cdict[level] = NULL;
+	}
+
+	ZSTD_freeDDict(fil_zstd.ddict);
+	fil_zstd.ddict = NULL;
+	fil_zstd.id = 0;
+#endif /* HAVE_ZSTD */
+}
@@ -98,6 +98,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0trunc.h"
@@ -120,6 +121,8 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #define thd_get_trx_isolation(X) ((enum_tx_isolation)thd_tx_isolation(X))
 
 extern "C" void thd_mark_transaction_to_rollback(MYSQL_THD thd, bool all);
+extern "C" int thd_is_error(const MYSQL_THD thd);
+extern "C" int thd_is_explain(const MYSQL_THD thd);
 unsigned long long thd_get_query_id(const MYSQL_THD thd);
 TABLE *find_fk_open_table(THD *thd, const char *db, size_t db_len,
 			  const char *table, size_t table_len);
@@ -635,8 +638,9 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(trx_pool_mutex),
 	PSI_KEY(trx_pool_manager_mutex),
 	PSI_KEY(srv_sys_mutex),
-	PSI_KEY(lock_mutex),
+	PSI_KEY(lock_sys_shard_mutex),
 	PSI_KEY(lock_wait_mutex),
+	PSI_KEY(lock_hot_row_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
 #  ifndef PFS_SKIP_EVENT_MUTEX
@@ -647,6 +651,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(rtr_path_mutex),
 	PSI_KEY(rtr_ssn_mutex),
 	PSI_KEY(trx_sys_mutex),
+	PSI_KEY(trx_sys_serialisation_mutex),
+	PSI_KEY(row_vers_cache_mutex),
 	PSI_KEY(zip_pad_mutex)
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -673,7 +679,8 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(index_tree_rw_lock),
 	PSI_RWLOCK_KEY(index_online_log),
 	PSI_RWLOCK_KEY(dict_table_stats),
-	PSI_RWLOCK_KEY(hash_table_locks)
+	PSI_RWLOCK_KEY(hash_table_locks),
+	PSI_RWLOCK_KEY(lock_sys_latch)
 };
 # endif /* UNIV_PFS_RWLOCK */
 
@@ -683,16 +690,24 @@ performance schema instrumented if "UNIV_PFS_THREAD"
 is defined */
 static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(buf_dump_thread),
+	PSI_KEY(dict_check_thread),
 	PSI_KEY(dict_stats_thread),
+	PSI_KEY(dict_stats_analyze_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(io_ibuf_thread),
 	PSI_KEY(io_log_thread),
 	PSI_KEY(io_read_thread),
 	PSI_KEY(io_write_thread),
+	PSI_KEY(log_flusher_thread),
+	PSI_KEY(log_writer_thread),
 	PSI_KEY(page_cleaner_thread),
+	PSI_KEY(recv_apply_thread),
 	PSI_KEY(recv_writer_thread),
+	PSI_KEY(row_merge_thread),
+	PSI_KEY(row_pread_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
+	PSI_KEY(srv_lock_deadlock_thread),
 	PSI_KEY(srv_master_thread),
 	PSI_KEY(srv_monitor_thread),
 	PSI_KEY(srv_purge_thread),
@@ -747,6 +762,9 @@ ha_create_table_option innodb_table_option_list[]=
   HA_TOPTION_ENUM("ENCRYPTED", encryption, "DEFAULT,YES,NO", 0),
   /* With this option the user defines the key identifier using for the encryption */
   HA_TOPTION_SYSVAR("ENCRYPTION_KEY_ID", encryption_key_id, default_encryption_key_id),
+  /* With this option the updates of a row by its primary key are
+  admitted to the record lock queue one transaction at a time */
+  HA_TOPTION_BOOL("HOT_ROW_QUEUE", hot_row_queue, 0),
 
   HA_TOPTION_END
 };
@@ -913,6 +931,7 @@ static ibool innodb_have_lz4=IF_LZ4(1, 0);
 static ibool innodb_have_lzma=IF_LZMA(1, 0);
 static ibool innodb_have_bzip2=IF_BZIP2(1, 0);
 static ibool innodb_have_snappy=IF_SNAPPY(1, 0);
+static ibool innodb_have_zstd=IF_ZSTD(1, 0);
 static ibool innodb_have_punch_hole=IF_PUNCH_HOLE(1, 0);
 
 static
@@ -942,10 +961,23 @@ static MYSQL_THDVAR_BOOL(ft_enable_stopword, PLUGIN_VAR_OPCMDARG,
   NULL, NULL,
   /* default */ TRUE);
 
+static MYSQL_THDVAR_BOOL(hot_row_queue, PLUGIN_VAR_OPCMDARG,
+  "Let the updates of a row by its primary key wait in a queue"
+  " before they are admitted to the record lock queue of the row",
+  NULL, NULL, FALSE);
+
 static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 0, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index when counting all rows of a table.",
+  NULL, NULL, 4, 1, ROW_PREAD_MAX_THREADS, 0);
+
+static MYSQL_THDVAR_ULONG(ddl_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the clustered index and sort the index entries when ALTER TABLE creates secondary indexes without rebuilding the table.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -1109,6 +1141,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &innodb_have_bzip2,		  SHOW_BOOL},
   {"have_snappy",
   (char*) &innodb_have_snappy,		  SHOW_BOOL},
+  {"have_zstd",
+  (char*) &innodb_have_zstd,		  SHOW_BOOL},
   {"have_punch_hole",
   (char*) &innodb_have_punch_hole,	  SHOW_BOOL},
 
@@ -1859,6 +1893,17 @@ thd_innodb_tmpdir(
 	return(tmp_dir);
 }
 
+/** Get the value of innodb_ddl_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_ddl_threads.
+@return maximum number of threads for building secondary indexes */
+ulint
+thd_ddl_threads(
+	THD*	thd)
+{
+	return(THDVAR(thd, ddl_threads));
+}
+
 /** Obtain the InnoDB transaction of a MySQL thread.
 @param[in,out]	thd	thread handle
 @return reference to transaction pointer */
@@ -2940,10 +2985,19 @@ ha_innobase::ha_innobase(
 			  | HA_CAN_RTREEKEYS
                           | HA_CAN_TABLES_WITHOUT_ROLLBACK
 			  | HA_CONCURRENT_OPTIMIZE
+			  | HA_HAS_RECORDS
 			  |  (srv_force_primary_key ? HA_REQUIRE_PRIMARY_KEY : 0)
 		  ),
 	m_start_of_scan(),
-        m_mysql_has_locked()
+        m_mysql_has_locked(),
+	m_prefetch_page_no(FIL_NULL),
+	m_prefetch_heap(NULL),
+	m_icp_heap(NULL),
+	m_icp_index(NULL),
+	m_icp_pred(NULL),
+	m_icp_n_pred(0),
+	m_icp_end(NULL),
+	m_icp_end_buf(NULL)
 {}
 
 /*********************************************************************//**
@@ -3405,6 +3459,9 @@ ha_innobase::reset_template(void)
 	if (m_prebuilt->idx_cond) {
 		m_prebuilt->idx_cond = NULL;
 		m_prebuilt->idx_cond_n_cols = 0;
+		m_prebuilt->idx_cond_pred = NULL;
+		m_prebuilt->idx_cond_n_pred = 0;
+		m_prebuilt->idx_cond_end = NULL;
 		/* Invalidate m_prebuilt->mysql_template
 		in ha_innobase::write_row(). */
 		m_prebuilt->template_type = ROW_MYSQL_NO_TEMPLATE;
@@ -3727,6 +3784,15 @@ static int innodb_init_params()
 	}
 #endif
 
+#ifndef HAVE_ZSTD
+	if (innodb_compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		sql_print_error("InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				"InnoDB: libzstd is not installed. \n",
+				innodb_compression_algorithm);
+		DBUG_RETURN(HA_ERR_INITIALIZATION);
+	}
+#endif
+
 	if ((srv_encrypt_tables || srv_encrypt_log)
 	     && !encryption_key_id_exists(FIL_DEFAULT_ENCRYPTION_KEY)) {
 		sql_print_error("InnoDB: cannot enable encryption, "
@@ -4019,6 +4085,11 @@ static int innodb_init_params()
 	}
 
 #ifdef LINUX_NATIVE_AIO
+# ifdef LINUX_IO_URING
+	if (!srv_use_native_aio) {
+		srv_use_io_uring = FALSE;
+	}
+# endif /* LINUX_IO_URING */
 	if (srv_use_native_aio) {
 		ib::info() << "Using Linux native AIO";
 	}
@@ -6534,6 +6605,18 @@ ha_innobase::close()
 
 	row_prebuilt_free(m_prebuilt, FALSE);
 
+	if (m_prefetch_heap != NULL) {
+		mem_heap_free(m_prefetch_heap);
+		m_prefetch_heap = NULL;
+	}
+
+	if (m_icp_heap != NULL) {
+		mem_heap_free(m_icp_heap);
+		m_icp_heap = NULL;
+		m_icp_index = NULL;
+		m_icp_n_pred = 0;
+	}
+
 	if (m_upd_buf != NULL) {
 		ut_ad(m_upd_buf_size != 0);
 		my_free(m_upd_buf);
@@ -7628,6 +7711,9 @@ ha_innobase::build_template(
 	m_prebuilt->mysql_prefix_len = 0;
 	m_prebuilt->n_template = 0;
 	m_prebuilt->idx_cond_n_cols = 0;
+	m_prebuilt->idx_cond_pred = NULL;
+	m_prebuilt->idx_cond_n_pred = 0;
+	m_prebuilt->idx_cond_end = NULL;
 
 	/* Note that in InnoDB, i is the column number in the table.
 	MySQL calls columns 'fields'. */
@@ -7829,6 +7915,11 @@ ha_innobase::build_template(
 		}
 
 		m_prebuilt->idx_cond = this;
+
+		if (index == m_icp_index) {
+			m_prebuilt->idx_cond_pred = m_icp_pred;
+			m_prebuilt->idx_cond_n_pred = m_icp_n_pred;
+		}
 	} else {
 no_icp:
 		mysql_row_templ_t*	templ;
@@ -8003,6 +8094,82 @@ ha_innobase::innobase_set_max_autoinc(
 	return(error);
 }
 
+/** Start a statement that may insert several rows.
+If the table is empty, the rows will be sorted and loaded into the
+indexes by end_bulk_insert(). Otherwise, the foreign key checks may
+be deferred until end_bulk_insert().
+@param[in]	rows	estimated number of rows, or 0 if unknown
+@param[in]	flags	ignored */
+void
+ha_innobase::start_bulk_insert(ha_rows rows, uint flags)
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+#ifdef WITH_WSREP
+	if (wsrep_on(ha_thd())) {
+		DBUG_VOID_RETURN;
+	}
+#endif /* WITH_WSREP */
+	m_prebuilt->bulk_insert = true;
+	DBUG_VOID_RETURN;
+}
+
+/** Load the rows that were buffered since start_bulk_insert(),
+or verify the foreign key checks that were deferred.
+@return error number */
+int
+ha_innobase::end_bulk_insert()
+{
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	ins_node_t*	node = m_prebuilt->ins_node;
+	dberr_t		err;
+
+	m_prebuilt->bulk_insert = false;
+
+	if (node == NULL || (node->fk_batch == NULL && node->bulk == NULL)) {
+		DBUG_RETURN(0);
+	} else if (thd_is_error(m_user_thd)
+		   || trx_is_interrupted(m_prebuilt->trx)) {
+		/* The statement failed or was killed, and it will be
+		rolled back. Discard the deferred work. */
+		err = thd_is_error(m_user_thd) ? DB_SUCCESS : DB_INTERRUPTED;
+
+		if (node->fk_batch != NULL) {
+			row_ins_fk_batch_free(node->fk_batch);
+			node->fk_batch = NULL;
+		}
+
+		if (node->bulk != NULL) {
+			row_merge_bulk_free(node->bulk);
+			node->bulk = NULL;
+		}
+	} else if (node->fk_batch != NULL) {
+		err = row_insert_fk_batch_check(m_prebuilt);
+
+		row_ins_fk_batch_free(node->fk_batch);
+		node->fk_batch = NULL;
+	} else {
+		trx_t*	trx = m_prebuilt->trx;
+
+		trx->op_info = "loading buffered rows";
+		err = row_merge_bulk_apply(node->bulk, trx);
+		trx->op_info = "";
+
+		row_merge_bulk_free(node->bulk);
+		node->bulk = NULL;
+	}
+
+	if (err != DB_SUCCESS) {
+		int	error = convert_error_code_to_mysql(
+			err, m_prebuilt->table->flags, m_user_thd);
+		/* The caller reports my_errno. */
+		my_errno = error;
+		DBUG_RETURN(error);
+	}
+
+	DBUG_RETURN(0);
+}
+
 /********************************************************************//**
 Stores a row in an InnoDB database, to the table specified in this
 handle.
@@ -9292,6 +9459,24 @@ ha_innobase::index_read(
 		dtuple_set_n_fields(m_prebuilt->search_tuple, 0);
 	}
 
+	if (m_prebuilt->idx_cond_n_pred) {
+		/* Records that are rejected by m_prebuilt->idx_cond_pred
+		must be checked against the end of the range in InnoDB,
+		like handler_index_cond_check() does for the rest. */
+		m_prebuilt->idx_cond_end = NULL;
+
+		if (end_range) {
+			ut_ad(index == m_icp_index);
+			row_sel_convert_mysql_key_to_innobase(
+				m_icp_end, m_icp_end_buf,
+				m_prebuilt->srch_key_val_len, index,
+				end_range->key, end_range->length);
+			m_prebuilt->idx_cond_end = m_icp_end;
+			m_prebuilt->idx_cond_end_on_equal
+				= key_compare_result_on_equal;
+		}
+	}
+
 	page_cur_mode_t	mode = convert_search_mode_to_innobase(find_flag);
 
 	ulint	match_mode = 0;
@@ -9868,6 +10053,47 @@ ha_innobase::rnd_pos(
 	DBUG_RETURN(error);
 }
 
+/** Start reading the clustered index leaf page of a row that is about
+to be read by rnd_pos(). Consecutive rows on the same leaf page, as
+produced by the rowid-ordered DS-MRR scan, result in a single read.
+@param[in]	pos	primary key value of the row in the MySQL format,
+or the row id if the clustered index was internally generated by InnoDB */
+void
+ha_innobase::rnd_pos_prefetch(const uchar* pos)
+{
+	dict_table_t*	table = m_prebuilt->table;
+	dict_index_t*	index = dict_table_get_first_index(table);
+
+	if (!table->is_readable() || index->is_corrupted()) {
+		return;
+	}
+
+	ulint		n_uniq	= dict_index_get_n_unique(index);
+
+	/* The calls for a batch of DS-MRR rowids reuse the memory. */
+	if (m_prefetch_heap) {
+		mem_heap_empty(m_prefetch_heap);
+	} else {
+		m_prefetch_heap = mem_heap_create(
+			sizeof(dtuple_t) + n_uniq * sizeof(dfield_t)
+			+ m_prebuilt->srch_key_val_len);
+	}
+
+	dtuple_t*	tuple	= dtuple_create(m_prefetch_heap, n_uniq);
+	byte*		buf	= static_cast<byte*>(
+		mem_heap_alloc(m_prefetch_heap,
+			       m_prebuilt->srch_key_val_len));
+
+	dict_index_copy_types(tuple, index, n_uniq);
+
+	row_sel_convert_mysql_key_to_innobase(
+		tuple, buf, m_prebuilt->srch_key_val_len, index,
+		pos, uint(ref_length));
+
+	m_prefetch_page_no = btr_cur_prefetch_leaf(
+		index, tuple, m_prefetch_page_no);
+}
+
 /**********************************************************************//**
 Initialize FT index scan
 @return 0 or error number */
@@ -13508,6 +13734,114 @@ ha_innobase::estimate_rows_upper_bound()
 	DBUG_RETURN((ha_rows) estimate);
 }
 
+/** Count a record for ha_innobase::records().
+@param[in]	thread	index of the scanning thread
+@param[in,out]	arg	array of counters, one cache line per thread
+@return	true */
+static
+bool
+innobase_count_rec(const rec_t*, const ulint*, ulint thread, void* arg)
+{
+	static_cast<ha_rows*>(arg)[thread * (CACHE_LINE_SIZE
+					     / sizeof(ha_rows))]++;
+	return(true);
+}
+
+/** Count the rows of the table in the read view of the transaction,
+scanning the clustered index with innodb_parallel_read_threads threads.
+This is invoked by opt_sum_query() for SELECT COUNT(*) without a WHERE
+clause.
+@return number of rows
+@retval HA_POS_ERROR if the SQL layer should count the rows itself */
+ha_rows
+ha_innobase::records()
+{
+	DBUG_ENTER("ha_innobase::records");
+
+	update_thd();
+
+	dict_index_t*	index = dict_table_get_first_index(m_prebuilt->table);
+
+	if (m_prebuilt->select_lock_type != LOCK_NONE
+	    || table->force_index
+	    || !index || !index->is_readable() || index->is_corrupted()) {
+		/* Let the SQL layer perform a locking read, use the
+		index that was requested, or report the error. */
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	if (thd_is_explain(m_user_thd)) {
+		/* Do not scan the table for EXPLAIN, which will show
+		the index scan instead of "Select tables optimized away". */
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	trx_t*	trx = m_prebuilt->trx;
+
+	trx_start_if_not_started(trx, false);
+
+	/* Like row_search_mvcc(), let READ UNCOMMITTED and tables without
+	undo logging read the latest version of each record. */
+	const bool	latest
+		= trx->isolation_level == TRX_ISO_READ_UNCOMMITTED
+		|| m_prebuilt->table->no_rollback();
+
+	if (!latest) {
+		trx->read_view.open(trx);
+	}
+
+	if (!row_merge_is_index_usable(trx, index)) {
+		/* The table was rebuilt after the read view was
+		created. Let the SQL layer report ER_TABLE_DEF_CHANGED. */
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	const ulint	n_threads = THDVAR(m_user_thd, parallel_read_threads);
+	const ulint	stride = CACHE_LINE_SIZE / sizeof(ha_rows);
+	ha_rows*	n_rows = static_cast<ha_rows*>(
+		ut_zalloc_nokey(n_threads * stride * sizeof *n_rows));
+
+	trx->op_info = "counting rows";
+
+	dberr_t	err = row_pread_scan(trx, latest, index, n_threads,
+				     innobase_count_rec, n_rows);
+
+	trx->op_info = "";
+
+	ha_rows	total = 0;
+
+	for (ulint i = 0; i < n_threads; i++) {
+		total += n_rows[i * stride];
+	}
+
+	ut_free(n_rows);
+
+	if (err != DB_SUCCESS) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	/* Account for the rows like a scan of the clustered index. */
+	if (m_prebuilt->table->is_system_db) {
+		srv_stats.n_system_rows_read.add(
+			thd_get_thread_id(trx->mysql_thd), total);
+	} else {
+		srv_stats.n_rows_read.add(
+			thd_get_thread_id(trx->mysql_thd), total);
+	}
+
+	if (internal_tmp_table) {
+		rows_tmp_read += total;
+	} else {
+		rows_read += total;
+	}
+
+	if (table->s->primary_key < MAX_KEY) {
+		index_rows_read[table->s->primary_key] += total;
+	}
+
+	DBUG_RETURN(total);
+}
+
 /*********************************************************************//**
 How many seeks it will take to read through the table. This is to be
 comparable to the number returned by records_in_range so that we can
@@ -15193,8 +15527,12 @@ ha_innobase::extra(
 	case HA_EXTRA_INSERT_WITH_UPDATE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_IGNORE;
 		break;
+	case HA_EXTRA_IGNORE_DUP_KEY:
+		m_prebuilt->ignore_dup_key = true;
+		break;
 	case HA_EXTRA_NO_IGNORE_DUP_KEY:
 		thd_to_trx(ha_thd())->duplicates &= ~TRX_DUP_IGNORE;
+		m_prebuilt->ignore_dup_key = false;
 		break;
 	case HA_EXTRA_WRITE_CAN_REPLACE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_REPLACE;
@@ -15251,6 +15589,23 @@ ha_innobase::end_stmt()
 	/* This is a statement level counter. */
 	m_prebuilt->autoinc_last_value = 0;
 
+	m_prebuilt->bulk_insert = false;
+	m_prebuilt->ignore_dup_key = false;
+
+	if (m_prebuilt->ins_node && m_prebuilt->ins_node->bulk) {
+		/* end_bulk_insert() was not invoked; the statement
+		must have been rolled back. */
+		row_merge_bulk_free(m_prebuilt->ins_node->bulk);
+		m_prebuilt->ins_node->bulk = NULL;
+	}
+
+	if (m_prebuilt->ins_node && m_prebuilt->ins_node->fk_batch) {
+		/* The deferred foreign key checks are moot, because
+		the statement was rolled back. */
+		row_ins_fk_batch_free(m_prebuilt->ins_node->fk_batch);
+		m_prebuilt->ins_node->fk_batch = NULL;
+	}
+
 	return(0);
 }
 
@@ -15299,6 +15654,8 @@ ha_innobase::start_stmt(
 
 	m_prebuilt->sql_stat_start = TRUE;
 	m_prebuilt->hint_need_to_fetch_extra_cols = 0;
+	m_prebuilt->hot_row_queue = table->s->option_struct->hot_row_queue
+		|| THDVAR(thd, hot_row_queue);
 	reset_template();
 
 	if (m_prebuilt->table->is_temporary()
@@ -15478,6 +15835,8 @@ ha_innobase::external_lock(
 
 	m_prebuilt->sql_stat_start = TRUE;
 	m_prebuilt->hint_need_to_fetch_extra_cols = 0;
+	m_prebuilt->hot_row_queue = table->s->option_struct->hot_row_queue
+		|| THDVAR(thd, hot_row_queue);
 
 	reset_template();
 
@@ -19103,6 +19462,15 @@ static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
   1,			/* Minimum value */
   5000, 0);		/* Maximum value */
 
+static MYSQL_SYSVAR_ULONG(old_version_cache_size, srv_old_version_cache_size,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of old row versions that consistent reads can share"
+  " instead of applying the same undo log records again (0 to disable).",
+  NULL, NULL,
+  8192,			/* Default setting */
+  0,			/* Minimum value */
+  1 << 24, 0);		/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Purge threads can be from 1 to 32. Default is 4.",
@@ -19281,6 +19649,23 @@ static MYSQL_SYSVAR_BOOL(stats_auto_recalc, srv_stats_auto_recalc,
   " new statistics)",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(stats_auto_recalc_incremental,
+  srv_stats_auto_recalc_incremental,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether the automatic recalculation of persistent statistics only"
+  " analyzes the indexes that were modified too much since their"
+  " statistics were calculated",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(stats_analyze_threads, srv_stats_analyze_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that analyze the indexes of a table in parallel"
+  " when calculating persistent statistics",
+  NULL, NULL,
+  1,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
+
 static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   srv_stats_persistent_sample_pages,
   PLUGIN_VAR_RQCMDARG,
@@ -19413,6 +19798,12 @@ static MYSQL_SYSVAR_STR(buffer_pool_filename, srv_buf_dump_filename,
   "Filename to/from which to dump/load the InnoDB buffer pool",
   innodb_srv_buf_dump_filename_validate, NULL, SRV_BUF_DUMP_FILENAME_DEFAULT);
 
+static MYSQL_SYSVAR_BOOL(buffer_pool_index_stats, srv_buf_pool_index_stats,
+  PLUGIN_VAR_OPCMDARG,
+  "Account the page accesses of each index in"
+  " INFORMATION_SCHEMA.INNODB_BUFFER_POOL_INDEX_STATS",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(buffer_pool_dump_now, innodb_buffer_pool_dump_now,
   PLUGIN_VAR_RQCMDARG,
   "Trigger an immediate dump of the buffer pool into a file named @@innodb_buffer_pool_filename",
@@ -19657,6 +20048,12 @@ static MYSQL_SYSVAR_ULONG(log_write_ahead_size, srv_log_write_ahead_size,
   NULL, innodb_log_write_ahead_size_update,
   8*1024L, OS_FILE_LOG_BLOCK_SIZE, UNIV_PAGE_SIZE_DEF, OS_FILE_LOG_BLOCK_SIZE);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_OPCMDARG,
+  "Let dedicated threads write and flush the redo log while committing"
+  " transactions wait for them (ON by default)",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_UINT(old_blocks_pct, innobase_old_blocks_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of the buffer pool to reserve for 'old' blocks.",
@@ -19792,6 +20189,13 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+#ifdef LINUX_IO_URING
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO, if supported by the kernel.",
+  NULL, NULL, FALSE);
+#endif /* LINUX_IO_URING */
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -20025,7 +20429,7 @@ static MYSQL_SYSVAR_BOOL(force_primary_key,
   "Do not allow to create table without primary key (off by default)",
   NULL, NULL, FALSE);
 
-static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", 0 };
+static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", "zstd", 0 };
 static TYPELIB page_compression_algorithms_typelib=
 {
   array_elements(page_compression_algorithms) - 1, 0,
@@ -20033,7 +20437,7 @@ static TYPELIB page_compression_algorithms_typelib=
 };
 static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PLUGIN_VAR_OPCMDARG,
-  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, or bzip2",
+  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, snappy, or zstd",
   innodb_compression_algorithm_validate, NULL,
   /* We use here the largest number of supported compression method to
   enable all those methods that are available. Availability of compression
@@ -20041,6 +20445,13 @@ static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PAGE_ZLIB_ALGORITHM,
   &page_compression_algorithms_typelib);
 
+static MYSQL_SYSVAR_STR(zstd_dictionary, srv_zstd_dictionary,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Path to a dictionary created by zstd --train, used by"
+  " innodb_compression_algorithm=zstd. Pages that were compressed"
+  " with the dictionary cannot be read without it.",
+  NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_ULONG(fatal_semaphore_wait_threshold, srv_fatal_semaphore_wait_threshold,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Maximum number of seconds that semaphore times out in InnoDB.",
@@ -20163,6 +20574,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_filename),
+  MYSQL_SYSVAR(buffer_pool_index_stats),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
@@ -20192,11 +20604,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
+  MYSQL_SYSVAR(ddl_threads),
   MYSQL_SYSVAR(doublewrite),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(use_atomic_writes),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(read_io_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(write_io_threads),
   MYSQL_SYSVAR(file_per_table),
   MYSQL_SYSVAR(flush_log_at_timeout),
@@ -20215,6 +20629,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(lock_schedule_algorithm),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
+  MYSQL_SYSVAR(hot_row_queue),
   MYSQL_SYSVAR(lock_wait_timeout),
   MYSQL_SYSVAR(deadlock_detect),
   MYSQL_SYSVAR(page_size),
@@ -20222,6 +20637,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_writer_threads),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(log_compressed_pages),
   MYSQL_SYSVAR(max_dirty_pages_pct),
@@ -20248,6 +20664,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
   MYSQL_SYSVAR(stats_auto_recalc),
+  MYSQL_SYSVAR(stats_auto_recalc_incremental),
+  MYSQL_SYSVAR(stats_analyze_threads),
   MYSQL_SYSVAR(stats_modified_counter),
   MYSQL_SYSVAR(stats_traditional),
 #ifdef BTR_CUR_HASH_ADAPT
@@ -20271,6 +20689,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+#ifdef LINUX_IO_URING
+  MYSQL_SYSVAR(use_io_uring),
+#endif /* LINUX_IO_URING */
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -20296,6 +20717,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
   MYSQL_SYSVAR(purge_batch_size),
+  MYSQL_SYSVAR(old_version_cache_size),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(background_drop_list_empty),
   MYSQL_SYSVAR(log_checkpoint_now),
@@ -20340,6 +20762,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   /* Table page compression feature */
   MYSQL_SYSVAR(compression_default),
   MYSQL_SYSVAR(compression_algorithm),
+  MYSQL_SYSVAR(zstd_dictionary),
   /* Encryption feature */
   MYSQL_SYSVAR(encrypt_tables),
   MYSQL_SYSVAR(encryption_threads),
@@ -20392,6 +20815,7 @@ i_s_innodb_cmp_per_index_reset,
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
 i_s_innodb_buffer_stats,
+i_s_innodb_buffer_index_stats,
 i_s_innodb_metrics,
 i_s_innodb_ft_default_stopword,
 i_s_innodb_ft_deleted,
@@ -20887,6 +21311,105 @@ innobase_get_computed_value(
 }
 
 
+/** Compile the comparisons in a pushed index condition that can
+be evaluated on the InnoDB index records.
+@param[in]	index	the index of the pushed condition
+@param[in]	cond	the pushed index condition */
+void
+ha_innobase::compile_idx_cond(const dict_index_t* index, Item* cond)
+{
+	m_icp_index = NULL;
+	m_icp_n_pred = 0;
+
+	if (m_icp_heap) {
+		mem_heap_empty(m_icp_heap);
+	} else {
+		m_icp_heap = mem_heap_create(1024);
+	}
+
+	/* Without virtual columns, the MySQL field number is
+	the InnoDB column number. */
+	if (!index || index->type & (DICT_FTS | DICT_SPATIAL)
+	    || table->s->stored_fields != table->s->fields) {
+		return;
+	}
+
+	Idx_cond_comparison*	cmps;
+	uint			n_cmps = get_idx_cond_comparisons(cond, &cmps);
+
+	if (!n_cmps) {
+		return;
+	}
+
+	m_icp_pred = static_cast<row_icp_pred_t*>(
+		mem_heap_alloc(m_icp_heap, n_cmps * sizeof *m_icp_pred));
+
+	for (uint i = 0; i < n_cmps; i++) {
+		const Idx_cond_comparison&	cmp = cmps[i];
+		ulint				pos = dict_index_get_nth_col_pos(
+			index, cmp.field->field_index, NULL);
+
+		if (pos == ULINT_UNDEFINED
+		    || dict_index_get_nth_field(index, pos)->prefix_len) {
+			continue;
+		}
+
+		const dict_col_t*	col = dict_index_get_nth_col(index, pos);
+		ulint			len = cmp.field->pack_length();
+
+		/* These are compared by memcmp() in cmp_data(). */
+		if ((col->mtype != DATA_INT && col->mtype != DATA_FIXBINARY)
+		    || col->len != len) {
+			continue;
+		}
+
+		row_icp_pred_t*	pred = &m_icp_pred[m_icp_n_pred++];
+		byte*		values = static_cast<byte*>(
+			mem_heap_alloc(m_icp_heap, cmp.n_values * len));
+
+		pred->field_no = pos;
+		pred->len = len;
+		pred->n_values = cmp.n_values;
+		pred->values = values;
+
+		switch (cmp.op) {
+		case Idx_cond_comparison::EQ: pred->op = ROW_ICP_EQ; break;
+		case Idx_cond_comparison::NE: pred->op = ROW_ICP_NE; break;
+		case Idx_cond_comparison::LT: pred->op = ROW_ICP_LT; break;
+		case Idx_cond_comparison::LE: pred->op = ROW_ICP_LE; break;
+		case Idx_cond_comparison::GT: pred->op = ROW_ICP_GT; break;
+		case Idx_cond_comparison::GE: pred->op = ROW_ICP_GE; break;
+		case Idx_cond_comparison::IN: pred->op = ROW_ICP_IN; break;
+		}
+
+		for (uint j = 0; j < cmp.n_values; j++) {
+			dfield_t	dfield;
+			byte		int_buf[8];
+
+			ut_ad(col->mtype != DATA_INT
+			      || len <= sizeof int_buf);
+			dict_col_copy_type(col, dfield_get_type(&dfield));
+			row_mysql_store_col_in_innobase_format(
+				&dfield, int_buf, TRUE, cmp.values + j * len,
+				len, dict_table_is_comp(index->table));
+			ut_ad(dfield_get_len(&dfield) == len);
+			memcpy(values + j * len, dfield_get_data(&dfield), len);
+		}
+	}
+
+	if (!m_icp_n_pred) {
+		return;
+	}
+
+	ulint	n_fields = dict_index_get_n_fields(index);
+
+	m_icp_end = dtuple_create(m_icp_heap, n_fields);
+	dict_index_copy_types(m_icp_end, index, n_fields);
+	m_icp_end_buf = static_cast<byte*>(
+		mem_heap_alloc(m_icp_heap, m_prebuilt->srch_key_val_len));
+	m_icp_index = index;
+}
+
 /** Attempt to push down an index condition.
 @param[in] keyno MySQL key number
 @param[in] idx_cond Index condition to be checked
@@ -20910,6 +21433,7 @@ ha_innobase::idx_cond_push(
 	pushed_idx_cond = idx_cond;
 	pushed_idx_cond_keyno = keyno;
 	in_range_check_pushed_down = TRUE;
+	compile_idx_cond(idx, idx_cond);
 	/* We will evaluate the condition entirely */
 	DBUG_RETURN(NULL);
 }
@@ -21317,6 +21841,17 @@ innodb_compression_algorithm_validate(
 		DBUG_RETURN(1);
 	}
 #endif
+
+#ifndef HAVE_ZSTD
+	if (compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				    "InnoDB: libzstd is not installed. \n",
+				    compression_algorithm);
+		DBUG_RETURN(1);
+	}
+#endif
 	DBUG_RETURN(0);
 }
 
@@ -70,6 +70,8 @@ struct ha_table_option_struct
 						value OFF.*/
 	uint		encryption;		/*!<  DEFAULT, ON, OFF */
 	ulonglong	encryption_key_id;	/*!< encryption key id  */
+	bool		hot_row_queue;		/*!< Whether the updates of
+						rows wait in hot row queues */
 };
 /* JAN: TODO: MySQL 5.7 handler.h */
 struct st_handler_tablename
@@ -134,6 +136,10 @@ class ha_innobase: public handler
 
 	int delete_all_rows();
 
+	void start_bulk_insert(ha_rows rows, uint flags);
+
+	int end_bulk_insert();
+
 	int write_row(uchar * buf);
 
 	int update_row(const uchar * old_data, const uchar * new_data);
@@ -180,6 +186,8 @@ class ha_innobase: public handler
 
 	int rnd_pos(uchar * buf, uchar *pos);
 
+	void rnd_pos_prefetch(const uchar* pos);
+
 	int ft_init();
 
 	void ft_end();
@@ -215,6 +223,8 @@ class ha_innobase: public handler
 
 	ha_rows estimate_rows_upper_bound();
 
+	ha_rows records();
+
 	void update_create_info(HA_CREATE_INFO* create_info);
 
 	int create(
@@ -478,6 +488,12 @@ class ha_innobase: public handler
 	false if accessing individual fields is enough */
 	void build_template(bool whole_row);
 
+	/** Compile the comparisons in a pushed index condition that can
+	be evaluated on the InnoDB index records.
+	@param[in]	index	the index of the pushed condition
+	@param[in]	cond	the pushed index condition */
+	void compile_idx_cond(const dict_index_t* index, Item* cond);
+
 	virtual int info_low(uint, bool);
 
 	/** The multi range read session object */
@@ -521,6 +537,31 @@ class ha_innobase: public handler
 
         /** If mysql has locked with external_lock() */
         bool                    m_mysql_has_locked;
+
+	/** clustered index leaf page that was prefetched for the
+	preceding rnd_pos_prefetch(), or FIL_NULL */
+	ulint			m_prefetch_page_no;
+
+	/** memory for the search tuple of rnd_pos_prefetch(), or NULL */
+	mem_heap_t*		m_prefetch_heap;
+
+	/** memory for the compiled index condition, or NULL */
+	mem_heap_t*		m_icp_heap;
+
+	/** the index that m_icp_pred was compiled for, or NULL */
+	const dict_index_t*	m_icp_index;
+
+	/** comparisons compiled from the pushed index condition */
+	row_icp_pred_t*		m_icp_pred;
+
+	/** number of elements in m_icp_pred */
+	ulint			m_icp_n_pred;
+
+	/** end of the scanned range, in the format of m_icp_index */
+	dtuple_t*		m_icp_end;
+
+	/** buffer for converting the end of the range to m_icp_end */
+	byte*			m_icp_end_buf;
 };
 
 
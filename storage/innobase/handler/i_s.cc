@@ -41,6 +41,7 @@ Modified Dec 29, 2014 Jan Lindström (Added sys_semaphore_waits)
 #include "dict0load.h"
 #include "buf0buddy.h"
 #include "buf0buf.h"
+#include "buf0stats.h"
 #include "ibuf0ibuf.h"
 #include "dict0mem.h"
 #include "dict0types.h"
@@ -4641,6 +4642,281 @@ UNIV_INTERN struct st_maria_plugin	i_s_innodb_buffer_stats =
         STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE),
 };
 
+/* Fields of the dynamic table INNODB_BUFFER_POOL_INDEX_STATS. */
+static ST_FIELD_INFO	i_s_innodb_buffer_index_stats_fields_info[] =
+{
+#define IDX_BUF_INDEX_STATS_SPACE	0
+	{STRUCT_FLD(field_name,		"SPACE"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_INDEX_ID	1
+	{STRUCT_FLD(field_name,		"INDEX_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_TABLE_NAME	2
+	{STRUCT_FLD(field_name,		"TABLE_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_INDEX_NAME	3
+	{STRUCT_FLD(field_name,		"INDEX_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_RESIDENT	4
+	{STRUCT_FLD(field_name,		"PAGES_RESIDENT"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_HITS	5
+	{STRUCT_FLD(field_name,		"PAGE_HITS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_MISSES	6
+	{STRUCT_FLD(field_name,		"PAGE_MISSES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_RA_USED	7
+	{STRUCT_FLD(field_name,		"READ_AHEAD_USED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_RA_EVICTED	8
+	{STRUCT_FLD(field_name,		"READ_AHEAD_EVICTED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_EVICTED	9
+	{STRUCT_FLD(field_name,		"PAGES_EVICTED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_INDEX_STATS_EVICTION_AGE	10
+	{STRUCT_FLD(field_name,		"AVG_EVICTION_AGE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill the dynamic table INFORMATION_SCHEMA.INNODB_BUFFER_POOL_INDEX_STATS
+from a snapshot of the per-index buffer pool statistics. Unlike
+INNODB_BUFFER_PAGE, this does not scan the buffer pool.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_innodb_buffer_index_stats_fill_table(
+/*=====================================*/
+	THD*		thd,		/*!< in: thread */
+	TABLE_LIST*	tables,		/*!< in/out: tables to fill */
+	Item*		)		/*!< in: condition (ignored) */
+{
+	TABLE*	table = tables->table;
+	Field**	fields = table->field;
+	char	table_name[MAX_FULL_NAME_LEN + 1];
+
+	DBUG_ENTER("i_s_innodb_buffer_index_stats_fill_table");
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name.str);
+
+	/* Only allow the PROCESS privilege holder to access the stats */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	std::vector<buf_index_stats_t>	snapshot;
+	buf_index_stats_get(snapshot);
+
+	for (ulint i = 0; i < snapshot.size(); i++) {
+		const buf_index_stats_t&	stats = snapshot[i];
+		bool				ret = false;
+
+		OK(fields[IDX_BUF_INDEX_STATS_SPACE]->store(
+			   stats.space, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_INDEX_ID]->store(
+			   stats.index_id, true));
+
+		fields[IDX_BUF_INDEX_STATS_TABLE_NAME]->set_null();
+		fields[IDX_BUF_INDEX_STATS_INDEX_NAME]->set_null();
+
+		mutex_enter(&dict_sys->mutex);
+
+		if (const dict_index_t* index = stats.index_id
+		    ? dict_index_get_if_in_cache_low(stats.index_id)
+		    : NULL) {
+			char*	table_name_end = innobase_convert_name(
+				table_name, sizeof(table_name),
+				index->table->name.m_name,
+				strlen(index->table->name.m_name),
+				thd);
+
+			ret = fields[IDX_BUF_INDEX_STATS_TABLE_NAME]
+				->store(table_name,
+					static_cast<uint>(
+						table_name_end - table_name),
+					system_charset_info)
+				|| field_store_index_name(
+					fields[IDX_BUF_INDEX_STATS_INDEX_NAME],
+					index->name);
+
+			fields[IDX_BUF_INDEX_STATS_TABLE_NAME]->set_notnull();
+		}
+
+		mutex_exit(&dict_sys->mutex);
+
+		OK(ret);
+
+		/* The counters are updated without any latch, so the
+		residency may be transiently negative. */
+		OK(fields[IDX_BUF_INDEX_STATS_RESIDENT]->store(
+			   std::max<int64>(stats.n_resident, 0), true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_HITS]->store(
+			   stats.n_hits, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_MISSES]->store(
+			   stats.n_misses, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_RA_USED]->store(
+			   stats.n_read_ahead_used, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_RA_EVICTED]->store(
+			   stats.n_evicted_unused, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_EVICTED]->store(
+			   stats.n_evicted, true));
+
+		OK(fields[IDX_BUF_INDEX_STATS_EVICTION_AGE]->store(
+			   stats.n_evicted > stats.n_evicted_unused
+			   ? stats.evicted_age_ms
+			   / (stats.n_evicted - stats.n_evicted_unused)
+			   : 0, true));
+
+		OK(schema_table_store_record(thd, table));
+	}
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_BUFFER_POOL_INDEX_STATS.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_innodb_buffer_index_stats_init(
+/*===============================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("i_s_innodb_buffer_index_stats_init");
+
+	schema = reinterpret_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = i_s_innodb_buffer_index_stats_fields_info;
+	schema->fill_table = i_s_innodb_buffer_index_stats_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_innodb_buffer_index_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_BUFFER_POOL_INDEX_STATS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB Buffer Pool Per-Index Statistics"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_innodb_buffer_index_stats_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+        /* Maria extension */
+	STRUCT_FLD(version_info, INNODB_VERSION_STR),
+        STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE),
+};
+
 /* Fields of the dynamic table INNODB_BUFFER_POOL_PAGE. */
 static ST_FIELD_INFO	i_s_innodb_buffer_page_fields_info[] =
 {
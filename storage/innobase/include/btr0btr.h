@@ -392,6 +392,14 @@ btr_free(
 	const page_id_t&	page_id,
 	const page_size_t&	page_size);
 
+/** Empty an index tree, keeping only the root page. This is used for
+rolling back TRX_UNDO_EMPTY (a bulk insert into an empty table).
+@param[in,out]	index	index tree
+@return error code */
+dberr_t
+btr_clear(dict_index_t* index)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
 /** Read the last used AUTO_INCREMENT value from PAGE_ROOT_AUTO_INC.
 @param[in,out]	index	clustered index
 @return	the last used AUTO_INCREMENT value
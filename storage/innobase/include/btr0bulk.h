@@ -83,7 +83,6 @@ class PageBulk
 		m_flush_observer(observer),
 		m_err(DB_SUCCESS)
 	{
-		ut_ad(!dict_index_is_spatial(m_index));
 	}
 
 	/** Deconstructor */
@@ -202,6 +201,9 @@ class PageBulk
 	mem_heap_t*	m_heap;
 
 private:
+	/** Sort the records of an R-tree page. */
+	void sortRecs();
+
 	/** The index B-tree */
 	dict_index_t*	m_index;
 
@@ -272,7 +274,8 @@ class BtrBulk
 	/** Constructor
 	@param[in]	index		B-tree index
 	@param[in]	trx_id		transaction id
-	@param[in]	observer	flush observer */
+	@param[in]	observer	flush observer, or NULL to write
+					redo log for all changes */
 	BtrBulk(
 		dict_index_t*	index,
 		trx_id_t	trx_id,
@@ -283,9 +286,11 @@ class BtrBulk
 		m_trx_id(trx_id),
 		m_flush_observer(observer)
 	{
-		ut_ad(m_flush_observer != NULL);
-		ut_d(my_atomic_addlint(
-			     &m_index->table->space->redo_skipped_count, 1));
+#ifdef UNIV_DEBUG
+		if (m_flush_observer)
+			my_atomic_addlint(
+				&m_index->table->space->redo_skipped_count, 1);
+#endif /* UNIV_DEBUG */
 	}
 
 	/** Destructor */
@@ -293,9 +298,12 @@ class BtrBulk
 	{
 		mem_heap_free(m_heap);
 		UT_DELETE(m_page_bulks);
-		ut_d(my_atomic_addlint(
-			     &m_index->table->space->redo_skipped_count,
-			     ulint(-1)));
+#ifdef UNIV_DEBUG
+		if (m_flush_observer)
+			my_atomic_addlint(
+				&m_index->table->space->redo_skipped_count,
+				ulint(-1));
+#endif /* UNIV_DEBUG */
 	}
 
 	/** Initialization
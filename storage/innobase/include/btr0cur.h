@@ -221,6 +221,17 @@ btr_cur_search_to_nth_level_func(
 	btr_cur_search_to_nth_level_func(i,l,t,m,lm,c,fi,li,mtr)
 #endif /* BTR_CUR_HASH_ADAPT */
 
+/** Start an asynchronous read of the leaf page that a search for a tuple
+would end up on, unless the page is already in the buffer pool.
+@param[in,out]	index	B-tree index
+@param[in]	tuple	search tuple
+@param[in]	prev	page number that was returned for the preceding
+			tuple in key order, or FIL_NULL
+@return page number of the leaf page, or FIL_NULL if the index consists
+of the root page only or a page could not be read */
+ulint
+btr_cur_prefetch_leaf(dict_index_t* index, const dtuple_t* tuple, ulint prev);
+
 /*****************************************************************//**
 Opens a cursor at either end of an index.
 @return DB_SUCCESS or error code */
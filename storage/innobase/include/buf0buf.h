@@ -498,7 +498,7 @@ buf_page_get_known_nowait(
 
 /** Given a tablespace id and page number tries to get that page. If the
 page is not in the buffer pool it is not loaded and NULL is returned.
-Suitable for using when holding the lock_sys_t::mutex.
+Suitable for using when holding the lock_sys.latch.
 @param[in]	page_id	page id
 @param[in]	file	file name
 @param[in]	line	line where called
@@ -513,7 +513,7 @@ buf_page_try_get_func(
 
 /** Tries to get a page.
 If the page is not in the buffer pool it is not loaded. Suitable for using
-when holding the lock_sys_t::mutex.
+when holding the lock_sys.latch.
 @param[in]	page_id	page identifier
 @param[in]	mtr	mini-transaction
 @return the page if in buffer pool, NULL if not */
@@ -671,6 +671,15 @@ ibool
 buf_page_peek_if_too_old(
 /*=====================*/
 	const buf_page_t*	bpage);	/*!< in: block to make younger */
+/** Note that a block that was recommended by buf_page_peek_if_too_old()
+was accessed. Instead of moving the block to the start of the LRU list
+right away, which would require buf_pool->mutex on the page hit path,
+the block will be moved when an LRU scan reaches it (second chance).
+NOTE: does not reserve the buffer pool mutex.
+@param[in,out]	bpage	block in the LRU list */
+UNIV_INLINE
+void
+buf_page_set_referenced(buf_page_t* bpage);
 /********************************************************************//**
 Gets the youngest modification log sequence number for a frame.
 Returns zero if not file page or no modification occurred yet.
@@ -1686,6 +1695,12 @@ class buf_page_t {
 					to read this for heuristic
 					purposes without holding any
 					mutex or latch */
+	int32		referenced;	/*!< nonzero if the block was
+					accessed after it became too old;
+					set by buf_page_set_referenced()
+					without holding any mutex, and
+					reset by the LRU scans while
+					holding buf_pool->mutex */
 	/* @} */
 	unsigned	access_time;	/*!< time of first access, or
 					0 if the block was never accessed
@@ -1751,6 +1766,10 @@ struct buf_block_t{
 					bufferfixed, or (2) the thread has an
 					x-latch on the block */
 	/* @} */
+	buf_index_stats_t*	index_stats;
+					/*!< statistics of the index that
+					the page is accounted to, or NULL;
+					see buf_index_stats_access() */
 #ifdef BTR_CUR_HASH_ADAPT
 	/** @name Hash search fields (unprotected)
 	NOTE that these fields are NOT protected by any semaphore! */
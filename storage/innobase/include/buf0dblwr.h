@@ -109,6 +109,13 @@ of threads can occur. */
 void
 buf_dblwr_flush_buffered_writes();
 
+/** Flush the buffered writes of the doublewrite partition that the pages
+of a buffer pool instance are written through.
+@see buf_dblwr_flush_buffered_writes()
+@param[in]	instance_no	buffer pool instance number */
+void
+buf_dblwr_flush_buffered_writes(ulint instance_no);
+
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -123,21 +130,37 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
-	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
-				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
-	ulint		first_free;/*!< first free position in write_buf
-				measured in units of srv_page_size */
+/** A partition of the batch flush slots of the doublewrite buffer.
+The pages of a buffer pool instance are always written through the
+same partition, so that the page cleaner threads do not have to wait
+for each other's batches. */
+struct buf_dblwr_batch_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the fields below
+				and the slots of the partition */
+	ulint		first;	/*!< the first slot of the partition */
+	ulint		size;	/*!< number of slots in the partition */
+	ulint		first_free;/*!< first free position in the
+				partition, relative to first */
 	ulint		b_reserved;/*!< number of slots currently reserved
 				for batch flush. */
 	os_event_t	b_event;/*!< event where threads wait for a
 				batch flush to end;
 				os_event_set() and os_event_reset()
-				are protected by buf_dblwr_t::mutex */
+				are protected by mutex */
+	bool		batch_running;/*!< set to TRUE if currently a batch
+				is being written from the partition */
+};
+
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the single page
+				flush slots */
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint		block2;	/*!< page number of the second block */
+	buf_dblwr_batch_t* batches;/*!< partitions of the first
+				srv_doublewrite_batch_size slots */
+	ulint		n_batches;/*!< number of elements in batches */
 	ulint		s_reserved;/*!< number of slots currently
 				reserved for single page flushes. */
 	os_event_t	s_event;/*!< event where threads wait for a
@@ -145,9 +168,6 @@ struct buf_dblwr_t{
 	bool*		in_use;	/*!< flag used to indicate if a slot is
 				in use. Only used for single page
 				flushes. */
-	bool		batch_running;/*!< set to TRUE if currently a batch
-				is being written from the doublewrite
-				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by srv_page_size
@@ -58,11 +58,16 @@ These are low-level functions
 void
 buf_LRU_flush_or_remove_pages(
 	ulint		id,
-	FlushObserver*	observer
+	FlushObserver*	observer);
+
 #ifdef BTR_CUR_HASH_ADAPT
-	, bool drop_ahi = false /*!< whether to drop the adaptive hash index */
+/** Drop the adaptive hash index entries of a tablespace that is being
+dropped or discarded, in all buffer pool instances. The dirty pages of
+the tablespace are not removed from the flush lists.
+@param[in]	id	tablespace identifier */
+void
+buf_LRU_drop_page_hash_for_tablespace(ulint id);
 #endif /* BTR_CUR_HASH_ADAPT */
-	);
 
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /********************************************************************//**
@@ -179,6 +184,13 @@ void
 buf_LRU_make_block_young(
 /*=====================*/
 	buf_page_t*	bpage);	/*!< in: control block */
+/** Give a block that was marked by buf_page_set_referenced() a second
+chance: move it to the start of the LRU list instead of evicting it.
+@param[in,out]	bpage	block in the LRU list
+@param[in]	scanned	number of blocks that the LRU scan has visited
+@return whether the block was moved */
+bool
+buf_LRU_second_chance(buf_page_t* bpage, ulint scanned);
 /**********************************************************************//**
 Updates buf_pool->LRU_old_ratio.
 @return updated old_pct */
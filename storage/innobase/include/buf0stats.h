@@ -0,0 +1,100 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/buf0stats.h
+Per-index buffer pool access statistics
+*******************************************************/
+
+#ifndef buf0stats_h
+#define buf0stats_h
+
+#include "univ.i"
+#include "buf0types.h"
+#include "dict0types.h"
+
+#include <vector>
+
+/** Buffer pool statistics of an index. The counters are updated
+with atomic operations without holding any latch, so a snapshot of
+an entry is not necessarily consistent. */
+struct buf_index_stats_t {
+	/** index identifier; 0 for the entry of untracked indexes */
+	index_id_t	index_id;
+	/** tablespace identifier */
+	ulint		space;
+	/** number of uncompressed pages that are in the buffer pool */
+	int64		n_resident;
+	/** number of buf_page_get_gen() that found the page in the
+	buffer pool */
+	int64		n_hits;
+	/** number of buf_page_get_gen() that had to read the page */
+	int64		n_misses;
+	/** number of pages whose first access found them in the buffer
+	pool without having read them, typically due to read-ahead */
+	int64		n_read_ahead_used;
+	/** number of pages that were evicted from the buffer pool */
+	int64		n_evicted;
+	/** number of pages that were evicted without ever being accessed */
+	int64		n_evicted_unused;
+	/** sum of the time between the first access and the eviction of
+	the accessed pages that were evicted, in milliseconds */
+	int64		evicted_age_ms;
+};
+
+/** Create the statistics. */
+void
+buf_index_stats_create();
+
+/** Free the statistics. */
+void
+buf_index_stats_free();
+
+/** Account an access to a page in buf_page_get_gen(). If the page
+now belongs to a different index than the one that the block was
+accounted to, the residency is moved to the new index.
+@param[in,out]	block		buffer-fixed and latched page
+@param[in]	miss		whether the page had to be read
+@param[in]	first_access	whether the page was not accessed before */
+void
+buf_index_stats_access(buf_block_t* block, bool miss, bool first_access);
+
+/** Free the entry of an index that is being removed from the
+dictionary cache.
+@param[in]	space		tablespace identifier
+@param[in]	index_id	index identifier */
+void
+buf_index_stats_remove(ulint space, index_id_t index_id);
+
+/** Account the eviction of a page from the buffer pool.
+@param[in]	block	page that is about to be evicted */
+void
+buf_index_stats_evict(const buf_block_t* block);
+
+/** Remove a page from the residency statistics when the block stops
+holding the page.
+@param[in,out]	block	page that is being removed from the page_hash */
+void
+buf_index_stats_release(buf_block_t* block);
+
+/** Copy the statistics of all indexes that have been accessed.
+@param[out]	snapshot	copies of the statistics */
+void
+buf_index_stats_get(std::vector<buf_index_stats_t>& snapshot);
+
+#endif /* buf0stats_h */
@@ -41,6 +41,8 @@ struct buf_pool_t;
 struct buf_pool_stat_t;
 /** Buffer pool buddy statistics struct */
 struct buf_buddy_stat_t;
+/** Buffer pool statistics of an index */
+struct buf_index_stats_t;
 /** Doublewrite memory struct */
 struct buf_dblwr_t;
 /** Flush observer for bulk create index */
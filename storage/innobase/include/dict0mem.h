@@ -896,6 +896,10 @@ struct dict_index_t{
 	records; usually equal to UT_BITS_IN_BYTES(n_nullable), but
 	can be less in clustered indexes with instant ADD COLUMN */
 	unsigned	n_core_null_bytes:8;
+	/** number of leading fields that are fixed-length and NOT NULL
+	in ROW_FORMAT!=REDUNDANT; their end offsets are the same in every
+	record, and rec_get_offsets() copies them from fixed_offsets[] */
+	unsigned	n_fixed_offsets:10;
 	/** magic value signalling that n_core_null_bytes was not
 	initialized yet */
 	static const unsigned NO_CORE_NULL_BYTES = 0xff;
@@ -926,6 +930,9 @@ struct dict_index_t{
 # define DICT_INDEX_MAGIC_N	76789786
 #endif
 	dict_field_t*	fields;	/*!< array of field descriptions */
+	const ulint*	fixed_offsets;
+				/*!< end offsets of the first
+				n_fixed_offsets fields, or NULL */
 	st_mysql_ftparser*
 			parser;	/*!< fulltext parser plugin */
 	bool		has_new_v_col;
@@ -974,6 +981,13 @@ struct dict_index_t{
 	ulint		stat_n_leaf_pages;
 				/*!< approximate number of leaf pages in the
 				index tree */
+	ib_uint64_t	stat_modified_counter;
+				/*!< approximate number of records inserted,
+				updated or deleted in this index since its
+				persistent statistics were last calculated;
+				not protected by any latch, but updated with
+				relaxed atomic operations, because it is
+				only used for heuristics */
 	bool		stats_error_printed;
 				/*!< has persistent statistics error printed
 				for this index ? */
@@ -1841,7 +1855,7 @@ struct dict_table_t {
 	kept in trx_t. In order to quickly determine whether a transaction has
 	locked the AUTOINC lock we keep a pointer to the transaction here in
 	the 'autoinc_trx' member. This is to avoid acquiring the
-	lock_sys_t::mutex and scanning the vector in trx_t.
+	lock_sys.latch and scanning the vector in trx_t.
 	When an AUTOINC lock has to wait, the corresponding lock instance is
 	created on the trx lock heap rather than use the pre-allocated instance
 	in autoinc_lock below. */
@@ -1864,14 +1878,14 @@ struct dict_table_t {
 
 	/** This counter is used to track the number of granted and pending
 	autoinc locks on this table. This value is set after acquiring the
-	lock_sys_t::mutex but we peek the contents to determine whether other
+	lock_sys.latch but we peek the contents to determine whether other
 	transactions have acquired the AUTOINC lock or not. Of course only one
 	transaction can be granted the lock but there can be multiple
 	waiters. */
 	ulong					n_waiting_or_granted_auto_inc_locks;
 
 	/** The transaction that currently holds the the AUTOINC lock on this
-	table. Protected by lock_sys.mutex. */
+	table. Protected by lock_sys.latch. */
 	const trx_t*				autoinc_trx;
 
 	/* @} */
@@ -1886,7 +1900,8 @@ struct dict_table_t {
 
 	/** Count of the number of record locks on this table. We use this to
 	determine whether we can evict the table from the dictionary cache.
-	It is protected by lock_sys.mutex. */
+	It is decremented while holding lock_sys.latch in exclusive mode, and
+	atomically incremented while holding it in shared mode. */
 	ulint					n_rec_locks;
 
 #ifndef DBUG_ASSERT_EXISTS
@@ -1898,7 +1913,7 @@ struct dict_table_t {
 	ulint					n_ref_count;
 
 public:
-	/** List of locks on the table. Protected by lock_sys.mutex. */
+	/** List of locks on the table. Protected by lock_sys.latch. */
 	table_lock_list_t			locks;
 
 	/** Timestamp of the last modification of this table. */
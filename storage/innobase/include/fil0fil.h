@@ -35,6 +35,8 @@ Created 10/25/1995 Heikki Tuuri
 #include "page0size.h"
 #include "ibuf0types.h"
 
+#include <map>
+
 // Forward declaration
 extern my_bool srv_use_doublewrite_buf;
 extern struct buf_dblwr_t* buf_dblwr;
@@ -637,6 +639,16 @@ struct fil_system_t {
 					/*!< whether fil_space_create()
 					has issued a warning about
 					potential space_id reuse */
+
+	typedef std::map<ulint, lsn_t, std::less<ulint>,
+			 ut_allocator<std::pair<const ulint, lsn_t> > >
+		dropped_t;
+	/** Tablespaces that were dropped while some of their pages
+	may still be dirty in the buffer pool, mapped to the LSN of the
+	MLOG_FILE_DELETE record. The pages are discarded by the page
+	cleaner, or by fil_space_create() if the identifier is reused.
+	Protected by mutex. */
+	dropped_t	dropped;
 };
 
 /** The tablespace memory cache. */
@@ -673,6 +685,13 @@ fil_node_create(
 	ulint		max_pages = ULINT_MAX)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Remove any dirty pages of a dropped tablespace from the buffer pool
+before its identifier is reused, so that they will not be written to the
+new tablespace.
+@param[in]	id	tablespace identifier */
+void
+fil_space_discard_dropped(ulint id);
+
 /** Create a space memory object and put it to the fil_system hash table.
 Error messages are issued to the server log.
 @param[in]	name		tablespace name
@@ -66,4 +66,11 @@ fil_decompress_page(
 				/*!< in: true if only an error should
 				be produced when decompression fails.
 				By default this parameter is false. */
+
+/** Load the zstd dictionary that is specified by innodb_zstd_dictionary.
+@return whether the dictionary was loaded or is not needed */
+bool fil_zstd_init();
+
+/** Free the zstd dictionary and the cached contexts. */
+void fil_zstd_close();
 #endif
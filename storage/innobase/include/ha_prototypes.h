@@ -314,6 +314,14 @@ const char*
 thd_innodb_tmpdir(
 	THD*	thd);
 
+/** Get the value of innodb_ddl_threads.
+@param[in]	thd	thread handle, or NULL to query
+			the global innodb_ddl_threads.
+@return maximum number of threads for building secondary indexes */
+ulint
+thd_ddl_threads(
+	THD*	thd);
+
 /**********************************************************************//**
 Get the current setting of the table_cache_size global parameter. We do
 a dirty read because for one there is no synchronization object and
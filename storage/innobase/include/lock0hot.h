@@ -0,0 +1,168 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/lock0hot.h
+Admission queues for the updates of hot rows
+*******************************************************/
+
+#ifndef lock0hot_h
+#define lock0hot_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "dict0types.h"
+#include "trx0types.h"
+#include "sync0types.h"
+#include "ut0new.h"
+
+#include <list>
+#include <map>
+
+/** Admission queues for the updates of hot rows.
+
+When many transactions update the same row, they all wait in the
+record lock queue of the row. Each grant and each new waiter then
+traverses the whole queue while holding lock_sys.latch, and most of
+the woken waiters have to wait again.
+
+With a hot row queue, at most N_ADMIT transactions per row are
+admitted to the record lock queue: normally the holder of the lock
+and the next waiter. The other transactions wait in FIFO order, each
+on its own event, and one of them is admitted whenever an admitted
+transaction commits or rolls back. This hands the row over from one
+transaction to the next without contention.
+
+A transaction only waits in a hot row queue if it has not modified or
+locked any rows, has not been admitted to any other queue, and holds
+no table locks other than intention locks (no LOCK TABLES locks and no
+AUTO_INC locks). Such waits are invisible to the deadlock detector, but
+they cannot be part of a cycle of lock waits. The waits are bounded by
+innodb_lock_wait_timeout.
+
+An admission is held until the transaction commits or rolls back, or
+until the statement that took it fails without locking the row, for
+example on a lock wait timeout or KILL QUERY. Otherwise an idle
+transaction whose statement was rolled back would keep the row queued.
+
+The rows are identified by the hash of the primary key value that a
+statement searches for. A hash collision can only make unrelated
+transactions wait for each other. */
+class lock_hot_row_t
+{
+	/** Key of a queue: clustered index id and hash of the key */
+	typedef std::pair<index_id_t, ulint>	key_t;
+
+	/** Transactions waiting for admission, in FIFO order */
+	typedef std::list<trx_t*, ut_allocator<trx_t*> >	waiters_t;
+
+	/** The admission queue of a row */
+	struct queue_t
+	{
+		/** number of admitted transactions that have not
+		committed or rolled back */
+		ulint		n_admitted;
+		/** transactions waiting for admission */
+		waiters_t	waiters;
+
+		queue_t() : n_admitted(0), waiters() {}
+	};
+
+	typedef std::map<key_t, queue_t, std::less<key_t>,
+			 ut_allocator<std::pair<const key_t, queue_t> > >
+		queues_t;
+
+	/** A partition of the queues */
+	struct part_t
+	{
+		/** mutex protecting queues and trx_lock_t::hot_row_admitted
+		of the waiters */
+		ib_mutex_t	mutex;
+		/** the non-empty queues */
+		queues_t	queues;
+	};
+
+	/** Number of partitions */
+	static const ulint N_PARTS = 64;
+
+	/** Number of transactions that are admitted to the record lock
+	queue of a row: the holder of the lock and the next waiter */
+	static const ulint N_ADMIT = 2;
+
+	/** Partitions, or NULL if not created */
+	part_t*		m_parts;
+
+	/** @return the partition of a key
+	@param[in]	key	key of a queue */
+	part_t& get_part(const key_t& key) const
+	{
+		return(m_parts[ut_fold_ulint_pair(ulint(key.first),
+						  key.second) % N_PARTS]);
+	}
+
+	/** @return the key of the queue of a row
+	@param[in]	index	clustered index
+	@param[in]	tuple	primary key value */
+	static key_t get_key(const dict_index_t* index, const dtuple_t* tuple);
+
+	/** Admit waiting transactions while there is room in a queue.
+	@param[in,out]	queue	queue of a row */
+	static void admit_waiters(queue_t& queue);
+
+	/** Release an admission to a queue.
+	@param[in]	key	key of the queue */
+	void release_low(const key_t& key);
+
+public:
+	lock_hot_row_t() : m_parts(NULL) {}
+
+	/** Create the queues. */
+	void create();
+
+	/** Free the queues. */
+	void close();
+
+	/** Wait until a transaction is admitted to lock a row.
+	@param[in,out]	trx	transaction
+	@param[in]	index	clustered index
+	@param[in]	tuple	primary key value
+	@retval DB_SUCCESS		if the transaction had been admitted
+	@retval DB_SUCCESS_LOCKED_REC	if the transaction was admitted now
+	@retval DB_LOCK_WAIT_TIMEOUT	on lock wait timeout
+	@retval DB_INTERRUPTED		if the statement was killed */
+	dberr_t enter(trx_t* trx, const dict_index_t* index,
+		      const dtuple_t* tuple);
+
+	/** Give back an admission that enter() granted to a statement
+	that failed without locking the row.
+	@param[in,out]	trx	transaction
+	@param[in]	index	clustered index
+	@param[in]	tuple	primary key value */
+	void leave(trx_t* trx, const dict_index_t* index,
+		   const dtuple_t* tuple);
+
+	/** Leave the queues that admitted a transaction, at commit
+	or rollback, after the record locks have been released.
+	@param[in,out]	trx	transaction */
+	void release(trx_t* trx);
+};
+
+/** The hot row queues */
+extern lock_hot_row_t	lock_hot_row;
+
+#endif /* lock0hot_h */
@@ -452,13 +452,13 @@ lock_table(
 	lock_mode	mode,	/*!< in: lock mode */
 	que_thr_t*	thr)	/*!< in: query thread */
 	MY_ATTRIBUTE((warn_unused_result));
-/*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+/** Create a table lock object for a resurrected transaction.
+@param[in,out]	table	table
+@param[in,out]	trx	recovered transaction
+@param[in]	mode	LOCK_IX, or LOCK_X if the transaction
+			inserted into an empty table (TRX_UNDO_EMPTY) */
 void
-lock_table_ix_resurrect(
-/*====================*/
-	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+lock_table_resurrect(dict_table_t* table, trx_t* trx, lock_mode mode);
 
 /** Sets a lock on a table based on the given mode.
 @param[in]	table	table to lock
@@ -557,13 +557,13 @@ lock_report_trx_id_insanity(
 	trx_id_t	max_trx_id);	/*!< in: trx_sys.get_max_trx_id() */
 /*********************************************************************//**
 Prints info of locks for all transactions.
-@return FALSE if not able to obtain lock mutex and exits without
+@return FALSE if not able to obtain lock_sys.latch and exits without
 printing info */
 ibool
 lock_print_info_summary(
 /*====================*/
 	FILE*	file,	/*!< in: file where to print */
-	ibool   nowait)	/*!< in: whether to wait for the lock mutex */
+	ibool   nowait)	/*!< in: whether to wait for lock_sys.latch */
 	MY_ATTRIBUTE((warn_unused_result));
 
 /** Prints transaction lock wait and MVCC state.
@@ -576,7 +576,7 @@ lock_trx_print_wait_and_mvcc_state(
 
 /*********************************************************************//**
 Prints info of locks for each transaction. This function assumes that the
-caller holds the lock mutex and more importantly it will release the lock
+caller holds lock_sys.latch and more importantly it will release the lock
 mutex on behalf of the caller. (This should be fixed in the future). */
 void
 lock_print_info_all_transactions(
@@ -586,7 +586,7 @@ lock_print_info_all_transactions(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch in exclusive mode. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -595,7 +595,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch in exclusive mode. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -714,6 +714,18 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/*********************************************************************//**
+A thread which searches the waits-for graph of the suspended transactions
+for cycles and resolves the deadlocks by cancelling the lock wait of a
+victim transaction.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_detect_thread)(
+/*========================================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -804,6 +816,14 @@ lock_trx_has_rec_x_lock(
 	MY_ATTRIBUTE((warn_unused_result));
 #endif /* UNIV_DEBUG */
 
+/** Check if a transaction holds or waits for a table lock other than an
+intention lock, such as from LOCK TABLES or an AUTO_INC lock.
+@param[in]	trx	transaction, serviced by the current thread
+@return whether such a table lock exists */
+bool
+lock_trx_has_strong_table_lock(const trx_t* trx)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
 /**
 Allocate cached locks for the transaction.
 @param trx		allocate cached record locks for this transaction */
@@ -875,15 +895,36 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
+/** Number of lock_sys_t::shards; must be a power of 2 */
+#define LOCK_SYS_N_SHARDS	64
+
 /** The lock system struct */
 class lock_sys_t
 {
   bool m_initialised;
 
+  /** A latch protecting the record lock queues of the pages
+  whose lock_rec_hash() modulo LOCK_SYS_N_SHARDS is the same */
+  struct shard_t
+  {
+    MY_ALIGNED(CACHE_LINE_SIZE)
+    LockMutex	mutex;
+  };
+
+  /** Record lock queue latches, indexed by the hash cell of the page;
+  the hash tables rec_hash, prdt_hash, prdt_page_hash have the same
+  number of cells. */
+  shard_t	shards[LOCK_SYS_N_SHARDS];
+
 public:
-	MY_ALIGNED(CACHE_LINE_SIZE)
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t*	latch;			/*!< Latch protecting the
+						locks. Exclusive mode is needed
+						for table locks, lock waits,
+						deadlock detection and anything
+						that spans multiple pages. Shared
+						mode together with a shard mutex
+						suffices for accessing the record
+						lock queue of a single page. */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -919,6 +960,15 @@ class lock_sys_t
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
 
+	os_event_t	deadlock_event;		/*!< An event waited for by
+						lock_deadlock_detect_thread.
+						Signaled when a transaction
+						is suspended in a lock wait
+						and on shutdown. */
+
+	bool		deadlock_thread_active;	/*!< True if the deadlock
+						detector thread is running */
+
 
   /**
     Constructor.
@@ -950,6 +1000,17 @@ class lock_sys_t
 
   /** Closes the lock system at database shutdown. */
   void close();
+
+  /**
+    Get the mutex that protects the record lock queue of a page.
+
+    @param[in] hash_val lock_rec_hash() of the page
+    @return the shard mutex
+  */
+  LockMutex* get_shard_mutex(ulint hash_val)
+  {
+    return &shards[hash_val & (LOCK_SYS_N_SHARDS - 1)].mutex;
+  }
 };
 
 /*********************************************************************//**
@@ -1012,7 +1073,7 @@ lock_rec_create_low(
 	trx_t*		trx,
 	bool		holds_trx_mutex);
 /** Enqueue a waiting request for a lock which cannot be granted immediately.
-Check for deadlocks.
+The wait will be checked for deadlocks by lock_deadlock_detect_thread.
 @param[in]	type_mode	the requested lock mode (LOCK_S or LOCK_X)
 				possibly ORed with LOCK_GAP or
 				LOCK_REC_NOT_GAP, ORed with
@@ -1026,7 +1087,6 @@ Check for deadlocks.
 @param[in,out]	thr		query thread
 @param[in]	prdt		minimum bounding box (spatial index)
 @retval	DB_LOCK_WAIT		if the waiting lock was enqueued
-@retval	DB_DEADLOCK		if this transaction was chosen as the victim
 @retval	DB_SUCCESS_LOCKED_REC	if the other transaction was chosen as a victim
 				(or it happened to commit) */
 dberr_t
@@ -1065,23 +1125,33 @@ lock_rec_free_all_from_discard_page(
 /** The lock system */
 extern lock_sys_t lock_sys;
 
-/** Test if lock_sys.mutex can be acquired without waiting. */
+/** Try to acquire lock_sys.latch in exclusive mode without waiting.
+@return nonzero if the latch could not be acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys.mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(lock_sys.latch))
 
-/** Test if lock_sys.mutex is owned. */
-#define lock_mutex_own() (lock_sys.mutex.is_owned())
+/** Test if lock_sys.latch is held in exclusive mode. */
+#define lock_mutex_own() rw_lock_own(lock_sys.latch, RW_LOCK_X)
 
-/** Acquire the lock_sys.mutex. */
+/** Acquire lock_sys.latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys.mutex);		\
+	rw_lock_x_lock(lock_sys.latch);		\
 } while (0)
 
-/** Release the lock_sys.mutex. */
+/** Release lock_sys.latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys.mutex.exit();			\
+	rw_lock_x_unlock(lock_sys.latch);		\
 } while (0)
 
+/** Test if the record lock queue of a page may be accessed, that is,
+lock_sys.latch is held in exclusive mode, or lock_sys.latch is held in
+shared mode together with the shard mutex of the page.
+@param hash_val	lock_rec_hash() of the page */
+#define lock_rec_queue_own(hash_val)					\
+	(lock_mutex_own()						\
+	 || (rw_lock_own(lock_sys.latch, RW_LOCK_S)				\
+	     && mutex_own(lock_sys.get_shard_mutex(hash_val))))
+
 /** Test if lock_sys.wait_mutex is owned. */
 #define lock_wait_mutex_own() (lock_sys.wait_mutex.is_owned())
 
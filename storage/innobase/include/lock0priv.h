@@ -110,7 +110,9 @@ operator<<(std::ostream& out, const lock_rec_t& lock)
 	return(lock.print(out));
 }
 
-/** Lock struct; protected by lock_sys.mutex */
+/** Lock struct; protected by lock_sys.latch in exclusive mode, or for
+record locks, by lock_sys.latch in shared mode together with the
+shard mutex of the page */
 struct lock_t {
 	trx_t*		trx;		/*!< transaction owning the
 					lock */
@@ -262,7 +264,7 @@ transactions */
 static const ulint	LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK = 200;
 
 /** When releasing transaction locks, this specifies how often we release
-the lock mutex for a moment to give also others access to it */
+lock_sys.latch for a moment to give also others access to it */
 static const ulint	LOCK_RELEASE_INTERVAL = 1000;
 
 /* Safety margin when creating a new record lock: this many extra records
@@ -547,9 +549,6 @@ static const byte lock_strength_matrix[5][5] = {
  /* AI */ {  FALSE, FALSE, FALSE, FALSE,  TRUE}
 };
 
-/** Maximum depth of the DFS stack. */
-static const ulint MAX_STACK_SIZE = 4096;
-
 #define PRDT_HEAPNO	PAGE_HEAP_NO_INFIMUM
 /** Record locking request status */
 enum lock_rec_req_status {
@@ -59,17 +59,35 @@ typedef ulint (*log_checksum_func_t)(const byte* log_block);
 log_sys.mutex. */
 extern log_checksum_func_t log_checksum_algorithm_ptr;
 
-/** Append a string to the log.
-@param[in]	str		string
-@param[in]	len		string length
-@param[out]	start_lsn	start LSN of the log record
-@return end lsn of the log record, zero if did not succeed */
-UNIV_INLINE
-lsn_t
-log_reserve_and_write_fast(
-	const void*	str,
-	ulint		len,
-	lsn_t*		start_lsn);
+/** Number of log_buf_range_t reservations that may be in progress
+concurrently; see log_t::copy_slots */
+#define LOG_BUF_COPY_SLOTS	1024
+
+/** Number of events that threads wait on in log_write_up_to() while
+log_writer_thread or log_flusher_thread is making progress; see
+log_t::write_events */
+#define LOG_WAIT_EVENTS		1024
+
+/** A range of the redo log buffer that was reserved by log_buf_reserve().
+The owner fills the range by log_buf_write() without holding
+log_sys.mutex, and finally publishes it by log_buf_close(). */
+struct log_buf_range_t {
+	/** the log buffer that the range was reserved in */
+	byte*		buf;
+	/** offset of the next byte to write within buf */
+	ulint		offset;
+	/** LSN of the next byte to write */
+	lsn_t		lsn;
+	/** start LSN of the range */
+	lsn_t		start_lsn;
+	/** end LSN of the range */
+	lsn_t		end_lsn;
+	/** log_sys.next_checkpoint_no at the time of the reservation */
+	ib_uint64_t	checkpoint_no;
+	/** reservation sequence number */
+	ib_uint64_t	seq;
+};
+
 /***********************************************************************//**
 Checks if there is need for a log buffer flush or a new checkpoint, and does
 this if yes. Any database operation should call this when it has modified
@@ -93,26 +111,52 @@ void
 log_margin_checkpoint_age(
 	ulint	len);
 
-/** Open the log for log_write_low. The log must be closed with log_close.
+/** Ensure that there is enough space in the log buffer for a write.
+The caller must hold log_sys.mutex; it may be released and reacquired.
 @param[in]	len	length of the data to be written
 @return start lsn of the log record */
 lsn_t
 log_reserve_and_open(
 	ulint	len);
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+
+/** Reserve a range of the redo log buffer for a log record group, and
+advance log_sys.lsn past it. The caller must hold log_sys.mutex and must
+have invoked log_reserve_and_open(len). After the mutex has been released,
+the records must be copied by log_buf_write() and the range must be
+published by log_buf_close().
+@param[in]	len	length of the log record group, in bytes
+@param[out]	range	the reserved range */
 void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len);	/*!< in: string length */
-/************************************************************//**
-Closes the log.
-@return lsn */
-lsn_t
-log_close(void);
-/*===========*/
+log_buf_reserve(
+	ulint			len,
+	log_buf_range_t&	range);
+
+/** Copy log records to a range that was reserved by log_buf_reserve().
+log_sys.mutex need not be held.
+@param[in,out]	range	reserved range
+@param[in]	str	log records
+@param[in]	len	length of str, in bytes */
+void
+log_buf_write(
+	log_buf_range_t&	range,
+	const byte*		str,
+	ulint			len);
+
+/** Publish a range that was completely filled by log_buf_write(),
+so that log_write_up_to() may write it to the log file.
+log_sys.mutex need not be held.
+@param[in]	range	reserved and filled range */
+void
+log_buf_close(
+	const log_buf_range_t&	range);
+
+/** Wait until all log_buf_reserve() ranges have been published by
+log_buf_close(). The caller must hold log_sys.mutex, which will be
+released while waiting, and must have set log_sys.is_extending, which
+prevents new reservations. */
+void
+log_buf_wait_copied();
+
 /************************************************************//**
 Gets the current lsn.
 @return current lsn */
@@ -164,8 +208,9 @@ log_set_capacity(ulonglong file_size)
 /******************************************************//**
 This function is called, e.g., when a transaction wants to commit. It checks
 that the log has been written to the log file up to the last log entry written
-by the transaction. If there is a flush running, it waits and checks if the
-flush flushed enough. If not, starts a new flush. */
+by the transaction. If log_writer_thread and log_flusher_thread are running,
+it waits for them to make progress. Otherwise, if there is a flush running,
+it waits and checks if the flush flushed enough. If not, starts a new flush. */
 void
 log_write_up_to(
 /*============*/
@@ -174,6 +219,9 @@ log_write_up_to(
 	bool	flush_to_disk);
 			/*!< in: true if we want the written log
 			also to be flushed to disk */
+/** Start log_writer_thread and log_flusher_thread. */
+void
+log_writer_threads_start();
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -512,10 +560,35 @@ struct log_t{
 	lsn_t		lsn;		/*!< log sequence number */
 	ulong		buf_free;	/*!< first free offset within the log
 					buffer in use */
+	ib_uint64_t	n_reserved;	/*!< number of log_buf_reserve()
+					calls; protected by mutex */
+	ib_uint64_t	n_copied;	/*!< number of reserved ranges whose
+					log_buf_close() has been observed,
+					in reservation order; protected
+					by mutex */
+	lsn_t		copied_lsn;	/*!< the log buffer has been
+					filled contiguously up to this lsn,
+					which log_write_up_to() may write
+					while later ranges are still being
+					copied; protected by mutex */
 
 	MY_ALIGNED(CACHE_LINE_SIZE)
 	LogSysMutex	mutex;		/*!< mutex protecting the log */
 	MY_ALIGNED(CACHE_LINE_SIZE)
+	lsn_t		copy_slots[LOG_BUF_COPY_SLOTS];
+					/*!< end lsn of each published
+					log_buf_range_t that has not been
+					accounted in copied_lsn yet, or 0;
+					indexed by log_buf_range_t::seq
+					modulo LOG_BUF_COPY_SLOTS. Written
+					by log_buf_close() without holding
+					mutex. */
+	int32		n_copy_waiters;	/*!< number of threads that are
+					waiting for copied_event; updated
+					by atomic operations */
+	os_event_t	copied_event;	/*!< set by log_buf_close() when
+					n_copy_waiters > 0 */
+	MY_ALIGNED(CACHE_LINE_SIZE)
 	LogSysMutex	write_mutex;	/*!< mutex protecting writing to log */
 	MY_ALIGNED(CACHE_LINE_SIZE)
 	FlushOrderMutex	log_flush_order_mutex;/*!< mutex to serialize access to
@@ -637,6 +710,37 @@ struct log_t{
 					when a flush is running;
 					os_event_set() and os_event_reset()
 					are protected by log_sys_t::mutex */
+	/* @} */
+
+	/** Fields of log_writer_thread and log_flusher_thread @{ */
+	os_event_t	writer_event;	/*!< wakes up log_writer_thread */
+	os_event_t	flusher_event;	/*!< wakes up log_flusher_thread */
+	lsn_t		write_requested_lsn;/*!< largest lsn that a thread
+					has asked to be written; updated by
+					atomic operations */
+	lsn_t		flush_requested_lsn;/*!< largest lsn that a thread
+					has asked to be flushed; updated by
+					atomic operations */
+	os_event_t	write_events[LOG_WAIT_EVENTS];
+					/*!< set by log_writer_thread when
+					write_lsn has advanced past a log
+					block; indexed by the log block
+					number modulo LOG_WAIT_EVENTS */
+	os_event_t	flush_events[LOG_WAIT_EVENTS];
+					/*!< set by log_flusher_thread when
+					flushed_to_disk_lsn has advanced past
+					a log block; indexed like
+					write_events */
+	bool		writer_threads_active;
+					/*!< whether log_write_up_to() may
+					wait for log_writer_thread and
+					log_flusher_thread */
+	ulint		n_writer_threads;/*!< number of log_writer_thread
+					and log_flusher_thread that are
+					running */
+	/* @} */
+
+	/** Statistics @{ */
 	ulint		n_log_ios;	/*!< number of log i/os initiated thus
 					far */
 	ulint		n_log_ios_old;	/*!< number of log i/o's at the
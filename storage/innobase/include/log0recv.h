@@ -214,6 +214,10 @@ struct recv_dblwr_t {
 	list	pages;
 };
 
+/** Maximum number of threads that apply a batch of redo log records
+(recv_apply_hashed_log_recs() and the recv_apply_thread() it starts) */
+#define RECV_MAX_APPLY_THREADS	64
+
 /** Recovery system data structure */
 struct recv_sys_t{
 	ib_mutex_t		mutex;	/*!< mutex protecting the fields apply_log_recs,
@@ -275,6 +279,21 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+	/** number of recv_apply_thread() that have not finished
+	their share of the current batch; protected by mutex */
+	ulint		n_apply_threads;
+	/** signalled when n_apply_threads reaches 0 */
+	os_event_t	apply_done;
+	/** Progress of each thread in the current batch */
+	struct apply_progress_t {
+		/** number of pages to which log was applied */
+		ulint	applied;
+		/** number of pages for which reads were posted */
+		ulint	read;
+	};
+	/** progress of recv_apply_hashed_log_recs() and each
+	recv_apply_thread(); protected by mutex */
+	apply_progress_t apply_progress[RECV_MAX_APPLY_THREADS];
 
 	recv_dblwr_t	dblwr;
 
@@ -43,6 +43,9 @@ Created 10/21/1995 Heikki Tuuri
 #include <dirent.h>
 #include <sys/stat.h>
 #include <time.h>
+#ifdef LINUX_IO_URING
+#include <sys/uio.h>
+#endif /* LINUX_IO_URING */
 #endif /* !_WIN32 */
 
 /** File node of a tablespace or the log data space */
@@ -1466,6 +1469,19 @@ os_aio_wait_until_no_pending_writes();
 void
 os_aio_simulated_wake_handler_threads();
 
+#ifdef LINUX_IO_URING
+/** Register memory ranges as io_uring fixed buffers, so that the kernel
+need not map the pages for each read or write that targets them.
+@param[in]	bufs	memory ranges, such as the buffer pool chunks
+@param[in]	n	number of memory ranges */
+void
+os_aio_register_buffers(const struct iovec* bufs, ulint n);
+
+/** Unregister the io_uring fixed buffers before the memory is freed. */
+void
+os_aio_unregister_buffers();
+#endif /* LINUX_IO_URING */
+
 #ifdef _WIN32
 /** This function can be called if one wants to post a batch of reads and
 prefers an i/o-handler thread to handle them all at once later. You must
@@ -121,6 +121,36 @@ exiting. If false, another thread is responsible for joining this thread */
 ATTRIBUTE_NORETURN ATTRIBUTE_COLD
 void os_thread_exit(bool detach = true);
 
+/** Work of os_thread_run(), which each thread does until nothing is left.
+@param[in,out]	arg	argument of os_thread_run()
+@param[in]	id	index of the thread; 0 for the calling thread */
+typedef void (*os_thread_work_t)(void* arg, ulint id);
+
+/** Do some work in the calling thread and in additional threads, and
+wait for all of them to finish.
+@param[in]	work	the work of each thread
+@param[in,out]	arg	argument of work and wait
+@param[in]	n	number of threads to create in addition to
+			the calling thread
+@param[in]	key	performance schema key of the created threads
+@param[in]	wait	function to invoke about once per second while
+			waiting for the created threads, or NULL */
+void
+os_thread_run_func(
+	os_thread_work_t	work,
+	void*			arg,
+	ulint			n,
+#ifdef UNIV_PFS_THREAD
+	mysql_pfs_key_t		key,
+#endif /* UNIV_PFS_THREAD */
+	void			(*wait)(void* arg));
+
+#ifdef UNIV_PFS_THREAD
+# define os_thread_run(w, a, n, k, f)	os_thread_run_func(w, a, n, k, f)
+#else /* UNIV_PFS_THREAD */
+# define os_thread_run(w, a, n, k, f)	os_thread_run_func(w, a, n, f)
+#endif /* UNIV_PFS_THREAD */
+
 /*****************************************************************//**
 Returns the thread identifier of current thread.
 @return current thread identifier */
@@ -44,8 +44,12 @@ Created 2/16/1997 Heikki Tuuri
 
 
 /**
-  Read view lists the trx ids of those transactions for which a consistent read
-  should not see the modifications to the database.
+  Read view determines the transactions whose modifications a consistent read
+  should see: those that were committed before the view was created.
+
+  The view only remembers the value of trx_sys.get_max_trx_id() at its
+  creation. Transactions are assigned commit sequence numbers from the same
+  counter, and trx_sys.csn_map maps transaction identifiers to them.
 */
 class ReadView
 {
@@ -78,8 +82,9 @@ class ReadView
     Copy state from another view.
 
     This method is used to find min(m_low_limit_no), min(m_low_limit_id) and
-    all transaction ids below min(m_low_limit_id). These values effectively
-    form oldest view.
+    min(m_up_limit_id). These values effectively form oldest view: the
+    changes of a transaction are visible in every view if its commit
+    sequence number is smaller than min(m_low_limit_id).
 
     @param other    view to copy from
   */
@@ -90,32 +95,8 @@ class ReadView
       m_low_limit_no= other.m_low_limit_no;
     if (m_low_limit_id > other.m_low_limit_id)
       m_low_limit_id= other.m_low_limit_id;
-
-    trx_ids_t::iterator dst= m_ids.begin();
-    for (trx_ids_t::const_iterator src= other.m_ids.begin();
-         src != other.m_ids.end(); src++)
-    {
-      if (*src >= m_low_limit_id)
-        break;
-loop:
-      if (dst == m_ids.end())
-      {
-        m_ids.push_back(*src);
-        dst= m_ids.end();
-        continue;
-      }
-      if (*dst < *src)
-      {
-        dst++;
-        goto loop;
-      }
-      else if (*dst > *src)
-        dst= m_ids.insert(dst, *src) + 1;
-    }
-    m_ids.erase(std::lower_bound(dst, m_ids.end(), m_low_limit_id),
-                m_ids.end());
-
-    m_up_limit_id= m_ids.empty() ? m_low_limit_id : m_ids.front();
+    if (m_up_limit_id > other.m_up_limit_id)
+      m_up_limit_id= other.m_up_limit_id;
     ut_ad(m_up_limit_id <= m_low_limit_id);
   }
 
@@ -215,13 +196,9 @@ class ReadView
 		if (id >= m_low_limit_id) {
 
 			return(false);
-
-		} else if (m_ids.empty()) {
-
-			return(true);
 		}
 
-		return(!std::binary_search(m_ids.begin(), m_ids.end(), id));
+		return(committed_before(id));
 	}
 
 	/**
@@ -259,23 +236,29 @@ class ReadView
 
 
 private:
+	/** Check whether a transaction committed before the view was
+	created, by looking up its commit sequence number.
+	@param[in]	id	transaction id, m_up_limit_id <= id < m_low_limit_id
+	@return whether the view sees the modifications of id */
+	bool committed_before(trx_id_t id) const;
+
 	/** The read should not see any transaction with trx id >= this
-	value. In other words, this is the "high water mark". */
+	value. In other words, this is the "high water mark". It also is
+	the commit sequence number of the view: the read sees exactly the
+	transactions whose commit sequence number is smaller than this. */
 	trx_id_t	m_low_limit_id;
 
 	/** The read should see all trx ids which are strictly
 	smaller (<) than this value.  In other words, this is the
-	low water mark". */
+	low water mark". This is a lower bound of the transactions that
+	were active when the view was created; see
+	trx_sys_t::update_min_active_id(). */
 	trx_id_t	m_up_limit_id;
 
 	/** trx id of creating transaction, set to TRX_ID_MAX for free
 	views. */
 	trx_id_t	m_creator_trx_id;
 
-	/** Set of RW transactions that was active when this snapshot
-	was taken */
-	trx_ids_t	m_ids;
-
 	/** The view does not need to see the undo logs for transactions
 	whose transaction number is strictly smaller (<) than this value:
 	they can be removed in purge if not needed by other views */
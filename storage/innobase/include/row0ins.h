@@ -54,6 +54,47 @@ row_ins_check_foreign_constraint(
 	dtuple_t*	entry,	/*!< in: index entry for index */
 	que_thr_t*	thr)	/*!< in: query thread */
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/** Foreign key checks of a multi-row insert statement that are
+deferred by row_ins_check_foreign_constraints() and verified in
+key order by row_ins_fk_batch_check() */
+struct row_ins_fk_batch_t;
+
+/** Start deferring the foreign key checks of a multi-row insert.
+@param[in]	table	table where the rows are inserted
+@param[in]	trx	transaction
+@return the deferred checks, or NULL if each row must be checked
+when it is inserted */
+row_ins_fk_batch_t*
+row_ins_fk_batch_create(const dict_table_t* table, const trx_t* trx)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Determine if the deferred checks should be verified before
+further rows are inserted.
+@param[in]	batch	deferred foreign key checks
+@return whether the memory limit was reached */
+bool
+row_ins_fk_batch_full(const row_ins_fk_batch_t* batch)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Verify the deferred foreign key checks, in the order of the keys
+of each referenced index. The parent records that are on the same
+leaf page are looked up and locked within one latching of the page.
+After a lock wait, the verification must be resumed by invoking this
+function again. On any other error, the remaining checks are
+discarded, because the statement will be rolled back.
+@param[in,out]	batch	deferred foreign key checks
+@param[in,out]	thr	query thread
+@return DB_SUCCESS, DB_LOCK_WAIT, DB_NO_REFERENCED_ROW, or error code */
+dberr_t
+row_ins_fk_batch_check(row_ins_fk_batch_t* batch, que_thr_t* thr)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Free deferred foreign key checks.
+@param[in,out]	batch	deferred foreign key checks */
+void
+row_ins_fk_batch_free(row_ins_fk_batch_t* batch)
+	MY_ATTRIBUTE((nonnull));
+
 /*********************************************************************//**
 Creates an insert node struct.
 @return own: insert node struct */
@@ -214,6 +255,12 @@ struct ins_node_t{
 				/* This is the first index that reported
 				DB_DUPLICATE_KEY.  Used in the case of REPLACE
 				or INSERT ... ON DUPLICATE UPDATE. */
+	/** buffered inserts into an empty table, or NULL
+	(see row_insert_for_mysql() and row_merge_bulk_apply()) */
+	row_merge_bulk_t*	bulk;
+	/** foreign key checks that are deferred until the end of a
+	multi-row insert, or NULL (see row_insert_for_mysql()) */
+	row_ins_fk_batch_t*	fk_batch;
 	ulint		magic_n;
 };
 
@@ -131,7 +131,9 @@ struct index_def_t {
 /** Structure for reporting duplicate records. */
 struct row_merge_dup_t {
 	dict_index_t*		index;	/*!< index being sorted */
-	struct TABLE*		table;	/*!< MySQL table object */
+	struct TABLE*		table;	/*!< MySQL table object, or NULL
+					to count duplicates without
+					reporting them */
 	const ulint*		col_map;/*!< mapping of column numbers
 					in table to the rebuilt table
 					(index->table), or NULL if not
@@ -139,6 +141,33 @@ struct row_merge_dup_t {
 	ulint			n_dup;	/*!< number of duplicates */
 };
 
+/** Progress of building one index in row_merge_build_parallel(). The
+threads add their progress to a shared total, which the thread that
+executes the statement reports to the client. */
+struct row_merge_progress_t {
+	/** transaction of the statement */
+	trx_t*		trx;
+	/** the thread that executes the statement */
+	os_thread_id_t	thread;
+	/** innodb_onlineddl_pct_progress before the indexes were built */
+	ulint		base;
+	/** progress when all indexes have been built,
+	in hundredths of a percent */
+	ulint		total;
+	/** progress of all threads, in hundredths of a percent */
+	ulint*		done;
+	/** progress percent of this index that was already reported
+	by an earlier phase */
+	double		offset;
+	/** progress of this index that was added to done */
+	ulint		reported;
+
+	/** Add the progress of this index to the total, and update
+	innodb_onlineddl_pct_progress and the client progress report.
+	@param[in]	curr	progress percent of the current phase */
+	void report(double curr);
+};
+
 /*************************************************************//**
 Report a duplicate key. */
 void
@@ -413,6 +442,8 @@ row_merge_file_create(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in,out]	progress	progress of row_merge_build_parallel(),
+or NULL if the progress is updated according to update_progress
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -427,7 +458,8 @@ row_merge_sort(
 	const double	pct_cost,
 	row_merge_block_t*	crypt_block,
 	ulint			space,
-	ut_stage_alter_t*	stage = NULL)
+	ut_stage_alter_t*	stage = NULL,
+	row_merge_progress_t*	progress = NULL)
 	MY_ATTRIBUTE((warn_unused_result));
 
 /*********************************************************************//**
@@ -488,4 +520,59 @@ row_merge_read_rec(
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space)	   /*!< in: space id */
 	MY_ATTRIBUTE((warn_unused_result));
+
+/** Buffered inserts into an empty table. The index entries are
+sorted and loaded into each index by row_merge_bulk_apply(). */
+struct row_merge_bulk_t;
+
+/** Create a buffer for inserting into an empty table.
+@param[in]	trx		transaction that wrote TRX_UNDO_EMPTY
+@param[in,out]	table		empty table
+@param[in,out]	mysql_table	MySQL table, for reporting duplicates
+@return the buffer */
+row_merge_bulk_t*
+row_merge_bulk_create(
+	const trx_t*	trx,
+	dict_table_t*	table,
+	struct TABLE*	mysql_table)
+	MY_ATTRIBUTE((warn_unused_result, nonnull, malloc));
+
+/** Determine if an index entry is small enough to be buffered.
+Larger records would not fit in the merge file buffers.
+@param[in]	index	index of the table
+@param[in]	entry	index entry
+@return whether row_merge_bulk_add() can buffer the entry */
+bool
+row_merge_bulk_fits(const dict_index_t* index, const dtuple_t* entry)
+	MY_ATTRIBUTE((warn_unused_result, nonnull));
+
+/** Buffer an index entry. When the buffer of the index fills up,
+it is sorted and written to a temporary file.
+@param[in,out]	bulk	bulk insert buffer
+@param[in]	i	position of the index in the table
+@param[in]	entry	index entry, which must fit
+			(see row_merge_bulk_fits())
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_add(
+	row_merge_bulk_t*	bulk,
+	ulint			i,
+	const dtuple_t*		entry,
+	trx_t*			trx)
+	MY_ATTRIBUTE((warn_unused_result, nonnull));
+
+/** Sort the buffered index entries and load them into the indexes.
+Nothing is loaded if the TRX_UNDO_EMPTY record was rolled back.
+@param[in,out]	bulk	bulk insert buffer
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_apply(row_merge_bulk_t* bulk, trx_t* trx)
+	MY_ATTRIBUTE((warn_unused_result, nonnull));
+
+/** Free a bulk insert buffer.
+@param[in,out]	bulk	bulk insert buffer */
+void
+row_merge_bulk_free(row_merge_bulk_t* bulk);
 #endif /* row0merge.h */
@@ -247,6 +247,14 @@ row_insert_for_mysql(
 	ins_mode_t		ins_mode)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Verify the foreign key checks that were deferred while inserting
+the rows of a multi-row insert statement (see row_insert_for_mysql()).
+@param[in,out]	prebuilt	table handle, with ins_node->fk_batch
+@return error code or DB_SUCCESS */
+dberr_t
+row_insert_fk_batch_check(row_prebuilt_t* prebuilt)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
 /*********************************************************************//**
 Builds a dummy query graph used in selects. */
 void
@@ -607,6 +615,32 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/** Comparison operator of a row_icp_pred_t */
+enum row_icp_op_t {
+	ROW_ICP_EQ,	/*!< field = value */
+	ROW_ICP_NE,	/*!< field <> value */
+	ROW_ICP_LT,	/*!< field < value */
+	ROW_ICP_LE,	/*!< field <= value */
+	ROW_ICP_GT,	/*!< field > value */
+	ROW_ICP_GE,	/*!< field >= value */
+	ROW_ICP_IN	/*!< field IN (values) */
+};
+
+/** A comparison of a fixed-length index field with constants, derived
+from the pushed index condition by ha_innobase::idx_cond_push(). It is
+evaluated on the index record without converting it to the MySQL format.
+The values are in the InnoDB format, which compares correctly by memcmp()
+for the column types that are compiled. */
+struct row_icp_pred_t {
+	ulint		field_no;	/*!< field number in the index */
+	ulint		len;		/*!< length of the field and of
+					each value */
+	row_icp_op_t	op;		/*!< comparison operator */
+	ulint		n_values;	/*!< number of values; more than
+					1 only for ROW_ICP_IN */
+	const byte*	values;		/*!< n_values * len bytes */
+};
+
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
@@ -677,6 +711,17 @@ struct row_prebuilt_t {
 					(VARCHAR can be off-page too) */
 	unsigned	versioned_write:1;/*!< whether this is
 					a versioned write */
+	unsigned	bulk_insert:1;	/*!< set by
+					ha_innobase::start_bulk_insert();
+					row_insert_for_mysql() may buffer
+					the rows if the table is empty */
+	unsigned	ignore_dup_key:1;/*!< set when MySQL calls
+					ha_innobase::extra with the
+					argument HA_EXTRA_IGNORE_DUP_KEY;
+					duplicates cannot be buffered then */
+	unsigned	hot_row_queue:1;/*!< whether the updates of a row
+					by its primary key wait in a hot row
+					queue; see lock_hot_row_t */
 	mysql_row_templ_t* mysql_template;/*!< template used to transform
 					rows fast between MySQL and Innobase
 					formats; memory for this template
@@ -829,6 +874,22 @@ struct row_prebuilt_t {
 					not used. */
 	ulint		idx_cond_n_cols;/*!< Number of fields in idx_cond_cols.
 					0 if and only if idx_cond == NULL. */
+	const row_icp_pred_t*
+			idx_cond_pred;	/*!< In ICP, the comparisons that are
+					implied by the index condition and
+					that can be evaluated on the index
+					record, or NULL */
+	ulint		idx_cond_n_pred;/*!< Number of elements in
+					idx_cond_pred; 0 if idx_cond == NULL */
+	const dtuple_t*	idx_cond_end;	/*!< In ICP, the end of the range
+					that is being scanned, in the format
+					of the index, or NULL; only set if
+					idx_cond_n_pred > 0 */
+	int		idx_cond_end_on_equal;
+					/*!< the result of comparing a record
+					that is equal to idx_cond_end:
+					1 if the range ends before the key,
+					-1 if after it, 0 if at it */
 	/*----------------------*/
 
 	/*----------------------*/
@@ -0,0 +1,79 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel consistent read of a clustered index
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "rem0types.h"
+
+struct trx_t;
+struct dict_index_t;
+
+/** Maximum number of threads that may be scanning clustered indexes
+in parallel at any time, in all row_pread_scan() calls */
+#define ROW_PREAD_MAX_THREADS	256
+
+/** Callback for row_pread_scan(). Invoked on each clustered index record
+version that is visible in the read view and not delete-marked.
+Invocations from different threads may run concurrently.
+@param[in]	rec	clustered index record (or an old version of it)
+@param[in]	offsets	rec_get_offsets(rec, index)
+@param[in]	thread	index of the scanning thread,
+			less than the n_threads passed to row_pread_scan()
+@param[in,out]	arg	the argument passed to row_pread_scan()
+@return	whether the scan should continue */
+typedef bool (*row_pread_func_t)(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	ulint		thread,
+	void*		arg);
+
+/** Scan a clustered index in a consistent read, using several threads.
+The index is partitioned into key ranges based on the node pointers in the
+upper levels of the B-tree, and the ranges are handed out to the threads
+until all of them have been scanned.
+@param[in,out]	trx		transaction
+@param[in]	latest		whether to read the latest version of
+				each record instead of using the read
+				view of trx
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads to use,
+				including the calling thread
+@param[in]	func		callback for each visible record
+@param[in,out]	arg		argument for func
+@return	error code
+@retval	DB_SUCCESS		if all ranges were scanned
+@retval	DB_INTERRUPTED		if the statement was killed
+@retval	DB_END_OF_INDEX		if func returned false */
+dberr_t
+row_pread_scan(
+	trx_t*			trx,
+	bool			latest,
+	dict_index_t*		index,
+	ulint			n_threads,
+	row_pread_func_t	func,
+	void*			arg)
+	MY_ATTRIBUTE((nonnull(1,3,5), warn_unused_result));
+
+#endif /* row0pread_h */
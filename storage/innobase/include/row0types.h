@@ -49,6 +49,9 @@ struct row_ext_t;
 /** Buffer for logging modifications during online index creation */
 struct row_log_t;
 
+/** Buffered inserts into an empty table */
+struct row_merge_bulk_t;
+
 /* MySQL data types */
 struct TABLE;
 
@@ -35,10 +35,181 @@ Created 2/6/1997 Heikki Tuuri
 #include "rem0types.h"
 #include "mtr0mtr.h"
 #include "dict0mem.h"
+#include "ut0mutex.h"
 
 // Forward declaration
 class ReadView;
 
+/** Cache of clustered index record versions that were reconstructed
+from undo log records for consistent reads.
+
+The version that a read view sees is determined by the newest version
+of the record, which is identified by its primary key, DB_TRX_ID and
+DB_ROLL_PTR, and by ReadView::low_limit_id(). Readers whose view is
+behind a frequently updated row can thus share the result instead of
+applying the same undo log records again.
+
+DB_TRX_ID and DB_ROLL_PTR alone do not identify the record: after a
+rollback to a savepoint, the transaction writes its next undo log
+record at the same position, possibly for another row.
+
+The cache is direct-mapped and partitioned by the hash of the key;
+each partition is protected by its own mutex. Entries that no read
+view can look up any more are removed by purge. */
+class row_vers_cache_t
+{
+	/** A cached version */
+	struct entry_t
+	{
+		/** identifier of the clustered index */
+		index_id_t	index_id;
+		/** DB_TRX_ID of the newest version of the record */
+		trx_id_t	trx_id;
+		/** DB_ROLL_PTR of the newest version of the record */
+		roll_ptr_t	roll_ptr;
+		/** ReadView::low_limit_id() of the readers,
+		or 0 if the entry is unused */
+		trx_id_t	low_limit_id;
+		/** primary key of the record (see make_key()), followed
+		by a copy of the old version including the record header;
+		NULL if the entry is unused */
+		byte*		buf;
+		/** length of the primary key in buf */
+		ulint		key_len;
+		/** rec_offs_size() of the old version,
+		or 0 if the record did not exist in the view */
+		ulint		size;
+		/** rec_offs_extra_size() of the old version */
+		ulint		extra_size;
+	};
+
+	/** A partition of the cache */
+	struct part_t
+	{
+		/** mutex protecting entries */
+		ib_mutex_t	mutex;
+		/** the cached versions */
+		entry_t*	entries;
+	};
+
+	/** Number of partitions */
+	static const ulint N_PARTS = 64;
+
+	/** Partitions, or NULL if the cache is disabled */
+	part_t*		m_parts;
+	/** Number of entries in each partition */
+	ulint		m_n_entries;
+
+	/** Look up the entry of a key.
+	@param[in]	index_id	clustered index identifier
+	@param[in]	trx_id		DB_TRX_ID of the newest version
+	@param[in]	roll_ptr	DB_ROLL_PTR of the newest version
+	@param[in]	low_limit_id	ReadView::low_limit_id()
+	@param[out]	part		partition of the entry
+	@return the entry that the key maps to */
+	entry_t* get(
+		index_id_t	index_id,
+		trx_id_t	trx_id,
+		roll_ptr_t	roll_ptr,
+		trx_id_t	low_limit_id,
+		part_t**	part) const
+	{
+		ulint	fold = ut_fold_ulint_pair(
+			ut_fold_ull(roll_ptr),
+			ut_fold_ulint_pair(ulint(low_limit_id),
+					   ulint(index_id ^ trx_id)));
+		*part = &m_parts[fold % N_PARTS];
+		return(&(*part)->entries[(fold / N_PARTS) % m_n_entries]);
+	}
+
+	/** Release the memory of an entry and mark it unused.
+	@param[in,out]	entry	cached version */
+	static void discard(entry_t* entry)
+	{
+		ut_free(entry->buf);
+		entry->buf = NULL;
+		entry->low_limit_id = 0;
+	}
+
+public:
+	row_vers_cache_t() : m_parts(NULL), m_n_entries(0) {}
+
+	/** Create the cache.
+	@param[in]	n_entries	number of cached versions,
+					or 0 to disable the cache */
+	void create(ulint n_entries);
+
+	/** Free the cache. */
+	void close();
+
+	/** @return whether the cache is enabled */
+	bool enabled() const { return(m_parts != NULL); }
+
+	/** Copy the primary key of a clustered index record.
+	@param[in]	index		clustered index
+	@param[in]	rec		clustered index record
+	@param[in]	offsets		rec_get_offsets(rec, index)
+	@param[in,out]	heap		memory heap for the key
+	@param[out]	key_len		length of the key
+	@return the primary key, to be passed to find() and insert() */
+	static const byte* make_key(
+		const dict_index_t*	index,
+		const rec_t*		rec,
+		const ulint*		offsets,
+		mem_heap_t*		heap,
+		ulint*			key_len);
+
+	/** Look up the version of a clustered index record that a read
+	view sees.
+	@param[in]	index		clustered index
+	@param[in]	key		make_key() of the newest version
+	@param[in]	key_len		length of key
+	@param[in]	trx_id		DB_TRX_ID of the newest version
+	@param[in]	roll_ptr	DB_ROLL_PTR of the newest version
+	@param[in]	view		read view
+	@param[in,out]	heap		memory heap for *old_vers
+	@param[out]	old_vers	copy of the version, or NULL if
+					the record does not exist in the view
+	@return whether the version was found in the cache */
+	bool find(
+		const dict_index_t*	index,
+		const byte*		key,
+		ulint			key_len,
+		trx_id_t		trx_id,
+		roll_ptr_t		roll_ptr,
+		const ReadView*		view,
+		mem_heap_t*		heap,
+		rec_t**			old_vers) const;
+
+	/** Store the version of a clustered index record that a read
+	view sees.
+	@param[in]	index		clustered index
+	@param[in]	key		make_key() of the newest version
+	@param[in]	key_len		length of key
+	@param[in]	trx_id		DB_TRX_ID of the newest version
+	@param[in]	roll_ptr	DB_ROLL_PTR of the newest version
+	@param[in]	view		read view
+	@param[in]	old_vers	the version, or NULL if the record
+					does not exist in the view
+	@param[in]	offsets		rec_get_offsets(old_vers, index) */
+	void insert(
+		const dict_index_t*	index,
+		const byte*		key,
+		ulint			key_len,
+		trx_id_t		trx_id,
+		roll_ptr_t		roll_ptr,
+		const ReadView*		view,
+		const rec_t*		old_vers,
+		const ulint*		offsets);
+
+	/** Remove the entries that no read view can look up any more.
+	@param[in]	limit	low_limit_id() of the oldest read view */
+	void prune(trx_id_t limit);
+};
+
+/** The cache of old record versions */
+extern row_vers_cache_t	row_vers_cache;
+
 /** Determine if an active transaction has inserted or modified a secondary
 index record.
 @param[in,out]	caller_trx	trx of current thread
@@ -143,6 +143,7 @@ enum monitor_id_t {
 	MONITOR_TIMEOUT,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
+	MONITOR_LOCK_HOT_ROW_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
 	MONITOR_RECLOCK_CREATED,
 	MONITOR_RECLOCK_REMOVED,
@@ -165,6 +166,7 @@ enum monitor_id_t {
 	MONITOR_OVLD_BUF_POOL_WAIT_FREE,
 	MONITOR_OVLD_BUF_POOL_READ_AHEAD,
 	MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED,
+	MONITOR_MRR_PREFETCH,
 	MONITOR_OVLD_BUF_POOL_PAGE_TOTAL,
 	MONITOR_OVLD_BUF_POOL_PAGE_MISC,
 	MONITOR_OVLD_BUF_POOL_PAGES_DATA,
@@ -244,6 +246,7 @@ enum monitor_id_t {
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_NUM_CALL,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL,
+	MONITOR_LRU_SECOND_CHANCE,
 
 	/* Buffer Page I/O specific counters. */
 	MONITOR_MODULE_BUF_PAGE,
@@ -306,6 +309,8 @@ enum monitor_id_t {
 	MONITOR_NUM_UNDO_SLOT_USED,
 	MONITOR_NUM_UNDO_SLOT_CACHED,
 	MONITOR_RSEG_CUR_SIZE,
+	MONITOR_VERS_CACHE_HIT,
+	MONITOR_VERS_CACHE_MISS,
 
 	/* Purge related counters */
 	MONITOR_MODULE_PURGE,
@@ -334,6 +339,18 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_LOG_BUF_RESERVE_WAITS,
+	MONITOR_LOG_BUF_COPY_WAITS,
+	MONITOR_LOG_BUF_COPY_TIME,
+	MONITOR_LOG_WRITE_WAITS,
+	MONITOR_LOG_WRITE_WAIT_TIME,
+	MONITOR_LOG_FLUSH_WAITS,
+	MONITOR_LOG_FLUSH_WAIT_TIME,
+	MONITOR_LOG_FLUSH_WAIT_100US,
+	MONITOR_LOG_FLUSH_WAIT_1MS,
+	MONITOR_LOG_FLUSH_WAIT_10MS,
+	MONITOR_LOG_FLUSH_WAIT_100MS,
+	MONITOR_LOG_FLUSH_WAIT_LONG,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -221,6 +221,10 @@ and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
 
+/** Whether buf_page_get_gen() accounts the accesses of the pages in
+INFORMATION_SCHEMA.INNODB_BUFFER_POOL_INDEX_STATS */
+extern my_bool		srv_buf_pool_index_stats;
+
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
 
@@ -274,6 +278,11 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+#ifdef LINUX_IO_URING
+/** innodb_use_io_uring: whether to use io_uring instead of libaio
+for the native aio on Linux */
+extern my_bool	srv_use_io_uring;
+#endif /* LINUX_IO_URING */
 extern my_bool	srv_numa_interleave;
 
 /* Use atomic writes i.e disable doublewrite buffer */
@@ -281,6 +290,9 @@ extern my_bool srv_use_atomic_writes;
 
 /* Compression algorithm*/
 extern ulong innodb_compression_algorithm;
+/** innodb_zstd_dictionary: path of the dictionary for
+innodb_compression_algorithm=zstd, or NULL */
+extern char*	srv_zstd_dictionary;
 
 /** TRUE if the server was successfully started */
 extern bool	srv_was_started;
@@ -347,6 +359,8 @@ extern ulong	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern ulong	srv_log_write_ahead_size;
+/** innodb_log_writer_threads */
+extern my_bool	srv_log_writer_threads;
 extern my_bool	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
 
@@ -464,6 +478,8 @@ extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
 extern my_bool			srv_stats_include_delete_marked;
 extern unsigned long long	srv_stats_modified_counter;
+extern ulong			srv_stats_analyze_threads;
+extern my_bool			srv_stats_auto_recalc_incremental;
 extern my_bool			srv_stats_sample_traditional;
 
 extern my_bool	srv_use_doublewrite_buf;
@@ -557,6 +573,10 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/** innodb_old_version_cache_size; the number of reconstructed old
+versions of clustered index records to cache, or 0 to disable the cache */
+extern ulong srv_old_version_cache_size;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -588,16 +608,24 @@ extern ulong srv_buf_dump_status_frequency;
 # ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	buf_dump_thread_key;
+extern mysql_pfs_key_t	dict_check_thread_key;
 extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	dict_stats_analyze_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
 extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
 extern mysql_pfs_key_t	page_cleaner_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	row_merge_thread_key;
+extern mysql_pfs_key_t	row_pread_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
+extern mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
@@ -785,7 +813,7 @@ srv_printf_innodb_monitor(
 /*======================*/
 	FILE*	file,		/*!< in: output stream */
 	ibool	nowait,		/*!< in: whether to wait for the
-				lock_sys_t::mutex */
+				lock_sys.latch */
 	ulint*	trx_start,	/*!< out: file position of the start of
 				the list of active transactions */
 	ulint*	trx_end);	/*!< out: file position of the end of
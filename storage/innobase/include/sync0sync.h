@@ -97,9 +97,12 @@ extern mysql_pfs_key_t	buf_dblwr_mutex_key;
 extern mysql_pfs_key_t	trx_mutex_key;
 extern mysql_pfs_key_t	trx_pool_mutex_key;
 extern mysql_pfs_key_t	trx_pool_manager_mutex_key;
-extern mysql_pfs_key_t	lock_mutex_key;
+extern mysql_pfs_key_t	lock_sys_shard_mutex_key;
 extern mysql_pfs_key_t	lock_wait_mutex_key;
+extern mysql_pfs_key_t	lock_hot_row_mutex_key;
 extern mysql_pfs_key_t	trx_sys_mutex_key;
+extern mysql_pfs_key_t	trx_sys_serialisation_mutex_key;
+extern mysql_pfs_key_t	row_vers_cache_mutex_key;
 extern mysql_pfs_key_t	srv_sys_mutex_key;
 extern mysql_pfs_key_t	srv_threads_mutex_key;
 extern mysql_pfs_key_t	event_mutex_key;
@@ -131,6 +134,7 @@ extern	mysql_pfs_key_t	index_online_log_key;
 extern	mysql_pfs_key_t	dict_table_stats_key;
 extern  mysql_pfs_key_t trx_sys_rw_lock_key;
 extern  mysql_pfs_key_t hash_table_locks_key;
+extern	mysql_pfs_key_t	lock_sys_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 /** Prints info of the sync system.
@@ -147,9 +147,13 @@ V
 lock_sys_wait_mutex			Mutex protecting lock timeout data
 |
 V
-lock_sys_mutex				Mutex protecting lock_sys_t
+lock_sys_latch				Latch protecting lock_sys_t
 |
 V
+lock_sys_shard_mutex			Mutex protecting the record lock
+|					queues of a subset of pages, while
+|					lock_sys_latch is held in S mode
+V
 trx_sys.mutex				Mutex protecting trx_sys_t
 |
 V
@@ -173,6 +177,12 @@ Log mutex
 Any other latch
 |
 V
+trx_sys.serialisation_mutex		Mutex protecting the list of
+|					transactions that are being committed
+V
+row_vers_cache mutex			Mutex protecting a partition of the
+|					cache of old record versions
+V
 Memory pool mutex */
 
 /** Latching order levels. If you modify these, you have to also update
@@ -193,6 +203,9 @@ enum latch_level_t {
 
 	SYNC_ANY_LATCH,
 
+	SYNC_ROW_VERS_CACHE,
+	SYNC_TRX_SERIALISATION,
+
 	SYNC_DOUBLEWRITE,
 
 	SYNC_BUF_FLUSH_LIST,
@@ -225,6 +238,7 @@ enum latch_level_t {
 	SYNC_TRX,
 	SYNC_RW_TRX_HASH_ELEMENT,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_SYS_SHARD,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -332,7 +346,11 @@ enum latch_id_t {
 	LATCH_ID_TRX,
 	LATCH_ID_LOCK_SYS,
 	LATCH_ID_LOCK_SYS_WAIT,
+	LATCH_ID_LOCK_SYS_SHARD,
+	LATCH_ID_LOCK_HOT_ROW,
 	LATCH_ID_TRX_SYS,
+	LATCH_ID_TRX_SYS_SERIALISATION,
+	LATCH_ID_ROW_VERS_CACHE,
 	LATCH_ID_SRV_SYS,
 	LATCH_ID_SRV_SYS_TASKS,
 	LATCH_ID_PAGE_ZIP_STAT_PER_INDEX,
@@ -187,7 +187,8 @@ trx_undo_report_row_operation(
 					may contain a clustered index
 					record tuple that also contains
 					virtual columns of the table;
-					otherwise, NULL */
+					otherwise, NULL (TRX_UNDO_EMPTY
+					if also rec is NULL) */
 	const upd_t*	update,		/*!< in: in the case of an update,
 					the update vector, otherwise NULL */
 	ulint		cmpl_info,	/*!< in: compiler info on secondary
@@ -310,6 +311,8 @@ trx_undo_read_v_idx(
 compilation info multiplied by 16 is ORed to this value in an undo log
 record */
 
+#define	TRX_UNDO_EMPTY		8	/*!< bulk insert into an empty
+					table; rollback empties all indexes */
 #define	TRX_UNDO_RENAME_TABLE	9	/*!< RENAME TABLE */
 #define	TRX_UNDO_INSERT_DEFAULT	10	/*!< insert a "default value"
 					pseudo-record for instant ALTER */
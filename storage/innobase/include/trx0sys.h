@@ -373,7 +373,6 @@ struct rw_trx_hash_element_t
 
 
   trx_id_t id; /* lf_hash_init() relies on this to be first in the struct */
-  trx_id_t no;
   trx_t *trx;
   ib_mutex_t mutex;
 };
@@ -464,7 +463,6 @@ class rw_trx_hash_t
     ut_ad(element->trx == 0);
     element->trx= trx;
     element->id= trx->id;
-    element->no= TRX_ID_MAX;
     trx->rw_trx_hash_element= element;
   }
 
@@ -590,10 +588,10 @@ class rw_trx_hash_t
     the transaction may get committed before this method returns.
 
     With do_ref_count == false the caller may dereference returned trx pointer
-    only if lock_sys.mutex was acquired before calling find().
+    only if lock_sys.latch was acquired before calling find().
 
     With do_ref_count == true caller may dereference trx even if it is not
-    holding lock_sys.mutex. Caller is responsible for calling
+    holding lock_sys.latch. Caller is responsible for calling
     trx->release_reference() when it is done playing with trx.
 
     Ideally this method should get caller rw_trx_hash_pins along with trx
@@ -783,6 +781,181 @@ class rw_trx_hash_t
 };
 
 
+/**
+  Map from read-write transaction identifier to commit sequence number.
+
+  Commit sequence numbers are allocated from the same counter as transaction
+  identifiers and serialisation numbers when a transaction is deregistered.
+  A read view remembers only the value of that counter at its creation:
+  transaction id is visible in the view if its commit sequence number is
+  smaller than ReadView::low_limit_id().
+
+  Registered transactions are stored in a direct-mapped array, which is read
+  without acquiring any latch. A slot is protected against concurrent
+  writers by temporarily replacing its id with LOCKED. When a slot is reused
+  while its previous entry may still be needed by a read view, the previous
+  entry is moved to a lock-free overflow hash. The purge coordinator thread
+  removes the overflow entries that no open read view needs any more.
+
+  If a transaction identifier cannot be found at all, the transaction
+  committed before any open read view was created.
+*/
+
+class trx_csn_map_t
+{
+  struct slot_t
+  {
+    /** transaction identifier, 0 if unused, LOCKED if being modified */
+    trx_id_t id;
+    /** commit sequence number, or TRX_ID_MAX if not committed */
+    trx_id_t csn;
+  };
+
+  /** Entry that was evicted from m_slots */
+  struct overflow_entry_t
+  {
+    /** transaction identifier; lf_hash_init() relies on this being first */
+    trx_id_t id;
+    /** commit sequence number, or TRX_ID_MAX if not committed */
+    trx_id_t csn;
+  };
+
+  /** Marker of a slot that is being modified */
+  static const trx_id_t LOCKED= TRX_ID_MAX;
+
+  /** Number of elements in m_slots; must be a power of 2 */
+  static const ulint N_SLOTS= 1 << 18;
+
+  /** The direct-mapped array of recently registered transactions */
+  slot_t *m_slots;
+
+  /** Number of elements in m_overflow, to skip empty lookups */
+  MY_ALIGNED(CACHE_LINE_SIZE) int32 m_n_overflow;
+
+  /**
+    Entries with smaller commit sequence numbers than this are visible in
+    every read view; see trx_sys_t::clone_oldest_view()
+  */
+  trx_id_t m_oldest;
+
+  /** Entries evicted from m_slots that may still be needed */
+  MY_ALIGNED(CACHE_LINE_SIZE) mutable LF_HASH m_overflow;
+
+
+  slot_t &get_slot(trx_id_t id) const { return m_slots[id & (N_SLOTS - 1)]; }
+
+
+  /**
+    Acquires exclusive access to a slot.
+    @return identifier that was stored in the slot
+  */
+  static trx_id_t lock_slot(slot_t &slot)
+  {
+    for (;;)
+    {
+      trx_id_t id= static_cast<trx_id_t>(my_atomic_load64_explicit(
+        reinterpret_cast<int64*>(&slot.id), MY_MEMORY_ORDER_RELAXED));
+      if (id != LOCKED &&
+          my_atomic_cas64(reinterpret_cast<int64*>(&slot.id),
+                          reinterpret_cast<int64*>(&id), int64(LOCKED)))
+        return id;
+      ut_delay(1);
+    }
+  }
+
+
+  /** Releases a slot that was locked by lock_slot(). */
+  static void unlock_slot(slot_t &slot, trx_id_t id)
+  {
+    my_atomic_store64_explicit(reinterpret_cast<int64*>(&slot.id), int64(id),
+                               MY_MEMORY_ORDER_RELEASE);
+  }
+
+public:
+  void create();
+
+
+  void close();
+
+
+  /**
+    Registers an active transaction.
+    @param id  transaction identifier
+  */
+  void insert(trx_id_t id);
+
+
+  /**
+    Assigns a commit sequence number to a registered transaction.
+    @param id   transaction identifier
+    @param csn  commit sequence number
+  */
+  void commit(trx_id_t id, trx_id_t csn);
+
+
+  /**
+    Looks up the commit sequence number of a transaction.
+
+    @param id  transaction identifier
+    @return commit sequence number
+    @retval TRX_ID_MAX if the transaction has not been committed
+    @retval 0 if the transaction was committed before any open read view
+    was created
+  */
+  trx_id_t find(trx_id_t id) const
+  {
+    const slot_t &slot= get_slot(id);
+    int64 *slot_id= reinterpret_cast<int64*>(const_cast<trx_id_t*>(&slot.id));
+
+    for (;;)
+    {
+      trx_id_t s= static_cast<trx_id_t>(
+        my_atomic_load64_explicit(slot_id, MY_MEMORY_ORDER_ACQUIRE));
+      if (s == LOCKED)
+      {
+        ut_delay(1);
+        continue;
+      }
+      if (s != id)
+        break;
+      trx_id_t csn= static_cast<trx_id_t>(my_atomic_load64_explicit(
+        reinterpret_cast<int64*>(const_cast<trx_id_t*>(&slot.csn)),
+        MY_MEMORY_ORDER_ACQUIRE));
+      /* A transaction that committed while we were reading
+      would only change csn; an evicted entry changes the id. */
+      if (static_cast<trx_id_t>(my_atomic_load64_explicit(
+            slot_id, MY_MEMORY_ORDER_RELAXED)) == id)
+        return csn;
+    }
+
+    if (!my_atomic_load32_explicit(const_cast<int32*>(&m_n_overflow),
+                                   MY_MEMORY_ORDER_ACQUIRE))
+      return 0;
+
+    return find_overflow(id);
+  }
+
+
+  /**
+    Removes overflow entries that no read view can need.
+
+    An entry is needed by a read view if the transaction was active when
+    the view was created and committed after it.
+
+    @param views  sorted ReadView::low_limit_id() of the open views
+    @param limit  ReadView::low_limit_id() of the purge view before the
+                  open views were collected
+  */
+  void prune(const trx_ids_t &views, trx_id_t limit);
+
+private:
+  trx_id_t find_overflow(trx_id_t id) const;
+
+  struct prune_arg_t;
+  static my_bool prune_callback(overflow_entry_t *entry, prune_arg_t *arg);
+};
+
+
 /** The transaction system central memory data structure. */
 class trx_sys_t
 {
@@ -794,16 +967,31 @@ class trx_sys_t
 
 
   /**
-    Solves race conditions between register_rw() and snapshot_ids() as well as
-    race condition between assign_new_trx_no() and snapshot_ids().
+    Solves race conditions between snapshot() and register_rw(),
+    assign_new_trx_no() or deregister_rw().
 
     @sa register_rw()
     @sa assign_new_trx_no()
-    @sa snapshot_ids()
+    @sa deregister_rw()
+    @sa snapshot()
   */
   MY_ALIGNED(CACHE_LINE_SIZE) trx_id_t m_rw_trx_hash_version;
 
 
+  /**
+    The smallest trx_t::no in serialisation_list, or TRX_ID_MAX if the list
+    is empty. Written under serialisation_mutex, read with atomic operations.
+  */
+  MY_ALIGNED(CACHE_LINE_SIZE) trx_id_t m_min_serialised_no;
+
+
+  /**
+    All transactions with a smaller identifier had committed when this was
+    last updated by update_min_active_id(). Accessed with atomic operations.
+  */
+  MY_ALIGNED(CACHE_LINE_SIZE) trx_id_t m_min_active_id;
+
+
   /**
     TRX_RSEG_HISTORY list length (number of committed transactions to purge)
   */
@@ -818,6 +1006,15 @@ class trx_sys_t
   /** List of all transactions. */
   MY_ALIGNED(CACHE_LINE_SIZE) trx_ut_list_t trx_list;
 
+  /** Mutex protecting serialisation_list. */
+  MY_ALIGNED(CACHE_LINE_SIZE) TrxSysMutex serialisation_mutex;
+
+  /**
+    Transactions that have been assigned trx_t::no but have not been
+    deregistered yet, ordered by trx_t::no.
+  */
+  trx_ut_list_t serialisation_list;
+
 	MY_ALIGNED(CACHE_LINE_SIZE)
 	/** Temporary rollback segments */
 	trx_rseg_t*	temp_rsegs[TRX_SYS_N_RSEGS];
@@ -839,6 +1036,10 @@ class trx_sys_t
   MY_ALIGNED(CACHE_LINE_SIZE) rw_trx_hash_t rw_trx_hash;
 
 
+  /** Commit sequence numbers of read-write transactions */
+  trx_csn_map_t csn_map;
+
+
 #ifdef WITH_WSREP
   /** Latest recovered XID during startup */
   XID recovered_wsrep_xid;
@@ -893,6 +1094,22 @@ class trx_sys_t
   }
 
 
+  /**
+    Determines the maximum transaction id.
+
+    Unlike get_max_trx_id(), the load will not be reordered before
+    preceding sequentially consistent atomic operations.
+
+    @return maximum currently allocated trx id
+  */
+
+  trx_id_t get_max_trx_id_seq_cst()
+  {
+    return static_cast<trx_id_t>
+           (my_atomic_load64(reinterpret_cast<int64*>(&m_max_trx_id)));
+  }
+
+
   /**
     Allocates a new transaction id.
     @return new, allocated trx id
@@ -909,31 +1126,34 @@ class trx_sys_t
   /**
     Allocates and assigns new transaction serialisation number.
 
-    There's a gap between m_max_trx_id increment and transaction serialisation
-    number becoming visible through rw_trx_hash. While we're in this gap
-    concurrent thread may come and do MVCC snapshot without seeing allocated
-    but not yet assigned serialisation number. Then at some point purge thread
-    may clone this view. As a result it won't see newly allocated serialisation
-    number and may remove "unnecessary" history data of this transaction from
+    There's a gap between m_max_trx_id increment and the transaction becoming
+    visible in serialisation_list. While we're in this gap concurrent thread
+    may come and do MVCC snapshot without seeing allocated but not yet
+    assigned serialisation number. Then at some point purge thread may clone
+    this view. As a result it won't see newly allocated serialisation number
+    and may remove "unnecessary" history data of this transaction from
     rollback segments.
 
     m_rw_trx_hash_version is intended to solve this problem. MVCC snapshot has
     to wait until m_max_trx_id == m_rw_trx_hash_version, which effectively
     means that all transaction serialisation numbers up to m_max_trx_id are
-    available through rw_trx_hash.
+    available through m_min_serialised_no.
 
-    We rely on refresh_rw_trx_hash_version() to issue RELEASE memory barrier so
-    that m_rw_trx_hash_version increment happens after
-    trx->rw_trx_hash_element->no becomes visible through rw_trx_hash.
+    The number is allocated under serialisation_mutex, so that
+    serialisation_list remains ordered by trx_t::no.
 
     @param trx transaction
   */
   void assign_new_trx_no(trx_t *trx)
   {
+    mutex_enter(&serialisation_mutex);
     trx->no= get_new_trx_id_no_refresh();
-    my_atomic_store64_explicit(reinterpret_cast<int64*>
-                               (&trx->rw_trx_hash_element->no),
-                               trx->no, MY_MEMORY_ORDER_RELAXED);
+    if (!UT_LIST_GET_LEN(serialisation_list))
+      my_atomic_store64_explicit(reinterpret_cast<int64*>
+                                 (&m_min_serialised_no),
+                                 trx->no, MY_MEMORY_ORDER_RELAXED);
+    UT_LIST_ADD_LAST(serialisation_list, trx);
+    mutex_exit(&serialisation_mutex);
     refresh_rw_trx_hash_version();
   }
 
@@ -941,43 +1161,67 @@ class trx_sys_t
   /**
     Takes MVCC snapshot.
 
-    To reduce malloc probablility we reserver rw_trx_hash.size() + 32 elements
-    in ids.
+    This does not depend on the number of active transactions: changes of
+    the transactions that were active at this point of time are hidden by
+    their commit sequence numbers, which will not be smaller than
+    max_trx_id. @sa ReadView::changes_visible()
 
     For details about get_rw_trx_hash_version() != get_max_trx_id() spin
-    @sa register_rw() and @sa assign_new_trx_no().
+    @sa register_rw(), @sa assign_new_trx_no() and @sa deregister_rw().
 
     We rely on get_rw_trx_hash_version() to issue ACQUIRE memory barrier so
-    that loading of m_rw_trx_hash_version happens before accessing rw_trx_hash.
+    that loading of m_rw_trx_hash_version happens before accessing csn_map
+    and m_min_serialised_no.
+
+    @param[out]    max_trx_id variable to store m_max_trx_id value
+    @param[out]    min_trx_no variable to store min(trx->no) value of
+                              the transactions that were being committed
+    @param[out]    min_trx_id variable to store a lower bound of the
+                              identifiers of active transactions
+  */
 
-    To optimise snapshot creation rw_trx_hash.iterate() is being used instead
-    of rw_trx_hash.iterate_no_dups(). It means that some transaction
-    identifiers may appear multiple times in ids.
+  void snapshot(trx_id_t *max_trx_id, trx_id_t *min_trx_no,
+                trx_id_t *min_trx_id)
+  {
+    trx_id_t id, no;
+
+    *min_trx_id= static_cast<trx_id_t>
+      (my_atomic_load64_explicit(reinterpret_cast<int64*>(&m_min_active_id),
+                                 MY_MEMORY_ORDER_ACQUIRE));
+
+    while ((id= get_rw_trx_hash_version()) != get_max_trx_id())
+      ut_delay(1);
+
+    no= static_cast<trx_id_t>
+      (my_atomic_load64_explicit(reinterpret_cast<int64*>
+                                 (&m_min_serialised_no),
+                                 MY_MEMORY_ORDER_RELAXED));
+    *max_trx_id= id;
+    *min_trx_no= std::min(no, id);
+    if (*min_trx_id > id)
+      *min_trx_id= id;
+  }
+
+
+  /**
+    Refreshes the lower bound of active transaction identifiers that is
+    used by snapshot().
 
     @param[in,out] caller_trx used to get access to rw_trx_hash_pins
-    @param[out]    ids        array to store registered transaction identifiers
-    @param[out]    max_trx_id variable to store m_max_trx_id value
-    @param[out]    mix_trx_no variable to store min(trx->no) value
   */
 
-  void snapshot_ids(trx_t *caller_trx, trx_ids_t *ids, trx_id_t *max_trx_id,
-                    trx_id_t *min_trx_no)
+  void update_min_active_id(trx_t *caller_trx)
   {
-    ut_ad(!mutex_own(&mutex));
-    snapshot_ids_arg arg(ids);
+    trx_id_t id;
 
-    while ((arg.m_id= get_rw_trx_hash_version()) != get_max_trx_id())
+    while ((id= get_rw_trx_hash_version()) != get_max_trx_id())
       ut_delay(1);
-    arg.m_no= arg.m_id;
 
-    ids->clear();
-    ids->reserve(rw_trx_hash.size() + 32);
     rw_trx_hash.iterate(caller_trx,
-                        reinterpret_cast<my_hash_walk_action>(copy_one_id),
-                        &arg);
-
-    *max_trx_id= arg.m_id;
-    *min_trx_no= arg.m_no;
+                        reinterpret_cast<my_hash_walk_action>
+                        (min_active_id_callback), &id);
+    my_atomic_store64_explicit(reinterpret_cast<int64*>(&m_min_active_id),
+                               id, MY_MEMORY_ORDER_RELEASE);
   }
 
 
@@ -985,6 +1229,7 @@ class trx_sys_t
   void init_max_trx_id(trx_id_t value)
   {
     m_max_trx_id= m_rw_trx_hash_version= value;
+    m_min_active_id= 0;
   }
 
 
@@ -1007,23 +1252,24 @@ class trx_sys_t
     Transaction becomes visible to MVCC.
 
     There's a gap between m_max_trx_id increment and transaction becoming
-    visible through rw_trx_hash. While we're in this gap concurrent thread may
+    visible through csn_map. While we're in this gap concurrent thread may
     come and do MVCC snapshot. As a result concurrent read view will be able to
     observe records owned by this transaction even before it was committed.
 
     m_rw_trx_hash_version is intended to solve this problem. MVCC snapshot has
     to wait until m_max_trx_id == m_rw_trx_hash_version, which effectively
     means that all transactions up to m_max_trx_id are available through
-    rw_trx_hash.
+    csn_map.
 
     We rely on refresh_rw_trx_hash_version() to issue RELEASE memory barrier so
     that m_rw_trx_hash_version increment happens after transaction becomes
-    visible through rw_trx_hash.
+    visible through csn_map and rw_trx_hash.
   */
 
   void register_rw(trx_t *trx)
   {
     trx->id= get_new_trx_id_no_refresh();
+    csn_map.insert(trx->id);
     rw_trx_hash.insert(trx);
     refresh_rw_trx_hash_version();
   }
@@ -1032,12 +1278,39 @@ class trx_sys_t
   /**
     Deregisters read-write transaction.
 
+    The transaction is assigned a commit sequence number: MVCC snapshots
+    that are created after this will see the changes of this transaction.
+    Like in register_rw(), m_rw_trx_hash_version makes MVCC snapshots wait
+    until the number has been stored in csn_map and the transaction has
+    been removed from serialisation_list.
+
+    trx->no cannot be used as the commit sequence number, because it was
+    assigned before the changes became visible: a snapshot that was taken
+    in between has a bigger m_low_limit_id, but it must not see the changes.
+    A transaction that has no trx->no did not write any persistent undo log
+    records, so no read view can find its changes. It gets the commit
+    sequence number 0, which does not consume a transaction identifier.
+
     Transaction is removed from rw_trx_hash, which releases all implicit locks.
-    MVCC snapshot won't see this transaction anymore.
   */
 
   void deregister_rw(trx_t *trx)
   {
+    if (trx->no == TRX_ID_MAX)
+      csn_map.commit(trx->id, 0);
+    else
+    {
+      csn_map.commit(trx->id, get_new_trx_id_no_refresh());
+      mutex_enter(&serialisation_mutex);
+      UT_LIST_REMOVE(serialisation_list, trx);
+      const trx_t *first= UT_LIST_GET_FIRST(serialisation_list);
+      my_atomic_store64_explicit(reinterpret_cast<int64*>
+                                 (&m_min_serialised_no),
+                                 first ? first->no : TRX_ID_MAX,
+                                 MY_MEMORY_ORDER_RELAXED);
+      mutex_exit(&serialisation_mutex);
+    }
+    refresh_rw_trx_hash_version();
     rw_trx_hash.erase(trx);
   }
 
@@ -1138,26 +1411,11 @@ class trx_sys_t
   }
 
 
-  struct snapshot_ids_arg
+  static my_bool min_active_id_callback(rw_trx_hash_element_t *element,
+                                        trx_id_t *id)
   {
-    snapshot_ids_arg(trx_ids_t *ids): m_ids(ids) {}
-    trx_ids_t *m_ids;
-    trx_id_t m_id;
-    trx_id_t m_no;
-  };
-
-
-  static my_bool copy_one_id(rw_trx_hash_element_t *element,
-                             snapshot_ids_arg *arg)
-  {
-    if (element->id < arg->m_id)
-    {
-      trx_id_t no= static_cast<trx_id_t>(my_atomic_load64_explicit(
-        reinterpret_cast<int64*>(&element->no), MY_MEMORY_ORDER_RELAXED));
-      arg->m_ids->push_back(element->id);
-      if (no < arg->m_no)
-        arg->m_no= no;
-    }
+    if (element->id < *id)
+      *id= element->id;
     return 0;
   }
 
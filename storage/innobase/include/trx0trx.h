@@ -231,7 +231,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys.mutex */
+holding lock_sys.latch */
 trx_t *
 trx_get_trx_by_xid(
 /*===============*/
@@ -292,7 +292,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys.mutex and trx_sys.mutex.
+The caller must hold lock_sys.latch and trx_sys.mutex.
 When possible, use trx_print() instead. */
 void
 trx_print_latched(
@@ -304,7 +304,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys.mutex. */
+Acquires and releases lock_sys.latch. */
 void
 trx_print(
 /*======*/
@@ -519,6 +519,11 @@ The transaction must have mysql_thd assigned. */
 
 typedef std::vector<ib_lock_t*, ut_allocator<ib_lock_t*> >	lock_pool_t;
 
+/** Keys of hot row queues (see lock_hot_row_t) */
+typedef std::vector<std::pair<index_id_t, ulint>,
+		    ut_allocator<std::pair<index_id_t, ulint> > >
+	hot_row_list_t;
+
 /*******************************************************************//**
 Latching protocol for trx_lock_t::que_state.  trx_lock_t::que_state
 captures the state of the query thread during the execution of a query.
@@ -532,7 +537,7 @@ granted the lock it was waiting for, which implies that the state can be changed
 asynchronously.
 
 All these operations take place within the context of locking. Therefore state
-changes within the locking code must acquire both the lock mutex and the
+changes within the locking code must acquire both lock_sys.latch and the
 trx->mutex when changing trx->lock.que_state to TRX_QUE_LOCK_WAIT or
 trx->lock.wait_lock to non-NULL but when the lock wait ends it is sufficient
 to only acquire the trx->mutex.
@@ -540,7 +545,7 @@ To query the state either of the mutexes is sufficient within the locking
 code and no mutex is required when the query thread is no longer waiting. */
 
 /** The locks and state of an active transaction. Protected by
-lock_sys.mutex, trx->mutex or both. */
+lock_sys.latch, trx->mutex or both. */
 struct trx_lock_t {
 	ulint		n_active_thrs;	/*!< number of active query threads */
 
@@ -552,15 +557,25 @@ struct trx_lock_t {
 					TRX_QUE_LOCK_WAIT, this points to
 					the lock request, otherwise this is
 					NULL; set to non-NULL when holding
-					both trx->mutex and lock_sys.mutex;
+					both trx->mutex and lock_sys.latch;
 					set to NULL when holding
-					lock_sys.mutex; readers should
-					hold lock_sys.mutex, except when
+					lock_sys.latch; readers should
+					hold lock_sys.latch, except when
 					they are holding trx->mutex and
 					wait_lock==NULL */
+	ib_uint64_t	wait_seq;	/*!< sequence number of the latest
+					lock wait of this transaction,
+					assigned when the waiting lock
+					request is enqueued; protected by
+					lock_sys.latch in exclusive mode */
+	bool		wait_checked;	/*!< whether the deadlock detector
+					has searched the waits-for graph
+					from the latest lock wait; protected
+					by lock_sys.latch in exclusive mode */
 	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
-					to and checked against lock_mark_counter
-					by lock_deadlock_recursive(). */
+					to and checked against
+					DeadlockChecker::s_lock_mark_counter
+					by DeadlockChecker::node_of(). */
 	bool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to false;
@@ -569,13 +584,13 @@ struct trx_lock_t {
 					resolution, it sets this to true.
 					Protected by trx->mutex. */
 	time_t		wait_started;	/*!< lock wait started at this time,
-					protected only by lock_sys.mutex */
+					protected only by lock_sys.latch */
 
 	que_thr_t*	wait_thr;	/*!< query thread belonging to this
 					trx that is in QUE_THR_LOCK_WAIT
 					state. For threads suspended in a
 					lock wait, this is protected by
-					lock_sys.mutex. Otherwise, this may
+					lock_sys.latch. Otherwise, this may
 					only be modified by the thread that is
 					serving the running transaction. */
 
@@ -588,12 +603,16 @@ struct trx_lock_t {
 	ulint		table_cached;	/*!< Next free table lock in pool */
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys.mutex */
+					protected by lock_sys.latch in
+					exclusive mode, or by trx->mutex
+					while lock_sys.latch is held in
+					shared mode */
 
 	trx_lock_list_t trx_locks;	/*!< locks requested by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys.mutex; removals are
-					protected by lock_sys.mutex */
+					and lock_sys.latch in either mode;
+					removals are protected by
+					lock_sys.latch in exclusive mode */
 
 	lock_pool_t	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -607,9 +626,21 @@ struct trx_lock_t {
 					check for this cancel of a transaction's
 					locks and avoid reacquiring the trx
 					mutex to prevent recursive deadlocks.
-					Protected by both the lock sys mutex
+					Protected by both lock_sys.latch
 					and the trx_t::mutex. */
 	ulint		n_rec_locks;	/*!< number of rec locks in this trx */
+
+	os_event_t	hot_row_event;	/*!< event for waiting for admission
+					in lock_hot_row_t::enter() */
+	bool		hot_row_admitted;
+					/*!< whether the hot row queue that
+					the transaction is waiting in has
+					admitted it; protected by the mutex
+					of the queue */
+	hot_row_list_t	hot_rows;	/*!< keys of the hot row queues that
+					admitted the transaction; only
+					accessed by the thread serving the
+					transaction */
 };
 
 /** Logical first modification time of a table in a transaction */
@@ -712,15 +743,15 @@ transactions. The trx_sys.mutex prevents a race condition between it
 and lock_trx_release_locks() [invoked by trx_commit()].
 
 * trx_print_low() may access transactions not associated with the current
-thread. The caller must be holding lock_sys.mutex.
+thread. The caller must be holding lock_sys.latch.
 
 * When a transaction handle is in the trx_sys.trx_list, some of its fields
 must not be modified without holding trx->mutex.
 
-* The locking code (in particular, lock_deadlock_recursive() and
+* The locking code (in particular, lock_deadlock_detect_thread() and
 lock_rec_convert_impl_to_expl()) will access transactions associated
 to other connections. The locks of transactions are protected by
-lock_sys.mutex and sometimes by trx->mutex. */
+lock_sys.latch and sometimes by trx->mutex. */
 
 /** Represents an instance of rollback segment along with its state variables.*/
 struct trx_undo_ptr_t {
@@ -772,7 +803,7 @@ struct trx_t {
 	TrxMutex	mutex;		/*!< Mutex protecting the fields
 					state and lock (except some fields
 					of lock, which are protected by
-					lock_sys.mutex) */
+					lock_sys.latch) */
 
 	trx_id_t	id;		/*!< transaction id */
 
@@ -843,7 +874,7 @@ struct trx_t {
 	ACTIVE->COMMITTED is possible when the transaction is in
 	rw_trx_hash.
 
-	Transitions to COMMITTED are protected by both lock_sys.mutex
+	Transitions to COMMITTED are protected by both lock_sys.latch
 	and trx->mutex.
 
 	NOTE: Some of these state change constraints are an overkill,
@@ -856,7 +887,7 @@ struct trx_t {
 					transaction, or NULL if not yet set */
 	trx_lock_t	lock;		/*!< Information about the transaction
 					locks and state. Protected by
-					trx->mutex or lock_sys.mutex
+					trx->mutex or lock_sys.latch
 					or both */
 	bool		is_recovered;	/*!< 0=normal transaction,
 					1=recovered, must be rolled back,
@@ -955,6 +986,9 @@ struct trx_t {
 	/*------------------------------*/
 	UT_LIST_NODE_T(trx_t) trx_list;	/*!< list of all transactions;
 					protected by trx_sys.mutex */
+	UT_LIST_NODE_T(trx_t) no_list;	/*!< trx_sys.serialisation_list;
+					protected by
+					trx_sys.serialisation_mutex */
 	/*------------------------------*/
 	dberr_t		error_state;	/*!< 0 if no error, otherwise error
 					number; NOTE That ONLY the thread
@@ -1005,7 +1039,7 @@ struct trx_t {
 					also in the lock list trx_locks. This
 					vector needs to be freed explicitly
 					when the trx instance is destroyed.
-					Protected by lock_sys.mutex. */
+					Protected by lock_sys.latch. */
 	/*------------------------------*/
 	bool		read_only;	/*!< true if transaction is flagged
 					as a READ-ONLY transaction.
@@ -302,6 +302,12 @@ management to ensure correct alignment for doubles etc. */
 #define IF_SNAPPY(A,B) B
 #endif
 
+#ifdef HAVE_ZSTD
+#define IF_ZSTD(A,B) A
+#else
+#define IF_ZSTD(A,B) B
+#endif
+
 #if defined (HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE) || defined(_WIN32)
 #define IF_PUNCH_HOLE(A,B) A
 #else
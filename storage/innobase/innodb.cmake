@@ -24,6 +24,7 @@ INCLUDE(lzo.cmake)
 INCLUDE(lzma.cmake)
 INCLUDE(bzip2.cmake)
 INCLUDE(snappy.cmake)
+INCLUDE(zstd.cmake)
 INCLUDE(numa)
 
 MYSQL_CHECK_LZ4()
@@ -31,6 +32,7 @@ MYSQL_CHECK_LZO()
 MYSQL_CHECK_LZMA()
 MYSQL_CHECK_BZIP2()
 MYSQL_CHECK_SNAPPY()
+MYSQL_CHECK_ZSTD()
 MYSQL_CHECK_NUMA()
 
 INCLUDE(${MYSQL_CMAKE_SCRIPT_DIR}/compile_flags.cmake)
@@ -61,6 +63,21 @@ IF(UNIX)
     IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
+
+      OPTION(WITH_URING "Use io_uring for asynchronous I/O if available" ON)
+      IF(WITH_URING)
+        CHECK_INCLUDE_FILES (liburing.h HAVE_LIBURING_H)
+        CHECK_LIBRARY_EXISTS(uring io_uring_queue_init "" HAVE_LIBURING)
+        IF(HAVE_LIBURING_H AND HAVE_LIBURING)
+          ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+          LINK_LIBRARIES(uring)
+          CHECK_LIBRARY_EXISTS(uring io_uring_clone_buffers ""
+                               HAVE_IO_URING_CLONE_BUFFERS)
+          IF(HAVE_IO_URING_CLONE_BUFFERS)
+            ADD_DEFINITIONS(-DHAVE_IO_URING_CLONE_BUFFERS=1)
+          ENDIF()
+        ENDIF()
+      ENDIF()
     ENDIF()
     IF(HAVE_LIBNUMA)
       LINK_LIBRARIES(numa)
@@ -0,0 +1,278 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file lock/lock0hot.cc
+Admission queues for the updates of hot rows
+*******************************************************/
+
+#include "ha_prototypes.h"
+#include <mysql/service_thd_wait.h>
+
+#include "lock0hot.h"
+#include "data0data.h"
+#include "dict0mem.h"
+#include "lock0lock.h"
+#include "srv0conc.h"
+#include "srv0mon.h"
+#include "trx0trx.h"
+
+/** The hot row queues */
+lock_hot_row_t	lock_hot_row;
+
+/** Create the queues. */
+void
+lock_hot_row_t::create()
+{
+	ut_ad(!m_parts);
+
+	m_parts = UT_NEW_ARRAY_NOKEY(part_t, N_PARTS);
+
+	for (ulint i = 0; i < N_PARTS; i++) {
+		mutex_create(LATCH_ID_LOCK_HOT_ROW, &m_parts[i].mutex);
+	}
+}
+
+/** Free the queues. */
+void
+lock_hot_row_t::close()
+{
+	if (!m_parts) {
+		return;
+	}
+
+	for (ulint i = 0; i < N_PARTS; i++) {
+		ut_ad(m_parts[i].queues.empty());
+		mutex_free(&m_parts[i].mutex);
+	}
+
+	UT_DELETE_ARRAY(m_parts);
+	m_parts = NULL;
+}
+
+/** @return the key of the queue of a row
+@param[in]	index	clustered index
+@param[in]	tuple	primary key value */
+lock_hot_row_t::key_t
+lock_hot_row_t::get_key(const dict_index_t* index, const dtuple_t* tuple)
+{
+	ut_ad(index->is_primary());
+
+	return(key_t(index->id,
+		     dtuple_fold(tuple, dtuple_get_n_fields(tuple),
+				 0, index->id)));
+}
+
+/** Admit waiting transactions while there is room in a queue.
+@param[in,out]	queue	queue of a row */
+void
+lock_hot_row_t::admit_waiters(queue_t& queue)
+{
+	while (queue.n_admitted < N_ADMIT && !queue.waiters.empty()) {
+		trx_t*	trx = queue.waiters.front();
+
+		queue.waiters.pop_front();
+		queue.n_admitted++;
+		trx->lock.hot_row_admitted = true;
+		os_event_set(trx->lock.hot_row_event);
+	}
+}
+
+/** Wait until a transaction is admitted to lock a row.
+@param[in,out]	trx	transaction
+@param[in]	index	clustered index
+@param[in]	tuple	primary key value
+@retval DB_SUCCESS		if the transaction had been admitted
+@retval DB_SUCCESS_LOCKED_REC	if the transaction was admitted now
+@retval DB_LOCK_WAIT_TIMEOUT	on lock wait timeout
+@retval DB_INTERRUPTED		if the statement was killed */
+dberr_t
+lock_hot_row_t::enter(
+	trx_t*			trx,
+	const dict_index_t*	index,
+	const dtuple_t*		tuple)
+{
+	const key_t	key = get_key(index, tuple);
+
+	for (ulint i = 0; i < trx->lock.hot_rows.size(); i++) {
+		if (trx->lock.hot_rows[i] == key) {
+			return(DB_SUCCESS);
+		}
+	}
+
+	/* Only a transaction that holds no record locks, not even
+	implicit ones, no admission to another queue and no table
+	locks other than intention locks may wait outside the lock
+	system. An admitted transaction could otherwise wait for a
+	lock that the waiting one holds, and the deadlock detector
+	would not see the cycle. Intention locks only conflict with
+	S and X table locks, which an admitted transaction cannot
+	request before it commits. */
+	const bool	may_wait = trx->undo_no == 0
+		&& trx->lock.n_rec_locks == 0
+		&& trx->lock.hot_rows.empty()
+		&& ib_vector_is_empty(trx->autoinc_locks)
+		&& !lock_trx_has_strong_table_lock(trx);
+
+	part_t&		part = get_part(key);
+
+	mutex_enter(&part.mutex);
+
+	queue_t&	queue = part.queues[key];
+
+	if (!may_wait
+	    || (queue.n_admitted < N_ADMIT && queue.waiters.empty())) {
+		queue.n_admitted++;
+		mutex_exit(&part.mutex);
+		trx->lock.hot_rows.push_back(key);
+		return(DB_SUCCESS_LOCKED_REC);
+	}
+
+	queue.waiters.push_back(trx);
+	trx->lock.hot_row_admitted = false;
+	int64_t	sig_count = os_event_reset(trx->lock.hot_row_event);
+
+	mutex_exit(&part.mutex);
+
+	MONITOR_INC(MONITOR_LOCK_HOT_ROW_WAIT);
+
+	const ulong	timeout = trx_lock_wait_timeout_get(trx);
+	const ib_time_t	start = ut_time();
+	dberr_t		err = DB_SUCCESS;
+	const bool	was_declared_inside_innodb
+		= trx->declared_to_be_inside_innodb;
+
+	if (was_declared_inside_innodb) {
+		/* Let the admitted transactions enter InnoDB. */
+		srv_conc_force_exit_innodb(trx);
+	}
+
+	thd_wait_begin(trx->mysql_thd, THD_WAIT_ROW_LOCK);
+
+	for (;;) {
+		/* Wake up every second to check for timeout or KILL. */
+		os_event_wait_time_low(trx->lock.hot_row_event, 1000000,
+				       sig_count);
+
+		mutex_enter(&part.mutex);
+
+		if (trx->lock.hot_row_admitted) {
+			mutex_exit(&part.mutex);
+			break;
+		}
+
+		if (trx_is_interrupted(trx)) {
+			err = DB_INTERRUPTED;
+		} else if (timeout < 100000000
+			   && ut_difftime(ut_time(), start)
+			   > double(timeout)) {
+			err = DB_LOCK_WAIT_TIMEOUT;
+			MONITOR_INC(MONITOR_TIMEOUT);
+		} else {
+			sig_count = os_event_reset(trx->lock.hot_row_event);
+			mutex_exit(&part.mutex);
+			continue;
+		}
+
+		queues_t::iterator	it = part.queues.find(key);
+		ut_ad(it != part.queues.end());
+		it->second.waiters.remove(trx);
+
+		if (!it->second.n_admitted && it->second.waiters.empty()) {
+			part.queues.erase(it);
+		}
+
+		mutex_exit(&part.mutex);
+		break;
+	}
+
+	thd_wait_end(trx->mysql_thd);
+
+	if (was_declared_inside_innodb) {
+		srv_conc_force_enter_innodb(trx);
+	}
+
+	if (err == DB_SUCCESS) {
+		trx->lock.hot_rows.push_back(key);
+		err = DB_SUCCESS_LOCKED_REC;
+	}
+
+	return(err);
+}
+
+/** Release an admission to a queue.
+@param[in]	key	key of the queue */
+void
+lock_hot_row_t::release_low(const key_t& key)
+{
+	part_t&		part = get_part(key);
+
+	mutex_enter(&part.mutex);
+
+	queues_t::iterator	it = part.queues.find(key);
+	ut_ad(it != part.queues.end());
+	ut_ad(it->second.n_admitted > 0);
+
+	it->second.n_admitted--;
+	admit_waiters(it->second);
+
+	if (!it->second.n_admitted) {
+		ut_ad(it->second.waiters.empty());
+		part.queues.erase(it);
+	}
+
+	mutex_exit(&part.mutex);
+}
+
+/** Give back an admission that enter() granted to a statement
+that failed without locking the row.
+@param[in,out]	trx	transaction
+@param[in]	index	clustered index
+@param[in]	tuple	primary key value */
+void
+lock_hot_row_t::leave(
+	trx_t*			trx,
+	const dict_index_t*	index,
+	const dtuple_t*		tuple)
+{
+	const key_t	key = get_key(index, tuple);
+
+	/* If the transaction was rolled back, release() already
+	gave back all its admissions. */
+	for (ulint i = 0; i < trx->lock.hot_rows.size(); i++) {
+		if (trx->lock.hot_rows[i] == key) {
+			trx->lock.hot_rows.erase(
+				trx->lock.hot_rows.begin() + i);
+			release_low(key);
+			return;
+		}
+	}
+}
+
+/** Leave the queues that admitted a transaction, at commit
+or rollback, after the record locks have been released.
+@param[in,out]	trx	transaction */
+void
+lock_hot_row_t::release(trx_t* trx)
+{
+	for (ulint i = 0; i < trx->lock.hot_rows.size(); i++) {
+		release_low(trx->lock.hot_rows[i]);
+	}
+
+	trx->lock.hot_rows.clear();
+}
@@ -33,11 +33,13 @@ Created 5/7/1996 Heikki Tuuri
 #include <sql_class.h>
 
 #include "lock0lock.h"
+#include "lock0hot.h"
 #include "lock0priv.h"
 #include "dict0mem.h"
 #include "trx0purge.h"
 #include "trx0sys.h"
 #include "srv0mon.h"
+#include "srv0start.h"
 #include "ut0vec.h"
 #include "btr0btr.h"
 #include "dict0boot.h"
@@ -46,8 +48,11 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0mysql.h"
 #include "row0vers.h"
 #include "pars0pars.h"
+#include "sync0sync.h"
 
+#include <algorithm>
 #include <set>
+#include <vector>
 
 #ifdef WITH_WSREP
 #include <mysql/service_wsrep.h>
@@ -102,155 +107,155 @@ static
 void
 lock_rec_print(FILE* file, const lock_t* lock);
 
-/** Deadlock checker. */
+/** Deadlock detector. Lock waits are only registered when they are
+enqueued. After a transaction has been suspended in a lock wait,
+lock_deadlock_detect_thread copies the part of the waits-for graph that
+is reachable from the lock waits that have started since the previous
+search, while holding lock_sys.latch. The copy is bounded by
+LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK, and it is searched for cycles
+without holding any latch. The search is bounded by
+LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK. A deadlock is resolved by cancelling
+the lock wait of a victim transaction, after checking under
+lock_sys.latch that the cycle still exists. */
 class DeadlockChecker {
 public:
-	/** Checks if a joining lock request results in a deadlock. If
-	a deadlock is found this function will resolve the deadlock
-	by choosing a victim transaction and rolling it back. It
-	will attempt to resolve all deadlocks. The returned transaction
-	id will be the joining transaction id or 0 if some other
-	transaction was chosen as a victim and rolled back or no
-	deadlock found.
-
-	@param lock lock the transaction is requesting
-	@param trx transaction requesting the lock
-
-	@return id of transaction chosen as victim or 0 */
-	static const trx_t* check_and_resolve(
-		const lock_t*	lock,
-		trx_t*		trx);
+	/** Register a lock wait that has just been enqueued.
+	@param[in]	lock	waiting lock request
+	@param[in,out]	trx	transaction that requested the lock */
+	static void register_wait(const lock_t* lock, trx_t* trx);
 
-private:
-	/** Do a shallow copy. Default destructor OK.
-	@param trx the start transaction (start node)
-	@param wait_lock lock that a transaction wants
-	@param mark_start visited node counter */
-	DeadlockChecker(
-		const trx_t*	trx,
-		const lock_t*	wait_lock,
-		ib_uint64_t	mark_start,
-		bool report_waiters)
-		:
-		m_cost(),
-		m_start(trx),
-		m_too_deep(),
-		m_wait_lock(wait_lock),
-		m_mark_start(mark_start),
-		m_n_elems(),
-		m_report_waiters(report_waiters)
-	{
-	}
-
-	/** Check if the search is too deep. */
-	bool is_too_deep() const
-	{
-		return(m_n_elems > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK
-		       || m_cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK);
-	}
+	/** Search the waits-for graph for cycles that contain a lock wait
+	that has been suspended since the previous call, and resolve them.
+	@return number of transactions that were chosen as victims */
+	ulint check_and_resolve();
 
-	/** Save current state.
-	@param lock lock to push on the stack.
-	@param heap_no the heap number to push on the stack.
-	@return false if stack is full. */
-	bool push(const lock_t*	lock, ulint heap_no)
-	{
-		ut_ad((lock_get_type_low(lock) & LOCK_REC)
-		      || (lock_get_type_low(lock) & LOCK_TABLE));
-
-		ut_ad(((lock_get_type_low(lock) & LOCK_TABLE) != 0)
-		      == (heap_no == ULINT_UNDEFINED));
-
-		/* Ensure that the stack is bounded. */
-		if (m_n_elems >= UT_ARR_SIZE(s_states)) {
-			return(false);
-		}
-
-		state_t&	state = s_states[m_n_elems++];
+private:
+	/** A waiting transaction in the copy of the waits-for graph */
+	struct node_t {
+		/** the waiting transaction */
+		trx_t*		trx;
+		/** trx->lock.wait_seq when the graph was copied */
+		ib_uint64_t	wait_seq;
+		/** first outgoing edge in m_edges */
+		ulint		first_edge;
+		/** end of the outgoing edges in m_edges */
+		ulint		end_edge;
+		/** whether the transaction was suspended in the lock wait */
+		bool		suspended;
+		/** whether the outgoing edges were copied */
+		bool		copied;
+		/** the search from which the node was last visited */
+		ulint		visited;
+	};
 
-		state.m_lock = lock;
-		state.m_wait_lock = m_wait_lock;
-		state.m_heap_no =heap_no;
+	/** A node on the search stack */
+	struct frame_t {
+		/** the node in m_nodes */
+		ulint		node;
+		/** next outgoing edge to follow in m_edges */
+		ulint		next_edge;
+	};
 
-		return(true);
-	}
+	/** Result of a search */
+	enum search_t {
+		/** no cycle was found */
+		NO_CYCLE,
+		/** a cycle was found on m_stack */
+		CYCLE,
+		/** the search was too deep or long */
+		TOO_DEEP
+	};
 
-	/** Restore state.
-	@param[out] lock current lock
-	@param[out] heap_no current heap_no */
-	void pop(const lock_t*& lock, ulint& heap_no)
-	{
-		ut_a(m_n_elems > 0);
+	/** Functor for adding the edges of a transaction to m_edges */
+	struct add_edge_t;
 
-		const state_t&	state = s_states[--m_n_elems];
+	/** Functor for finding the lock that blocks a waiting request */
+	struct find_blocker_t;
 
-		lock = state.m_lock;
-		heap_no = state.m_heap_no;
-		m_wait_lock = state.m_wait_lock;
-	}
+	/** Functor for reporting lock waits to the replication layer */
+	struct report_wait_t;
 
-	/** Check whether the node has been visited.
-	@param lock lock to check
-	@return true if the node has been visited */
-	bool is_visited(const lock_t* lock) const
+	/** Check if a transaction is suspended in a lock wait.
+	@param[in]	trx	transaction
+	@return whether the transaction is in m_suspended */
+	bool is_suspended(const trx_t* trx) const
 	{
-		return(lock->trx->lock.deadlock_mark > m_mark_start);
+		return(std::binary_search(m_suspended.begin(),
+					  m_suspended.end(), trx));
 	}
 
-	/** Get the next lock in the queue that is owned by a transaction
-	whose sub-tree has not already been searched.
-	Note: "next" here means PREV for table locks.
-	@param lock Lock in queue
-	@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
-	@return next lock or NULL if at end of queue */
-	const lock_t* get_next_lock(const lock_t* lock, ulint heap_no) const;
-
-	/** Get the first lock to search. The search starts from the current
-	wait_lock. What we are really interested in is an edge from the
-	current wait_lock's owning transaction to another transaction that has
-	a lock ahead in the queue. We skip locks where the owning transaction's
-	sub-tree has already been searched.
+	/** Look up or add the node of a waiting transaction in the copy
+	of the waits-for graph.
+	@param[in,out]	trx	waiting transaction
+	@return the node in m_nodes */
+	ulint node_of(trx_t* trx);
 
-	Note: The record locks are traversed from the oldest lock to the
-	latest. For table locks we go from latest to oldest.
+	/** Copy the waits-for graph that is reachable from the lock
+	waits that have not been searched from yet.
+	@return number of lock waits that have not been searched from */
+	ulint copy_graph();
 
-	For record locks, we first position the iterator on first lock on
-	the page and then reposition on the actual heap_no. This is required
-	due to the way the record lock has is implemented.
-
-	@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
-
-	@return first lock or NULL */
-	const lock_t* get_first_lock(ulint* heap_no) const;
-
-	/** Notify that a deadlock has been detected and print the conflicting
-	transaction info.
-	@param lock lock causing deadlock */
-	void notify(const lock_t* lock) const;
+	/** Push a node to the search stack.
+	@param[in]	node	node in m_nodes
+	@param[in]	search	identifier of the search */
+	void push(ulint node, ulint search)
+	{
+		frame_t	frame = { node, m_nodes[node].first_edge };
 
-	/** Select the victim transaction that should be rolledback.
-	@return victim transaction */
-	const trx_t* select_victim() const;
+		m_nodes[node].visited = search;
+		m_stack.push_back(frame);
+	}
 
-	/** Rollback transaction selected as the victim. */
-	void trx_rollback();
+	/** Search the copy of the waits-for graph for a cycle that
+	contains a node.
+	@param[in]	start	node in m_nodes
+	@return the result of the search */
+	search_t search(ulint start);
 
-	/** Looks iteratively for a deadlock. Note: the joining transaction
-	may have been granted its lock by the deadlock checks.
+	/** Check that a lock wait in the copy of the waits-for graph
+	still exists.
+	@param[in]	node	node in m_nodes
+	@return whether the transaction is still in the same lock wait */
+	bool is_waiting(const node_t& node) const
+	{
+		ut_ad(lock_mutex_own());
+		return(node.trx->lock.wait_lock != NULL
+		       && node.trx->lock.wait_seq == node.wait_seq);
+	}
+
+	/** Check if a transaction should rather be chosen as the victim
+	than another one.
+	@param[in]	a	candidate
+	@param[in]	b	current choice
+	@return whether a should be rolled back instead of b */
+	static bool prefer_victim(const trx_t* a, const trx_t* b);
+
+	/** Resolve the deadlock that is formed by the nodes on m_stack,
+	if it still exists. Each transaction waits for the next one, and
+	the last one for the first one.
+	@return whether a victim transaction was chosen */
+	bool resolve();
+
+	/** Cancel the lock wait of a deadlock victim.
+	@param[in,out]	trx	transaction to be rolled back */
+	static void rollback(trx_t* trx);
+
+	/** Print info about a transaction that is rolled back because
+	the search was too deep or long.
+	@param[in]	trx	transaction to be rolled back
+	@param[in]	lock	lock that the transaction is waiting for */
+	static void rollback_print(const trx_t* trx, const lock_t* lock);
 
-	@return 0 if no deadlock else the victim transaction.*/
-	const trx_t* search();
+	/** rewind(3) the file used for storing the latest detected deadlock
+	and print a heading message to stderr if printing of all deadlocks to
+	stderr is enabled. */
+	static void start_print();
 
 	/** Print transaction data to the deadlock file and possibly to stderr.
 	@param trx transaction
 	@param max_query_len max query length to print */
 	static void print(const trx_t* trx, ulint max_query_len);
 
-	/** rewind(3) the file used for storing the latest detected deadlock
-	and print a heading message to stderr if printing of all deadlocks to
-	stderr is enabled. */
-	static void start_print();
-
 	/** Print lock data to the deadlock file and possibly to stderr.
 	@param lock record or table type lock */
 	static void print(const lock_t* lock);
@@ -259,53 +264,42 @@ class DeadlockChecker {
 	@param msg message to print */
 	static void print(const char* msg);
 
-	/** Print info about transaction that was rolled back.
-	@param trx transaction rolled back
-	@param lock lock trx wants */
-	static void rollback_print(const trx_t* trx, const lock_t* lock);
-
-private:
-	/** DFS state information, used during deadlock checking. */
-	struct state_t {
-		const lock_t*	m_lock;		/*!< Current lock */
-		const lock_t*	m_wait_lock;	/*!< Waiting for lock */
-		ulint		m_heap_no;	/*!< heap number if rec lock */
-	};
+	/** Lock wait sequence number. Protected by lock_sys.latch. */
+	static ib_uint64_t	s_wait_seq;
 
-	/** Used in deadlock tracking. Protected by lock_sys.mutex. */
+	/** Counter for trx_lock_t::deadlock_mark. Protected by
+	lock_sys.latch. */
 	static ib_uint64_t	s_lock_mark_counter;
 
-	/** Calculation steps thus far. It is the count of the nodes visited. */
-	ulint			m_cost;
-
-	/** Joining transaction that is requesting a lock in an
-	incompatible mode */
-	const trx_t*		m_start;
-
-	/** TRUE if search was too deep and was aborted */
-	bool			m_too_deep;
+	/** The value of s_lock_mark_counter when the waits-for graph
+	was copied; a transaction with a greater deadlock_mark is the
+	node deadlock_mark - m_mark_start - 1 */
+	ib_uint64_t		m_mark_start;
 
-	/** Lock that trx wants */
-	const lock_t*		m_wait_lock;
+	/** Number of lock requests that were examined while copying
+	the waits-for graph */
+	ulint			m_cost;
 
-	/**  Value of lock_mark_count at the start of the deadlock check. */
-	ib_uint64_t		m_mark_start;
+	/** The copy of the waits-for graph; the nodes of the lock waits
+	that have not been searched from yet come first */
+	std::vector<node_t, ut_allocator<node_t> >	m_nodes;
 
-	/** Number of states pushed onto the stack */
-	size_t			m_n_elems;
+	/** The outgoing edges of m_nodes, as positions in m_nodes */
+	std::vector<ulint, ut_allocator<ulint> >	m_edges;
 
-	/** This is to avoid malloc/free calls. */
-	static state_t		s_states[MAX_STACK_SIZE];
+	/** The search stack */
+	std::vector<frame_t, ut_allocator<frame_t> >	m_stack;
 
-	/** Set if thd_rpl_deadlock_check() should be called for waits. */
-	const bool m_report_waiters;
+	/** The transactions that are suspended in a lock wait, in
+	ascending order; collected by copy_graph() */
+	std::vector<trx_t*, ut_allocator<trx_t*> >	m_suspended;
 };
 
-/** Counter to mark visited nodes during deadlock search. */
-ib_uint64_t	DeadlockChecker::s_lock_mark_counter = 0;
+/** Lock wait sequence number. */
+ib_uint64_t	DeadlockChecker::s_wait_seq = 0;
 
-/** The stack used for deadlock searches. */
-DeadlockChecker::state_t	DeadlockChecker::s_states[MAX_STACK_SIZE];
+/** Counter for trx_lock_t::deadlock_mark. */
+ib_uint64_t	DeadlockChecker::s_lock_mark_counter = 0;
 
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
@@ -478,11 +472,17 @@ void lock_sys_t::create(ulint n_cells)
 		(ut_zalloc_nokey(srv_max_n_threads * sizeof *waiting_threads));
 	last_slot = waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &mutex);
+	latch = static_cast<rw_lock_t*>(ut_zalloc_nokey(sizeof *latch));
+	rw_lock_create(lock_sys_latch_key, latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; i++) {
+		mutex_create(LATCH_ID_LOCK_SYS_SHARD, &shards[i].mutex);
+	}
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &wait_mutex);
 
 	timeout_event = os_event_create(0);
+	deadlock_event = os_event_create(0);
 
 	rec_hash = hash_create(n_cells);
 	prdt_hash = hash_create(n_cells);
@@ -516,7 +516,7 @@ void lock_sys_t::resize(ulint n_cells)
 {
 	ut_ad(this == &lock_sys);
 
-	mutex_enter(&mutex);
+	rw_lock_x_lock(latch);
 
 	hash_table_t* old_hash = rec_hash;
 	rec_hash = hash_create(n_cells);
@@ -561,7 +561,7 @@ void lock_sys_t::resize(ulint n_cells)
 		buf_pool_mutex_exit(buf_pool);
 	}
 
-	mutex_exit(&mutex);
+	rw_lock_x_unlock(latch);
 }
 
 
@@ -582,8 +582,16 @@ void lock_sys_t::close()
 	hash_table_free(prdt_page_hash);
 
 	os_event_destroy(timeout_event);
+	os_event_destroy(deadlock_event);
+
+	rw_lock_free(latch);
+	ut_free(latch);
+	latch = NULL;
+
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; i++) {
+		mutex_destroy(&shards[i].mutex);
+	}
 
-	mutex_destroy(&mutex);
 	mutex_destroy(&wait_mutex);
 
 	for (ulint i = srv_max_n_threads; i--; ) {
@@ -1022,7 +1030,7 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1071,7 +1079,7 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1184,7 +1192,7 @@ lock_rec_other_has_conflicting(
 {
 	lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1267,7 +1275,7 @@ lock_sec_rec_some_has_impl(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch in exclusive mode. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -1280,7 +1288,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch in exclusive mode. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -1363,7 +1371,7 @@ lock_rec_create_low(
 	ulint		n_bits;
 	ulint		n_bytes;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(lock_rec_hash(space, page_no)));
 	ut_ad(holds_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -1432,7 +1440,7 @@ lock_rec_create_low(
  	}
 	lock_rec_bitmap_reset(lock);
 	lock_rec_set_nth_bit(lock, heap_no);
-	index->table->n_rec_locks++;
+	my_atomic_addlint(&index->table->n_rec_locks, 1);
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
 #ifdef WITH_WSREP
@@ -1525,8 +1533,8 @@ lock_rec_create_low(
 	if (!holds_trx_mutex) {
 		trx_mutex_exit(trx);
 	}
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return lock;
 }
@@ -1681,7 +1689,7 @@ lock_rec_insert_to_head(
 }
 
 /** Enqueue a waiting request for a lock which cannot be granted immediately.
-Check for deadlocks.
+The wait will be checked for deadlocks by lock_deadlock_detect_thread.
 @param[in]	type_mode	the requested lock mode (LOCK_S or LOCK_X)
 				possibly ORed with LOCK_GAP or
 				LOCK_REC_NOT_GAP, ORed with
@@ -1695,7 +1703,6 @@ Check for deadlocks.
 @param[in,out]	thr		query thread
 @param[in]	prdt		minimum bounding box (spatial index)
 @retval	DB_LOCK_WAIT		if the waiting lock was enqueued
-@retval	DB_DEADLOCK		if this transaction was chosen as the victim
 @retval	DB_SUCCESS_LOCKED_REC	if the other transaction was chosen as a victim
 				(or it happened to commit) */
 dberr_t
@@ -1750,18 +1757,10 @@ lock_rec_enqueue_waiting(
 		lock_prdt_set_prdt(lock, prdt);
 	}
 
-	if (const trx_t* victim =
-	    DeadlockChecker::check_and_resolve(lock, trx)) {
-		ut_ad(victim == trx);
-		lock_reset_lock_and_trx_wait(lock);
-		lock_rec_reset_nth_bit(lock, heap_no);
-		return DB_DEADLOCK;
-	}
-
 	if (!trx->lock.wait_lock) {
-		/* If there was a deadlock but we chose another
-		transaction as a victim, it is possible that we
-		already have the lock now granted! */
+		/* The conflicting transaction may have been chosen
+		as a victim by lock_rec_create(), and we already have
+		the lock now granted! */
 #ifdef WITH_WSREP
 		if (wsrep_debug) {
 			ib::info() << "WSREP: BF thread got lock granted early, ID " << ib::hex(trx->id)
@@ -1771,6 +1770,8 @@ lock_rec_enqueue_waiting(
 		return DB_SUCCESS_LOCKED_REC;
 	}
 
+	DeadlockChecker::register_wait(lock, trx);
+
 	trx->lock.que_state = TRX_QUE_LOCK_WAIT;
 
 	trx->lock.was_chosen_as_deadlock_victim = false;
@@ -1824,7 +1825,7 @@ lock_rec_add_to_queue(
 					transaction mutex */
 {
 #ifdef UNIV_DEBUG
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index)
 	      || dict_index_get_online_status(index) != ONLINE_INDEX_CREATION);
@@ -1928,6 +1929,77 @@ lock_rec_add_to_queue(
 		type_mode, block, heap_no, index, trx, caller_owns_trx_mutex);
 }
 
+/** Try to lock a record while holding lock_sys.latch in shared mode.
+Only the record lock queue of the page is accessed, under the shard mutex.
+If the request conflicts with another transaction, nothing is done,
+and the caller must retry while holding lock_sys.latch in exclusive mode,
+so that a waiting lock request can be enqueued and deadlocks detected.
+@param[in]	impl	if true, no lock is set if no wait is necessary
+@param[in]	mode	LOCK_X or LOCK_S possibly ORed to either
+			LOCK_GAP or LOCK_REC_NOT_GAP
+@param[in]	block	buffer block containing the record
+@param[in]	heap_no	heap number of the record
+@param[in]	index	index of the record
+@param[in,out]	trx	transaction
+@return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, or
+DB_LOCK_WAIT if the request must be retried */
+static
+dberr_t
+lock_rec_lock_shared(
+	bool			impl,
+	ulint			mode,
+	const buf_block_t*	block,
+	ulint			heap_no,
+	dict_index_t*		index,
+	trx_t*			trx)
+{
+	dberr_t	err = DB_LOCK_WAIT;
+
+	rw_lock_s_lock(lock_sys.latch);
+
+	/* block->lock_hash_val is only updated by lock_sys.resize(),
+	which holds lock_sys.latch in exclusive mode. */
+	LockMutex*	shard = lock_sys.get_shard_mutex(
+		buf_block_get_lock_hash_val(block));
+
+	mutex_enter(shard);
+	trx_mutex_enter(trx);
+	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
+	      || lock_table_has(trx, index->table, LOCK_IS));
+	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
+	      || lock_table_has(trx, index->table, LOCK_IX));
+
+	if (!lock_rec_get_first_on_page(lock_sys.rec_hash, block)) {
+		if (!impl) {
+			lock_rec_create(
+#ifdef WITH_WSREP
+				NULL, NULL,
+#endif
+				mode, block, heap_no, index, trx, true);
+		}
+
+		err = DB_SUCCESS_LOCKED_REC;
+	} else if (lock_rec_has_expl(mode, block, heap_no, trx)) {
+		/* The transaction already has a strong enough lock. */
+		err = DB_SUCCESS;
+	} else if (!lock_rec_other_has_conflicting(
+			   mode, block, heap_no, trx)) {
+		if (impl) {
+			err = DB_SUCCESS;
+		} else {
+			lock_rec_add_to_queue(LOCK_REC | mode, block, heap_no,
+					      index, trx, true);
+			err = DB_SUCCESS_LOCKED_REC;
+		}
+	}
+
+	trx_mutex_exit(trx);
+	mutex_exit(shard);
+	rw_lock_s_unlock(lock_sys.latch);
+
+	return(err);
+}
+
 /*********************************************************************//**
 Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
@@ -1964,6 +2036,19 @@ lock_rec_lock(
   ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
   DBUG_EXECUTE_IF("innodb_report_deadlock", return DB_DEADLOCK;);
 
+#ifdef WITH_WSREP
+  if (!wsrep_on_trx(trx))
+#endif /* WITH_WSREP */
+  {
+    err= lock_rec_lock_shared(impl, mode, block, heap_no, index, trx);
+    if (err != DB_LOCK_WAIT)
+    {
+      MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
+      return err;
+    }
+    err= DB_SUCCESS;
+  }
+
   lock_mutex_enter();
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_S ||
         lock_table_has(trx, index->table, LOCK_IS));
@@ -3727,7 +3812,8 @@ lock_table_remove_low(
 
 /*********************************************************************//**
 Enqueues a waiting request for a table lock which cannot be granted
-immediately. Checks for deadlocks.
+immediately. The wait will be checked for deadlocks by
+lock_deadlock_detect_thread.
 @retval	DB_LOCK_WAIT	if the waiting lock was enqueued
 @retval	DB_DEADLOCK	if this transaction was chosen as the victim
 @retval	DB_SUCCESS	if the other transaction committed or aborted */
@@ -3778,26 +3864,15 @@ lock_table_enqueue_waiting(
 #endif
 				 );
 
-	const trx_t*	victim_trx =
-			DeadlockChecker::check_and_resolve(lock, trx);
-
-	if (victim_trx != 0) {
-		ut_ad(victim_trx == trx);
-
-		/* The order here is important, we don't want to
-		lose the state of the lock before calling remove. */
-		lock_table_remove_low(lock);
-		lock_reset_lock_and_trx_wait(lock);
-
-		return(DB_DEADLOCK);
-
-	} else if (trx->lock.wait_lock == NULL) {
-		/* Deadlock resolution chose another transaction as a victim,
-		and we accidentally got our lock granted! */
+	if (trx->lock.wait_lock == NULL) {
+		/* The conflicting transaction was chosen as a victim
+		by lock_table_create(), and we got our lock granted! */
 
 		return(DB_SUCCESS);
 	}
 
+	DeadlockChecker::register_wait(lock, trx);
+
 	trx->lock.que_state = TRX_QUE_LOCK_WAIT;
 
 	trx->lock.wait_started = ut_time();
@@ -3893,7 +3968,7 @@ lock_table(
 	trx = thr_get_trx(thr);
 
 	/* Look for equal or stronger locks the same trx already
-	has on the table. No need to acquire the lock mutex here
+	has on the table. No need to acquire lock_sys.latch here
 	because only this transacton can add/access table locks
 	to/from trx_t::table_locks. */
 
@@ -3952,17 +4027,18 @@ lock_table(
 	return(err);
 }
 
-/*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+/** Create a table lock object for a resurrected transaction.
+@param[in,out]	table	table
+@param[in,out]	trx	recovered transaction
+@param[in]	mode	LOCK_IX, or LOCK_X if the transaction
+			inserted into an empty table (TRX_UNDO_EMPTY) */
 void
-lock_table_ix_resurrect(
-/*====================*/
-	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+lock_table_resurrect(dict_table_t* table, trx_t* trx, lock_mode mode)
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_IX || mode == LOCK_X);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -3972,10 +4048,10 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	trx_mutex_enter(trx);
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
@@ -4363,7 +4439,7 @@ lock_trx_table_locks_remove(
 
 	ut_ad(lock_mutex_own());
 
-	/* It is safe to read this because we are holding the lock mutex */
+	/* It is safe to read this because we are holding lock_sys.latch */
 	if (!trx->lock.cancel) {
 		trx_mutex_enter(trx);
 	} else {
@@ -4582,15 +4658,15 @@ lock_get_n_rec_locks(void)
 
 /*********************************************************************//**
 Prints info of locks for all transactions.
-@return FALSE if not able to obtain lock mutex
+@return FALSE if not able to obtain lock_sys.latch
 and exits without printing info */
 ibool
 lock_print_info_summary(
 /*====================*/
 	FILE*	file,	/*!< in: file where to print */
-	ibool	nowait)	/*!< in: whether to wait for the lock mutex */
+	ibool	nowait)	/*!< in: whether to wait for lock_sys.latch */
 {
-	/* if nowait is FALSE, wait on the lock mutex,
+	/* if nowait is FALSE, wait on lock_sys.latch,
 	otherwise return immediately if fail to obtain the
 	mutex. */
 	if (!nowait) {
@@ -4759,7 +4835,7 @@ static my_bool lock_print_info_all_transactions_callback(
 
 /*********************************************************************//**
 Prints info of locks for each transaction. This function assumes that the
-caller holds the lock mutex and more importantly it will release the lock
+caller holds lock_sys.latch and more importantly it will release the lock
 mutex on behalf of the caller. (This should be fixed in the future). */
 void
 lock_print_info_all_transactions(
@@ -4852,8 +4928,8 @@ lock_table_queue_validate(
 
 		/* Transaction state may change from ACTIVE to PREPARED.
 		State change to COMMITTED is not possible while we are
-		holding lock_sys.mutex: it is done by lock_trx_release_locks()
-		under lock_sys.mutex protection.
+		holding lock_sys.latch: it is done by lock_trx_release_locks()
+		under lock_sys.latch protection.
 		Transaction in NOT_STARTED state cannot hold locks, and
 		lock->trx->state can only move to NOT_STARTED from COMMITTED. */
 		check_trx_state(lock->trx);
@@ -4883,7 +4959,7 @@ lock_rec_queue_validate(
 /*====================*/
 	bool			locked_lock_trx_sys,
 					/*!< in: if the caller holds
-					both the lock mutex and
+					both lock_sys.latch and
 					trx_sys_t->lock. */
 	const buf_block_t*	block,	/*!< in: buffer block containing rec */
 	const rec_t*		rec,	/*!< in: record to look at */
@@ -4935,14 +5011,14 @@ lock_rec_queue_validate(
 
 	} else if (dict_index_is_clust(index)) {
 		/* Unlike the non-debug code, this invariant can only succeed
-		if the check and assertion are covered by the lock mutex. */
+		if the check and assertion are covered by lock_sys.latch. */
 
 		const trx_t *impl_trx = trx_sys.rw_trx_hash.find(current_trx(),
 			lock_clust_rec_some_has_impl(rec, index, offsets));
 
 		ut_ad(lock_mutex_own());
 		/* impl_trx cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys.mutex */
+		because lock_trx_release_locks() acquires lock_sys.latch */
 
 		if (!impl_trx) {
 		} else if (const lock_t* other_lock
@@ -5257,7 +5333,7 @@ lock_validate()
 				    (lock_validate_table_locks), 0);
 
 	/* Iterate over all the record locks and validate the locks. We
-	don't want to hog the lock_sys_t::mutex and the trx_sys_t::mutex.
+	don't want to hog lock_sys.latch and the trx_sys_t::mutex.
 	Release both mutexes during the validation check. */
 
 	for (ulint i = 0; i < hash_get_n_cells(lock_sys.rec_hash); i++) {
@@ -6274,11 +6350,11 @@ lock_trx_release_locks(
 
 	bool release_lock = UT_LIST_GET_LEN(trx->lock.trx_locks) > 0;
 
-	/* Don't take lock_sys.mutex if trx didn't acquire any lock. */
+	/* Don't take lock_sys.latch if trx didn't acquire any lock. */
 	if (release_lock) {
 
 		/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-		is protected by both the lock_sys.mutex and the trx->mutex. */
+		is protected by both lock_sys.latch and the trx->mutex. */
 		lock_mutex_enter();
 	}
 
@@ -6342,6 +6418,10 @@ lock_trx_release_locks(
 	ut_a(trx->lock.table_locks.empty());
 
 	mem_heap_empty(trx->lock.lock_heap);
+
+	/* Now that the record locks have been released, admit the
+	next transactions to the queues of the hot rows. */
+	lock_hot_row.release(trx);
 }
 
 static inline dberr_t lock_trx_handle_wait_low(trx_t* trx)
@@ -6584,6 +6664,40 @@ lock_trx_has_rec_x_lock(
 }
 #endif /* UNIV_DEBUG */
 
+/** Check if a transaction holds or waits for a table lock other than an
+intention lock, such as from LOCK TABLES or an AUTO_INC lock.
+@param[in]	trx	transaction, serviced by the current thread
+@return whether such a table lock exists */
+bool
+lock_trx_has_strong_table_lock(const trx_t* trx)
+{
+	bool	found = false;
+
+	rw_lock_s_lock(lock_sys.latch);
+
+	typedef lock_pool_t::const_iterator iterator;
+
+	for (iterator it = trx->lock.table_locks.begin(),
+		     end = trx->lock.table_locks.end();
+	     it != end; ++it) {
+		if (const lock_t* lock = *it) {
+			switch (lock_get_mode(lock)) {
+			case LOCK_IS:
+			case LOCK_IX:
+				continue;
+			default:
+				found = true;
+			}
+
+			break;
+		}
+	}
+
+	rw_lock_s_unlock(lock_sys.latch);
+
+	return(found);
+}
+
 /** rewind(3) the file used for storing the latest detected deadlock and
 print a heading message to stderr if printing of all deadlocks to stderr
 is enabled. */
@@ -6656,297 +6770,479 @@ DeadlockChecker::print(const lock_t* lock)
 	}
 }
 
-/** Get the next lock in the queue that is owned by a transaction whose
-sub-tree has not already been searched.
-Note: "next" here means PREV for table locks.
+/** Determine if a lock request in the queue of a waiting lock request
+is blocking it.
+@param[in]	wait_lock	waiting lock request
+@param[in]	lock		lock request in the same queue
+@param[in,out]	behind		whether wait_lock has been passed in the queue
+@return whether wait_lock has to wait for lock */
+static
+bool
+lock_wait_is_blocked_by(
+	const lock_t*	wait_lock,
+	const lock_t*	lock,
+	bool&		behind)
+{
+	if (lock == wait_lock) {
+		behind = true;
+		return(false);
+	}
 
-@param lock Lock in queue
-@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
+	/* With innodb_lock_schedule_algorithm=VATS, a granted lock
+	may be located behind the waiting request. Waiting requests
+	behind wait_lock are not blocking it. */
+	return(lock->trx != wait_lock->trx
+	       && !(behind && lock_get_wait(lock))
+	       && lock_has_to_wait(wait_lock, lock));
+}
 
-@return next lock or NULL if at end of queue */
-const lock_t*
-DeadlockChecker::get_next_lock(const lock_t* lock, ulint heap_no) const
+/** Invoke a functor on each lock request that a waiting lock request
+has to wait for.
+@param[in]	wait_lock	waiting lock request
+@param[in,out]	functor		invoked as functor(lock) */
+template<typename Functor>
+static
+void
+lock_wait_for_each_blocker(const lock_t* wait_lock, Functor& functor)
 {
 	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
 
-	do {
-		if (lock_get_type_low(lock) == LOCK_REC) {
-			ut_ad(heap_no != ULINT_UNDEFINED);
+	bool	behind = false;
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		hash_table_t*	lock_hash = wait_lock->type_mode
+			& LOCK_PREDICATE
+			? lock_sys.prdt_hash
+			: lock_sys.rec_hash;
+
+		/* We are only interested in records that match the heap_no. */
+		const ulint	heap_no = lock_rec_find_set_bit(wait_lock);
+
+		ut_ad(heap_no <= 0xffff);
+
+		const lock_t*	lock = lock_rec_get_first_on_page_addr(
+			lock_hash,
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
+
+		/* Position on the first lock on the physical record. */
+		if (!lock_rec_get_nth_bit(lock, heap_no)) {
 			lock = lock_rec_get_next_const(heap_no, lock);
-		} else {
-			ut_ad(heap_no == ULINT_UNDEFINED);
-			ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
+		}
 
-			lock = UT_LIST_GET_NEXT(
-				un_member.tab_lock.locks, lock);
+		for (; lock != NULL;
+		     lock = lock_rec_get_next_const(heap_no, lock)) {
+			if (lock_wait_is_blocked_by(wait_lock, lock, behind)) {
+				functor(lock);
+			}
 		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
 
-	} while (lock != NULL && is_visited(lock));
+		for (const lock_t* lock = UT_LIST_GET_FIRST(
+			     wait_lock->un_member.tab_lock.table->locks);
+		     lock != NULL;
+		     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
+			if (lock_wait_is_blocked_by(wait_lock, lock, behind)) {
+				functor(lock);
+			}
+		}
+	}
+}
 
-	ut_ad(lock == NULL
-	      || lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
+/** Functor for reporting lock waits to the replication layer */
+struct DeadlockChecker::report_wait_t {
+	/** the waiting connection */
+	THD*	m_thd;
 
-	return(lock);
-}
+	void operator()(const lock_t* lock) const
+	{
+		/* We do not need to report autoinc locks to the upper
+		layer. These locks are released before commit, so they
+		can not cause deadlocks with binlog-fixed commit
+		order. */
+		if (lock_get_type_low(lock) != LOCK_TABLE
+		    || lock_get_mode(lock) != LOCK_AUTO_INC) {
+			thd_rpl_deadlock_check(m_thd, lock->trx->mysql_thd);
+		}
+	}
+};
 
-/** Get the first lock to search. The search starts from the current
-wait_lock. What we are really interested in is an edge from the
-current wait_lock's owning transaction to another transaction that has
-a lock ahead in the queue. We skip locks where the owning transaction's
-sub-tree has already been searched.
+/** Functor for adding the edges of a transaction to m_edges */
+struct DeadlockChecker::add_edge_t {
+	/** the deadlock detector */
+	DeadlockChecker&	m_checker;
 
-Note: The record locks are traversed from the oldest lock to the
-latest. For table locks we go from latest to oldest.
+	void operator()(const lock_t* lock) const
+	{
+		m_checker.m_cost++;
 
-For record locks, we first position the "iterator" on the first lock on
-the page and then reposition on the actual heap_no. This is required
-due to the way the record lock has is implemented.
+		/* A transaction that is not waiting cannot be part
+		of a cycle. */
+		if (lock->trx->lock.wait_lock != NULL) {
+			m_checker.m_edges.push_back(
+				m_checker.node_of(lock->trx));
+		}
+	}
+};
 
-@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
-@return first lock or NULL */
-const lock_t*
-DeadlockChecker::get_first_lock(ulint* heap_no) const
+/** Functor for finding the lock that blocks a waiting request */
+struct DeadlockChecker::find_blocker_t {
+	/** the transaction that holds the lock */
+	const trx_t*	m_trx;
+	/** the blocking lock, or NULL if not found */
+	const lock_t*	m_lock;
+
+	void operator()(const lock_t* lock)
+	{
+		if (m_lock == NULL && lock->trx == m_trx) {
+			m_lock = lock;
+		}
+	}
+};
+
+/** Register a lock wait that has just been enqueued. The waits-for graph
+will be searched by lock_deadlock_detect_thread after the transaction has
+been suspended in lock_wait_suspend_thread().
+@param[in]	lock	waiting lock request
+@param[in,out]	trx	transaction that requested the lock */
+void
+DeadlockChecker::register_wait(const lock_t* lock, trx_t* trx)
 {
 	ut_ad(lock_mutex_own());
+	ut_ad(trx_mutex_own(trx));
+	ut_ad(lock->trx == trx);
+	ut_ad(trx->lock.wait_lock == lock);
+	check_trx_state(trx);
+	ut_ad(!srv_read_only_mode);
 
-	const lock_t*	lock = m_wait_lock;
+	trx->lock.wait_seq = ++s_wait_seq;
+	trx->lock.wait_checked = false;
+	trx->lock.deadlock_mark = 0;
 
-	if (lock_get_type_low(lock) == LOCK_REC) {
-		hash_table_t*	lock_hash;
+	if (!innobase_deadlock_detect
+	    || !trx->mysql_thd || !thd_need_wait_reports(trx->mysql_thd)) {
+		return;
+	}
 
-		lock_hash = lock->type_mode & LOCK_PREDICATE
-			? lock_sys.prdt_hash
-			: lock_sys.rec_hash;
+	/* Release the mutex to obey the latching order.
+	This is safe, because DeadlockChecker::register_wait()
+	is invoked when a lock wait is enqueued for the currently
+	running transaction. Because trx is a running transaction
+	(it is not currently suspended because of a lock wait),
+	its state can only be changed by this thread, which is
+	currently associated with the transaction. */
 
-		/* We are only interested in records that match the heap_no. */
-		*heap_no = lock_rec_find_set_bit(lock);
+	trx_mutex_exit(trx);
 
-		ut_ad(*heap_no <= 0xffff);
-		ut_ad(*heap_no != ULINT_UNDEFINED);
+	report_wait_t	report = { trx->mysql_thd };
 
-		/* Find the locks on the page. */
-		lock = lock_rec_get_first_on_page_addr(
-			lock_hash,
-			lock->un_member.rec_lock.space,
-			lock->un_member.rec_lock.page_no);
+	lock_wait_for_each_blocker(lock, report);
 
-		/* Position on the first lock on the physical record.*/
-		if (!lock_rec_get_nth_bit(lock, *heap_no)) {
-			lock = lock_rec_get_next_const(*heap_no, lock);
-		}
+	trx_mutex_enter(trx);
+}
 
-		ut_a(!lock_get_wait(lock));
-	} else {
-		/* Table locks don't care about the heap_no. */
-		*heap_no = ULINT_UNDEFINED;
-		ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
-		dict_table_t*	table = lock->un_member.tab_lock.table;
-		lock = UT_LIST_GET_FIRST(table->locks);
+/** Look up or add the node of a waiting transaction in the copy of the
+waits-for graph.
+@param[in,out]	trx	waiting transaction
+@return the node in m_nodes */
+ulint
+DeadlockChecker::node_of(trx_t* trx)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(trx->lock.wait_lock != NULL);
+
+	if (trx->lock.deadlock_mark > m_mark_start) {
+		return(ulint(trx->lock.deadlock_mark - m_mark_start - 1));
 	}
 
-	/* Must find at least two locks, otherwise there cannot be a
-	waiting lock, secondly the first lock cannot be the wait_lock. */
-	ut_a(lock != NULL);
-	ut_a(lock != m_wait_lock ||
-	     (innodb_lock_schedule_algorithm
-	      	== INNODB_LOCK_SCHEDULE_ALGORITHM_VATS
-	      && !thd_is_replication_slave_thread(lock->trx->mysql_thd)));
+	node_t	node;
 
-	/* Check that the lock type doesn't change. */
-	ut_ad(lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
+	node.trx = trx;
+	node.wait_seq = trx->lock.wait_seq;
+	node.first_edge = 0;
+	node.end_edge = 0;
+	node.suspended = is_suspended(trx);
+	node.copied = false;
+	node.visited = 0;
 
-	return(lock);
+	m_nodes.push_back(node);
+
+	trx->lock.deadlock_mark = m_mark_start + m_nodes.size();
+
+	return(m_nodes.size() - 1);
 }
 
-/** Notify that a deadlock has been detected and print the conflicting
-transaction info.
-@param lock lock causing deadlock */
-void
-DeadlockChecker::notify(const lock_t* lock) const
+/** Copy the waits-for graph that is reachable from the lock waits that
+have not been searched from yet.
+@return number of lock waits that have not been searched from */
+ulint
+DeadlockChecker::copy_graph()
 {
 	ut_ad(lock_mutex_own());
 
-	start_print();
+	m_suspended.clear();
+	m_nodes.clear();
+	m_edges.clear();
 
-	print("\n*** (1) TRANSACTION:\n");
+	for (const srv_slot_t* slot = lock_sys.waiting_threads;
+	     slot < lock_sys.last_slot;
+	     ++slot) {
 
-	print(m_wait_lock->trx, 3000);
+		if (slot->in_use) {
+			m_suspended.push_back(thr_get_trx(slot->thr));
+		}
+	}
 
-	print("*** (1) WAITING FOR THIS LOCK TO BE GRANTED:\n");
+	std::sort(m_suspended.begin(), m_suspended.end());
 
-	print(m_wait_lock);
+	m_mark_start = s_lock_mark_counter;
+	m_cost = 0;
 
-	print("*** (2) TRANSACTION:\n");
+	for (ulint i = 0; i < m_suspended.size(); i++) {
+		trx_t*	trx = m_suspended[i];
 
-	print(lock->trx, 3000);
+		if (trx->lock.wait_lock != NULL
+		    && !trx->lock.wait_checked) {
+			trx->lock.wait_checked = true;
+			node_of(trx);
+		}
+	}
 
-	print("*** (2) HOLDS THE LOCK(S):\n");
+	const ulint	n_new_waits = m_nodes.size();
+	add_edge_t	add_edge = { *this };
 
-	print(lock);
+	/* Copy the outgoing edges breadth first. The nodes that are
+	added after the limit has been exceeded are left without
+	edges, and a search that reaches them is too long. */
+	for (ulint i = 0;
+	     i < m_nodes.size()
+	     && m_cost <= LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK;
+	     i++) {
 
-	/* It is possible that the joining transaction was granted its
-	lock when we rolled back some other waiting transaction. */
+		m_nodes[i].first_edge = m_edges.size();
 
-	if (m_start->lock.wait_lock != 0) {
-		print("*** (2) WAITING FOR THIS LOCK TO BE GRANTED:\n");
+		lock_wait_for_each_blocker(m_nodes[i].trx->lock.wait_lock,
+					   add_edge);
 
-		print(m_start->lock.wait_lock);
+		m_nodes[i].end_edge = m_edges.size();
+		m_nodes[i].copied = true;
 	}
 
-	DBUG_PRINT("ib_lock", ("deadlock detected"));
+	s_lock_mark_counter = m_mark_start + m_nodes.size();
+
+	return(n_new_waits);
 }
 
-/** Select the victim transaction that should be rolledback.
-@return victim transaction */
-const trx_t*
-DeadlockChecker::select_victim() const
+/** Search the copy of the waits-for graph for a cycle that contains a
+node. This does not access any transaction or lock.
+@param[in]	start	node in m_nodes
+@return the result of the search */
+DeadlockChecker::search_t
+DeadlockChecker::search(ulint start)
 {
-	ut_ad(lock_mutex_own());
-	ut_ad(m_start->lock.wait_lock != 0);
-	ut_ad(m_wait_lock->trx != m_start);
+	ut_ad(m_stack.empty());
 
-	if (trx_weight_ge(m_wait_lock->trx, m_start)) {
-		/* The joining transaction is 'smaller',
-		choose it as the victim and roll it back. */
-#ifdef WITH_WSREP
-		if (wsrep_thd_is_BF(m_start->mysql_thd, TRUE)) {
-			return(m_wait_lock->trx);
+	/* Nodes that were visited by an earlier search from another
+	node can still be on a cycle that contains this one. Within
+	one search, a node that has been visited need not be visited
+	again, because every path from it has been or is being
+	followed. */
+	const ulint	id = start + 1;
+
+	if (!m_nodes[start].copied) {
+		return(TOO_DEEP);
+	}
+
+	push(start, id);
+
+	while (!m_stack.empty()) {
+		frame_t&	frame = m_stack.back();
+
+		if (frame.next_edge == m_nodes[frame.node].end_edge) {
+			m_stack.pop_back();
+			continue;
 		}
-#endif /* WITH_WSREP */
-		return(m_start);
+
+		const ulint	blocker = m_edges[frame.next_edge++];
+
+		if (blocker == start) {
+			/* Found a cycle: each node on the stack is
+			waiting for the next one, and the last one is
+			waiting for the first one. */
+			return(CYCLE);
+		}
+
+		if (m_nodes[blocker].visited == id) {
+			continue;
+		}
+
+		if (!m_nodes[blocker].copied
+		    || m_stack.size() >= LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK) {
+			m_stack.clear();
+			return(TOO_DEEP);
+		}
+
+		push(blocker, id);
 	}
 
+	return(NO_CYCLE);
+}
+
+/** Check if a transaction should rather be chosen as the victim than
+another one.
+@param[in]	a	candidate
+@param[in]	b	current choice
+@return whether a should be rolled back instead of b */
+bool
+DeadlockChecker::prefer_victim(const trx_t* a, const trx_t* b)
+{
+	ut_ad(lock_mutex_own());
+
 #ifdef WITH_WSREP
-	if (wsrep_thd_is_BF(m_wait_lock->trx->mysql_thd, TRUE)) {
-		return(m_start);
+	bool	a_bf = wsrep_thd_is_BF(a->mysql_thd, TRUE);
+
+	if (a_bf != wsrep_thd_is_BF(b->mysql_thd, TRUE)) {
+		return(!a_bf);
 	}
 #endif /* WITH_WSREP */
 
-	return(m_wait_lock->trx);
+	if (!trx_weight_ge(a, b)) {
+		/* a is 'smaller' */
+		return(true);
+	}
+
+	if (!trx_weight_ge(b, a)) {
+		return(false);
+	}
+
+	/* Roll back the transaction that started to wait last, that is,
+	the one that completed the cycle. */
+	return(a->lock.wait_seq > b->lock.wait_seq);
 }
 
-/** Looks iteratively for a deadlock. Note: the joining transaction may
-have been granted its lock by the deadlock checks.
-@return 0 if no deadlock else the victim transaction instance.*/
-const trx_t*
-DeadlockChecker::search()
+/** Resolve the deadlock that is formed by the nodes on m_stack, if it
+still exists. Each transaction waits for the next one, and the last one
+for the first one.
+@return whether a victim transaction was chosen */
+bool
+DeadlockChecker::resolve()
 {
 	ut_ad(lock_mutex_own());
-	ut_ad(!trx_mutex_own(m_start));
 
-	ut_ad(m_start != NULL);
-	ut_ad(m_wait_lock != NULL);
-	check_trx_state(m_wait_lock->trx);
-	ut_ad(m_mark_start <= s_lock_mark_counter);
+	const ulint	n = m_stack.size();
+	ulint		victim = 0;
 
-	/* Look at the locks ahead of wait_lock in the lock queue. */
-	ulint		heap_no;
-	const lock_t*	lock = get_first_lock(&heap_no);
+	ut_ad(n > 1);
+
+	/* Only a suspended transaction can be chosen as the victim.
+	If some transaction had not been suspended yet, the cycle
+	will be found when it has been. */
+	for (ulint i = 0; i < n; i++) {
+		if (!m_nodes[m_stack[i].node].suspended) {
+			return(false);
+		}
+	}
 
-	for (;;) {
-		/* We should never visit the same sub-tree more than once. */
-		ut_ad(lock == NULL || !is_visited(lock));
+	/* The graph was searched without holding lock_sys.latch.
+	A transaction that is still in the same lock wait has not
+	released any locks, but the wait that blocked it may have
+	ended, or it may have been granted. */
+	for (ulint i = 0; i < n; i++) {
+		const node_t&	node = m_nodes[m_stack[i].node];
+		const node_t&	next = m_nodes[m_stack[
+			i + 1 < n ? i + 1 : 0].node];
 
-		while (m_n_elems > 0 && lock == NULL) {
+		if (!is_waiting(node) || !is_waiting(next)) {
+			return(false);
+		}
 
-			/* Restore previous search state. */
+		find_blocker_t	blocker = { next.trx, NULL };
 
-			pop(lock, heap_no);
+		lock_wait_for_each_blocker(node.trx->lock.wait_lock, blocker);
 
-			lock = get_next_lock(lock, heap_no);
+		if (blocker.m_lock == NULL) {
+			return(false);
 		}
 
-		if (lock == NULL) {
-			break;
+		if (i > 0 && prefer_victim(node.trx,
+					   m_nodes[m_stack[victim].node].trx)) {
+			victim = i;
 		}
+	}
 
-		if (lock == m_wait_lock) {
+	start_print();
 
-			/* We can mark this subtree as searched */
-			ut_ad(lock->trx->lock.deadlock_mark <= m_mark_start);
+	for (ulint i = 0; i < n; i++) {
+		const trx_t*	trx = m_nodes[m_stack[i].node].trx;
+		const lock_t*	wait_lock = m_nodes[m_stack[
+			i ? i - 1 : n - 1].node].trx->lock.wait_lock;
+		find_blocker_t	blocker = { trx, NULL };
+		char		msg[64];
 
-			lock->trx->lock.deadlock_mark = ++s_lock_mark_counter;
+		lock_wait_for_each_blocker(wait_lock, blocker);
+		ut_ad(blocker.m_lock != NULL);
 
-			/* We are not prepared for an overflow. This 64-bit
-			counter should never wrap around. At 10^9 increments
-			per second, it would take 10^3 years of uptime. */
+		snprintf(msg, sizeof msg, "%s*** (" ULINTPF ") TRANSACTION:\n",
+			 i ? "" : "\n", i + 1);
+		print(msg);
+		print(trx, 3000);
 
-			ut_ad(s_lock_mark_counter > 0);
+		snprintf(msg, sizeof msg,
+			 "*** (" ULINTPF ") HOLDS THE LOCK(S):\n", i + 1);
+		print(msg);
+		print(blocker.m_lock);
 
-			/* Backtrack */
-			lock = NULL;
-			continue;
-		}
+		snprintf(msg, sizeof msg,
+			 "*** (" ULINTPF ") WAITING FOR THIS LOCK"
+			 " TO BE GRANTED:\n", i + 1);
+		print(msg);
+		print(trx->lock.wait_lock);
+	}
 
-		if (!lock_has_to_wait(m_wait_lock, lock)) {
-			/* No conflict, next lock */
-			lock = get_next_lock(lock, heap_no);
-			continue;
-		}
+	char	msg[64];
 
-		if (lock->trx == m_start) {
-			/* Found a cycle. */
-			notify(lock);
-			return select_victim();
-		}
+	snprintf(msg, sizeof msg, "*** WE ROLL BACK TRANSACTION (" ULINTPF
+		 ")\n", victim + 1);
+	print(msg);
 
-		if (is_too_deep()) {
-			/* Search too deep to continue. */
-			m_too_deep = true;
-			return m_start;
-		}
+	DBUG_PRINT("ib_lock", ("deadlock detected"));
 
-		/* We do not need to report autoinc locks to the upper
-		layer. These locks are released before commit, so they
-		can not cause deadlocks with binlog-fixed commit
-		order. */
-		if (m_report_waiters
-		    && (lock_get_type_low(lock) != LOCK_TABLE
-			|| lock_get_mode(lock) != LOCK_AUTO_INC)) {
-			thd_rpl_deadlock_check(m_start->mysql_thd,
-					       lock->trx->mysql_thd);
-		}
+	MONITOR_INC(MONITOR_DEADLOCK);
 
-		if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
-			/* Another trx ahead has requested a lock in an
-			incompatible mode, and is itself waiting for a lock. */
+	rollback(m_nodes[m_stack[victim].node].trx);
 
-			++m_cost;
+	return(true);
+}
 
-			if (!push(lock, heap_no)) {
-				m_too_deep = true;
-				return m_start;
-			}
+/** Cancel the lock wait of a deadlock victim.
+@param[in,out]	trx	transaction to be rolled back */
+void
+DeadlockChecker::rollback(trx_t* trx)
+{
+	ut_ad(lock_mutex_own());
 
-			m_wait_lock = lock->trx->lock.wait_lock;
+	trx_mutex_enter(trx);
 
-			lock = get_first_lock(&heap_no);
+	trx->lock.was_chosen_as_deadlock_victim = true;
 
-			if (is_visited(lock)) {
-				lock = get_next_lock(lock, heap_no);
-			}
-		} else {
-			lock = get_next_lock(lock, heap_no);
-		}
-	}
+	lock_cancel_waiting_and_release(trx->lock.wait_lock);
 
-	ut_a(lock == NULL && m_n_elems == 0);
+	trx_mutex_exit(trx);
 
-	/* No deadlock found. */
-	return(0);
+	lock_deadlock_found = true;
 }
 
-/** Print info about transaction that was rolled back.
-@param trx transaction rolled back
-@param lock lock trx wants */
+/** Print info about a transaction that is rolled back because the search
+was too deep or long.
+@param[in]	trx	transaction to be rolled back
+@param[in]	lock	lock that the transaction is waiting for */
 void
-DeadlockChecker::rollback_print(const trx_t*	trx, const lock_t* lock)
+DeadlockChecker::rollback_print(const trx_t* trx, const lock_t* lock)
 {
 	ut_ad(lock_mutex_own());
 
-	/* If the lock search exceeds the max step
-	or the max depth, the current trx will be
-	the victim. Print its information. */
 	start_print();
 
 	print("TOO DEEP OR LONG SEARCH IN THE LOCK TABLE"
@@ -6961,107 +7257,104 @@ DeadlockChecker::rollback_print(const trx_t*	trx, const lock_t* lock)
 	print(lock);
 }
 
-/** Rollback transaction selected as the victim. */
-void
-DeadlockChecker::trx_rollback()
+/** Search the waits-for graph for cycles that contain a lock wait that
+has been suspended since the previous call, and resolve them.
+@return number of transactions that were chosen as victims */
+ulint
+DeadlockChecker::check_and_resolve()
 {
-	ut_ad(lock_mutex_own());
-
-	trx_t*	trx = m_wait_lock->trx;
-
-	print("*** WE ROLL BACK TRANSACTION (1)\n");
-
-	trx_mutex_enter(trx);
+	ut_ad(!lock_mutex_own());
+	ut_ad(!srv_read_only_mode);
 
-	trx->lock.was_chosen_as_deadlock_victim = true;
+	ulint	n_victims = 0;
 
-	lock_cancel_waiting_and_release(trx->lock.wait_lock);
+	lock_wait_mutex_enter();
+	lock_mutex_enter();
 
-	trx_mutex_exit(trx);
-}
+	const ulint	n_new_waits = copy_graph();
 
-/** Checks if a joining lock request results in a deadlock. If a deadlock is
-found this function will resolve the deadlock by choosing a victim transaction
-and rolling it back. It will attempt to resolve all deadlocks. The returned
-transaction id will be the joining transaction instance or NULL if some other
-transaction was chosen as a victim and rolled back or no deadlock found.
+	lock_mutex_exit();
+	lock_wait_mutex_exit();
 
-@param[in]	lock lock the transaction is requesting
-@param[in,out]	trx transaction requesting the lock
+	for (ulint i = 0; i < n_new_waits; i++) {
+		const search_t	found = search(i);
 
-@return transaction instanace chosen as victim or 0 */
-const trx_t*
-DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
-{
-	ut_ad(lock_mutex_own());
-	ut_ad(trx_mutex_own(trx));
-	check_trx_state(trx);
-	ut_ad(!srv_read_only_mode);
-
-	if (!innobase_deadlock_detect) {
-		return(NULL);
-	}
+		if (found == NO_CYCLE) {
+			continue;
+		}
 
-	/*  Release the mutex to obey the latching order.
-	This is safe, because DeadlockChecker::check_and_resolve()
-	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because m_trx is a running transaction
-	(it is not currently suspended because of a lock wait),
-	its state can only be changed by this thread, which is
-	currently associated with the transaction. */
+		lock_wait_mutex_enter();
+		lock_mutex_enter();
 
-	trx_mutex_exit(trx);
+		if (found == CYCLE) {
+			n_victims += resolve();
+		} else if (is_waiting(m_nodes[i])) {
+			trx_t*	trx = m_nodes[i].trx;
 
-	const trx_t*	victim_trx;
-	const bool	report_waiters = trx->mysql_thd
-		&& thd_need_wait_reports(trx->mysql_thd);
+			rollback_print(trx, trx->lock.wait_lock);
 
-	/* Try and resolve as many deadlocks as possible. */
-	do {
-		DeadlockChecker	checker(trx, lock, s_lock_mark_counter,
-					report_waiters);
+			MONITOR_INC(MONITOR_DEADLOCK);
 
-		victim_trx = checker.search();
+			rollback(trx);
 
-		/* Search too deep, we rollback the joining transaction only
-		if it is possible to rollback. Otherwise we rollback the
-		transaction that is holding the lock that the joining
-		transaction wants. */
-		if (checker.is_too_deep()) {
+			n_victims++;
+		}
 
-			ut_ad(trx == checker.m_start);
-			ut_ad(trx == victim_trx);
+		lock_mutex_exit();
+		lock_wait_mutex_exit();
 
-			rollback_print(victim_trx, lock);
+		m_stack.clear();
+	}
 
-			MONITOR_INC(MONITOR_DEADLOCK);
+	return(n_victims);
+}
 
-			break;
+/*********************************************************************//**
+A thread which searches the waits-for graph of the suspended transactions
+for cycles and resolves the deadlocks by cancelling the lock wait of a
+victim transaction.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_detect_thread)(void*)
+{
+	int64_t		sig_count = 0;
+	os_event_t	event = lock_sys.deadlock_event;
+	DeadlockChecker	checker;
 
-		} else if (victim_trx != NULL && victim_trx != trx) {
+	ut_ad(!srv_read_only_mode);
 
-			ut_ad(victim_trx == checker.m_wait_lock->trx);
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_lock_deadlock_thread_key);
+#endif /* UNIV_PFS_THREAD */
 
-			checker.trx_rollback();
+	do {
+		/* We are woken up whenever a transaction is suspended
+		in a lock wait, and on shutdown. */
 
-			lock_deadlock_found = true;
+		os_event_wait_time_low(event, 1000000, sig_count);
+		sig_count = os_event_reset(event);
 
-			MONITOR_INC(MONITOR_DEADLOCK);
+		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
+			break;
 		}
 
-	} while (victim_trx != NULL && victim_trx != trx);
+		while (innobase_deadlock_detect
+		       && checker.check_and_resolve()) {
+			/* Resolving a deadlock may have exposed
+			another one. */
+		}
 
-	/* If the joining transaction was selected as the victim. */
-	if (victim_trx != NULL) {
+	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
 
-		print("*** WE ROLL BACK TRANSACTION (2)\n");
+	lock_sys.deadlock_thread_active = false;
 
-		lock_deadlock_found = true;
-	}
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
 
-	trx_mutex_enter(trx);
+	os_thread_exit();
 
-	return(victim_trx);
+	OS_THREAD_DUMMY_RETURN;
 }
 
 /**
@@ -88,10 +88,10 @@ lock_wait_table_release_slot(
 
 	/* Note: When we reserve the slot we use the trx_t::mutex to update
 	the slot values to change the state to reserved. Here we are using the
-	lock mutex to change the state of the slot to free. This is by design,
+	lock_sys.latch to change the state of the slot to free. This is by design,
 	because when we query the slot state we always hold both the lock and
-	trx_t::mutex. To reduce contention on the lock mutex when reserving the
-	slot we avoid acquiring the lock mutex. */
+	trx_t::mutex. To reduce contention on lock_sys.latch when reserving the
+	slot we avoid acquiring lock_sys.latch. */
 
 	lock_mutex_enter();
 
@@ -184,7 +184,7 @@ lock_wait_table_reserve_slot(
 check if lock timeout was for priority thread,
 as a side effect trigger lock monitor
 @param[in]    trx    transaction owning the lock
-@param[in]    locked true if trx and lock_sys.mutex is ownd
+@param[in]    locked true if trx and lock_sys.latch is ownd
 @return	false for regular lock timeout */
 static
 bool
@@ -283,6 +283,11 @@ lock_wait_suspend_thread(
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
 
+	if (innobase_deadlock_detect) {
+		/* Let lock_deadlock_detect_thread check the wait. */
+		os_event_set(lock_sys.deadlock_event);
+	}
+
 	if (thr->lock_state == QUE_THR_LOCK_ROW) {
 		srv_stats.n_lock_wait_count.inc();
 		srv_stats.n_lock_wait_current_count.inc();
@@ -440,10 +445,10 @@ lock_wait_release_thread_if_suspended(
 	ut_ad(lock_mutex_own());
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
+	/* We own both lock_sys.latch and the trx_t::mutex but not the
 	lock wait mutex. This is OK because other threads will see the state
 	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	of the slot to free unless that thread also owns lock_sys.latch. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
@@ -556,7 +561,7 @@ DECLARE_THREAD(lock_wait_timeout_thread)(void*)
 		     slot < lock_sys.last_slot;
 		     ++slot) {
 
-			/* We are doing a read without the lock mutex
+			/* We are doing a read without lock_sys.latch
 			and/or the trx mutex. This is OK because a slot
 		       	can't be freed or reserved without the lock wait
 		       	mutex. */
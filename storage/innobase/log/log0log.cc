@@ -134,6 +134,11 @@ extern "C" UNIV_INTERN
 os_thread_ret_t
 DECLARE_THREAD(log_scrub_thread)(void*);
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	log_writer_thread_key;
+mysql_pfs_key_t	log_flusher_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /****************************************************************//**
 Returns the oldest modified block lsn in the pool, or log_sys.lsn if none
 exists.
@@ -192,6 +197,7 @@ void log_buffer_extend(ulong len)
 	}
 
 	log_sys.is_extending = true;
+	log_buf_wait_copied();
 
 	while (ut_calc_align_down(log_sys.buf_free,
 				  OS_FILE_LOG_BLOCK_SIZE)
@@ -203,6 +209,7 @@ void log_buffer_extend(ulong len)
 		log_buffer_flush_to_disk();
 
 		log_mutex_enter_all();
+		log_buf_wait_copied();
 	}
 
 	ulong move_start = ut_calc_align_down(
@@ -338,7 +345,68 @@ log_margin_checkpoint_age(
 	return;
 }
 
-/** Open the log for log_write_low. The log must be closed with log_close.
+/** Account for the log_buf_close() of reserved ranges, in reservation
+order, and advance log_sys.copied_lsn accordingly. */
+static
+void
+log_buf_advance_copied()
+{
+	ut_ad(log_mutex_own());
+
+	while (log_sys.n_copied < log_sys.n_reserved) {
+		lsn_t&	slot = log_sys.copy_slots[
+			log_sys.n_copied % LOG_BUF_COPY_SLOTS];
+		lsn_t	end_lsn = lsn_t(my_atomic_load64_explicit(
+					reinterpret_cast<int64*>(&slot),
+					MY_MEMORY_ORDER_ACQUIRE));
+		if (!end_lsn) {
+			/* The copying is still in progress. */
+			break;
+		}
+
+		slot = 0;
+		log_sys.copied_lsn = end_lsn;
+		log_sys.n_copied++;
+	}
+
+	if (log_sys.n_copied == log_sys.n_reserved) {
+		/* log_sys.lsn may have been assigned directly, for
+		example during recovery. */
+		log_sys.copied_lsn = log_sys.lsn;
+	}
+}
+
+/** Wait until the oldest range that has not been accounted in
+log_sys.n_copied has been published by log_buf_close(). The caller must
+hold log_sys.mutex, which will be released while waiting. */
+static
+void
+log_buf_wait_close()
+{
+	ut_ad(log_mutex_own());
+	ut_ad(log_sys.n_copied < log_sys.n_reserved);
+
+	lsn_t*		slot = &log_sys.copy_slots[
+		log_sys.n_copied % LOG_BUF_COPY_SLOTS];
+	const int64_t	sig_count = os_event_reset(log_sys.copied_event);
+
+	/* Either log_buf_close() will observe the increment and set
+	the event, or we will observe the published slot. The slot must
+	be checked while holding log_sys.mutex, because once the mutex
+	is released, log_buf_advance_copied() may reset the slot. */
+	my_atomic_add32(&log_sys.n_copy_waiters, 1);
+
+	if (!my_atomic_load64(reinterpret_cast<int64*>(slot))) {
+		log_mutex_exit();
+		os_event_wait_low(log_sys.copied_event, sig_count);
+		log_mutex_enter();
+	}
+
+	my_atomic_add32(&log_sys.n_copy_waiters, -1);
+}
+
+/** Ensure that there is enough space in the log buffer for a write.
+The caller must hold log_sys.mutex; it may be released and reacquired.
 @param[in]	len	length of the data to be written
 @return start lsn of the log record */
 lsn_t
@@ -389,116 +457,78 @@ log_reserve_and_open(
 		goto loop;
 	}
 
+	if (log_sys.n_reserved - log_sys.n_copied >= LOG_BUF_COPY_SLOTS) {
+		log_buf_advance_copied();
+
+		if (log_sys.n_reserved - log_sys.n_copied
+		    >= LOG_BUF_COPY_SLOTS) {
+			/* All copy slots are in use. Wait for the
+			oldest reservation to be published. */
+			MONITOR_INC(MONITOR_LOG_BUF_RESERVE_WAITS);
+			log_buf_wait_close();
+			goto loop;
+		}
+	}
+
 	return(log_sys.lsn);
 }
 
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+/** Reserve a range of the redo log buffer for a log record group, and
+advance log_sys.lsn past it. The caller must hold log_sys.mutex and must
+have invoked log_reserve_and_open(len). After the mutex has been released,
+the records must be copied by log_buf_write() and the range must be
+published by log_buf_close().
+@param[in]	len	length of the log record group, in bytes
+@param[out]	range	the reserved range */
 void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len)	/*!< in: string length */
+log_buf_reserve(
+	ulint			len,
+	log_buf_range_t&	range)
 {
-	ulint	len;
-	ulint	data_len;
-	byte*	log_block;
-
 	ut_ad(log_mutex_own());
-part_loop:
-	/* Calculate a part length */
-
-	data_len = (log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE) + str_len;
-
-	if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+	ut_ad(len > 0);
 
-		/* The string fits within the current log block */
+	/* log_reserve_and_open() waited for a free copy slot. */
+	ut_ad(log_sys.n_reserved - log_sys.n_copied < LOG_BUF_COPY_SLOTS);
 
-		len = str_len;
-	} else {
-		data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
-
-		len = OS_FILE_LOG_BLOCK_SIZE
-			- (log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE)
-			- LOG_BLOCK_TRL_SIZE;
-	}
-
-	memcpy(log_sys.buf + log_sys.buf_free, str, len);
-
-	str_len -= len;
-	str = str + len;
+	range.buf = log_sys.buf;
+	range.offset = log_sys.buf_free;
+	range.lsn = range.start_lsn = log_sys.lsn;
+	range.checkpoint_no = log_sys.next_checkpoint_no;
+	range.seq = log_sys.n_reserved++;
 
-	log_block = static_cast<byte*>(
-		ut_align_down(log_sys.buf + log_sys.buf_free,
-			      OS_FILE_LOG_BLOCK_SIZE));
+	/* Account for the headers and trailers of the log blocks
+	that the record group will span. A block that becomes
+	exactly full is followed by the header of the next block. */
+	ulint	end = range.offset;
 
-	log_block_set_data_len(log_block, data_len);
+	for (;;) {
+		const ulint	avail = OS_FILE_LOG_BLOCK_SIZE
+			- LOG_BLOCK_TRL_SIZE - end % OS_FILE_LOG_BLOCK_SIZE;
 
-	if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
-		/* This block became full */
-		log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE);
-		log_block_set_checkpoint_no(log_block,
-					    log_sys.next_checkpoint_no);
-		len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
-
-		log_sys.lsn += len;
+		if (len < avail) {
+			end += len;
+			break;
+		}
 
-		/* Initialize the next block header */
-		log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE,
-			       log_sys.lsn);
-	} else {
-		log_sys.lsn += len;
+		end += avail + LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		len -= avail;
 	}
 
-	log_sys.buf_free += ulong(len);
+	log_sys.lsn += end - log_sys.buf_free;
+	log_sys.buf_free = ulong(end);
+	range.end_lsn = log_sys.lsn;
 
 	ut_ad(log_sys.buf_free <= srv_log_buffer_size);
 
-	if (str_len > 0) {
-		goto part_loop;
-	}
-
-	srv_stats.log_write_requests.inc();
-}
-
-/************************************************************//**
-Closes the log.
-@return lsn */
-lsn_t
-log_close(void)
-/*===========*/
-{
-	byte*		log_block;
-	ulint		first_rec_group;
-	lsn_t		oldest_lsn;
-	lsn_t		lsn;
-	lsn_t		checkpoint_age;
-
-	ut_ad(log_mutex_own());
-
-	lsn = log_sys.lsn;
-
-	log_block = static_cast<byte*>(
-		ut_align_down(log_sys.buf + log_sys.buf_free,
-			      OS_FILE_LOG_BLOCK_SIZE));
-
-	first_rec_group = log_block_get_first_rec_group(log_block);
-
-	if (first_rec_group == 0) {
-		/* We initialized a new log block which was not written
-		full by the current mtr: the next mtr log record group
-		will start within this block at the offset data_len */
-
-		log_block_set_first_rec_group(
-			log_block, log_block_get_data_len(log_block));
-	}
-
 	if (log_sys.buf_free > log_sys.max_buf_free) {
 		log_sys.check_flush_or_checkpoint = true;
 	}
 
-	checkpoint_age = lsn - log_sys.last_checkpoint_lsn;
+	const lsn_t	lsn = log_sys.lsn;
+	const lsn_t	checkpoint_age = lsn - log_sys.last_checkpoint_lsn;
+
+	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE, checkpoint_age);
 
 	if (checkpoint_age >= log_sys.log_group_capacity) {
 		DBUG_EXECUTE_IF(
@@ -520,19 +550,125 @@ log_close(void)
 	}
 
 	if (checkpoint_age <= log_sys.max_modified_age_sync) {
-		goto function_exit;
+		return;
 	}
 
-	oldest_lsn = buf_pool_get_oldest_modification();
+	const lsn_t	oldest_lsn = buf_pool_get_oldest_modification();
 
 	if (!oldest_lsn
 	    || lsn - oldest_lsn > log_sys.max_modified_age_sync
 	    || checkpoint_age > log_sys.max_checkpoint_age_async) {
 		log_sys.check_flush_or_checkpoint = true;
 	}
-function_exit:
+}
 
-	return(lsn);
+/** Copy log records to a range that was reserved by log_buf_reserve().
+log_sys.mutex need not be held.
+@param[in,out]	range	reserved range
+@param[in]	str	log records
+@param[in]	len	length of str, in bytes */
+void
+log_buf_write(
+	log_buf_range_t&	range,
+	const byte*		str,
+	ulint			len)
+{
+	ut_ad(range.lsn + len <= range.end_lsn);
+
+	for (;;) {
+		const ulint	avail = OS_FILE_LOG_BLOCK_SIZE
+			- LOG_BLOCK_TRL_SIZE
+			- range.offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (len < avail) {
+			/* The string fits within the current log block.
+			Its LOG_BLOCK_HDR_DATA_LEN will be assigned by
+			whoever fills the block, or by log_write_up_to(). */
+			memcpy(range.buf + range.offset, str, len);
+			range.offset += len;
+			range.lsn += len;
+			break;
+		}
+
+		memcpy(range.buf + range.offset, str, avail);
+		str += avail;
+		len -= avail;
+
+		/* This block became full */
+		byte*	log_block = range.buf + ut_calc_align_down(
+			range.offset, OS_FILE_LOG_BLOCK_SIZE);
+		log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE);
+		log_block_set_checkpoint_no(log_block, range.checkpoint_no);
+
+		range.offset += avail + LOG_BLOCK_TRL_SIZE
+			+ LOG_BLOCK_HDR_SIZE;
+		range.lsn += avail + LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+
+		/* Initialize the next block header. Its
+		LOG_BLOCK_HDR_DATA_LEN may already have been assigned by a
+		concurrent later reservation that filled the block. */
+		log_block += OS_FILE_LOG_BLOCK_SIZE;
+		log_block_set_hdr_no(log_block,
+				     log_block_convert_lsn_to_no(range.lsn));
+		log_block_set_first_rec_group(log_block, 0);
+	}
+
+	srv_stats.log_write_requests.inc();
+}
+
+/** Publish a range that was completely filled by log_buf_write(),
+so that log_write_up_to() may write it to the log file.
+log_sys.mutex need not be held.
+@param[in]	range	reserved and filled range */
+void
+log_buf_close(
+	const log_buf_range_t&	range)
+{
+	ut_ad(range.lsn == range.end_lsn);
+
+	if (range.start_lsn / OS_FILE_LOG_BLOCK_SIZE
+	    != range.end_lsn / OS_FILE_LOG_BLOCK_SIZE) {
+		/* We initialized a new log block which was not written
+		full by the current mtr: the next mtr log record group
+		will start within this block at this offset. */
+		log_block_set_first_rec_group(
+			range.buf + ut_calc_align_down(
+				range.offset, OS_FILE_LOG_BLOCK_SIZE),
+			range.offset % OS_FILE_LOG_BLOCK_SIZE);
+	}
+
+	lsn_t*	slot = &log_sys.copy_slots[range.seq % LOG_BUF_COPY_SLOTS];
+	ut_ad(!*slot);
+	/* This store must not be reordered with the load of
+	n_copy_waiters; see log_buf_wait_close(). */
+	my_atomic_store64(reinterpret_cast<int64*>(slot),
+			  int64(range.end_lsn));
+
+	if (my_atomic_load32(&log_sys.n_copy_waiters)) {
+		os_event_set(log_sys.copied_event);
+	}
+}
+
+/** Wait until all log_buf_reserve() ranges have been published by
+log_buf_close(). The caller must hold log_sys.mutex, which will be
+released while waiting, and must have set log_sys.is_extending, which
+prevents new reservations. */
+void
+log_buf_wait_copied()
+{
+	ut_ad(log_mutex_own());
+	ut_ad(log_sys.is_extending);
+
+	log_buf_advance_copied();
+
+	if (log_sys.n_copied != log_sys.n_reserved) {
+		MONITOR_INC(MONITOR_LOG_BUF_COPY_WAITS);
+
+		do {
+			log_buf_wait_close();
+			log_buf_advance_copied();
+		} while (log_sys.n_copied != log_sys.n_reserved);
+	}
 }
 
 /** Calculate the recommended highest values for lsn - last_checkpoint_lsn
@@ -628,6 +764,17 @@ void log_t::create()
   n_pending_flushes= 0;
   flush_event = os_event_create("log_flush_event");
   os_event_set(flush_event);
+  writer_event= os_event_create("log_writer_event");
+  flusher_event= os_event_create("log_flusher_event");
+  write_requested_lsn= 0;
+  flush_requested_lsn= 0;
+  for (ulint i= 0; i < LOG_WAIT_EVENTS; i++)
+  {
+    write_events[i]= os_event_create(0);
+    flush_events[i]= os_event_create(0);
+  }
+  writer_threads_active= false;
+  n_writer_threads= 0;
   n_log_ios= 0;
   n_log_ios_old= 0;
   log_group_capacity= 0;
@@ -649,6 +796,13 @@ void log_t::create()
   buf_free= LOG_BLOCK_HDR_SIZE;
   lsn= LOG_START_LSN + LOG_BLOCK_HDR_SIZE;
 
+  n_reserved= 0;
+  n_copied= 0;
+  n_copy_waiters= 0;
+  copied_event= os_event_create(0);
+  copied_lsn= lsn;
+  memset(copy_slots, 0, sizeof copy_slots);
+
   MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE, lsn - last_checkpoint_lsn);
 
   log_scrub_thread_active= !srv_read_only_mode && srv_scrub_log;
@@ -940,8 +1094,9 @@ wait and check if an already running write is covering the request.
 included in the redo log file write
 @param[in]	flush_to_disk	whether the written log should also
 be flushed to the file system */
+static
 void
-log_write_up_to(
+log_write_up_to_low(
 	lsn_t	lsn,
 	bool	flush_to_disk)
 {
@@ -1015,31 +1170,55 @@ log_write_up_to(
 		}
 	}
 
+	/* Wait until the records up to lsn have been copied to the log
+	buffer. Do not wait for later reservations, which could keep
+	arriving; the buffers will be switched by a later write, once
+	log_reserve_and_open() has run out of space and every
+	reservation has been copied. log_sys.mutex is released while
+	waiting, so that log_buf_reserve() is not blocked by a slow copy
+	of a later reservation. */
 	log_mutex_enter();
-	if (!flush_to_disk
-	    && log_sys.buf_free == log_sys.buf_next_to_write) {
-		/* Nothing to write and no flush to disk requested */
-		log_mutex_exit_all();
-		return;
+	log_buf_advance_copied();
+
+	if (log_sys.copied_lsn < std::min(lsn, log_sys.lsn)) {
+		MONITOR_INC(MONITOR_LOG_BUF_COPY_WAITS);
+
+		do {
+			log_buf_wait_close();
+			log_buf_advance_copied();
+		} while (log_sys.copied_lsn < std::min(lsn, log_sys.lsn));
 	}
 
-	ulint		start_offset;
-	ulint		end_offset;
+	/* Whether some later reservations are still being copied */
+	const bool	partial = log_sys.n_copied != log_sys.n_reserved;
+	ulint		start_offset = log_sys.buf_next_to_write;
+	ulint		end_offset = log_sys.buf_free
+		- ulint(log_sys.lsn - log_sys.copied_lsn);
 	ulint		area_start;
 	ulint		area_end;
 	ulong		write_ahead_size = srv_log_write_ahead_size;
 	ulint		pad_size;
 
+	ut_ad(end_offset >= start_offset);
+
+	if (!flush_to_disk && end_offset == start_offset) {
+		/* Nothing to write and no flush to disk requested */
+		log_mutex_exit_all();
+		return;
+	}
+
+	write_lsn = log_sys.copied_lsn;
+
 	DBUG_PRINT("ib_log", ("write " LSN_PF " to " LSN_PF,
 			      log_sys.write_lsn,
-			      log_sys.lsn));
+			      write_lsn));
 	if (flush_to_disk) {
 		log_sys.n_pending_flushes++;
-		log_sys.current_flush_lsn = log_sys.lsn;
+		log_sys.current_flush_lsn = write_lsn;
 		MONITOR_INC(MONITOR_PENDING_LOG_FLUSH);
 		os_event_reset(log_sys.flush_event);
 
-		if (log_sys.buf_free == log_sys.buf_next_to_write) {
+		if (end_offset == start_offset) {
 			/* Nothing to write, flush only */
 			log_mutex_exit_all();
 			log_write_flush_to_disk_low();
@@ -1048,23 +1227,42 @@ log_write_up_to(
 		}
 	}
 
-	start_offset = log_sys.buf_next_to_write;
-	end_offset = log_sys.buf_free;
-
 	area_start = ut_calc_align_down(start_offset, OS_FILE_LOG_BLOCK_SIZE);
 	area_end = ut_calc_align(end_offset, OS_FILE_LOG_BLOCK_SIZE);
 
 	ut_ad(area_end - area_start > 0);
 
-	log_block_set_flush_bit(log_sys.buf + area_start, TRUE);
+	write_buf = log_sys.buf;
+
+	if (partial) {
+		/* The last block may still be modified by the
+		log_buf_write() of later reservations. Write a copy of
+		the area from the log buffer that is not in use. The
+		log_write_mutex prevents anyone else from using it. */
+		write_buf = log_sys.first_in_use
+			? log_sys.buf + srv_log_buffer_size
+			: log_sys.buf - srv_log_buffer_size;
+		memcpy(write_buf + area_start, log_sys.buf + area_start,
+		       area_end - area_start);
+	}
+
+	log_block_set_flush_bit(write_buf + area_start, TRUE);
+	/* The data length of the last, incomplete block is not
+	maintained by log_buf_write(). */
+	log_block_set_data_len(
+		write_buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
+		end_offset % OS_FILE_LOG_BLOCK_SIZE);
 	log_block_set_checkpoint_no(
-		log_sys.buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
+		write_buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
 		log_sys.next_checkpoint_no);
 
-	write_lsn = log_sys.lsn;
-	write_buf = log_sys.buf;
-
-	log_buffer_switch();
+	if (partial) {
+		/* Keep filling the buffer in use. The last block will
+		be written again by the next write. */
+		log_sys.buf_next_to_write = ulong(end_offset);
+	} else {
+		log_buffer_switch();
+	}
 
 	log_sys.log.set_fields(log_sys.write_lsn);
 
@@ -1128,6 +1326,302 @@ log_write_up_to(
 	}
 }
 
+/** Determine how far the log has been written or flushed.
+@param[in]	flush_to_disk	whether to return flushed_to_disk_lsn
+@return log_sys.write_lsn or log_sys.flushed_to_disk_lsn */
+static inline
+lsn_t
+log_get_written_lsn(bool flush_to_disk)
+{
+#if UNIV_WORD_SIZE > 7
+	/* We can do a dirty read of LSN. */
+	return(flush_to_disk
+	       ? log_sys.flushed_to_disk_lsn : log_sys.write_lsn);
+#else
+	log_mutex_enter_all();
+	lsn_t	lsn = flush_to_disk
+		? log_sys.flushed_to_disk_lsn : log_sys.write_lsn;
+	log_mutex_exit_all();
+	return(lsn);
+#endif
+}
+
+/** Ask log_writer_thread or log_flusher_thread to advance up to an lsn.
+@param[in,out]	requested	log_sys.write_requested_lsn or
+log_sys.flush_requested_lsn
+@param[in]	lsn		log sequence number */
+static inline
+void
+log_request_lsn(lsn_t* requested, lsn_t lsn)
+{
+	int64*	req = reinterpret_cast<int64*>(requested);
+	int64	cur = my_atomic_load64_explicit(req, MY_MEMORY_ORDER_RELAXED);
+
+	while (lsn_t(cur) < lsn
+	       && !my_atomic_cas64_strong_explicit(req, &cur, int64(lsn),
+						   MY_MEMORY_ORDER_RELAXED,
+						   MY_MEMORY_ORDER_RELAXED)) {
+	}
+}
+
+/** @return whether log_write_up_to() should wait for log_writer_thread
+and log_flusher_thread instead of writing the log itself */
+static inline
+bool
+log_writer_threads_enabled()
+{
+	return(log_sys.writer_threads_active && srv_log_writer_threads);
+}
+
+/** Wake up the threads that are waiting in log_write_up_to() for an
+lsn in the range (old_lsn, new_lsn].
+@param[in,out]	events	log_sys.write_events or log_sys.flush_events
+@param[in]	old_lsn	the previously notified lsn
+@param[in]	new_lsn	the lsn that has been written or flushed */
+static
+void
+log_wait_events_set(os_event_t* events, lsn_t old_lsn, lsn_t new_lsn)
+{
+	ut_ad(old_lsn < new_lsn);
+
+	lsn_t	block = old_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	last = new_lsn / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (last - block >= LOG_WAIT_EVENTS) {
+		block = last - (LOG_WAIT_EVENTS - 1);
+	}
+
+	do {
+		os_event_set(events[block % LOG_WAIT_EVENTS]);
+	} while (block++ != last);
+}
+
+/** Wait for log_writer_thread or log_flusher_thread to advance up to
+an lsn. If the threads stop, write the log in the calling thread.
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+static
+void
+log_wait_for_writer(lsn_t lsn, bool flush_to_disk)
+{
+	os_event_t	event = (flush_to_disk
+				 ? log_sys.flush_events
+				 : log_sys.write_events)[
+					 (lsn / OS_FILE_LOG_BLOCK_SIZE)
+					 % LOG_WAIT_EVENTS];
+
+	log_request_lsn(&log_sys.write_requested_lsn, lsn);
+
+	if (flush_to_disk) {
+		log_request_lsn(&log_sys.flush_requested_lsn, lsn);
+	}
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(event);
+
+		if (log_get_written_lsn(flush_to_disk) >= lsn) {
+			return;
+		}
+
+		if (!log_sys.writer_threads_active) {
+			/* The threads are exiting. They have set all
+			events after clearing the flag. */
+			log_write_up_to_low(lsn, flush_to_disk);
+			return;
+		}
+
+		os_event_set(flush_to_disk && log_get_written_lsn(false) >= lsn
+			     ? log_sys.flusher_event
+			     : log_sys.writer_event);
+		os_event_wait_low(event, sig_count);
+	}
+}
+
+/** Ensure that the log has been written to the log file up to a given
+log entry (such as that of a transaction commit).
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+void
+log_write_up_to(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (recv_no_ibuf_operations
+	    || log_get_written_lsn(flush_to_disk) >= lsn) {
+		return;
+	}
+
+	const uintmax_t	start_time = ut_time_us(NULL);
+
+	if (log_writer_threads_enabled()) {
+		log_wait_for_writer(lsn, flush_to_disk);
+	} else {
+		log_write_up_to_low(lsn, flush_to_disk);
+	}
+
+	const int64	usec = int64(ut_time_us(NULL) - start_time);
+
+	if (!flush_to_disk) {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_WRITE_WAITS);
+		if (MONITOR_IS_ON(MONITOR_LOG_WRITE_WAIT_TIME)) {
+			my_atomic_add64_explicit(
+				reinterpret_cast<int64*>(
+					&MONITOR_VALUE(
+						MONITOR_LOG_WRITE_WAIT_TIME)),
+				usec, MY_MEMORY_ORDER_RELAXED);
+		}
+		return;
+	}
+
+	MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAITS);
+	if (MONITOR_IS_ON(MONITOR_LOG_FLUSH_WAIT_TIME)) {
+		my_atomic_add64_explicit(
+			reinterpret_cast<int64*>(
+				&MONITOR_VALUE(MONITOR_LOG_FLUSH_WAIT_TIME)),
+			usec, MY_MEMORY_ORDER_RELAXED);
+	}
+
+	if (usec < 100) {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAIT_100US);
+	} else if (usec < 1000) {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAIT_1MS);
+	} else if (usec < 10000) {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAIT_10MS);
+	} else if (usec < 100000) {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAIT_100MS);
+	} else {
+		MONITOR_ATOMIC_INC(MONITOR_LOG_FLUSH_WAIT_LONG);
+	}
+}
+
+/** Main loop of log_writer_thread and log_flusher_thread.
+log_writer_thread writes the log up to log_sys.write_requested_lsn,
+while log_flusher_thread flushes the already written log up to
+log_sys.flush_requested_lsn. Each thread wakes up the threads that are
+waiting in log_write_up_to() for the log that it has completed.
+@param[in]	flush_to_disk	whether this is log_flusher_thread */
+static
+void
+log_writer_loop(bool flush_to_disk)
+{
+	os_event_t	event = flush_to_disk
+		? log_sys.flusher_event : log_sys.writer_event;
+	os_event_t*	events = flush_to_disk
+		? log_sys.flush_events : log_sys.write_events;
+	int64*		requested = reinterpret_cast<int64*>(
+		flush_to_disk
+		? &log_sys.flush_requested_lsn
+		: &log_sys.write_requested_lsn);
+	lsn_t		notified = log_get_written_lsn(flush_to_disk);
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_FLUSH_PHASE) {
+		int64_t	sig_count = os_event_reset(event);
+		lsn_t	lsn = lsn_t(my_atomic_load64_explicit(
+					    requested,
+					    MY_MEMORY_ORDER_RELAXED));
+
+		if (flush_to_disk) {
+			/* Leave the writing to log_writer_thread. */
+			lsn = std::min(lsn, log_get_written_lsn(false));
+		}
+
+		if (lsn > notified) {
+			log_write_up_to_low(lsn, flush_to_disk);
+		}
+
+		const lsn_t	done = log_get_written_lsn(flush_to_disk);
+
+		if (done > notified) {
+			log_wait_events_set(events, notified, done);
+			notified = done;
+
+			if (!flush_to_disk
+			    && lsn_t(my_atomic_load64_explicit(
+					     reinterpret_cast<int64*>(
+						     &log_sys
+						     .flush_requested_lsn),
+					     MY_MEMORY_ORDER_RELAXED))
+			    > log_get_written_lsn(true)) {
+				os_event_set(log_sys.flusher_event);
+			}
+
+			continue;
+		}
+
+		os_event_wait_low(event, sig_count);
+	}
+
+	/* Let the waiting threads write the log themselves. */
+	log_sys.writer_threads_active = false;
+
+	for (ulint i = 0; i < LOG_WAIT_EVENTS; i++) {
+		os_event_set(log_sys.write_events[i]);
+		os_event_set(log_sys.flush_events[i]);
+	}
+
+	my_atomic_addlint(&log_sys.n_writer_threads, ulint(-1));
+}
+
+/** Thread that writes the redo log for log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(void*)
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	log_writer_loop(false);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Thread that flushes the redo log for log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(void*)
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	log_writer_loop(true);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start log_writer_thread and log_flusher_thread. */
+void
+log_writer_threads_start()
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!log_sys.n_writer_threads);
+
+	log_sys.n_writer_threads = 2;
+	log_sys.writer_threads_active = true;
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+}
+
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -1151,6 +1645,18 @@ log_buffer_sync_in_background(
 {
 	lsn_t	lsn;
 
+	if (log_writer_threads_enabled()) {
+		/* Let log_writer_thread and log_flusher_thread do the
+		work without waiting for it. */
+		lsn = log_get_lsn();
+		log_request_lsn(&log_sys.write_requested_lsn, lsn);
+		if (flush) {
+			log_request_lsn(&log_sys.flush_requested_lsn, lsn);
+		}
+		os_event_set(log_sys.writer_event);
+		return;
+	}
+
 	log_mutex_enter();
 
 	lsn = log_sys.lsn;
@@ -1705,6 +2211,9 @@ logs_empty_and_mark_files_at_shutdown(void)
 		if (lock_sys.timeout_thread_active) {
 			os_event_set(lock_sys.timeout_event);
 		}
+		if (lock_sys.deadlock_thread_active) {
+			os_event_set(lock_sys.deadlock_event);
+		}
 		if (dict_stats_event) {
 			os_event_set(dict_stats_event);
 		} else {
@@ -1760,6 +2269,8 @@ logs_empty_and_mark_files_at_shutdown(void)
 		thread_name = "dict_stats_thread";
 	} else if (lock_sys.timeout_thread_active) {
 		thread_name = "lock_wait_timeout_thread";
+	} else if (lock_sys.deadlock_thread_active) {
+		thread_name = "lock_deadlock_detect_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_name = "buf_dump_thread";
 		goto wait_suspend_loop;
@@ -1832,6 +2343,12 @@ logs_empty_and_mark_files_at_shutdown(void)
 	}
 
 	if (log_sys.is_initialised()) {
+		if (my_atomic_loadlint(&log_sys.n_writer_threads)) {
+			os_event_set(log_sys.writer_event);
+			os_event_set(log_sys.flusher_event);
+			goto loop;
+		}
+
 		log_mutex_enter();
 		const ulint	n_write	= log_sys.n_pending_checkpoint_writes;
 		const ulint	n_flush	= log_sys.n_pending_flushes;
@@ -2044,6 +2561,16 @@ void log_t::close()
   buf = NULL;
 
   os_event_destroy(flush_event);
+  ut_ad(!n_copy_waiters);
+  os_event_destroy(copied_event);
+  ut_ad(!n_writer_threads);
+  os_event_destroy(writer_event);
+  os_event_destroy(flusher_event);
+  for (ulint i= 0; i < LOG_WAIT_EVENTS; i++)
+  {
+    os_event_destroy(write_events[i]);
+    os_event_destroy(flush_events[i]);
+  }
 
   rw_lock_free(&checkpoint_lock);
   /* rw_lock_free() already called checkpoint_lock.~rw_lock_t();
@@ -2089,17 +2616,21 @@ log_pad_current_log_block(void)
 	}
 
 	if (pad_length) {
+		log_buf_range_t	range;
+
 		srv_stats.n_log_scrubs.inc();
-	}
 
-	for (i = 0; i < pad_length; i++) {
-		log_write_low(&b, 1);
+		log_buf_reserve(pad_length, range);
+
+		for (i = 0; i < pad_length; i++) {
+			log_buf_write(range, &b, 1);
+		}
+
+		log_buf_close(range);
 	}
 
 	lsn = log_sys.lsn;
 
-	log_close();
-
 	ut_a(lsn % OS_FILE_LOG_BLOCK_SIZE == LOG_BLOCK_HDR_SIZE);
 }
 
@@ -122,11 +122,16 @@ static lsn_t	recv_max_page_lsn;
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	trx_rollback_clean_thread_key;
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 /** Is recv_writer_thread active? */
 bool	recv_writer_thread_active;
 
+/** Number of threads applying the current batch of redo log records;
+protected by recv_sys->mutex */
+static ulint	recv_n_apply_threads;
+
 #ifndef	DBUG_OFF
 /** Return string name of the redo log record type.
 @param[in]	type	record log record enum
@@ -461,6 +466,10 @@ recv_sys_close()
 			os_event_destroy(recv_sys->flush_end);
 		}
 
+		if (recv_sys->apply_done != NULL) {
+			os_event_destroy(recv_sys->apply_done);
+		}
+
 		if (recv_sys->buf != NULL) {
 			ut_free_dodump(recv_sys->buf, recv_sys->buf_size);
 		}
@@ -570,6 +579,8 @@ recv_sys_init()
 		recv_sys->flush_end = os_event_create(0);
 	}
 
+	recv_sys->apply_done = os_event_create(0);
+
 	ulint size = buf_pool_get_curr_size();
 	/* Set appropriate value of recv_n_pool_free_frames. */
 	if (size >= 10 << 20) {
@@ -1852,6 +1863,21 @@ recv_recover_page(bool just_read_in, buf_block_t* block)
 	mutex_exit(&recv_sys->mutex);
 }
 
+/** Determine the redo log application thread that processes a page.
+All pages of a read-ahead area are assigned to the same thread, so that
+recv_read_in_area() only changes the state of pages of its own thread.
+@param[in]	space_id	tablespace identifier
+@param[in]	page_no		page number
+@param[in]	n_threads	number of threads processing the batch
+@return index of the thread */
+static inline
+ulint
+recv_apply_thread_of(ulint space_id, ulint page_no, ulint n_threads)
+{
+	return(ut_fold_ulint_pair(space_id, page_no / RECV_READ_AHEAD_AREA)
+	       % n_threads);
+}
+
 /** Reads in pages which have hashed log records, from an area around a given
 page number.
 @param[in]	page_id	page id
@@ -1883,6 +1909,12 @@ recv_read_in_area(
 
 			mutex_enter(&(recv_sys->mutex));
 
+			ut_ad(recv_apply_thread_of(page_id.space(), page_no,
+						   recv_n_apply_threads)
+			      == recv_apply_thread_of(page_id.space(),
+						      page_id.page_no(),
+						      recv_n_apply_threads));
+
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
 				recv_addr->state = RECV_BEING_READ;
 
@@ -1899,6 +1931,137 @@ recv_read_in_area(
 	return(n);
 }
 
+/** Apply the stored log records to the pages that are assigned to a
+thread. The read-ahead areas are partitioned between the threads by
+recv_apply_thread_of(), so that each page is processed by one thread
+only, including by the read-ahead in recv_read_in_area(). Each thread
+walks all of recv_sys->addr_hash, because pages of the same area do
+not hash to the same cell.
+@param[in]	thread		index of this thread
+@param[in]	n_threads	number of threads processing the batch */
+static
+void
+recv_apply_hashed_log_recs_low(ulint thread, ulint n_threads)
+{
+	ut_ad(mutex_own(&recv_sys->mutex));
+	ut_ad(thread < n_threads);
+	ut_ad(n_threads <= RECV_MAX_APPLY_THREADS);
+
+	recv_sys_t::apply_progress_t&	progress
+		= recv_sys->apply_progress[thread];
+
+	/* In the first pass, only post reads for the pages that are not
+	in the buffer pool, so that the I/O handler threads can apply
+	the log to them while we are applying the log to the pages that
+	already reside in the buffer pool in the second pass. */
+	for (ulint pass = 0; pass < 2; pass++) {
+		for (ulint i = 0;
+		     i < hash_get_n_cells(recv_sys->addr_hash);
+		     i++) {
+			for (recv_addr_t* recv_addr
+				     = static_cast<recv_addr_t*>(
+					     HASH_GET_FIRST(
+						     recv_sys->addr_hash, i));
+			     recv_addr;
+			     recv_addr = static_cast<recv_addr_t*>(
+				     HASH_GET_NEXT(addr_hash, recv_addr))) {
+
+				if (recv_apply_thread_of(recv_addr->space,
+							 recv_addr->page_no,
+							 n_threads)
+				    != thread) {
+					continue;
+				}
+
+				/* Avoid applying REDO log for the
+				tablespace that is schedule for TRUNCATE. */
+				if (!pass
+				    && (recv_addr->state == RECV_DISCARDED
+					|| srv_is_tablespace_truncated(
+						recv_addr->space))) {
+					ut_a(recv_sys->n_addrs);
+					recv_addr->state = RECV_DISCARDED;
+					recv_sys->n_addrs--;
+					continue;
+				}
+
+				if (recv_addr->state != RECV_NOT_PROCESSED) {
+					continue;
+				}
+
+				const page_id_t		page_id(
+					recv_addr->space, recv_addr->page_no);
+				bool			found;
+				const page_size_t&	page_size
+					= fil_space_get_page_size(
+						recv_addr->space, &found);
+
+				ut_ad(found);
+
+				mutex_exit(&recv_sys->mutex);
+
+				ulint	applied = 0;
+				ulint	read = 0;
+
+				if (!buf_page_peek(page_id)) {
+					read = recv_read_in_area(page_id);
+				} else if (pass) {
+					mtr_t	mtr;
+					mtr.start();
+
+					buf_block_t* block = buf_page_get(
+						page_id, page_size,
+						RW_X_LATCH, &mtr);
+
+					buf_block_dbg_add_level(
+						block, SYNC_NO_ORDER_CHECK);
+
+					recv_recover_page(FALSE, block);
+					mtr.commit();
+					applied = 1;
+				}
+
+				mutex_enter(&recv_sys->mutex);
+				progress.applied += applied;
+				progress.read += read;
+			}
+		}
+	}
+}
+
+/** Redo log application thread. Applies the records of the current
+batch to the pages that are assigned to this thread.
+@param[in]	arg	index of this thread
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(void* arg)
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	mutex_enter(&recv_sys->mutex);
+
+	ut_ad(recv_sys->apply_batch_on);
+	ut_ad(recv_sys->n_apply_threads > 0);
+
+	recv_apply_hashed_log_recs_low(ulint(arg), recv_n_apply_threads);
+
+	if (!--recv_sys->n_apply_threads) {
+		os_event_set(recv_sys->apply_done);
+	}
+
+	mutex_exit(&recv_sys->mutex);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /** Apply the hash table of stored log records to persistent data pages.
 @param[in]	last_batch	whether the change buffer merge will be
 				performed as part of the operation */
@@ -1931,6 +2094,10 @@ recv_apply_hashed_log_recs(bool last_batch)
 
 	ut_d(recv_no_log_write = recv_no_ibuf_operations);
 
+	/* Use as many threads as there are read I/O handler threads,
+	but do not bother starting threads for small batches. */
+	ulint	n_threads = 1;
+
 	if (ulint n = recv_sys->n_addrs) {
 		const char* msg = last_batch
 			? "Starting final batch to recover "
@@ -1938,63 +2105,54 @@ recv_apply_hashed_log_recs(bool last_batch)
 		ib::info() << msg << n << " pages from redo log.";
 		sd_notifyf(0, "STATUS=%s" ULINTPF " pages from redo log",
 			   msg, n);
+
+		if (n >= RECV_READ_AHEAD_AREA * 8) {
+			n_threads = ut_min(ulint(srv_n_read_io_threads),
+					   ulint(RECV_MAX_APPLY_THREADS));
+		}
 	}
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	for (ulint i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
-		for (recv_addr_t* recv_addr = static_cast<recv_addr_t*>(
-			     HASH_GET_FIRST(recv_sys->addr_hash, i));
-		     recv_addr;
-		     recv_addr = static_cast<recv_addr_t*>(
-				HASH_GET_NEXT(addr_hash, recv_addr))) {
+	memset(recv_sys->apply_progress, 0, sizeof recv_sys->apply_progress);
 
-			if (srv_is_tablespace_truncated(recv_addr->space)) {
-				/* Avoid applying REDO log for the tablespace
-				that is schedule for TRUNCATE. */
-				ut_a(recv_sys->n_addrs);
-				recv_addr->state = RECV_DISCARDED;
-				recv_sys->n_addrs--;
-				continue;
-			}
+	recv_n_apply_threads = n_threads;
 
-			if (recv_addr->state == RECV_DISCARDED) {
-				ut_a(recv_sys->n_addrs);
-				recv_sys->n_addrs--;
-				continue;
-			}
+	if (n_threads > 1) {
+		recv_sys->n_apply_threads = n_threads - 1;
+		os_event_reset(recv_sys->apply_done);
 
-			const page_id_t		page_id(recv_addr->space,
-							recv_addr->page_no);
-			bool			found;
-			const page_size_t&	page_size
-				= fil_space_get_page_size(recv_addr->space,
-							  &found);
+		for (ulint i = 1; i < n_threads; i++) {
+			os_thread_create(recv_apply_thread,
+					 reinterpret_cast<void*>(i), NULL);
+		}
+	}
 
-			ut_ad(found);
+	recv_apply_hashed_log_recs_low(0, n_threads);
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				mutex_exit(&recv_sys->mutex);
+	/* Wait until the other threads have processed their share of
+	the hash table */
 
-				if (buf_page_peek(page_id)) {
-					mtr_t	mtr;
-					mtr.start();
+	while (recv_sys->n_apply_threads) {
+		const int64_t sig_count = os_event_reset(recv_sys->apply_done);
+		mutex_exit(&recv_sys->mutex);
 
-					buf_block_t* block = buf_page_get(
-						page_id, page_size,
-						RW_X_LATCH, &mtr);
+		os_event_wait_time_low(recv_sys->apply_done, 15000000,
+				       sig_count);
 
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+		mutex_enter(&recv_sys->mutex);
 
-					recv_recover_page(FALSE, block);
-					mtr.commit();
-				} else {
-					recv_read_in_area(page_id);
-				}
+		if (!recv_sys->n_apply_threads) {
+			break;
+		}
 
-				mutex_enter(&recv_sys->mutex);
-			}
+		for (ulint i = 0; i < n_threads; i++) {
+			const recv_sys_t::apply_progress_t& progress
+				= recv_sys->apply_progress[i];
+			ib::info() << "Redo log apply thread " << i
+				<< ": applied log to " << progress.applied
+				<< " pages, read " << progress.read
+				<< " pages";
 		}
 	}
 
@@ -418,10 +418,14 @@ class mtr_t::Command {
 	/** Release the resources */
 	void release_resources();
 
-	/** Append the redo log records to the redo log buffer.
+	/** Reserve space for the redo log records in the redo log buffer.
 	@param[in]	len	number of bytes to write */
 	void finish_write(ulint len);
 
+	/** Copy the redo log records to the space that was reserved by
+	finish_write(). This does not require log_sys.mutex. */
+	void copy_log();
+
 private:
 	/** Prepare to write the mini-transaction log to the redo log buffer.
 	@return number of bytes to write in finish_write() */
@@ -442,6 +446,10 @@ class mtr_t::Command {
 
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
+
+	/** The reserved range of the redo log buffer, if m_end_lsn is
+	greater than m_start_lsn */
+	log_buf_range_t		m_range;
 };
 
 /** Check if a mini-transaction is dirtying a clean page.
@@ -460,13 +468,20 @@ mtr_t::is_block_dirtied(const buf_block_t* block)
 
 /** Write the block contents to the REDO log */
 struct mtr_write_log_t {
+	/** Constructor
+	@param[in,out]	range	reserved range of the redo log buffer */
+	mtr_write_log_t(log_buf_range_t& range) : m_range(range) {}
+
 	/** Append a block to the redo log buffer.
 	@return whether the appending should continue */
 	bool operator()(const mtr_buf_t::block_t* block) const
 	{
-		log_write_low(block->begin(), block->used());
+		log_buf_write(m_range, block->begin(), block->used());
 		return(true);
 	}
+
+	/** The reserved range of the redo log buffer */
+	log_buf_range_t&	m_range;
 };
 
 /** Append records to the system-wide redo log buffer.
@@ -476,7 +491,7 @@ mtr_write_log(
 	const mtr_buf_t*	log)
 {
 	const ulint	len = log->size();
-	mtr_write_log_t	write_log;
+	log_buf_range_t	range;
 
 	ut_ad(!recv_no_log_write);
 	DBUG_PRINT("ib_log",
@@ -484,8 +499,11 @@ mtr_write_log(
 		    len, log_sys.lsn));
 
 	log_reserve_and_open(len);
+	log_buf_reserve(len, range);
+
+	mtr_write_log_t	write_log(range);
 	log->for_each_block(write_log);
-	log_close();
+	log_buf_close(range);
 }
 
 /** Start a mini-transaction.
@@ -616,6 +634,7 @@ mtr_t::commit_checkpoint(
 
 	Command	cmd(this);
 	cmd.finish_write(m_impl.m_log.size());
+	cmd.copy_log();
 	cmd.release_resources();
 
 	if (write_mlog_checkpoint) {
@@ -836,7 +855,7 @@ mtr_t::Command::prepare_write()
 	return(len);
 }
 
-/** Append the redo log records to the redo log buffer
+/** Reserve space for the redo log records in the redo log buffer.
 @param[in] len	number of bytes to write */
 void
 mtr_t::Command::finish_write(
@@ -847,25 +866,42 @@ mtr_t::Command::finish_write(
 	ut_ad(m_impl->m_log.size() == len);
 	ut_ad(len > 0);
 
-	if (m_impl->m_log.is_small()) {
-		const mtr_buf_t::block_t*	front = m_impl->m_log.front();
-		ut_ad(len <= front->used());
-
-		m_end_lsn = log_reserve_and_write_fast(
-			front->begin(), len, &m_start_lsn);
+	/* The LSN range is reserved under log_sys.mutex rather than by an
+	atomic increment of log_sys.lsn. The mutex is already held for
+	fil_names_write_if_was_clean() and for the space checks of
+	log_reserve_and_open(). execute() also acquires
+	log_sys.log_flush_order_mutex before releasing it, so that the pages
+	are added to the flush lists in LSN order, which
+	buf_pool_get_oldest_modification() relies on for checkpoints.
+	Only this constant-time reservation is serialized; the records
+	are copied by copy_log() without holding the mutex. */
+	m_start_lsn = log_reserve_and_open(len);
+	log_buf_reserve(len, m_range);
+	ut_ad(m_range.start_lsn == m_start_lsn);
+	m_end_lsn = m_range.end_lsn;
+}
 
-		if (m_end_lsn > 0) {
-			return;
-		}
-	}
+/** Copy the redo log records to the space that was reserved by
+finish_write(). This does not require log_sys.mutex. */
+void
+mtr_t::Command::copy_log()
+{
+	ut_ad(m_end_lsn > m_start_lsn);
 
-	/* Open the database log for log_write_low */
-	m_start_lsn = log_reserve_and_open(len);
+	const bool	timed = MONITOR_IS_ON(MONITOR_LOG_BUF_COPY_TIME);
+	const uintmax_t	start_time = timed ? ut_time_us(NULL) : 0;
 
-	mtr_write_log_t	write_log;
+	mtr_write_log_t	write_log(m_range);
 	m_impl->m_log.for_each_block(write_log);
-
-	m_end_lsn = log_close();
+	log_buf_close(m_range);
+
+	if (timed) {
+		my_atomic_add64_explicit(
+			reinterpret_cast<int64*>(
+				&MONITOR_VALUE(MONITOR_LOG_BUF_COPY_TIME)),
+			int64(ut_time_us(NULL) - start_time),
+			MY_MEMORY_ORDER_RELAXED);
+	}
 }
 
 /** Release the latches and blocks acquired by this mini-transaction */
@@ -932,6 +968,13 @@ mtr_t::Command::execute()
 		log_flush_order_mutex_exit();
 	}
 
+	/* The log records are copied while other mini-transactions
+	may be reserving and copying their own. The pages cannot be
+	written before log_write_up_to() has covered the copy. */
+	if (m_end_lsn > m_start_lsn) {
+		copy_log();
+	}
+
 	release_latches();
 
 	release_resources();
@@ -62,6 +62,10 @@ Created 10/21/1995 Heikki Tuuri
 
 #ifdef LINUX_NATIVE_AIO
 #include <libaio.h>
+# ifdef LINUX_IO_URING
+#  include <liburing.h>
+#  include <algorithm>
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
@@ -401,8 +405,11 @@ class AIO {
 #ifdef LINUX_NATIVE_AIO
 	/** Dispatch an AIO request to the kernel.
 	@param[in,out]	slot	an already reserved slot
+	@param[in]	submit	false if the request may be queued until
+				os_aio_simulated_wake_handler_threads();
+				only used with io_uring
 	@return true on success. */
-	bool linux_dispatch(Slot* slot)
+	bool linux_dispatch(Slot* slot, bool submit)
 		MY_ATTRIBUTE((warn_unused_result));
 
 	/** Accessor for an AIO event
@@ -441,6 +448,45 @@ class AIO {
 	@return true if supported, false otherwise. */
 	static bool is_linux_native_aio_supported()
 		MY_ATTRIBUTE((warn_unused_result));
+
+# ifdef LINUX_IO_URING
+	/** Queue an AIO request in the io_uring of the segment of the slot.
+	The caller must own the mutex.
+	@param[in,out]	slot	an already reserved slot
+	@param[in]	submit	whether to submit the queued requests of
+				the segment to the kernel right away */
+	void uring_dispatch(Slot* slot, bool submit);
+
+	/** Submit the requests that uring_dispatch() queued without
+	submitting them. The caller must own the mutex.
+	@param[in]	segment	local segment in the array */
+	void uring_submit(ulint segment);
+
+	/** Accessor for the io_uring of a segment
+	@param[in]	segment	local segment in the array
+	@return the io_uring of the segment */
+	io_uring* ring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		ut_ad(segment < get_n_segments());
+
+		return(&m_rings[segment]);
+	}
+
+	/** Submit the queued requests of all io_uring instances. */
+	static void uring_submit_all();
+
+	/** Register os_aio_fixed_bufs with the io_uring instances. */
+	static void uring_register_buffers();
+
+	/** Unregister the fixed buffers from the io_uring instances. */
+	static void uring_unregister_buffers();
+
+	/** Check if the kernel supports the io_uring features we need.
+	@return true if supported, false otherwise. */
+	static bool is_linux_io_uring_supported()
+		MY_ATTRIBUTE((warn_unused_result));
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 #ifdef WIN_ASYNC_IO
@@ -592,6 +638,13 @@ class AIO {
 	@return DB_SUCCESS or error code */
 	dberr_t init_linux_native_aio()
 		MY_ATTRIBUTE((warn_unused_result));
+
+# ifdef LINUX_IO_URING
+	/** Initialise the io_uring instances
+	@return DB_SUCCESS or error code */
+	dberr_t init_linux_io_uring()
+		MY_ATTRIBUTE((warn_unused_result));
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 private:
@@ -634,6 +687,17 @@ class AIO {
 	event for each possible pending IO. The size of the array
 	is equal to m_slots.size(). */
 	IOEvents		m_events;
+
+# ifdef LINUX_IO_URING
+	/** io_uring instances, one per segment, if srv_use_io_uring.
+	Submission is protected by m_mutex; the completion queue is only
+	accessed by the I/O handler thread of the segment. */
+	io_uring*		m_rings;
+
+	/** for each of m_rings, whether os_aio_fixed_bufs are
+	registered with it; protected by m_mutex */
+	bool*			m_fixed_bufs;
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIV_AIO */
 
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
@@ -672,6 +736,17 @@ static const ulint	OS_AIO_IO_SETUP_RETRY_SLEEP = 500000UL;
 
 /** number of attempts before giving up on io_setup(). */
 static const int	OS_AIO_IO_SETUP_RETRY_ATTEMPTS = 5;
+
+# ifdef LINUX_IO_URING
+/** maximum size of an io_uring fixed buffer */
+static const ulint	OS_AIO_FIXED_BUF_MAX_SIZE = 1U << 30;
+
+/** Memory ranges that are registered as io_uring fixed buffers, ordered
+by address. Modified by os_aio_register_buffers() and
+os_aio_unregister_buffers(); only read while holding the mutex of an
+AIO array that has some m_fixed_bufs set. */
+static std::vector<iovec>	os_aio_fixed_bufs;
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 /** Array of events used in simulated AIO */
@@ -1720,6 +1795,11 @@ class LinuxAIOHandler {
 	each wakeup and that is why we use timed wait in io_getevents(). */
 	void collect();
 
+#ifdef LINUX_IO_URING
+	/** The io_uring counterpart of collect(). */
+	void collect_uring();
+#endif /* LINUX_IO_URING */
+
 private:
 	/** Slot array */
 	AIO*			m_array;
@@ -1760,6 +1840,13 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	slot->n_bytes = 0;
 	slot->io_already_done = false;
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		m_array->uring_dispatch(slot, true);
+		return(DB_SUCCESS);
+	}
+#endif /* LINUX_IO_URING */
+
 	struct iocb*	iocb = &slot->control;
 
 	if (slot->type.is_read()) {
@@ -1888,6 +1975,13 @@ LinuxAIOHandler::collect()
 	ut_ad(m_array != NULL);
 	ut_ad(m_segment < m_array->get_n_segments());
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		collect_uring();
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
 	/* Which io_context we are going to use. */
 	io_context*	io_ctx = m_array->io_ctx(m_segment);
 
@@ -1998,6 +2092,107 @@ LinuxAIOHandler::collect()
 	}
 }
 
+#ifdef LINUX_IO_URING
+/** This is called from within the io-thread when using io_uring. If there
+are no completed IO requests in the slot array, the thread waits for
+completions of the io_uring of its segment, with a timeout. After reaping
+completions or on timeout, any requests that are still queued are
+submitted. They may have been queued without submitting them, or the
+kernel may have refused them while the completion queue was full. */
+void
+LinuxAIOHandler::collect_uring()
+{
+	io_uring*	ring = m_array->ring(m_segment);
+
+	/* Starting point of the m_segment we will be working on. */
+	ulint	start_pos = m_segment * m_n_slots;
+
+	/* End point. */
+	ulint	end_pos = start_pos + m_n_slots;
+
+	for (;;) {
+		struct __kernel_timespec	timeout;
+
+		timeout.tv_sec = 0;
+		timeout.tv_nsec = OS_AIO_REAP_TIMEOUT;
+
+		struct io_uring_cqe*	cqe;
+		ulint			n_done = 0;
+
+		int	ret = io_uring_wait_cqe_timeout(ring, &cqe, &timeout);
+
+		/* Only this thread consumes the completion queue. */
+		while (ret == 0) {
+			Slot*	slot = static_cast<Slot*>(
+				io_uring_cqe_get_data(cqe));
+			int	res = cqe->res;
+
+			io_uring_cqe_seen(ring, cqe);
+
+			ut_a(slot->is_reserved);
+			ut_a(slot->pos >= start_pos);
+			ut_a(slot->pos < end_pos);
+
+			if (res >= 0
+			    && slot->offset > 0
+			    && !slot->type.is_log()
+			    && slot->type.is_write()
+			    && slot->type.punch_hole()) {
+
+				slot->err = slot->type.punch_hole(
+					slot->file,
+					slot->offset, slot->len);
+			} else {
+				slot->err = DB_SUCCESS;
+			}
+
+			m_array->acquire();
+
+			slot->ret = res < 0 ? res : 0;
+			slot->io_already_done = true;
+			slot->n_bytes = res < 0 ? 0 : res;
+
+			m_array->release();
+
+			++n_done;
+
+			ret = io_uring_peek_cqe(ring, &cqe);
+		}
+
+		if (ret == -ETIME || n_done > 0) {
+			/* Submit any requests that were left queued,
+			because they were not submitted yet or because
+			the kernel could not accept them before these
+			completions were reaped. */
+			m_array->acquire();
+			m_array->uring_submit(m_segment);
+			m_array->release();
+		}
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
+		    || !buf_page_cleaner_is_active
+		    || n_done > 0) {
+
+			break;
+		}
+
+		switch (ret) {
+		case -EAGAIN:
+			/* No more completions were available. */
+		case -ETIME:
+			/* Timed out. */
+		case -EINTR:
+			/* Interrupted. */
+			continue;
+		}
+
+		ib::fatal()
+			<< "Unexpected ret_code[" << ret
+			<< "] from io_uring_wait_cqe_timeout()!";
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /** Process a Linux AIO request
 @param[out]	m1		the messages passed with the
 @param[out]	m2		AIO request; note that in case the
@@ -2119,13 +2314,25 @@ os_aio_linux_handler(
 
 /** Dispatch an AIO request to the kernel.
 @param[in,out]	slot		an already reserved slot
+@param[in]	submit		false if the request may be queued until
+				os_aio_simulated_wake_handler_threads();
+				only used with io_uring
 @return true on success. */
 bool
-AIO::linux_dispatch(Slot* slot)
+AIO::linux_dispatch(Slot* slot, bool submit)
 {
 	ut_a(slot->is_reserved);
 	ut_ad(slot->type.validate());
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		acquire();
+		uring_dispatch(slot, submit);
+		release();
+		return(true);
+	}
+#endif /* LINUX_IO_URING */
+
 	/* Find out what we are going to work with.
 	The iocb struct is directly in the slot.
 	The io_context is one per segment. */
@@ -2147,6 +2354,345 @@ AIO::linux_dispatch(Slot* slot)
 	return(ret == 1);
 }
 
+#ifdef LINUX_IO_URING
+/** Compare the start address of a memory range with an iovec.
+@param[in]	ptr	start address
+@param[in]	buf	registered buffer
+@return whether ptr is before the buffer */
+static
+bool
+os_aio_fixed_buf_after(const byte* ptr, const iovec& buf)
+{
+	return(ptr < static_cast<const byte*>(buf.iov_base));
+}
+
+/** Compare two iovec by address.
+@return whether a is before b */
+static
+bool
+os_aio_fixed_buf_less(const iovec& a, const iovec& b)
+{
+	return(a.iov_base < b.iov_base);
+}
+
+/** Look up the io_uring fixed buffer that contains a memory range.
+@param[in]	ptr	start of the range
+@param[in]	len	length of the range
+@return index of the fixed buffer, or -1 if there is none */
+static
+int
+os_aio_fixed_buf_index(const byte* ptr, ulint len)
+{
+	std::vector<iovec>::const_iterator	it = std::upper_bound(
+		os_aio_fixed_bufs.begin(), os_aio_fixed_bufs.end(), ptr,
+		os_aio_fixed_buf_after);
+
+	if (it == os_aio_fixed_bufs.begin()) {
+		return(-1);
+	}
+
+	--it;
+
+	if (ptr + len > static_cast<const byte*>(it->iov_base)
+	    + it->iov_len) {
+		return(-1);
+	}
+
+	return(int(it - os_aio_fixed_bufs.begin()));
+}
+
+/** Queue an AIO request in the io_uring of the segment of the slot.
+The caller must own the mutex.
+@param[in,out]	slot		an already reserved slot
+@param[in]	submit		whether to submit the queued requests of
+				the segment to the kernel right away */
+void
+AIO::uring_dispatch(Slot* slot, bool submit)
+{
+	ut_ad(is_mutex_owned());
+	ut_a(slot->is_reserved);
+	ut_ad(slot->type.validate());
+
+	const ulint	segment = (slot->pos * m_n_segments)
+		/ m_slots.size();
+	io_uring*	uring = ring(segment);
+
+	/* The submission queue has an entry for each slot of the
+	segment, and a slot is never queued twice. */
+	struct io_uring_sqe*	sqe = io_uring_get_sqe(uring);
+	ut_a(sqe != NULL);
+
+	int	buf_index = m_fixed_bufs[segment]
+		? os_aio_fixed_buf_index(slot->ptr, slot->len) : -1;
+
+	if (slot->type.is_read()) {
+		if (buf_index >= 0) {
+			io_uring_prep_read_fixed(
+				sqe, slot->file, slot->ptr,
+				unsigned(slot->len), slot->offset, buf_index);
+		} else {
+			io_uring_prep_read(
+				sqe, slot->file, slot->ptr,
+				unsigned(slot->len), slot->offset);
+		}
+	} else {
+		ut_ad(slot->type.is_write());
+
+		if (buf_index >= 0) {
+			io_uring_prep_write_fixed(
+				sqe, slot->file, slot->ptr,
+				unsigned(slot->len), slot->offset, buf_index);
+		} else {
+			io_uring_prep_write(
+				sqe, slot->file, slot->ptr,
+				unsigned(slot->len), slot->offset);
+		}
+	}
+
+	io_uring_sqe_set_data(sqe, slot);
+
+	if (submit) {
+		uring_submit(segment);
+	}
+}
+
+/** Submit the requests that uring_dispatch() queued without submitting
+them. The caller must own the mutex.
+@param[in]	segment		local segment in the array */
+void
+AIO::uring_submit(ulint segment)
+{
+	ut_ad(is_mutex_owned());
+
+	io_uring*	uring = ring(segment);
+
+	/* An entry cannot be taken back from the submission queue.
+	Keep submitting until the kernel has accepted all of them;
+	a submission may be short. */
+	while (io_uring_sq_ready(uring) > 0) {
+		int	ret = io_uring_submit(uring);
+
+		switch (ret) {
+		case -EINTR:
+			continue;
+		case 0:
+		case -EAGAIN:
+		case -EBUSY:
+			/* The kernel is short of resources, or the
+			completion queue is full. The entries stay
+			queued. The io-handler thread will submit them
+			after it has reaped completions, or when its
+			wait times out. */
+			return;
+		}
+
+		if (ret < 0) {
+			ib::fatal() << "io_uring_submit() returned error "
+				<< -ret;
+		}
+	}
+}
+
+/** Submit the queued requests of all io_uring instances. */
+void
+AIO::uring_submit_all()
+{
+	AIO*	arrays[] = { s_reads, s_writes, s_ibuf, s_log };
+
+	for (ulint i = 0; i < array_elements(arrays); ++i) {
+		AIO*	array = arrays[i];
+
+		if (array == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		for (ulint segment = 0; segment < array->m_n_segments;
+		     ++segment) {
+			array->uring_submit(segment);
+		}
+
+		array->release();
+	}
+}
+
+/** Register os_aio_fixed_bufs with the io_uring instances. The buffers
+are registered with one io_uring and cloned to the others, so that the
+memory is accounted against the locked memory limit only once. */
+void
+AIO::uring_register_buffers()
+{
+	/* The redo log is never read or written from the buffer pool. */
+	AIO*		arrays[] = { s_reads, s_writes, s_ibuf };
+	io_uring*	src = NULL;
+	ulint		n_rings = 0;
+	ulint		n_registered = 0;
+
+	for (ulint i = 0; i < array_elements(arrays); ++i) {
+		AIO*	array = arrays[i];
+
+		if (array == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		for (ulint segment = 0; segment < array->m_n_segments;
+		     ++segment) {
+			io_uring*	uring = array->ring(segment);
+			int		ret;
+
+			if (src == NULL) {
+				ret = io_uring_register_buffers(
+					uring, &os_aio_fixed_bufs[0],
+					unsigned(os_aio_fixed_bufs.size()));
+
+				if (ret < 0) {
+					array->release();
+
+					ib::warn() << "Could not register the"
+						" buffer pool with io_uring"
+						" (error " << -ret << ")."
+						" Increasing the locked memory"
+						" limit (ulimit -l) may help.";
+					return;
+				}
+
+				src = uring;
+			} else {
+#ifdef HAVE_IO_URING_CLONE_BUFFERS
+				ret = io_uring_clone_buffers(uring, src);
+#else
+				ret = -EOPNOTSUPP;
+#endif /* HAVE_IO_URING_CLONE_BUFFERS */
+			}
+
+			array->m_fixed_bufs[segment] = ret == 0;
+			n_registered += ret == 0;
+			++n_rings;
+		}
+
+		array->release();
+	}
+
+	if (n_registered < n_rings) {
+		/* Before Linux 6.12, registering the buffers with each
+		io_uring would lock the memory once per io_uring. */
+		ib::info() << "The buffer pool is registered with "
+			<< n_registered << " of " << n_rings
+			<< " io_uring instances. Sharing the registration"
+			" requires Linux 6.12 and liburing 2.8 or later.";
+	}
+}
+
+/** Unregister the fixed buffers from the io_uring instances. */
+void
+AIO::uring_unregister_buffers()
+{
+	AIO*	arrays[] = { s_reads, s_writes, s_ibuf };
+
+	for (ulint i = 0; i < array_elements(arrays); ++i) {
+		AIO*	array = arrays[i];
+
+		if (array == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		for (ulint segment = 0; segment < array->m_n_segments;
+		     ++segment) {
+			if (array->m_fixed_bufs[segment]) {
+				array->m_fixed_bufs[segment] = false;
+				io_uring_unregister_buffers(
+					array->ring(segment));
+			}
+		}
+
+		array->release();
+	}
+}
+
+/** Check if the kernel supports the io_uring features we need.
+@return true if supported, false otherwise. */
+bool
+AIO::is_linux_io_uring_supported()
+{
+	struct io_uring	uring;
+
+	int	ret = io_uring_queue_init(1, &uring, 0);
+
+	if (ret < 0) {
+		ib::warn() << "io_uring_queue_init() returned error " << -ret;
+		return(false);
+	}
+
+	/* The I/O handler threads wait for completions with a timeout
+	while other threads submit requests to the same ring. Without
+	IORING_FEAT_EXT_ARG, the timeout would be passed as a submission
+	queue entry, which would require a mutex around the wait. */
+	bool	supported = uring.features & IORING_FEAT_EXT_ARG;
+
+	io_uring_queue_exit(&uring);
+
+	if (!supported) {
+		ib::warn() << "io_uring requires Linux 5.11 or later.";
+	}
+
+	return(supported);
+}
+
+/** Register memory ranges as io_uring fixed buffers, so that the kernel
+need not map the pages for each read or write that targets them.
+@param[in]	bufs	memory ranges, such as the buffer pool chunks
+@param[in]	n	number of memory ranges */
+void
+os_aio_register_buffers(const iovec* bufs, ulint n)
+{
+	ut_ad(os_aio_fixed_bufs.empty());
+
+	if (!srv_use_native_aio || !srv_use_io_uring || n == 0) {
+		return;
+	}
+
+	for (ulint i = 0; i < n; ++i) {
+		byte*	ptr = static_cast<byte*>(bufs[i].iov_base);
+		ulint	len = bufs[i].iov_len;
+
+		/* A fixed buffer may not exceed 1GiB. */
+		while (len > 0) {
+			iovec	buf;
+
+			buf.iov_base = ptr;
+			buf.iov_len = std::min(len, OS_AIO_FIXED_BUF_MAX_SIZE);
+			os_aio_fixed_bufs.push_back(buf);
+
+			ptr += buf.iov_len;
+			len -= buf.iov_len;
+		}
+	}
+
+	std::sort(os_aio_fixed_bufs.begin(), os_aio_fixed_bufs.end(),
+		  os_aio_fixed_buf_less);
+
+	AIO::uring_register_buffers();
+}
+
+/** Unregister the io_uring fixed buffers before the memory is freed. */
+void
+os_aio_unregister_buffers()
+{
+	if (os_aio_fixed_bufs.empty()) {
+		return;
+	}
+
+	AIO::uring_unregister_buffers();
+
+	os_aio_fixed_bufs.clear();
+}
+#endif /* LINUX_IO_URING */
+
 /** Creates an io_context for native linux AIO.
 @param[in]	max_events	number of events
 @param[out]	io_ctx		io_ctx to initialize.
@@ -5682,6 +6228,10 @@ AIO::AIO(
 # ifdef LINUX_NATIVE_AIO
 	,m_aio_ctx(),
 	m_events(m_slots.size())
+#  ifdef LINUX_IO_URING
+	,m_rings(),
+	m_fixed_bufs()
+#  endif /* LINUX_IO_URING */
 # endif /* LINUX_NATIVE_AIO */
 #ifdef WIN_ASYNC_IO
 	,m_completion_port(new_completion_port())
@@ -5780,6 +6330,51 @@ AIO::init_linux_native_aio()
 
 	return(DB_SUCCESS);
 }
+# ifdef LINUX_IO_URING
+/** Initialise the io_uring instances, one per segment. */
+dberr_t
+AIO::init_linux_io_uring()
+{
+	ut_a(m_rings == NULL);
+
+	m_rings = static_cast<io_uring*>(
+		ut_zalloc_nokey(m_n_segments * sizeof *m_rings));
+	m_fixed_bufs = static_cast<bool*>(
+		ut_zalloc_nokey(m_n_segments * sizeof *m_fixed_bufs));
+
+	if (m_rings == NULL || m_fixed_bufs == NULL) {
+		ut_free(m_rings);
+		ut_free(m_fixed_bufs);
+		m_rings = NULL;
+		m_fixed_bufs = NULL;
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		int	ret = io_uring_queue_init(
+			unsigned(slots_per_segment()), &m_rings[i], 0);
+
+		if (ret < 0) {
+			ib::error() << "io_uring_queue_init() returned error "
+				<< -ret << ". You can set"
+				" innodb_use_io_uring = 0 in my.cnf";
+
+			while (i--) {
+				io_uring_queue_exit(&m_rings[i]);
+			}
+
+			ut_free(m_rings);
+			ut_free(m_fixed_bufs);
+			m_rings = NULL;
+			m_fixed_bufs = NULL;
+
+			return(DB_ERROR);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 /** Initialise the array */
@@ -5791,7 +6386,11 @@ AIO::init()
 
 	if (srv_use_native_aio) {
 #ifdef LINUX_NATIVE_AIO
-		dberr_t	err = init_linux_native_aio();
+		dberr_t	err =
+# ifdef LINUX_IO_URING
+			srv_use_io_uring ? init_linux_io_uring() :
+# endif /* LINUX_IO_URING */
+			init_linux_native_aio();
 
 		if (err != DB_SUCCESS) {
 			return(err);
@@ -5851,6 +6450,16 @@ AIO::~AIO()
 		m_events.clear();
 		ut_free(m_aio_ctx);
 	}
+# ifdef LINUX_IO_URING
+	if (m_rings != NULL) {
+		for (ulint i = 0; i < m_n_segments; ++i) {
+			io_uring_queue_exit(&m_rings[i]);
+		}
+
+		ut_free(m_rings);
+		ut_free(m_fixed_bufs);
+	}
+# endif /* LINUX_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 #if defined(WIN_ASYNC_IO)
 	CloseHandle(m_completion_port);
@@ -5879,8 +6488,24 @@ AIO::start(
 	ulint		n_slots_sync)
 {
 #if defined(LINUX_NATIVE_AIO)
+# ifdef LINUX_IO_URING
+	if (srv_use_native_aio && srv_use_io_uring) {
+		if (is_linux_io_uring_supported()) {
+			ib::info() << "Using io_uring";
+		} else {
+			ib::warn() << "io_uring disabled.";
+
+			srv_use_io_uring = FALSE;
+		}
+	}
+# endif /* LINUX_IO_URING */
+
 	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio && !is_linux_native_aio_supported()) {
+	if (srv_use_native_aio
+# ifdef LINUX_IO_URING
+	    && !srv_use_io_uring
+# endif /* LINUX_IO_URING */
+	    && !is_linux_native_aio_supported()) {
 
 		ib::warn() << "Linux Native AIO disabled.";
 
@@ -6346,6 +6971,14 @@ void
 os_aio_simulated_wake_handler_threads()
 {
 	if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			/* Submit the requests that were queued with
+			IORequest::DO_NOT_WAKE. */
+			AIO::uring_submit_all();
+		}
+#endif /* LINUX_IO_URING */
+
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -6657,7 +7290,7 @@ os_aio_func(
 				file, slot->ptr, slot->len,
 				NULL, &slot->control);
 #elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -6675,7 +7308,7 @@ os_aio_func(
 				file, slot->ptr, slot->len,
 				NULL, &slot->control);
 #elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
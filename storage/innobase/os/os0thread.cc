@@ -199,6 +199,109 @@ os_thread_exit(bool detach)
 #endif
 }
 
+/** State of os_thread_run() that is shared between the threads */
+struct os_thread_run_t {
+	/** the work of each thread */
+	os_thread_work_t	work;
+	/** argument of work */
+	void*			arg;
+#ifdef UNIV_PFS_THREAD
+	/** performance schema key of the created threads */
+	mysql_pfs_key_t		key;
+#endif /* UNIV_PFS_THREAD */
+	/** index of the next created thread */
+	ulint			next_id;
+	/** number of created threads that have not finished */
+	ulint			n_running;
+	/** signalled when n_running reaches 0 */
+	os_event_t		done;
+};
+
+/** Thread created by os_thread_run().
+@param[in,out]	arg	os_thread_run_t
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(os_thread_run_thread)(void* arg)
+{
+	my_thread_init();
+
+	os_thread_run_t*	run = static_cast<os_thread_run_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(run->key);
+#endif /* UNIV_PFS_THREAD */
+
+	run->work(run->arg, my_atomic_addlint(&run->next_id, 1));
+
+	/* The state may be freed as soon as the last thread has
+	signalled completion. */
+	if (my_atomic_addlint(&run->n_running, ulint(-1)) == 1) {
+		os_event_set(run->done);
+	}
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Do some work in the calling thread and in additional threads, and
+wait for all of them to finish.
+@param[in]	work	the work of each thread
+@param[in,out]	arg	argument of work and wait
+@param[in]	n	number of threads to create in addition to
+			the calling thread
+@param[in]	key	performance schema key of the created threads
+@param[in]	wait	function to invoke about once per second while
+			waiting for the created threads, or NULL */
+void
+os_thread_run_func(
+	os_thread_work_t	work,
+	void*			arg,
+	ulint			n,
+#ifdef UNIV_PFS_THREAD
+	mysql_pfs_key_t		key,
+#endif /* UNIV_PFS_THREAD */
+	void			(*wait)(void* arg))
+{
+	os_thread_run_t	run;
+
+	run.work = work;
+	run.arg = arg;
+#ifdef UNIV_PFS_THREAD
+	run.key = key;
+#endif /* UNIV_PFS_THREAD */
+	run.next_id = 1;
+	run.n_running = n;
+	run.done = NULL;
+
+	if (n) {
+		run.done = os_event_create(0);
+
+		for (ulint i = 0; i < n; i++) {
+			os_thread_create(os_thread_run_thread, &run, NULL);
+		}
+	}
+
+	work(arg, 0);
+
+	if (!n) {
+		return;
+	}
+
+	if (wait) {
+		while (os_event_wait_time(run.done, 1000000)
+		       == OS_SYNC_TIME_EXCEEDED) {
+			wait(arg);
+		}
+	} else {
+		os_event_wait(run.done);
+	}
+
+	os_event_destroy(run.done);
+}
+
 /*****************************************************************//**
 Advises the os to give up remainder of the thread's time slice. */
 void
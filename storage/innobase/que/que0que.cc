@@ -31,6 +31,7 @@ Created 5/27/1996 Heikki Tuuri
 #include "trx0roll.h"
 #include "row0undo.h"
 #include "row0ins.h"
+#include "row0merge.h"
 #include "row0upd.h"
 #include "row0sel.h"
 #include "row0purge.h"
@@ -470,6 +471,16 @@ que_graph_free_recursive(
 			ins->entry_sys_heap = NULL;
 		}
 
+		if (ins->bulk != NULL) {
+			row_merge_bulk_free(ins->bulk);
+			ins->bulk = NULL;
+		}
+
+		if (ins->fk_batch != NULL) {
+			row_ins_fk_batch_free(ins->fk_batch);
+			ins->fk_batch = NULL;
+		}
+
 		break;
 	case QUE_NODE_PURGE:
 		purge = static_cast<purge_node_t*>(node);
@@ -180,15 +180,32 @@ will mark their views as closed but not actually free their views.
 
   @param[in,out] trx transaction
 */
-inline void ReadView::snapshot(trx_t *trx)
+inline void ReadView::snapshot(trx_t *)
 {
-  trx_sys.snapshot_ids(trx, &m_ids, &m_low_limit_id, &m_low_limit_no);
-  std::sort(m_ids.begin(), m_ids.end());
-  m_up_limit_id= m_ids.empty() ? m_low_limit_id : m_ids.front();
+  trx_sys.snapshot(&m_low_limit_id, &m_low_limit_no, &m_up_limit_id);
   ut_ad(m_up_limit_id <= m_low_limit_id);
 }
 
 
+/**
+  Checks whether a transaction committed before the view was created.
+
+  Transactions that were active when the view was created will be assigned
+  a commit sequence number that is not smaller than m_low_limit_id. If the
+  transaction is not found in trx_sys.csn_map, it committed before any open
+  view was created.
+
+  @param[in] id transaction id, m_up_limit_id <= id < m_low_limit_id
+  @return whether the view sees the modifications of id
+*/
+bool ReadView::committed_before(trx_id_t id) const
+{
+  ut_ad(id >= m_up_limit_id);
+  ut_ad(id < m_low_limit_id);
+  return trx_sys.csn_map.find(id) < m_low_limit_id;
+}
+
+
 /**
   Opens a read view where exactly the transactions serialized before this
   point in time are seen in the view.
@@ -234,10 +251,21 @@ void ReadView::open(trx_t *trx)
       before state is set to READ_VIEW_STATE_OPEN. New read-write transaction
       may get started, committed and purged meanwhile. It is acceptable as
       well, since this view doesn't see it.
+
+      But a transaction that was active when the view was created must not
+      commit meanwhile: purge could forget its commit sequence number (see
+      trx_csn_map_t::prune()) while this view is not visible to purge. That
+      is why the value is checked again after the view has been opened.
     */
-    if (trx_is_autocommit_non_locking(trx) && m_ids.empty() &&
+    if (trx_is_autocommit_non_locking(trx) &&
         m_low_limit_id == trx_sys.get_max_trx_id())
-      goto reopen;
+    {
+      my_atomic_store32(&m_state, READ_VIEW_STATE_OPEN);
+      if (m_low_limit_id == trx_sys.get_max_trx_id_seq_cst())
+        goto reopen;
+      my_atomic_store32_explicit(&m_state, READ_VIEW_STATE_CLOSED,
+                                 MY_MEMORY_ORDER_RELAXED);
+    }
 
     /*
       Can't reuse view, take new snapshot.
@@ -275,11 +303,20 @@ void ReadView::open(trx_t *trx)
   No need to call ReadView::close(). The caller owns the view that is passed
   in. This function is called by purge thread to determine whether it should
   purge the delete marked record or not.
+
+  The purge coordinator also refreshes the lower bound of active transaction
+  identifiers for new views, and removes the commit sequence numbers that no
+  open view needs from trx_sys.csn_map.
 */
 void trx_sys_t::clone_oldest_view()
 {
+  trx_ids_t views;
+
+  update_min_active_id(NULL);
   purge_sys.view.snapshot(0);
+  const trx_id_t limit= purge_sys.view.low_limit_id();
   mutex_enter(&mutex);
+  views.reserve(UT_LIST_GET_LEN(trx_list));
   /* Find oldest view. */
   for (const trx_t *trx= UT_LIST_GET_FIRST(trx_list); trx;
        trx= UT_LIST_GET_NEXT(trx_list, trx))
@@ -290,7 +327,13 @@ void trx_sys_t::clone_oldest_view()
       ut_delay(1);
 
     if (state == READ_VIEW_STATE_OPEN)
+    {
       purge_sys.view.copy(trx->read_view);
+      views.push_back(trx->read_view.low_limit_id());
+    }
   }
   mutex_exit(&mutex);
+
+  std::sort(views.begin(), views.end());
+  csn_map.prune(views, limit);
 }
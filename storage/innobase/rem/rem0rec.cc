@@ -369,9 +369,19 @@ rec_init_offsets_comp_ordinary(
 	offsets[3] = (ulint) index;
 #endif /* UNIV_DEBUG */
 
-	/* read the lengths of fields 0..n_fields */
-	ulint i = 0;
-	do {
+	/* The leading fixed-length NOT NULL fields have neither null
+	flags nor lengths, so their offsets are the same in every record. */
+	ulint i = std::min(ulint(index->n_fixed_offsets),
+			   std::min(n_core, rec_offs_n_fields(offsets)));
+
+	if (i) {
+		memcpy(rec_offs_base(offsets) + 1, index->fixed_offsets,
+		       i * sizeof *offsets);
+		offs = index->fixed_offsets[i - 1];
+	}
+
+	/* read the lengths of fields i..n_fields */
+	for (; i < rec_offs_n_fields(offsets); i++) {
 		const dict_field_t*	field
 			= dict_index_get_nth_field(index, i);
 		const dict_col_t*	col
@@ -448,7 +458,7 @@ rec_init_offsets_comp_ordinary(
 		}
 resolved:
 		rec_offs_base(offsets)[i + 1] = len;
-	} while (++i < rec_offs_n_fields(offsets));
+	}
 
 	*rec_offs_base(offsets)
 		= ulint(rec - (lens + 1)) | REC_OFFS_COMPACT | any;
@@ -643,7 +653,22 @@ rec_init_offsets(
 		offs = 0;
 		null_mask = 1;
 
-		/* read the lengths of fields 0..n */
+		/* The node pointer fields precede the child page number. */
+		i = std::min(ulint(index->n_fixed_offsets),
+			     std::min(n_node_ptr_field,
+				      rec_offs_n_fields(offsets)));
+
+		if (i) {
+			memcpy(rec_offs_base(offsets) + 1,
+			       index->fixed_offsets, i * sizeof *offsets);
+			offs = index->fixed_offsets[i - 1];
+
+			if (i == rec_offs_n_fields(offsets)) {
+				goto done;
+			}
+		}
+
+		/* read the lengths of fields i..n */
 		do {
 			ulint	len;
 			if (UNIV_UNLIKELY(i == n_node_ptr_field)) {
@@ -713,7 +738,7 @@ rec_init_offsets(
 resolved:
 			rec_offs_base(offsets)[i + 1] = len;
 		} while (++i < rec_offs_n_fields(offsets));
-
+done:
 		*rec_offs_base(offsets)
 			= ulint(rec - (lens + 1)) | REC_OFFS_COMPACT;
 	} else {
@@ -3717,6 +3717,10 @@ row_import_for_mysql(
 
 	ibuf_delete_for_discarded_space(table->space_id);
 
+	/* DISCARD TABLESPACE may have left dirty pages in the buffer
+	pool. Remove them before PageConverter evicts the pages. */
+	fil_space_discard_dropped(table->space_id);
+
 	trx_start_if_not_started(prebuilt->trx, true);
 
 	trx = trx_create();
@@ -40,6 +40,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "row0sel.h"
 #include "row0row.h"
 #include "row0log.h"
+#include "row0merge.h"
 #include "rem0cmp.h"
 #include "lock0lock.h"
 #include "log0log.h"
@@ -89,6 +90,8 @@ ins_node_create(
 
 	node->trx_id = 0;
 	node->duplicate = NULL;
+	node->bulk = NULL;
+	node->fk_batch = NULL;
 
 	node->entry_sys_heap = mem_heap_create(128);
 
@@ -1084,8 +1087,8 @@ row_ins_foreign_check_on_constraint(
 	/* Since we are going to delete or update a row, we have to invalidate
 	the MySQL query cache for table. A deadlock of threads is not possible
 	here because the caller of this function does not hold any latches with
-	the mutex rank above the lock_sys_t::mutex. The query cache mutex
-	has a rank just above the lock_sys_t::mutex. */
+	the latch rank above lock_sys.latch. The query cache mutex
+	has a rank just above lock_sys.latch. */
 
 	row_ins_invalidate_query_cache(thr, table->name.m_name);
 
@@ -1918,6 +1921,455 @@ row_ins_check_foreign_constraint(
 	DBUG_RETURN(err);
 }
 
+/** Foreign key checks of a multi-row insert statement that are
+deferred by row_ins_check_foreign_constraints() */
+struct row_ins_fk_batch_t {
+	/** deferred checks of one constraint */
+	struct fk_t {
+		/** the constraint; the child table cannot be altered
+		while the statement is being executed */
+		dict_foreign_t*	foreign;
+		/** the foreign key column values (n_fields of foreign) */
+		std::vector<dtuple_t*, ut_allocator<dtuple_t*> >	keys;
+		/** number of keys[] that have been verified */
+		ulint		n_checked;
+	};
+
+	/** memory heap for the keys */
+	mem_heap_t*					heap;
+	/** the deferred checks of each constraint */
+	std::vector<fk_t, ut_allocator<fk_t> >		fks;
+};
+
+/** Start deferring the foreign key checks of a multi-row insert.
+@param[in]	table	table where the rows are inserted
+@param[in]	trx	transaction
+@return the deferred checks, or NULL if each row must be checked
+when it is inserted */
+row_ins_fk_batch_t*
+row_ins_fk_batch_create(const dict_table_t* table, const trx_t* trx)
+{
+	/* With INSERT IGNORE, REPLACE or ON DUPLICATE KEY UPDATE,
+	a failing row may be skipped or replaced; this can only be
+	decided when the row is being inserted. */
+	if (!trx->check_foreigns || trx->duplicates
+	    || table->foreign_set.empty()
+	    || table->is_temporary() || table->versioned()) {
+		return(NULL);
+	}
+
+	row_ins_fk_batch_t*	batch = UT_NEW_NOKEY(row_ins_fk_batch_t());
+	batch->heap = mem_heap_create(1024);
+	return(batch);
+}
+
+/** Determine if the deferred checks should be verified before
+further rows are inserted.
+@param[in]	batch	deferred foreign key checks
+@return whether the memory limit was reached */
+bool
+row_ins_fk_batch_full(const row_ins_fk_batch_t* batch)
+{
+	return(mem_heap_get_size(batch->heap) >= srv_sort_buf_size);
+}
+
+/** Discard the deferred foreign key checks.
+@param[in,out]	batch	deferred foreign key checks */
+static
+void
+row_ins_fk_batch_empty(row_ins_fk_batch_t* batch)
+{
+	batch->fks.clear();
+	mem_heap_empty(batch->heap);
+}
+
+/** Free deferred foreign key checks.
+@param[in,out]	batch	deferred foreign key checks */
+void
+row_ins_fk_batch_free(row_ins_fk_batch_t* batch)
+{
+	mem_heap_free(batch->heap);
+	UT_DELETE(batch);
+}
+
+/** Defer the check of a foreign key constraint for an index entry.
+@param[in,out]	batch	deferred foreign key checks
+@param[in]	foreign	constraint of the child table
+@param[in]	entry	index entry for foreign->foreign_index
+@return whether the check was deferred or is not needed */
+static
+bool
+row_ins_fk_batch_add(
+	row_ins_fk_batch_t*	batch,
+	dict_foreign_t*		foreign,
+	const dtuple_t*		entry)
+{
+	const dict_table_t*	referenced_table = foreign->referenced_table;
+
+	/* A row may refer to a row that is inserted later by the same
+	statement; this must be an error, as in the row-by-row check.
+	The checks of rows of a versioned parent table are also left to
+	row_ins_check_foreign_constraint(). If the parent table is not
+	in the cache, it will report the error. */
+	if (referenced_table == NULL
+	    || referenced_table == foreign->foreign_table
+	    || referenced_table->versioned()) {
+		return(false);
+	}
+
+	ut_ad(entry->n_fields >= foreign->n_fields);
+
+	for (ulint i = 0; i < foreign->n_fields; i++) {
+		if (dfield_is_null(dtuple_get_nth_field(entry, i))) {
+			/* The constraint is not checked (see
+			row_ins_check_foreign_constraint()). */
+			return(true);
+		}
+	}
+
+	row_ins_fk_batch_t::fk_t*	fk = NULL;
+
+	for (ulint i = 0; i < batch->fks.size(); i++) {
+		if (batch->fks[i].foreign == foreign) {
+			fk = &batch->fks[i];
+			break;
+		}
+	}
+
+	if (fk == NULL) {
+		batch->fks.push_back(row_ins_fk_batch_t::fk_t());
+		fk = &batch->fks.back();
+		fk->foreign = foreign;
+		fk->n_checked = 0;
+	}
+
+	dtuple_t*	key = dtuple_create(batch->heap, foreign->n_fields);
+
+	for (ulint i = 0; i < foreign->n_fields; i++) {
+		dfield_t*	field = dtuple_get_nth_field(key, i);
+		dfield_copy(field, dtuple_get_nth_field(entry, i));
+		dfield_dup(field, batch->heap);
+	}
+
+	fk->keys.push_back(key);
+	return(true);
+}
+
+/** Compare two deferred foreign key values.
+@param[in]	a	foreign key value
+@param[in]	b	foreign key value of the same constraint
+@return whether a is less than b */
+static
+bool
+row_ins_fk_batch_less(const dtuple_t* a, const dtuple_t* b)
+{
+	ut_ad(a->n_fields == b->n_fields);
+
+	for (ulint i = 0; i < a->n_fields; i++) {
+		if (int cmp = cmp_dfield_dfield(dtuple_get_nth_field(a, i),
+						dtuple_get_nth_field(b, i))) {
+			return(cmp < 0);
+		}
+	}
+
+	return(false);
+}
+
+/** Determine if two deferred foreign key values are equal.
+@param[in]	a	foreign key value
+@param[in]	b	foreign key value of the same constraint
+@return whether a is equal to b */
+static
+bool
+row_ins_fk_batch_equal(const dtuple_t* a, const dtuple_t* b)
+{
+	return(!row_ins_fk_batch_less(a, b) && !row_ins_fk_batch_less(b, a));
+}
+
+/** Look up and lock the first parent record that matches a key,
+starting from the first record that is not less than the key,
+like row_ins_check_foreign_constraint() does for a single row.
+@param[in]	foreign		constraint
+@param[in]	key		foreign key value
+@param[in,out]	pcur		cursor on the referenced index
+@param[in,out]	mtr		mini-transaction
+@param[in,out]	thr		query thread
+@param[in,out]	offsets_heap	memory heap for offsets
+@return DB_SUCCESS, DB_NO_REFERENCED_ROW, DB_LOCK_WAIT, or error code */
+static
+dberr_t
+row_ins_fk_batch_check_key(
+	dict_foreign_t*	foreign,
+	const dtuple_t*	key,
+	btr_pcur_t*	pcur,
+	mtr_t*		mtr,
+	que_thr_t*	thr,
+	mem_heap_t**	offsets_heap)
+{
+	dict_index_t*	check_index	= foreign->referenced_index;
+	trx_t*		trx		= thr_get_trx(thr);
+	const bool	skip_gap_lock	= trx->isolation_level
+		<= TRX_ISO_READ_COMMITTED;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	dberr_t		err;
+
+	rec_offs_init(offsets_);
+
+	do {
+		const rec_t*		rec = btr_pcur_get_rec(pcur);
+		const buf_block_t*	block = btr_pcur_get_block(pcur);
+
+		if (page_rec_is_infimum(rec)) {
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, check_index, offsets, true,
+					  ULINT_UNDEFINED, offsets_heap);
+
+		if (page_rec_is_supremum(rec)) {
+			if (skip_gap_lock) {
+				continue;
+			}
+
+			err = row_ins_set_shared_rec_lock(
+				LOCK_ORDINARY, block, rec, check_index,
+				offsets, thr);
+
+			switch (err) {
+			case DB_SUCCESS_LOCKED_REC:
+			case DB_SUCCESS:
+				continue;
+			default:
+				return(err);
+			}
+		}
+
+		if (int cmp = cmp_dtuple_rec(key, rec, offsets)) {
+			ut_a(cmp < 0);
+
+			err = skip_gap_lock
+				? DB_SUCCESS
+				: row_ins_set_shared_rec_lock(
+					LOCK_GAP, block, rec, check_index,
+					offsets, thr);
+
+			switch (err) {
+			case DB_SUCCESS_LOCKED_REC:
+			case DB_SUCCESS:
+				row_ins_foreign_report_add_err(
+					trx, foreign, rec, key);
+				return(DB_NO_REFERENCED_ROW);
+			default:
+				return(err);
+			}
+		}
+
+		const bool	deleted = rec_get_deleted_flag(
+			rec, rec_offs_comp(offsets));
+
+		err = row_ins_set_shared_rec_lock(
+			deleted && !skip_gap_lock
+			? LOCK_ORDINARY : LOCK_REC_NOT_GAP,
+			block, rec, check_index, offsets, thr);
+
+		switch (err) {
+		case DB_SUCCESS_LOCKED_REC:
+		case DB_SUCCESS:
+			if (!deleted) {
+				return(DB_SUCCESS);
+			}
+			break;
+		default:
+			return(err);
+		}
+	} while (btr_pcur_move_to_next(pcur, mtr));
+
+	row_ins_foreign_report_add_err(
+		trx, foreign, btr_pcur_get_rec(pcur), key);
+	return(DB_NO_REFERENCED_ROW);
+}
+
+/** Verify the deferred checks of a constraint in key order.
+@param[in,out]	fk	deferred checks of the constraint
+@param[in,out]	thr	query thread
+@return DB_SUCCESS, DB_NO_REFERENCED_ROW, DB_LOCK_WAIT, or error code */
+static
+dberr_t
+row_ins_fk_batch_check_low(row_ins_fk_batch_t::fk_t* fk, que_thr_t* thr)
+{
+	dict_foreign_t*	foreign		= fk->foreign;
+	dict_table_t*	check_table	= foreign->referenced_table;
+	dict_index_t*	check_index	= foreign->referenced_index;
+	dberr_t		err;
+
+	if (fk->n_checked == 0) {
+		std::sort(fk->keys.begin(), fk->keys.end(),
+			  row_ins_fk_batch_less);
+		fk->keys.erase(std::unique(fk->keys.begin(), fk->keys.end(),
+					   row_ins_fk_batch_equal),
+			       fk->keys.end());
+	}
+
+	if (check_table == NULL || !check_table->is_readable()
+	    || check_index == NULL) {
+		/* The parent table was dropped or discarded after the
+		check was deferred. Let the row-by-row check report it. */
+		for (; fk->n_checked < fk->keys.size(); fk->n_checked++) {
+			err = row_ins_check_foreign_constraint(
+				TRUE, foreign, foreign->foreign_table,
+				fk->keys[fk->n_checked], thr);
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+		}
+
+		return(DB_SUCCESS);
+	}
+
+	err = lock_table(0, check_table, LOCK_IS, thr);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	mem_heap_t*	heap = NULL;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+
+	mtr.start();
+
+	btr_pcur_open(check_index, fk->keys[fk->n_checked], PAGE_CUR_GE,
+		      BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	for (;;) {
+		err = row_ins_fk_batch_check_key(
+			foreign, fk->keys[fk->n_checked], &pcur, &mtr, thr,
+			&heap);
+
+		if (err != DB_SUCCESS || ++fk->n_checked == fk->keys.size()) {
+			break;
+		}
+
+		const dtuple_t*	key = fk->keys[fk->n_checked];
+		const rec_t*	last = page_rec_get_prev_const(
+			page_get_supremum_rec(btr_pcur_get_page(&pcur)));
+
+		if (!page_rec_is_infimum(last)
+		    && cmp_dtuple_rec(key, last, rec_get_offsets(
+					      last, check_index, NULL, true,
+					      ULINT_UNDEFINED, &heap)) <= 0) {
+			/* The first record that is not less than the
+			key is on the same page. The cursor is on a record
+			that matched a smaller key; no preceding page can
+			contain the key. */
+			page_cur_search(btr_pcur_get_block(&pcur), check_index,
+					key, PAGE_CUR_GE,
+					btr_pcur_get_page_cur(&pcur));
+		} else {
+			btr_pcur_close(&pcur);
+			mtr.commit();
+			mtr.start();
+			btr_pcur_open(check_index, key, PAGE_CUR_GE,
+				      BTR_SEARCH_LEAF, &pcur, &mtr);
+		}
+
+		if (heap != NULL) {
+			mem_heap_empty(heap);
+		}
+	}
+
+	btr_pcur_close(&pcur);
+	mtr.commit();
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	return(err);
+}
+
+/** Verify the deferred foreign key checks, in the order of the keys
+of each referenced index. The parent records that are on the same
+leaf page are looked up and locked within one latching of the page.
+After DB_LOCK_WAIT, the lock has been waited for, and the verification
+must be resumed by invoking this function again. On any other error,
+the remaining checks are discarded, because the statement will be
+rolled back.
+@param[in,out]	batch	deferred foreign key checks
+@param[in,out]	thr	query thread
+@return DB_SUCCESS, DB_LOCK_WAIT, DB_NO_REFERENCED_ROW, or error code */
+dberr_t
+row_ins_fk_batch_check(row_ins_fk_batch_t* batch, que_thr_t* thr)
+{
+	trx_t*	trx		= thr_get_trx(thr);
+	dberr_t	err		= DB_SUCCESS;
+	bool	got_s_lock	= false;
+
+	if (trx->dict_operation_lock_mode == 0) {
+		got_s_lock = true;
+		row_mysql_freeze_data_dictionary(trx);
+	}
+
+	for (ulint i = 0; i < batch->fks.size(); i++) {
+		row_ins_fk_batch_t::fk_t*	fk = &batch->fks[i];
+
+		if (fk->n_checked == fk->keys.size()) {
+			continue;
+		}
+
+		dict_table_t*	check_table = fk->foreign->referenced_table;
+
+		/* Like row_ins_check_foreign_constraints(), defer a
+		DROP TABLE of the child table while it is being checked. */
+		fk->foreign->foreign_table->inc_fk_checks();
+		err = row_ins_fk_batch_check_low(fk, thr);
+		fk->foreign->foreign_table->dec_fk_checks();
+
+		if (err == DB_LOCK_WAIT && check_table != NULL) {
+			/* Wait for the lock here, like
+			row_ins_check_foreign_constraint() does. The
+			counter prevents the referenced table from being
+			dropped while lock_wait_suspend_thread() has
+			released the dict_operation_lock. */
+			trx->error_state = err;
+
+			que_thr_stop_for_mysql(thr);
+
+			thr->lock_state = QUE_THR_LOCK_ROW;
+
+			check_table->inc_fk_checks();
+
+			lock_wait_suspend_thread(thr);
+
+			thr->lock_state = QUE_THR_LOCK_NOLOCK;
+
+			if (check_table->to_be_dropped) {
+				err = DB_LOCK_WAIT_TIMEOUT;
+			} else if (trx->error_state != DB_SUCCESS) {
+				err = trx->error_state;
+			}
+
+			check_table->dec_fk_checks();
+		}
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	if (got_s_lock) {
+		row_mysql_unfreeze_data_dictionary(trx);
+	}
+
+	if (err != DB_LOCK_WAIT) {
+		row_ins_fk_batch_empty(batch);
+	}
+
+	return(err);
+}
+
 /***************************************************************//**
 Checks if foreign key constraints fail for an index entry. If index
 is not mentioned in any constraint, this function does nothing,
@@ -1944,13 +2396,20 @@ row_ins_check_foreign_constraints(
 	DEBUG_SYNC_C_IF_THD(thr_get_trx(thr)->mysql_thd,
 			    "foreign_constraint_check_for_ins");
 
+	row_ins_fk_batch_t*	batch
+		= que_node_get_type(thr->run_node) == QUE_NODE_INSERT
+		? static_cast<ins_node_t*>(thr->run_node)->fk_batch
+		: NULL;
+
 	for (dict_foreign_set::iterator it = table->foreign_set.begin();
 	     it != table->foreign_set.end();
 	     ++it) {
 
 		foreign = *it;
 
-		if (foreign->foreign_index == index) {
+		if (foreign->foreign_index == index
+		    && !(batch && row_ins_fk_batch_add(
+				 batch, foreign, entry))) {
 			dict_table_t*	ref_table = NULL;
 			dict_table_t*	referenced_table
 						= foreign->referenced_table;
@@ -3371,6 +3830,10 @@ row_ins_index_entry(
 			DBUG_SET("-d,row_ins_index_entry_timeout");
 			return(DB_LOCK_WAIT);});
 
+	my_atomic_add64_explicit(
+		reinterpret_cast<int64*>(&index->stat_modified_counter), 1,
+		MY_MEMORY_ORDER_RELAXED);
+
 	if (index->is_primary()) {
 		return(row_ins_clust_index_entry(index, entry, thr, 0, false));
 	} else {
@@ -3620,6 +4083,75 @@ row_ins_get_row_from_select(
 	}
 }
 
+/** Buffer a row for inserting into an empty table.
+If some index entry is too large for the buffer, load the buffered rows
+and fall back to inserting the row normally.
+@param[in,out]	node	row insert node with node->bulk != NULL
+@param[in,out]	thr	query thread
+@return error code */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_ins_bulk(ins_node_t* node, que_thr_t* thr)
+{
+	trx_t*	trx = thr_get_trx(thr);
+	dberr_t	err;
+	bool	fits = true;
+
+	ut_ad(node->index == dict_table_get_first_index(node->table));
+	ut_ad(!node->duplicate);
+
+	/* There is no undo log record for the buffered rows.
+	The TRX_UNDO_EMPTY record will empty the whole table. */
+	trx_write_roll_ptr(&node->sys_buf[DATA_ROW_ID_LEN + DATA_TRX_ID_LEN],
+			   roll_ptr_t(1) << ROLL_PTR_INSERT_FLAG_POS);
+
+	for (; node->index != NULL;
+	     node->index = dict_table_get_next_index(node->index),
+		     node->entry = UT_LIST_GET_NEXT(tuple_list, node->entry)) {
+		err = row_ins_index_entry_set_vals(
+			node->index, node->entry, node->row);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		ut_ad(dtuple_check_typed(node->entry));
+
+		fits = fits && row_merge_bulk_fits(node->index, node->entry);
+	}
+
+	ulint	i = 0;
+
+	for (node->index = dict_table_get_first_index(node->table),
+		     node->entry = UT_LIST_GET_FIRST(node->entry_list);
+	     fits && node->index != NULL;
+	     node->index = dict_table_get_next_index(node->index),
+		     node->entry = UT_LIST_GET_NEXT(tuple_list, node->entry),
+		     i++) {
+		err = row_merge_bulk_add(node->bulk, i, node->entry, trx);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	if (fits) {
+		ut_ad(node->entry == NULL);
+		node->state = INS_NODE_ALLOC_ROW_ID;
+		return(DB_SUCCESS);
+	}
+
+	/* Load the rows that were buffered so far, and insert this
+	and any subsequent rows of the statement one by one. */
+	err = row_merge_bulk_apply(node->bulk, trx);
+	row_merge_bulk_free(node->bulk);
+	node->bulk = NULL;
+
+	node->index = dict_table_get_first_index(node->table);
+	node->entry = UT_LIST_GET_FIRST(node->entry_list);
+	return(err);
+}
+
 /***********************************************************//**
 Inserts a row to a table.
 @return DB_SUCCESS if operation successfully completed, else error
@@ -3662,6 +4194,14 @@ row_ins(
 
 	ut_ad(node->state == INS_NODE_INSERT_ENTRIES);
 
+	if (node->bulk != NULL) {
+		err = row_ins_bulk(node, thr);
+
+		if (err != DB_SUCCESS || node->bulk != NULL) {
+			DBUG_RETURN(err);
+		}
+	}
+
 	while (node->index != NULL) {
 		if (node->index->type != DICT_FTS) {
 			err = row_ins_index_entry_step(node, thr);
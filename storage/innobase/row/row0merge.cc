@@ -47,6 +47,7 @@ Completed by Sunny Bains and Marko Makela
 #include "row0ftsort.h"
 #include "row0import.h"
 #include "row0vers.h"
+#include "row0pread.h"
 #include "handler0alter.h"
 #include "btr0bulk.h"
 #include "fsp0sysspace.h"
@@ -68,213 +69,21 @@ float my_log2f(float n)
 /* Whether to disable file system cache */
 char	srv_disable_sort_file_cache;
 
-/** Class that caches index row tuples made from a single cluster
-index page scan, and then insert into corresponding index tree */
-class index_tuple_info_t {
-public:
-	/** constructor
-	@param[in]	heap	memory heap
-	@param[in]	index	index to be created */
-	index_tuple_info_t(
-		mem_heap_t*	heap,
-		dict_index_t*	index) UNIV_NOTHROW
-	{
-		m_heap = heap;
-		m_index = index;
-		m_dtuple_vec = UT_NEW_NOKEY(idx_tuple_vec());
-	}
-
-	/** destructor */
-	~index_tuple_info_t()
-	{
-		UT_DELETE(m_dtuple_vec);
-	}
-
-	/** Get the index object
-	@return the index object */
-	dict_index_t*   get_index() UNIV_NOTHROW
-	{
-		return(m_index);
-	}
-
-	/** Caches an index row into index tuple vector
-	@param[in]	row	table row
-	@param[in]	ext	externally stored column
-	prefixes, or NULL */
-	void add(
-		const dtuple_t*		row,
-		const row_ext_t*	ext) UNIV_NOTHROW
-	{
-		dtuple_t*	dtuple;
-
-		dtuple = row_build_index_entry(row, ext, m_index, m_heap);
-
-		ut_ad(dtuple);
-
-		m_dtuple_vec->push_back(dtuple);
-	}
-
-	/** Insert spatial index rows cached in vector into spatial index
-	@param[in]	trx_id		transaction id
-	@param[in,out]	row_heap	memory heap
-	@param[in]	pcur		cluster index scanning cursor
-	@param[in,out]	scan_mtr	mini-transaction for pcur
-	@param[out]	mtr_committed	whether scan_mtr got committed
-	@return DB_SUCCESS if successful, else error number */
-	dberr_t insert(
-		trx_id_t		trx_id,
-		mem_heap_t*		row_heap,
-		btr_pcur_t*		pcur,
-		mtr_t*			scan_mtr,
-		bool*			mtr_committed)
-	{
-		big_rec_t*      big_rec;
-		rec_t*          rec;
-		btr_cur_t       ins_cur;
-		mtr_t           mtr;
-		rtr_info_t      rtr_info;
-		ulint*		ins_offsets = NULL;
-		dberr_t		error = DB_SUCCESS;
-		dtuple_t*	dtuple;
-		ulint		count = 0;
-		const ulint	flag = BTR_NO_UNDO_LOG_FLAG
-				       | BTR_NO_LOCKING_FLAG
-				       | BTR_KEEP_SYS_FLAG | BTR_CREATE_FLAG;
-
-		ut_ad(dict_index_is_spatial(m_index));
-
-		DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
-			log_sys.check_flush_or_checkpoint = true;
-		);
-
-		for (idx_tuple_vec::iterator it = m_dtuple_vec->begin();
-		     it != m_dtuple_vec->end();
-		     ++it) {
-			dtuple = *it;
-			ut_ad(dtuple);
-
-			if (log_sys.check_flush_or_checkpoint) {
-				if (!(*mtr_committed)) {
-					btr_pcur_move_to_prev_on_page(pcur);
-					btr_pcur_store_position(pcur, scan_mtr);
-					mtr_commit(scan_mtr);
-					*mtr_committed = true;
-				}
-
-				log_free_check();
-			}
-
-			mtr.start();
-			m_index->set_modified(mtr);
-
-			ins_cur.index = m_index;
-			rtr_init_rtr_info(&rtr_info, false, &ins_cur, m_index,
-					  false);
-			rtr_info_update_btr(&ins_cur, &rtr_info);
-
-			btr_cur_search_to_nth_level(m_index, 0, dtuple,
-						    PAGE_CUR_RTREE_INSERT,
-						    BTR_MODIFY_LEAF, &ins_cur,
-						    0, __FILE__, __LINE__,
-						    &mtr);
-
-			/* It need to update MBR in parent entry,
-			so change search mode to BTR_MODIFY_TREE */
-			if (rtr_info.mbr_adj) {
-				mtr_commit(&mtr);
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false, &ins_cur,
-						  m_index, false);
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				mtr_start(&mtr);
-				m_index->set_modified(mtr);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE, &ins_cur, 0,
-					__FILE__, __LINE__, &mtr);
-			}
-
-			error = btr_cur_optimistic_insert(
-				flag, &ins_cur, &ins_offsets, &row_heap,
-				dtuple, &rec, &big_rec, 0, NULL, &mtr);
-
-			if (error == DB_FAIL) {
-				ut_ad(!big_rec);
-				mtr.commit();
-				mtr.start();
-				m_index->set_modified(mtr);
-
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false,
-						  &ins_cur, m_index, false);
-
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE,
-					&ins_cur, 0,
-					__FILE__, __LINE__, &mtr);
-
-
-				error = btr_cur_pessimistic_insert(
-						flag, &ins_cur, &ins_offsets,
-						&row_heap, dtuple, &rec,
-						&big_rec, 0, NULL, &mtr);
-			}
-
-			DBUG_EXECUTE_IF(
-				"row_merge_ins_spatial_fail",
-				error = DB_FAIL;
-			);
-
-			if (error == DB_SUCCESS) {
-				if (rtr_info.mbr_adj) {
-					error = rtr_ins_enlarge_mbr(
-							&ins_cur, &mtr);
-				}
-
-				if (error == DB_SUCCESS) {
-					page_update_max_trx_id(
-						btr_cur_get_block(&ins_cur),
-						btr_cur_get_page_zip(&ins_cur),
-						trx_id, &mtr);
-				}
-			}
-
-			mtr_commit(&mtr);
-
-			rtr_clean_rtr_info(&rtr_info, true);
-			count++;
-		}
-
-		m_dtuple_vec->clear();
-
-		return(error);
-	}
-
-private:
-	/** Cache index rows made from a cluster index scan. Usually
-	for rows on single cluster index page */
-	typedef std::vector<dtuple_t*, ut_allocator<dtuple_t*> >
-		idx_tuple_vec;
-
-	/** vector used to cache index rows made from cluster index scan */
-	idx_tuple_vec*		m_dtuple_vec;
-
-	/** the index being built */
-	dict_index_t*		m_index;
-
-	/** memory heap for creating index tuples */
-	mem_heap_t*		m_heap;
-};
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	row_merge_thread_key;
+#endif /* UNIV_PFS_THREAD */
 
 /* Maximum pending doc memory limit in bytes for a fts tokenization thread */
 #define FTS_PENDING_DOC_MEMORY_LIMIT	1000000
 
+/* Length of the Hilbert value that precedes the spatial index entries
+in the merge sort */
+#define ROW_MERGE_HILBERT_LEN		8
+
 /** Insert sorted data tuples to the index.
 @param[in]	index		index to be inserted
+@param[in]	sort_index	index of the sorted tuples: index, or
+the spatial sort index of index
 @param[in]	old_table	old table
 @param[in]	fd		file descriptor
 @param[in,out]	block		file buffer
@@ -284,11 +93,14 @@ or NULL if fd, block will be used instead
 @param[in,out]	stage		performance schema accounting object, used by
 ALTER TABLE. If not NULL stage->begin_phase_insert() will be called initially
 and then stage->inc() will be called for each record that is processed.
+@param[in,out]	progress	progress of row_merge_build_parallel(),
+or NULL to update innodb_onlineddl_pct_progress directly
 @return DB_SUCCESS or error number */
 static	MY_ATTRIBUTE((warn_unused_result))
 dberr_t
 row_merge_insert_index_tuples(
 	dict_index_t*		index,
+	const dict_index_t*	sort_index,
 	const dict_table_t*	old_table,
 	const pfs_os_file_t&	fd,
 	row_merge_block_t*	block,
@@ -301,7 +113,8 @@ row_merge_insert_index_tuples(
 					  */
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space,	   /*!< in: space id */
-	ut_stage_alter_t*	stage = NULL);
+	ut_stage_alter_t*	stage = NULL,
+	row_merge_progress_t*	progress = NULL);
 
 /******************************************************//**
 Encode an index record. */
@@ -859,7 +672,7 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++ && dup->table) {
 		/* Only report the first duplicate record,
 		but count all duplicate records. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
@@ -1568,49 +1381,187 @@ row_mtuple_cmp(
 		       n_unique, n_unique, *current_mtuple, *prev_mtuple, dup));
 }
 
-/** Insert cached spatial index rows.
-@param[in]	trx_id		transaction id
-@param[in]	sp_tuples	cached spatial rows
-@param[in]	num_spatial	number of spatial indexes
-@param[in,out]	row_heap	heap for insert
-@param[in,out]	sp_heap		heap for tuples
-@param[in,out]	pcur		cluster index cursor
-@param[in,out]	mtr		mini transaction
-@param[in,out]	mtr_committed	whether scan_mtr got committed
-@return DB_SUCCESS or error number */
+/** Map a coordinate to an unsigned integer of the same order.
+@param[in]	d	coordinate
+@return the most significant 32 bits of the order-preserving image */
+static inline
+uint32_t
+row_merge_hilbert_coord(double d)
+{
+	uint64_t	u;
+
+	memcpy(&u, &d, sizeof u);
+
+	/* Flip all bits of negative numbers, and the sign bit of
+	positive numbers, so that the images compare like the numbers. */
+	u = (u >> 63) ? ~u : u | uint64_t(1) << 63;
+
+	return(uint32_t(u >> 32));
+}
+
+/** Compute the distance of the centre of a minimum bounding rectangle
+along a Hilbert curve that fills the plane. Entries that are close to
+each other on the curve are close to each other in space, so that
+loading an R-tree in this order keeps the overlap of the pages small.
+@param[in]	mbr	minimum bounding rectangle (DATA_MBR_LEN bytes)
+@return the Hilbert value */
 static
-dberr_t
-row_merge_spatial_rows(
-	trx_id_t		trx_id,
-	index_tuple_info_t**	sp_tuples,
-	ulint			num_spatial,
-	mem_heap_t*		row_heap,
-	mem_heap_t*		sp_heap,
-	btr_pcur_t*		pcur,
-	mtr_t*			mtr,
-	bool*			mtr_committed)
+uint64_t
+row_merge_hilbert_value(const byte* mbr)
 {
-	dberr_t			err = DB_SUCCESS;
+	uint32_t	x = row_merge_hilbert_coord(
+		(mach_double_read(mbr)
+		 + mach_double_read(mbr + sizeof(double))) / 2);
+	uint32_t	y = row_merge_hilbert_coord(
+		(mach_double_read(mbr + 2 * sizeof(double))
+		 + mach_double_read(mbr + 3 * sizeof(double))) / 2);
+	uint64_t	d = 0;
+
+	for (uint32_t s = uint32_t(1) << 31; s; s >>= 1) {
+		const uint32_t	rx = (x & s) != 0;
+		const uint32_t	ry = (y & s) != 0;
+
+		d += uint64_t(s) * s * ((3 * rx) ^ ry);
+
+		/* Rotate the quadrant. */
+		if (!ry) {
+			if (rx) {
+				x = ~x;
+				y = ~y;
+			}
 
-	if (sp_tuples == NULL) {
-		return(DB_SUCCESS);
+			std::swap(x, y);
+		}
+	}
+
+	return(d);
+}
+
+/** Create a temporary index for sorting the entries of a spatial index
+along the Hilbert curve. The first field is the Hilbert value of the
+entry, followed by the fields of the spatial index.
+@param[in]	index	spatial index
+@return the sort index, to be freed with dict_mem_index_free() */
+static
+dict_index_t*
+row_merge_create_spatial_sort_index(const dict_index_t* index)
+{
+	ut_ad(dict_index_is_spatial(index));
+
+	const ulint	n_fields = dict_index_get_n_fields(index) + 1;
+	dict_index_t*	sort_index = dict_mem_index_create(
+		index->table, "tmp_spatial_idx", 0, n_fields);
+
+	sort_index->id = index->id;
+	sort_index->n_uniq = unsigned(n_fields);
+	sort_index->n_def = unsigned(n_fields);
+	sort_index->n_nullable = index->n_nullable;
+	sort_index->n_core_null_bytes = UT_BITS_IN_BYTES(
+		unsigned(index->n_nullable));
+	sort_index->cached = TRUE;
+
+	dict_field_t*	field = dict_index_get_nth_field(sort_index, 0);
+
+	field->name = NULL;
+	field->prefix_len = 0;
+	field->col = static_cast<dict_col_t*>(
+		mem_heap_zalloc(sort_index->heap, sizeof(dict_col_t)));
+	field->col->mtype = DATA_INT;
+	field->col->prtype = DATA_NOT_NULL | DATA_UNSIGNED;
+	field->col->len = ROW_MERGE_HILBERT_LEN;
+	field->fixed_len = ROW_MERGE_HILBERT_LEN;
+
+	memcpy(field + 1, index->fields, (n_fields - 1) * sizeof *field);
+
+	return(sort_index);
+}
+
+/** Prepend the Hilbert value to a spatial index entry.
+@param[in]	sort_index	spatial sort index
+@param[in]	entry		spatial index entry
+@param[in,out]	heap		memory heap
+@return the fields of the sort index, pointing to the entry data */
+static
+dfield_t*
+row_merge_spatial_sort_fields(
+	const dict_index_t*	sort_index,
+	const dtuple_t*		entry,
+	mem_heap_t*		heap)
+{
+	const ulint	n_fields = dict_index_get_n_fields(sort_index);
+	const dfield_t*	mbr = dtuple_get_nth_field(entry, 0);
+	dfield_t*	fields = static_cast<dfield_t*>(
+		mem_heap_zalloc(heap, n_fields * sizeof *fields));
+	byte*		hilbert = static_cast<byte*>(
+		mem_heap_alloc(heap, ROW_MERGE_HILBERT_LEN));
+
+	ut_ad(dtuple_get_n_fields(entry) + 1 == n_fields);
+	ut_ad(dfield_get_len(mbr) == DATA_MBR_LEN);
+
+	mach_write_to_8(hilbert, row_merge_hilbert_value(
+				static_cast<const byte*>(
+					dfield_get_data(mbr))));
+	dfield_set_data(&fields[0], hilbert, ROW_MERGE_HILBERT_LEN);
+	memcpy(fields + 1, entry->fields, (n_fields - 1) * sizeof *fields);
+
+	for (ulint i = 0; i < n_fields; i++) {
+		dict_col_copy_type(dict_index_get_nth_col(sort_index, i),
+				   dfield_get_type(&fields[i]));
+	}
+
+	return(fields);
+}
+
+/** Insert an entry of a spatial index into the sort buffer of its
+spatial sort index.
+@param[in,out]	buf	sort buffer
+@param[in]	index	spatial index
+@param[in]	row	table row
+@param[in]	ext	cache of externally stored column prefixes, or NULL
+@param[in,out]	heap	memory heap for the index entry
+@return whether the entry was added; false if out of space */
+static
+bool
+row_merge_buf_add_spatial(
+	row_merge_buf_t*	buf,
+	dict_index_t*		index,
+	const dtuple_t*		row,
+	const row_ext_t*	ext,
+	mem_heap_t*		heap)
+{
+	if (buf->n_tuples >= buf->max_tuples) {
+		return(false);
 	}
 
-	ut_ad(sp_heap != NULL);
+	const dtuple_t*	entry = row_build_index_entry(
+		row, ext, index, heap);
+	ut_ad(entry);
 
-	for (ulint j = 0; j < num_spatial; j++) {
-		err = sp_tuples[j]->insert(
-			trx_id, row_heap,
-			pcur, mtr, mtr_committed);
+	const ulint	n_fields = dict_index_get_n_fields(buf->index);
+	dfield_t*	field = row_merge_spatial_sort_fields(
+		buf->index, entry, heap);
+	ulint		extra_size;
+	ulint		size = rec_get_converted_size_temp(
+		buf->index, field, n_fields, &extra_size);
 
-		if (err != DB_SUCCESS) {
-			return(err);
-		}
+	/* See row_merge_buf_add(). Reserve bytes for the encoded
+	extra_size and for the end marker of row_merge_block_t. */
+	size += 1 + ((extra_size + 1) >= 0x80);
+	ut_ad(size < srv_sort_buf_size);
+
+	if (buf->total_size + size >= srv_sort_buf_size) {
+		return(false);
 	}
 
-	mem_heap_empty(sp_heap);
+	buf->total_size += size;
+	buf->tuples[buf->n_tuples++].fields = field = static_cast<dfield_t*>(
+		mem_heap_dup(buf->heap, field, n_fields * sizeof *field));
 
-	return(err);
+	for (ulint n = n_fields; n--; ) {
+		dfield_dup(field++, buf->heap);
+	}
+
+	return(true);
 }
 
 /** Check if the geometry field is valid.
@@ -1651,6 +1602,8 @@ containing the index entries for the indexes to be built.
 @param[in]	online		true if creating indexes online
 @param[in]	index		indexes to be created
 @param[in]	fts_sort_idx	full-text index to be created, or NULL
+@param[in]	spatial_sort_idx	spatial sort indexes of the spatial
+				indexes to be created, NULL for other indexes
 @param[in]	psort_info	parallel sort info for fts_sort_idx creation,
 				or NULL
 @param[in]	files		temporary files
@@ -1685,6 +1638,7 @@ row_merge_read_clustered_index(
 	bool			online,
 	dict_index_t**		index,
 	dict_index_t*		fts_sort_idx,
+	dict_index_t**		spatial_sort_idx,
 	fts_psort_t*		psort_info,
 	merge_file_t*		files,
 	const ulint*		key_numbers,
@@ -1723,9 +1677,6 @@ row_merge_read_clustered_index(
 	os_event_t		fts_parallel_sort_event = NULL;
 	ibool			fts_pll_sort = FALSE;
 	int64_t			sig_count = 0;
-	index_tuple_info_t**	sp_tuples = NULL;
-	mem_heap_t*		sp_heap = NULL;
-	ulint			num_spatial = 0;
 	BtrBulk*		clust_btr_bulk = NULL;
 	bool			clust_temp_file = false;
 	mem_heap_t*		mtuple_heap = NULL;
@@ -1803,38 +1754,15 @@ row_merge_read_clustered_index(
 			row_fts_start_psort(psort_info);
 			fts_parallel_sort_event =
 				 psort_info[0].psort_common->sort_event;
+		} else if (dict_index_is_spatial(index[i])) {
+			ut_a(spatial_sort_idx[i]);
+			merge_buf[i] = row_merge_buf_create(
+				spatial_sort_idx[i]);
 		} else {
-			if (dict_index_is_spatial(index[i])) {
-				num_spatial++;
-			}
-
 			merge_buf[i] = row_merge_buf_create(index[i]);
 		}
 	}
 
-	if (num_spatial > 0) {
-		ulint	count = 0;
-
-		sp_heap = mem_heap_create(512);
-
-		sp_tuples = static_cast<index_tuple_info_t**>(
-			ut_malloc_nokey(num_spatial
-					* sizeof(*sp_tuples)));
-
-		for (ulint i = 0; i < n_index; i++) {
-			if (dict_index_is_spatial(index[i])) {
-				sp_tuples[count]
-					= UT_NEW_NOKEY(
-						index_tuple_info_t(
-							sp_heap,
-							index[i]));
-				count++;
-			}
-		}
-
-		ut_ad(count == num_spatial);
-	}
-
 	mtr_start(&mtr);
 
 	/* Find the clustered index and create a persistent cursor
@@ -1959,22 +1887,6 @@ row_merge_read_clustered_index(
 				}
 			}
 
-			/* Insert the cached spatial index rows. */
-			bool	mtr_committed = false;
-
-			err = row_merge_spatial_rows(
-				trx->id, sp_tuples, num_spatial,
-				row_heap, sp_heap, &pcur,
-				&mtr, &mtr_committed);
-
-			if (err != DB_SUCCESS) {
-				goto func_exit;
-			}
-
-			if (mtr_committed) {
-				goto scan_next;
-			}
-
 			if (my_atomic_load32_explicit(&clust_index->lock.waiters,
 						      MY_MEMORY_ORDER_RELAXED)) {
 				/* There are waiters on the clustered
@@ -1999,7 +1911,6 @@ row_merge_read_clustered_index(
 
 				/* Give the waiters a chance to proceed. */
 				os_thread_yield();
-scan_next:
 				mtr_start(&mtr);
 				/* Restore position on the record, or its
 				predecessor if the record was purged
@@ -2316,7 +2227,6 @@ row_merge_read_clustered_index(
 		/* Build all entries for all the indexes to be created
 		in a single scan of the clustered index. */
 
-		ulint	s_idx_cnt = 0;
 		bool	skip_sort = skip_pk_sort
 			&& dict_index_is_clust(merge_buf[0]->index);
 
@@ -2325,33 +2235,26 @@ row_merge_read_clustered_index(
 			merge_file_t*		file	= &files[i];
 			ulint			rows_added = 0;
 
-			if (dict_index_is_spatial(buf->index)) {
-				if (!row) {
-					continue;
-				}
-
-				ut_ad(sp_tuples[s_idx_cnt]->get_index()
-				      == buf->index);
+			ut_ad(!row
+			      || !dict_index_is_clust(buf->index)
+			      || trx_id_check(row->fields[new_trx_id_col].data,
+					      trx->id));
 
+			if (row && dict_index_is_spatial(index[i])) {
 				/* If the geometry field is invalid, report
 				error. */
-				if (!row_geo_field_is_valid(row, buf->index)) {
+				if (!row_geo_field_is_valid(row, index[i])) {
 					err = DB_CANT_CREATE_GEOMETRY_OBJECT;
 					break;
 				}
 
-				sp_tuples[s_idx_cnt]->add(row, ext);
-				s_idx_cnt++;
-
-				continue;
-			}
-
-			ut_ad(!row
-			      || !dict_index_is_clust(buf->index)
-			      || trx_id_check(row->fields[new_trx_id_col].data,
-					      trx->id));
-
-			if (UNIV_LIKELY
+				if (row_merge_buf_add_spatial(
+					    buf, index[i], row, ext,
+					    row_heap)) {
+					file->n_rec++;
+					continue;
+				}
+			} else if (UNIV_LIKELY
 			    (row && (rows_added = row_merge_buf_add(
 					buf, fts_index, old_table, new_table,
 					psort_info, row, ext, &doc_id,
@@ -2450,25 +2353,6 @@ row_merge_read_clustered_index(
 					/* Temporary File is not used.
 					so insert sorted block to the index */
 					if (row != NULL) {
-						bool	mtr_committed = false;
-
-						/* We have to do insert the
-						cached spatial index rows, since
-						after the mtr_commit, the cluster
-						index page could be updated, then
-						the data in cached rows become
-						invalid. */
-						err = row_merge_spatial_rows(
-							trx->id, sp_tuples,
-							num_spatial,
-							row_heap, sp_heap,
-							&pcur, &mtr,
-							&mtr_committed);
-
-						if (err != DB_SUCCESS) {
-							goto func_exit;
-						}
-
 						/* We are not at the end of
 						the scan yet. We must
 						mtr_commit() in order to be
@@ -2478,14 +2362,12 @@ row_merge_read_clustered_index(
 						current row will be invalid, and
 						we must reread it on the next
 						loop iteration. */
-						if (!mtr_committed) {
-							btr_pcur_move_to_prev_on_page(
-								&pcur);
-							btr_pcur_store_position(
-								&pcur, &mtr);
+						btr_pcur_move_to_prev_on_page(
+							&pcur);
+						btr_pcur_store_position(
+							&pcur, &mtr);
 
-							mtr_commit(&mtr);
-						}
+						mtr_commit(&mtr);
 					}
 
 					mem_heap_empty(mtuple_heap);
@@ -2508,7 +2390,7 @@ row_merge_read_clustered_index(
 					}
 
 					err = row_merge_insert_index_tuples(
-						index[i], old_table,
+						index[i], index[i], old_table,
 						OS_FILE_CLOSED, NULL, buf, clust_btr_bulk,
 						table_total_rows,
 						curr_progress,
@@ -2522,9 +2404,8 @@ row_merge_read_clustered_index(
 						UT_DELETE(clust_btr_bulk);
 						clust_btr_bulk = NULL;
 					} else {
-						/* Release latches for possible
-						log_free_chck in spatial index
-						build. */
+						/* Release the latches while
+						the scan continues. */
 						clust_btr_bulk->release();
 					}
 
@@ -2619,7 +2500,7 @@ row_merge_read_clustered_index(
 					btr_bulk.init();
 
 					err = row_merge_insert_index_tuples(
-						index[i], old_table,
+						index[i], buf->index, old_table,
 						OS_FILE_CLOSED, NULL, buf, &btr_bulk,
 						table_total_rows,
 						curr_progress,
@@ -2676,7 +2557,14 @@ row_merge_read_clustered_index(
 				that the buffer has been written out
 				and emptied. */
 
-				if (UNIV_UNLIKELY
+				if (dict_index_is_spatial(index[i])) {
+					/* An empty buffer should have enough
+					room for at least one record. */
+					ut_a(row_merge_buf_add_spatial(
+						     buf, index[i], row, ext,
+						     row_heap));
+					rows_added = 1;
+				} else if (UNIV_UNLIKELY
 				    (!(rows_added = row_merge_buf_add(
 						buf, fts_index, old_table,
 						new_table, psort_info, row, ext,
@@ -2720,8 +2608,6 @@ row_merge_read_clustered_index(
 	}
 
 func_exit:
-	/* row_merge_spatial_rows may have committed
-	the mtr	before an error occurs. */
 	if (mtr.is_active()) {
 		mtr_commit(&mtr);
 	}
@@ -2827,17 +2713,6 @@ row_merge_read_clustered_index(
 
 	btr_pcur_close(&pcur);
 
-	if (sp_tuples != NULL) {
-		for (ulint i = 0; i < num_spatial; i++) {
-			UT_DELETE(sp_tuples[i]);
-		}
-		ut_free(sp_tuples);
-
-		if (sp_heap) {
-			mem_heap_free(sp_heap);
-		}
-	}
-
 	/* Update the next Doc ID we used. Table should be locked, so
 	no concurrent DML */
 	if (max_doc_id && err == DB_SUCCESS) {
@@ -2867,123 +2742,567 @@ row_merge_read_clustered_index(
 	DBUG_RETURN(err);
 }
 
-/** Write a record via buffer 2 and read the next record to buffer N.
-@param N number of the buffer (0 or 1)
-@param INDEX record descriptor
-@param AT_END statement to execute at end of input */
-#define ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)			\
-	do {								\
-		b2 = row_merge_write_rec(&block[2 * srv_sort_buf_size], \
-					 &buf[2], b2,			\
-					 of->fd, &of->offset,		\
-					 mrec##N, offsets##N,		\
-			crypt_block ? &crypt_block[2 * srv_sort_buf_size] : NULL , \
-					space);				\
-		if (UNIV_UNLIKELY(!b2 || ++of->n_rec > file->n_rec)) {	\
-			goto corrupt;					\
-		}							\
-		b##N = row_merge_read_rec(&block[N * srv_sort_buf_size],\
-					  &buf[N], b##N, INDEX,		\
-					  file->fd, foffs##N,		\
-					  &mrec##N, offsets##N,		\
-			crypt_block ? &crypt_block[N * srv_sort_buf_size] : NULL, \
-					  space);			\
-									\
-		if (UNIV_UNLIKELY(!b##N)) {				\
-			if (mrec##N) {					\
-				goto corrupt;				\
-			}						\
-			AT_END;						\
-		}							\
-	} while (0)
+/** State of a thread of row_merge_pread_clustered_index() */
+struct row_merge_pread_thread_t {
+	/** sort buffers, one for each index */
+	row_merge_buf_t**	buf;
+	/** number of index entries written, one for each index */
+	ib_uint64_t*		n_rec;
+	/** memory heap for building rows */
+	mem_heap_t*		row_heap;
+	/** file buffer, or NULL if nothing was written yet */
+	row_merge_block_t*	block;
+	/** memory descriptor of block */
+	ut_new_pfx_t		block_pfx;
+	/** encryption buffer, or NULL */
+	row_merge_block_t*	crypt_block;
+	/** memory descriptor of crypt_block */
+	ut_new_pfx_t		crypt_pfx;
+	/** outcome of the thread */
+	dberr_t			err;
+	/** the index that err refers to */
+	ulint			err_index;
+	/** number of records read by the thread */
+	ulint			n_read;
+};
 
-#ifdef HAVE_PSI_STAGE_INTERFACE
-#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
-	do {								\
-		if (stage != NULL) {					\
-			stage->inc();					\
-		}							\
-		ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END);		\
-	} while (0)
-#else /* HAVE_PSI_STAGE_INTERFACE */
-#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
-	ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)
-#endif /* HAVE_PSI_STAGE_INTERFACE */
+/** State of row_merge_pread_clustered_index() that is shared between
+the threads */
+struct row_merge_pread_t {
+	/** transaction */
+	trx_t*				trx;
+	/** the table; old_table == new_table */
+	const dict_table_t*		table;
+	/** indexes to be created */
+	dict_index_t**			index;
+	/** number of indexes to be created */
+	ulint				n_index;
+	/** temporary files for the index entries */
+	merge_file_t*			files;
+	/** state of each thread */
+	row_merge_pread_thread_t*	threads;
+	/** number of records read by all threads, in steps of 1000 */
+	ulint				n_read;
+	/** estimated number of records in the table */
+	ib_uint64_t			n_rows;
+	/** percent of task weight out of total alter job */
+	double				pct_cost;
+};
 
-/** Merge two blocks of records on disk and write a bigger block.
-@param[in]	dup	descriptor of index being created
-@param[in]	file	file containing index entries
-@param[in,out]	block	3 buffers
-@param[in,out]	foffs0	offset of first source list in the file
-@param[in,out]	foffs1	offset of second source list in the file
-@param[in,out]	of	output file
-@param[in,out]	stage	performance schema accounting object, used by
-ALTER TABLE. If not NULL stage->inc() will be called for each record
-processed.
-@param[in,out]	crypt_block	encryption buffer
-@param[in]	space	tablespace ID for encryption
-@return DB_SUCCESS or error code */
-static MY_ATTRIBUTE((warn_unused_result))
+/** Sort a buffer of row_merge_pread_clustered_index() and append it
+to the temporary file of the index as a new run.
+@param[in,out]	scan	shared state of the scan
+@param[in,out]	thread	the scanning thread
+@param[in]	i	index whose buffer to write
+@return error code */
+static
 dberr_t
-row_merge_blocks(
-	const row_merge_dup_t*	dup,
-	const merge_file_t*	file,
-	row_merge_block_t*	block,
-	ulint*			foffs0,
-	ulint*			foffs1,
-	merge_file_t*		of,
-	ut_stage_alter_t*	stage MY_ATTRIBUTE((unused)),
-	row_merge_block_t*	crypt_block,
-	ulint			space)
+row_merge_pread_write(
+	row_merge_pread_t*		scan,
+	row_merge_pread_thread_t*	thread,
+	ulint				i)
 {
-	mem_heap_t*	heap;	/*!< memory heap for offsets0, offsets1 */
-
-	mrec_buf_t*	buf;	/*!< buffer for handling
-				split mrec in block[] */
-	const byte*	b0;	/*!< pointer to block[0] */
-	const byte*	b1;	/*!< pointer to block[srv_sort_buf_size] */
-	byte*		b2;	/*!< pointer to block[2 * srv_sort_buf_size] */
-	const mrec_t*	mrec0;	/*!< merge rec, points to block[0] or buf[0] */
-	const mrec_t*	mrec1;	/*!< merge rec, points to
-				block[srv_sort_buf_size] or buf[1] */
-	ulint*		offsets0;/* offsets of mrec0 */
-	ulint*		offsets1;/* offsets of mrec1 */
+	row_merge_buf_t*	buf = thread->buf[i];
+	merge_file_t*		file = &scan->files[i];
 
-	DBUG_ENTER("row_merge_blocks");
-	DBUG_LOG("ib_merge_sort",
-		 "fd=" << file->fd << ',' << *foffs0 << '+' << *foffs1
-		 << " to fd=" << of->fd << ',' << of->offset);
+	ut_ad(buf->n_tuples);
 
-	heap = row_merge_heap_create(dup->index, &buf, &offsets0, &offsets1);
+	if (dict_index_is_unique(buf->index)) {
+		/* Only count the duplicates here. The table->record[0]
+		is shared between the threads; the caller of
+		row_pread_scan() will report the duplicate. */
+		row_merge_dup_t	dup = {buf->index, NULL, NULL, 0};
 
-	/* Write a record and read the next record.  Split the output
-	file in two halves, which can be merged on the following pass. */
+		row_merge_buf_sort(buf, &dup);
 
-	if (!row_merge_read(file->fd, *foffs0, &block[0],
-			    crypt_block ? &crypt_block[0] : NULL,
-			    space) ||
-	    !row_merge_read(file->fd, *foffs1, &block[srv_sort_buf_size],
-			    crypt_block ? &crypt_block[srv_sort_buf_size] : NULL,
-			    space)) {
-corrupt:
-		mem_heap_free(heap);
-		DBUG_RETURN(DB_CORRUPTION);
+		if (dup.n_dup) {
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
 	}
 
-	b0 = &block[0];
-	b1 = &block[srv_sort_buf_size];
-	b2 = &block[2 * srv_sort_buf_size];
+	if (!thread->block) {
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
 
-	b0 = row_merge_read_rec(
-		&block[0], &buf[0], b0, dup->index,
-		file->fd, foffs0, &mrec0, offsets0,
-		crypt_block ? &crypt_block[0] : NULL,
-		space);
+		thread->block = alloc.allocate_large(
+			srv_sort_buf_size, &thread->block_pfx);
 
-	b1 = row_merge_read_rec(
-		&block[srv_sort_buf_size],
-		&buf[srv_sort_buf_size], b1, dup->index,
-		file->fd, foffs1, &mrec1, offsets1,
+		if (!thread->block) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		if (log_tmp_is_encrypted()) {
+			thread->crypt_block = alloc.allocate_large(
+				srv_sort_buf_size, &thread->crypt_pfx);
+
+			if (!thread->crypt_block) {
+				return(DB_OUT_OF_MEMORY);
+			}
+		}
+	}
+
+	row_merge_buf_write(buf, file, thread->block);
+
+	/* Each block is a sorted run of its own, so the threads
+	may append their blocks in any order. */
+	if (!row_merge_write(file->fd, my_atomic_addlint(&file->offset, 1),
+			     thread->block, thread->crypt_block,
+			     scan->table->space->id)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(thread->block, srv_sort_buf_size);
+
+	thread->n_rec[i] += buf->n_tuples;
+	thread->buf[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/** Buffer the secondary index entries of a clustered index record.
+@param[in]	rec	clustered index record
+@param[in]	offsets	rec_get_offsets(rec, clust_index)
+@param[in]	thread	index of the scanning thread
+@param[in,out]	arg	row_merge_pread_t
+@return	whether the scan should continue */
+static
+bool
+row_merge_pread_rec(
+	const rec_t*	rec,
+	const ulint*	offsets,
+	ulint		thread,
+	void*		arg)
+{
+	row_merge_pread_t*		scan
+		= static_cast<row_merge_pread_t*>(arg);
+	row_merge_pread_thread_t*	t = &scan->threads[thread];
+	const dict_table_t*		table = scan->table;
+	row_ext_t*			ext;
+	doc_id_t			doc_id = 0;
+	mem_heap_t*			v_heap = NULL;
+
+	if (t->row_heap) {
+		mem_heap_empty(t->row_heap);
+	} else {
+		t->row_heap = mem_heap_create(sizeof(mrec_buf_t));
+		t->buf = static_cast<row_merge_buf_t**>(
+			ut_malloc_nokey(scan->n_index * sizeof *t->buf));
+		t->n_rec = static_cast<ib_uint64_t*>(
+			ut_zalloc_nokey(scan->n_index * sizeof *t->n_rec));
+
+		for (ulint i = 0; i < scan->n_index; i++) {
+			t->buf[i] = row_merge_buf_create(scan->index[i]);
+		}
+	}
+
+	ut_ad(!rec_offs_any_null_extern(rec, offsets));
+
+	const dtuple_t*	row = row_build_w_add_vcol(
+		ROW_COPY_POINTERS, dict_table_get_first_index(table),
+		rec, offsets, table, NULL, NULL, NULL, &ext, t->row_heap);
+
+	for (ulint i = 0; i < scan->n_index; i++) {
+		if (!row_merge_buf_add(t->buf[i], NULL, table, table, NULL,
+				       row, ext, &doc_id, NULL, &t->err,
+				       &v_heap, NULL, scan->trx)) {
+			/* The buffer is full. Write it out and try
+			again with an empty buffer. */
+			t->err = row_merge_pread_write(scan, t, i);
+
+			if (t->err != DB_SUCCESS) {
+				t->err_index = i;
+				return(false);
+			}
+
+			if (UNIV_UNLIKELY(!row_merge_buf_add(
+					t->buf[i], NULL, table, table, NULL,
+					row, ext, &doc_id, NULL, &t->err,
+					&v_heap, NULL, scan->trx))) {
+				/* An empty buffer should have enough
+				room for at least one record. */
+				ut_error;
+			}
+		}
+
+		if (t->err != DB_SUCCESS) {
+			ut_ad(t->err == DB_TOO_BIG_RECORD);
+			t->err_index = i;
+			return(false);
+		}
+	}
+
+	ut_ad(!v_heap);
+
+	/* Increment innodb_onlineddl_pct_progress status variable */
+	if (++t->n_read % 1000 == 0) {
+		/* Update progress for each 1000 rows of each thread */
+		const ulint	n = my_atomic_addlint(&scan->n_read, 1000)
+			+ 1000;
+		const double	curr_progress = n >= scan->n_rows
+			? scan->pct_cost
+			: scan->pct_cost * n / scan->n_rows;
+		/* presenting 10.12% as 1012 integer */
+		onlineddl_pct_progress = (ulint) (curr_progress * 100);
+	}
+
+	return(true);
+}
+
+/** Determine if row_merge_pread_clustered_index() can be used.
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	index		indexes to be created
+@param[in]	n_index		number of indexes to create
+@param[in]	add_v		newly added virtual columns, or NULL
+@param[in]	drop_historical	whether to drop historical system rows
+@return whether the clustered index can be read by several threads */
+static
+bool
+row_merge_pread_possible(
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t**		index,
+	ulint			n_index,
+	const dict_add_v_col_t*	add_v,
+	bool			drop_historical)
+{
+	if (old_table != new_table || add_v || drop_historical
+	    || old_table->is_temporary()) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		/* Full-text and spatial indexes are built by
+		row_merge_read_clustered_index() itself, and
+		virtual column values can only be computed in
+		the thread that is executing the statement. */
+		if ((index[i]->type & (DICT_FTS | DICT_SPATIAL))
+		    || dict_index_has_virtual(index[i])) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Read the clustered index of a table with several threads, and create
+temporary files containing the entries of secondary indexes to be created.
+This is a variant of row_merge_read_clustered_index() for adding secondary
+indexes that do not contain virtual columns, without rebuilding the table.
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting erroneous
+				records
+@param[in]	old_table	table where rows are read from
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in,out]	files		temporary files
+@param[in]	key_numbers	MySQL key numbers to create
+@param[in]	n_index		number of indexes to create
+@param[in,out]	tmpfd		temporary file handle
+@param[in]	n_threads	number of threads to read with
+@param[in]	pct_cost	percent of task weight out of total alter job
+@return DB_SUCCESS or error */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_pread_clustered_index(
+	trx_t*			trx,
+	struct TABLE*		table,
+	const dict_table_t*	old_table,
+	bool			online,
+	dict_index_t**		index,
+	merge_file_t*		files,
+	const ulint*		key_numbers,
+	ulint			n_index,
+	pfs_os_file_t*		tmpfd,
+	ulint			n_threads,
+	double			pct_cost)
+{
+	row_merge_pread_t	scan;
+	dberr_t			err = DB_SUCCESS;
+	const char*		path = thd_innodb_tmpdir(trx->mysql_thd);
+
+	DBUG_ENTER("row_merge_pread_clustered_index");
+
+	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+	ut_ad(!online || trx->read_view.is_open());
+
+	trx->op_info = "reading clustered index";
+
+	for (ulint i = 0; i < n_index; i++) {
+		ut_ad(!dict_index_is_clust(index[i]));
+		ut_ad(!(index[i]->type & (DICT_FTS | DICT_SPATIAL)));
+		ut_ad(!dict_index_has_virtual(index[i]));
+
+		if (!row_merge_file_create_if_needed(
+			    &files[i], tmpfd, 0, path)) {
+			trx->error_key_num = i;
+			trx->op_info = "";
+			DBUG_RETURN(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	scan.trx = trx;
+	scan.table = old_table;
+	scan.index = index;
+	scan.n_index = n_index;
+	scan.files = files;
+	scan.threads = static_cast<row_merge_pread_thread_t*>(
+		ut_zalloc_nokey(n_threads * sizeof *scan.threads));
+	scan.n_read = 0;
+	scan.n_rows = std::max<ib_uint64_t>(
+		dict_table_get_n_rows(old_table), 1);
+	scan.pct_cost = pct_cost;
+
+	for (ulint t = 0; t < n_threads; t++) {
+		scan.threads[t].err = DB_SUCCESS;
+	}
+
+	/* Without a read view (!online), the latest version of each
+	record is read. The table lock acquired by
+	ha_innobase::prepare_inplace_alter_table() guarantees that it
+	was committed. Delete-marked records are skipped either way. */
+	err = row_pread_scan(trx, !trx->read_view.is_open(),
+			     dict_table_get_first_index(old_table),
+			     n_threads, row_merge_pread_rec, &scan);
+
+	ulint	t = 0;
+	ulint	i = 0;
+
+	if (err == DB_END_OF_INDEX) {
+		while (scan.threads[t].err == DB_SUCCESS) {
+			t++;
+			ut_a(t < n_threads);
+		}
+
+		err = scan.threads[t].err;
+		i = scan.threads[t].err_index;
+	} else if (err == DB_SUCCESS) {
+		/* Write out the partially filled buffers. */
+		for (t = 0; t < n_threads; t++) {
+			if (!scan.threads[t].buf) {
+				continue;
+			}
+
+			for (i = 0; i < n_index; i++) {
+				if (!scan.threads[t].buf[i]->n_tuples) {
+					continue;
+				}
+
+				err = row_merge_pread_write(
+					&scan, &scan.threads[t], i);
+
+				if (err != DB_SUCCESS) {
+					goto write_failed;
+				}
+			}
+		}
+	}
+
+write_failed:
+	switch (err) {
+	case DB_SUCCESS:
+		break;
+	case DB_DUPLICATE_KEY:
+		{
+			/* Sort the buffer again, this time reporting
+			the duplicate in table->record[0]. */
+			row_merge_dup_t	dup = {index[i], table, NULL, 0};
+			row_merge_buf_sort(scan.threads[t].buf[i], &dup);
+			ut_ad(dup.n_dup);
+			trx->error_key_num = key_numbers[i];
+		}
+		break;
+	case DB_TOO_BIG_RECORD:
+		break;
+	default:
+		trx->error_key_num = i;
+	}
+
+	for (t = 0; t < n_threads; t++) {
+		row_merge_pread_thread_t*	thread = &scan.threads[t];
+
+		if (!thread->buf) {
+			continue;
+		}
+
+		for (i = 0; i < n_index; i++) {
+			files[i].n_rec += thread->n_rec[i];
+			row_merge_buf_free(thread->buf[i]);
+		}
+
+		ut_free(thread->buf);
+		ut_free(thread->n_rec);
+		mem_heap_free(thread->row_heap);
+
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+		if (thread->block) {
+			alloc.deallocate_large(thread->block,
+					       &thread->block_pfx,
+					       srv_sort_buf_size);
+		}
+
+		if (thread->crypt_block) {
+			alloc.deallocate_large(thread->crypt_block,
+					       &thread->crypt_pfx,
+					       srv_sort_buf_size);
+		}
+	}
+
+	ut_free(scan.threads);
+
+	for (i = 0; i < n_index; i++) {
+		if (!files[i].offset) {
+			/* The index will be empty. */
+			row_merge_file_destroy(&files[i]);
+		}
+
+		if (online && err == DB_SUCCESS) {
+			/* Note the newest transaction that modified
+			this index when the scan was completed. We
+			prevent older readers from accessing this
+			index, to ensure read consistency. */
+			rw_lock_x_lock(dict_index_get_lock(index[i]));
+			ut_a(dict_index_get_online_status(index[i])
+			     == ONLINE_INDEX_CREATION);
+
+			trx_id_t	max_trx_id = row_log_get_max_trx(
+				index[i]);
+
+			if (max_trx_id > index[i]->trx_id) {
+				index[i]->trx_id = max_trx_id;
+			}
+
+			rw_lock_x_unlock(dict_index_get_lock(index[i]));
+		}
+	}
+
+	/* presenting 10.12% as 1012 integer */
+	onlineddl_pct_progress = (ulint) (pct_cost * 100);
+
+	trx->op_info = "";
+
+	DBUG_RETURN(err);
+}
+
+/** Write a record via buffer 2 and read the next record to buffer N.
+@param N number of the buffer (0 or 1)
+@param INDEX record descriptor
+@param AT_END statement to execute at end of input */
+#define ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)			\
+	do {								\
+		b2 = row_merge_write_rec(&block[2 * srv_sort_buf_size], \
+					 &buf[2], b2,			\
+					 of->fd, &of->offset,		\
+					 mrec##N, offsets##N,		\
+			crypt_block ? &crypt_block[2 * srv_sort_buf_size] : NULL , \
+					space);				\
+		if (UNIV_UNLIKELY(!b2 || ++of->n_rec > file->n_rec)) {	\
+			goto corrupt;					\
+		}							\
+		b##N = row_merge_read_rec(&block[N * srv_sort_buf_size],\
+					  &buf[N], b##N, INDEX,		\
+					  file->fd, foffs##N,		\
+					  &mrec##N, offsets##N,		\
+			crypt_block ? &crypt_block[N * srv_sort_buf_size] : NULL, \
+					  space);			\
+									\
+		if (UNIV_UNLIKELY(!b##N)) {				\
+			if (mrec##N) {					\
+				goto corrupt;				\
+			}						\
+			AT_END;						\
+		}							\
+	} while (0)
+
+#ifdef HAVE_PSI_STAGE_INTERFACE
+#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
+	do {								\
+		if (stage != NULL) {					\
+			stage->inc();					\
+		}							\
+		ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END);		\
+	} while (0)
+#else /* HAVE_PSI_STAGE_INTERFACE */
+#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
+	ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+
+/** Merge two blocks of records on disk and write a bigger block.
+@param[in]	dup	descriptor of index being created
+@param[in]	file	file containing index entries
+@param[in,out]	block	3 buffers
+@param[in,out]	foffs0	offset of first source list in the file
+@param[in,out]	foffs1	offset of second source list in the file
+@param[in,out]	of	output file
+@param[in,out]	stage	performance schema accounting object, used by
+ALTER TABLE. If not NULL stage->inc() will be called for each record
+processed.
+@param[in,out]	crypt_block	encryption buffer
+@param[in]	space	tablespace ID for encryption
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_blocks(
+	const row_merge_dup_t*	dup,
+	const merge_file_t*	file,
+	row_merge_block_t*	block,
+	ulint*			foffs0,
+	ulint*			foffs1,
+	merge_file_t*		of,
+	ut_stage_alter_t*	stage MY_ATTRIBUTE((unused)),
+	row_merge_block_t*	crypt_block,
+	ulint			space)
+{
+	mem_heap_t*	heap;	/*!< memory heap for offsets0, offsets1 */
+
+	mrec_buf_t*	buf;	/*!< buffer for handling
+				split mrec in block[] */
+	const byte*	b0;	/*!< pointer to block[0] */
+	const byte*	b1;	/*!< pointer to block[srv_sort_buf_size] */
+	byte*		b2;	/*!< pointer to block[2 * srv_sort_buf_size] */
+	const mrec_t*	mrec0;	/*!< merge rec, points to block[0] or buf[0] */
+	const mrec_t*	mrec1;	/*!< merge rec, points to
+				block[srv_sort_buf_size] or buf[1] */
+	ulint*		offsets0;/* offsets of mrec0 */
+	ulint*		offsets1;/* offsets of mrec1 */
+
+	DBUG_ENTER("row_merge_blocks");
+	DBUG_LOG("ib_merge_sort",
+		 "fd=" << file->fd << ',' << *foffs0 << '+' << *foffs1
+		 << " to fd=" << of->fd << ',' << of->offset);
+
+	heap = row_merge_heap_create(dup->index, &buf, &offsets0, &offsets1);
+
+	/* Write a record and read the next record.  Split the output
+	file in two halves, which can be merged on the following pass. */
+
+	if (!row_merge_read(file->fd, *foffs0, &block[0],
+			    crypt_block ? &crypt_block[0] : NULL,
+			    space) ||
+	    !row_merge_read(file->fd, *foffs1, &block[srv_sort_buf_size],
+			    crypt_block ? &crypt_block[srv_sort_buf_size] : NULL,
+			    space)) {
+corrupt:
+		mem_heap_free(heap);
+		DBUG_RETURN(DB_CORRUPTION);
+	}
+
+	b0 = &block[0];
+	b1 = &block[srv_sort_buf_size];
+	b2 = &block[2 * srv_sort_buf_size];
+
+	b0 = row_merge_read_rec(
+		&block[0], &buf[0], b0, dup->index,
+		file->fd, foffs0, &mrec0, offsets0,
+		crypt_block ? &crypt_block[0] : NULL,
+		space);
+
+	b1 = row_merge_read_rec(
+		&block[srv_sort_buf_size],
+		&buf[srv_sort_buf_size], b1, dup->index,
+		file->fd, foffs1, &mrec1, offsets1,
 		crypt_block ? &crypt_block[srv_sort_buf_size] : NULL,
 		space);
 
@@ -3279,6 +3598,8 @@ row_merge(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in,out]	progress	progress of row_merge_build_parallel(),
+or NULL if the progress is updated according to update_progress
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -3296,7 +3617,8 @@ row_merge_sort(
 	const double		pct_cost, /*!< in: current progress percent */
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space,	   /*!< in: space id */
-	ut_stage_alter_t* 	stage)
+	ut_stage_alter_t* 	stage,
+	row_merge_progress_t*	progress)
 {
 	const ulint	half	= file->offset / 2;
 	ulint		num_runs;
@@ -3343,8 +3665,9 @@ row_merge_sort(
 	sol10-64 in buildbot.
 	*/
 #ifndef UNIV_SOLARIS
-	/* Progress report only for "normal" indexes. */
-	if (!(dup->index->type & DICT_FTS)) {
+	/* Progress report only for "normal" indexes, and not from
+	threads other than the one executing the statement. */
+	if (update_progress && !(dup->index->type & DICT_FTS)) {
 		thd_progress_init(trx->mysql_thd, 1);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3361,7 +3684,7 @@ row_merge_sort(
 		show processlist progress field */
 		/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-		if (!(dup->index->type & DICT_FTS)) {
+		if (update_progress && !(dup->index->type & DICT_FTS)) {
 			thd_progress_report(trx->mysql_thd, file->offset - num_runs, file->offset);
 		}
 #endif /* UNIV_SOLARIS */
@@ -3370,7 +3693,14 @@ row_merge_sort(
 				  &num_runs, run_offset, stage,
 				  crypt_block, space);
 
-		if(update_progress) {
+		if (progress) {
+			merge_count++;
+			progress->report(
+				(merge_count >= total_merge_sort_count)
+				? pct_cost
+				: pct_cost * merge_count
+				/ total_merge_sort_count);
+		} else if(update_progress) {
 			merge_count++;
 			curr_progress = (merge_count >= total_merge_sort_count) ?
 				pct_cost :
@@ -3390,7 +3720,7 @@ row_merge_sort(
 
 	/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-	if (!(dup->index->type & DICT_FTS)) {
+	if (update_progress && !(dup->index->type & DICT_FTS)) {
 		thd_progress_end(trx->mysql_thd);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3466,16 +3796,16 @@ row_merge_copy_blobs(
 
 /** Convert a merge record to a typed data tuple. Note that externally
 stored fields are not copied to heap.
-@param[in,out]	index	index on the table
+@param[in]	index	index on the table
 @param[in]	mtuple	merge record
 @param[in]	heap	memory heap from which memory needed is allocated
 @return	index entry built. */
 static
 void
 row_merge_mtuple_to_dtuple(
-	dict_index_t*	index,
-	dtuple_t*	dtuple,
-	const mtuple_t* mtuple)
+	const dict_index_t*	index,
+	dtuple_t*		dtuple,
+	const mtuple_t*		mtuple)
 {
 	ut_ad(!dict_index_is_ibuf(index));
 
@@ -3485,6 +3815,8 @@ row_merge_mtuple_to_dtuple(
 
 /** Insert sorted data tuples to the index.
 @param[in]	index		index to be inserted
+@param[in]	sort_index	index of the sorted tuples: index, or
+the spatial sort index of index
 @param[in]	old_table	old table
 @param[in]	fd		file descriptor
 @param[in,out]	block		file buffer
@@ -3494,11 +3826,14 @@ or NULL if fd, block will be used instead
 @param[in,out]	stage		performance schema accounting object, used by
 ALTER TABLE. If not NULL stage->begin_phase_insert() will be called initially
 and then stage->inc() will be called for each record that is processed.
+@param[in,out]	progress	progress of row_merge_build_parallel(),
+or NULL to update innodb_onlineddl_pct_progress directly
 @return DB_SUCCESS or error number */
 static	MY_ATTRIBUTE((warn_unused_result))
 dberr_t
 row_merge_insert_index_tuples(
 	dict_index_t*		index,
+	const dict_index_t*	sort_index,
 	const dict_table_t*	old_table,
 	const pfs_os_file_t&	fd,
 	row_merge_block_t*	block,
@@ -3511,7 +3846,8 @@ row_merge_insert_index_tuples(
 					  */
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space,	   /*!< in: space id */
-	ut_stage_alter_t*	stage)
+	ut_stage_alter_t*	stage,
+	row_merge_progress_t*	progress)
 {
 	const byte*		b;
 	mem_heap_t*		heap;
@@ -3522,6 +3858,7 @@ row_merge_insert_index_tuples(
 	mrec_buf_t*		buf;
 	ulint			n_rows = 0;
 	dtuple_t*		dtuple;
+	dtuple_t*		sp_tuple = NULL;
 	ib_uint64_t		inserted_rows = 0;
 	double			curr_progress = 0;
 	dict_index_t*		old_index = NULL;
@@ -3534,7 +3871,8 @@ row_merge_insert_index_tuples(
 
 	ut_ad(!srv_read_only_mode);
 	ut_ad(!(index->type & DICT_FTS));
-	ut_ad(!dict_index_is_spatial(index));
+	ut_ad(!dict_index_is_spatial(sort_index));
+	ut_ad((sort_index == index) == !dict_index_is_spatial(index));
 
 	if (stage != NULL) {
 		stage->begin_phase_insert();
@@ -3544,12 +3882,22 @@ row_merge_insert_index_tuples(
 
 	{
 		ulint i	= 1 + REC_OFFS_HEADER_SIZE
-			+ dict_index_get_n_fields(index);
+			+ dict_index_get_n_fields(sort_index);
 		heap = mem_heap_create(sizeof *buf + i * sizeof *offsets);
 		offsets = static_cast<ulint*>(
 			mem_heap_alloc(heap, i * sizeof *offsets));
 		offsets[0] = i;
-		offsets[1] = dict_index_get_n_fields(index);
+		offsets[1] = dict_index_get_n_fields(sort_index);
+	}
+
+	if (sort_index != index) {
+		/* The spatial index entries are preceded by their
+		Hilbert value, which is not stored in the index. */
+		ut_ad(dict_index_get_n_fields(sort_index)
+		      == dict_index_get_n_fields(index) + 1);
+		sp_tuple = dtuple_create(heap, dict_index_get_n_fields(index));
+		dtuple_set_n_fields_cmp(
+			sp_tuple, dict_index_get_n_unique_in_tree(index));
 	}
 
 	if (row_buf != NULL) {
@@ -3561,9 +3909,9 @@ row_merge_insert_index_tuples(
 		buf = NULL;
 		b = NULL;
 		dtuple = dtuple_create(
-			heap, dict_index_get_n_fields(index));
+			heap, dict_index_get_n_fields(sort_index));
 		dtuple_set_n_fields_cmp(
-			dtuple, dict_index_get_n_unique_in_tree(index));
+			dtuple, dict_index_get_n_unique_in_tree(sort_index));
 	} else {
 		b = block;
 		dtuple = NULL;
@@ -3591,14 +3939,14 @@ row_merge_insert_index_tuples(
 			/* Convert merge tuple record from
 			row buffer to data tuple record */
 			row_merge_mtuple_to_dtuple(
-				index, dtuple, &row_buf->tuples[n_rows]);
+				sort_index, dtuple, &row_buf->tuples[n_rows]);
 
 			n_ext = dtuple_get_n_ext(dtuple);
 			n_rows++;
 			/* BLOB pointers must be copied from dtuple */
 			mrec = NULL;
 		} else {
-			b = row_merge_read_rec(block, buf, b, index,
+			b = row_merge_read_rec(block, buf, b, sort_index,
 					       fd, &foffs, &mrec, offsets,
 					       crypt_block,
 					       space);
@@ -3612,7 +3960,18 @@ row_merge_insert_index_tuples(
 			}
 
 			dtuple = row_rec_to_index_entry_low(
-				mrec, index, offsets, &n_ext, tuple_heap);
+				mrec, sort_index, offsets, &n_ext,
+				tuple_heap);
+		}
+
+		dtuple_t*	entry = dtuple;
+
+		if (sp_tuple != NULL) {
+			memcpy(sp_tuple->fields, dtuple->fields + 1,
+			       sp_tuple->n_fields * sizeof *sp_tuple->fields);
+			dict_index_copy_types(sp_tuple, index,
+					      sp_tuple->n_fields);
+			entry = sp_tuple;
 		}
 
 		old_index	= dict_table_get_first_index(old_table);
@@ -3651,7 +4010,7 @@ row_merge_insert_index_tuples(
 			row_merge_copy_blobs(
 				mrec, offsets,
 				dict_table_page_size(old_table),
-				dtuple, tuple_heap);
+				entry, tuple_heap);
 		}
 
 #ifdef UNIV_DEBUG
@@ -3661,10 +4020,15 @@ row_merge_insert_index_tuples(
 		};
 #endif /* UNIV_DEBUG */
 
-		ut_ad(dtuple_validate(dtuple));
+		ut_ad(dtuple_validate(entry));
 		ut_ad(!sync_check_iterate(sync_allowed_latches(latches,
 							       latches + 2)));
-		error = btr_bulk->insert(dtuple);
+		error = btr_bulk->insert(entry);
+
+		DBUG_EXECUTE_IF("row_merge_ins_spatial_fail",
+				if (sp_tuple != NULL) {
+					error = DB_FAIL;
+				});
 
 		if (error != DB_SUCCESS) {
 			goto err_exit;
@@ -3681,8 +4045,12 @@ row_merge_insert_index_tuples(
 				pct_cost :
 				((pct_cost * inserted_rows) / table_total_rows);
 
-			/* presenting 10.12% as 1012 integer */;
-			onlineddl_pct_progress = (ulint) ((pct_progress + curr_progress) * 100);
+			if (progress) {
+				progress->report(curr_progress);
+			} else {
+				/* presenting 10.12% as 1012 integer */;
+				onlineddl_pct_progress = (ulint) ((pct_progress + curr_progress) * 100);
+			}
 		}
 	}
 
@@ -4445,80 +4813,411 @@ row_merge_create_index(
 					table, ifield->col_no);
 			}
 		} else {
-			name = dict_table_get_col_name(table, ifield->col_no);
+			name = dict_table_get_col_name(table, ifield->col_no);
+		}
+
+		dict_mem_index_add_field(index, name, ifield->prefix_len);
+	}
+
+	DBUG_RETURN(index);
+}
+
+/*********************************************************************//**
+Check if a transaction can use an index. */
+bool
+row_merge_is_index_usable(
+/*======================*/
+	const trx_t*		trx,	/*!< in: transaction */
+	const dict_index_t*	index)	/*!< in: index to check */
+{
+	if (!index->is_primary()
+	    && dict_index_is_online_ddl(index)) {
+		/* Indexes that are being created are not useable. */
+		return(false);
+	}
+
+	return(!index->is_corrupted()
+	       && (index->table->is_temporary()
+		   || index->trx_id == 0
+		   || !trx->read_view.is_open()
+		   || trx->read_view.changes_visible(
+			   index->trx_id,
+			   index->table->name)));
+}
+
+/*********************************************************************//**
+Drop a table. The caller must have ensured that the background stats
+thread is not processing the table. This can be done by calling
+dict_stats_wait_bg_to_stop_using_table() after locking the dictionary and
+before calling this function.
+@return DB_SUCCESS or error code */
+dberr_t
+row_merge_drop_table(
+/*=================*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_table_t*	table)		/*!< in: table to drop */
+{
+	ut_ad(!srv_read_only_mode);
+
+	/* There must be no open transactions on the table. */
+	ut_a(table->get_ref_count() == 0);
+
+	return(row_drop_table_for_mysql(table->name.m_name,
+			trx, false, false, false));
+}
+
+/** Write an MLOG_INDEX_LOAD record to indicate in the redo-log
+that redo-logging of individual index pages was disabled, and
+the flushing of such pages to the data files was completed.
+@param[in]	index	an index tree on which redo logging was disabled */
+static
+void
+row_merge_write_redo(
+	const dict_index_t*	index)
+{
+	mtr_t	mtr;
+	byte*	log_ptr;
+
+	ut_ad(!index->table->is_temporary());
+	mtr.start();
+	log_ptr = mlog_open(&mtr, 11 + 8);
+	log_ptr = mlog_write_initial_log_record_low(
+		MLOG_INDEX_LOAD,
+		index->table->space->id, index->page, log_ptr, &mtr);
+	mach_write_to_8(log_ptr, index->id);
+	mlog_close(&mtr, log_ptr + 8);
+	mtr.commit();
+}
+
+/** State of row_merge_build_parallel() that is shared between the threads */
+struct row_merge_build_t {
+	/** transaction */
+	trx_t*			trx;
+	/** table where rows were read from */
+	const dict_table_t*	old_table;
+	/** indexes being created */
+	dict_index_t**		indexes;
+	/** temporary files of indexes[] */
+	merge_file_t*		files;
+	/** outcome of building indexes[], if built[] is set */
+	dberr_t*		errors;
+	/** whether indexes[] was built */
+	bool*			built;
+	/** positions in indexes[] of the unique indexes, which
+	only the calling thread may build, because duplicates are
+	reported in the shared table->record[0] */
+	ulint*			unique;
+	/** number of elements in unique[] */
+	ulint			n_unique;
+	/** positions in indexes[] of the non-unique indexes, which
+	any thread may build */
+	ulint*			shared;
+	/** number of elements in shared[] */
+	ulint			n_shared;
+	/** number of elements of shared[] that have been assigned */
+	ulint			n_assigned;
+	/** nonzero if building any index failed */
+	ulint			abort;
+	/** MySQL table object, for reporting duplicates */
+	struct TABLE*		table;
+	/** location for creating temporary files */
+	const char*		path;
+	/** flush observer for the index pages */
+	FlushObserver*		observer;
+	/** total progress percent until now */
+	double			pct_progress;
+	/** progress percent of building each index of indexes[] */
+	const double*		pct_cost;
+	/** progress of all threads, in hundredths of a percent */
+	ulint			progress_done;
+	/** progress reporting; offset and reported are copied
+	to each index */
+	row_merge_progress_t	progress;
+};
+
+/** Add the progress of this index to the total, and update
+innodb_onlineddl_pct_progress and the client progress report.
+@param[in]	curr	progress percent of the current phase */
+void
+row_merge_progress_t::report(double curr)
+{
+	const ulint	now = ulint((offset + curr) * 100);
+
+	if (now <= reported) {
+		return;
+	}
+
+	const ulint	delta = now - reported;
+	const ulint	n = my_atomic_addlint(done, delta) + delta;
+
+	reported = now;
+
+	/* presenting 10.12% as 1012 integer */
+	onlineddl_pct_progress = base + n;
+
+#ifndef UNIV_SOLARIS
+	/* Only the thread that executes the statement may access the THD. */
+	if (os_thread_eq(os_thread_get_curr_id(), thread)) {
+		thd_progress_report(trx->mysql_thd, n, total);
+	}
+#endif /* UNIV_SOLARIS */
+}
+
+/** Sort the entries of an index and insert them into the index tree.
+@param[in,out]	build	shared state
+@param[in]	i	position of the index in build->indexes[]
+@param[in,out]	block	3 buffers
+@param[in,out]	crypt_block	encryption buffer, or NULL
+@param[in,out]	tmpfd	temporary file handle
+@return error code */
+static
+dberr_t
+row_merge_build_one(
+	row_merge_build_t*	build,
+	ulint			i,
+	row_merge_block_t*	block,
+	row_merge_block_t*	crypt_block,
+	pfs_os_file_t*		tmpfd)
+{
+	dict_index_t*	index = build->indexes[i];
+	merge_file_t*	file = &build->files[i];
+	const ulint	space = index->table->space->id;
+	row_merge_dup_t	dup = {
+		index, dict_index_is_unique(index) ? build->table : NULL,
+		NULL, 0};
+
+	if (!row_merge_tmpfile_if_needed(tmpfd, build->path)) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	row_merge_progress_t	progress = build->progress;
+	const double		sort_cost = build->pct_cost[i]
+		* PCT_COST_MERGESORT_INDEX;
+
+	dberr_t	err = row_merge_sort(
+		build->trx, &dup, file, block, tmpfd, false,
+		build->pct_progress, sort_cost, crypt_block, space, NULL,
+		&progress);
+
+	if (err == DB_SUCCESS) {
+		BtrBulk	btr_bulk(index, build->trx->id, build->observer);
+		btr_bulk.init();
+
+		progress.offset = sort_cost;
+
+		err = row_merge_insert_index_tuples(
+			index, index, build->old_table, file->fd, block, NULL,
+			&btr_bulk, file->n_rec, build->pct_progress,
+			build->pct_cost[i] - sort_cost,
+			crypt_block, space, NULL, &progress);
+
+		err = btr_bulk.finish(err);
+	}
+
+	/* The estimates of the phases may fall short. */
+	progress.offset = 0;
+	progress.report(build->pct_cost[i]);
+
+	return(err);
+}
+
+/** Build indexes of row_merge_build_parallel() until all of them have
+been assigned to some thread, or building some index failed.
+@param[in,out]	arg	row_merge_build_t
+@param[in]	id	index of the thread; the calling thread (0)
+			builds the unique indexes first */
+static
+void
+row_merge_build_worker(void* arg, ulint id)
+{
+	row_merge_build_t*	build = static_cast<row_merge_build_t*>(arg);
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	row_merge_block_t*	block;
+	row_merge_block_t*	crypt_block = NULL;
+	pfs_os_file_t		tmpfd = OS_FILE_CLOSED;
+	const size_t		block_size = 3 * srv_sort_buf_size;
+	ulint			n_unique = id ? 0 : build->n_unique;
+	dberr_t			err = DB_SUCCESS;
+
+	block = alloc.allocate_large(block_size, &block_pfx);
+
+	if (!block) {
+		err = DB_OUT_OF_MEMORY;
+	} else if (log_tmp_is_encrypted()) {
+		crypt_block = alloc.allocate_large(block_size, &crypt_pfx);
+
+		if (!crypt_block) {
+			err = DB_OUT_OF_MEMORY;
+		}
+	}
+
+	if (!id) {
+		/* The other threads may be building indexes now. */
+		DEBUG_SYNC_C("row_merge_build_worker");
+	}
+
+	for (ulint j = 0; err == DB_SUCCESS; j++) {
+		ulint	i;
+
+		if (my_atomic_loadlint(&build->abort)) {
+			break;
+		} else if (j < n_unique) {
+			i = build->unique[j];
+		} else {
+			ulint	k = my_atomic_addlint(&build->n_assigned, 1);
+
+			if (k >= build->n_shared) {
+				break;
+			}
+
+			i = build->shared[k];
 		}
 
-		dict_mem_index_add_field(index, name, ifield->prefix_len);
+		err = row_merge_build_one(build, i, block, crypt_block,
+					  &tmpfd);
+		build->errors[i] = err;
+		build->built[i] = true;
 	}
 
-	DBUG_RETURN(index);
-}
+	if (err != DB_SUCCESS) {
+		my_atomic_addlint(&build->abort, 1);
+	}
 
-/*********************************************************************//**
-Check if a transaction can use an index. */
-bool
-row_merge_is_index_usable(
-/*======================*/
-	const trx_t*		trx,	/*!< in: transaction */
-	const dict_index_t*	index)	/*!< in: index to check */
-{
-	if (!index->is_primary()
-	    && dict_index_is_online_ddl(index)) {
-		/* Indexes that are being created are not useable. */
-		return(false);
+	row_merge_file_destroy_low(tmpfd);
+
+	if (block) {
+		alloc.deallocate_large(block, &block_pfx, block_size);
 	}
 
-	return(!index->is_corrupted()
-	       && (index->table->is_temporary()
-		   || index->trx_id == 0
-		   || !trx->read_view.is_open()
-		   || trx->read_view.changes_visible(
-			   index->trx_id,
-			   index->table->name)));
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx, block_size);
+	}
 }
 
-/*********************************************************************//**
-Drop a table. The caller must have ensured that the background stats
-thread is not processing the table. This can be done by calling
-dict_stats_wait_bg_to_stop_using_table() after locking the dictionary and
-before calling this function.
-@return DB_SUCCESS or error code */
-dberr_t
-row_merge_drop_table(
-/*=================*/
-	trx_t*		trx,		/*!< in: transaction */
-	dict_table_t*	table)		/*!< in: table to drop */
+/** Report the progress of the threads of row_merge_build_parallel().
+@param[in,out]	arg	row_merge_build_t */
+static
+void
+row_merge_build_report(void* arg)
 {
-	ut_ad(!srv_read_only_mode);
-
-	/* There must be no open transactions on the table. */
-	ut_a(table->get_ref_count() == 0);
+#ifndef UNIV_SOLARIS
+	row_merge_build_t*	build = static_cast<row_merge_build_t*>(arg);
 
-	return(row_drop_table_for_mysql(table->name.m_name,
-			trx, false, false, false));
+	thd_progress_report(build->trx->mysql_thd,
+			    my_atomic_loadlint(&build->progress_done),
+			    build->progress.total);
+#endif /* UNIV_SOLARIS */
 }
 
-/** Write an MLOG_INDEX_LOAD record to indicate in the redo-log
-that redo-logging of individual index pages was disabled, and
-the flushing of such pages to the data files was completed.
-@param[in]	index	an index tree on which redo logging was disabled */
+/** Sort the entries and bulk load several indexes at a time. The indexes
+that were built are flagged in built[], and their outcome is stored in
+errors[]. Indexes that were not built because building some index failed
+are left for the caller.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows were read from
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[in,out]	files		temporary files of indexes[]
+@param[in,out]	table		MySQL table, for reporting duplicates
+@param[in,out]	observer	flush observer for the index pages
+@param[in]	n_threads	maximum number of threads, including the
+				calling thread
+@param[in]	pct_progress	total progress percent until now
+@param[in]	pct_cost	progress percent of building each index
+@param[out]	built		built[i] is set if indexes[i] was built
+@param[out]	errors		outcome of building indexes[i]
+@return whether any index was built */
 static
-void
-row_merge_write_redo(
-	const dict_index_t*	index)
+bool
+row_merge_build_parallel(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	merge_file_t*		files,
+	struct TABLE*		table,
+	FlushObserver*		observer,
+	ulint			n_threads,
+	double			pct_progress,
+	const double*		pct_cost,
+	bool*			built,
+	dberr_t*		errors)
 {
-	mtr_t	mtr;
-	byte*	log_ptr;
+	row_merge_build_t	build;
+	ulint*			pos = static_cast<ulint*>(
+		ut_malloc_nokey(2 * n_indexes * sizeof *pos));
+
+	build.trx = trx;
+	build.old_table = old_table;
+	build.indexes = indexes;
+	build.files = files;
+	build.errors = errors;
+	build.built = built;
+	build.unique = pos;
+	build.n_unique = 0;
+	build.shared = pos + n_indexes;
+	build.n_shared = 0;
+	build.n_assigned = 0;
+	build.abort = 0;
+	build.table = table;
+	build.path = thd_innodb_tmpdir(trx->mysql_thd);
+	build.observer = observer;
+	build.pct_progress = pct_progress;
+	build.pct_cost = pct_cost;
+	build.progress_done = 0;
+	build.progress.trx = trx;
+	build.progress.thread = os_thread_get_curr_id();
+	build.progress.base = ulint(pct_progress * 100);
+	build.progress.total = 0;
+	build.progress.done = &build.progress_done;
+	build.progress.offset = 0;
+	build.progress.reported = 0;
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		built[i] = false;
+
+		if (files[i].fd == OS_FILE_CLOSED
+		    || (indexes[i]->type & (DICT_FTS | DICT_SPATIAL))) {
+			continue;
+		}
 
-	ut_ad(!index->table->is_temporary());
-	mtr.start();
-	log_ptr = mlog_open(&mtr, 11 + 8);
-	log_ptr = mlog_write_initial_log_record_low(
-		MLOG_INDEX_LOAD,
-		index->table->space->id, index->page, log_ptr, &mtr);
-	mach_write_to_8(log_ptr, index->id);
-	mlog_close(&mtr, log_ptr + 8);
-	mtr.commit();
+		if (dict_index_is_unique(indexes[i])) {
+			build.unique[build.n_unique++] = i;
+		} else {
+			build.shared[build.n_shared++] = i;
+		}
+
+		build.progress.total += ulint(pct_cost[i] * 100);
+	}
+
+	if (!build.n_shared || build.n_unique + build.n_shared < 2) {
+		/* There is nothing to do in parallel. */
+		ut_free(pos);
+		return(false);
+	}
+
+	/* Unless the calling thread is busy with unique indexes,
+	it builds one of the shared[] ones. */
+	const ulint	n = std::min(n_threads - 1,
+				     build.n_shared - !build.n_unique);
+
+#ifndef UNIV_SOLARIS
+	/* The progress of all threads is reported as one stage. */
+	thd_progress_init(trx->mysql_thd, 1);
+#endif /* UNIV_SOLARIS */
+
+	/* Keep reporting the progress of the other threads. */
+	os_thread_run(row_merge_build_worker, &build, n,
+		      row_merge_thread_key, row_merge_build_report);
+
+#ifndef UNIV_SOLARIS
+	thd_progress_end(trx->mysql_thd);
+#endif /* UNIV_SOLARIS */
+
+	ut_free(pos);
+	return(true);
 }
 
 /** Build indexes on a table by reading a clustered index, creating a temporary
@@ -4581,10 +5280,15 @@ row_merge_build_indexes(
 	dberr_t			error;
 	pfs_os_file_t		tmpfd = OS_FILE_CLOSED;
 	dict_index_t*		fts_sort_idx = NULL;
+	dict_index_t**		spatial_sort_idx = NULL;
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
+	const ulint		n_threads = thd_ddl_threads(trx->mysql_thd);
+	bool*			built = NULL;
+	dberr_t*		built_err = NULL;
+	double*			built_cost = NULL;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4630,31 +5334,18 @@ row_merge_build_indexes(
 
 	trx_start_if_not_started_xa(trx, true);
 
-	/* Check if we need a flush observer to flush dirty pages.
+	/* We need a flush observer to flush dirty pages.
 	Since we disable redo logging in bulk load, so we should flush
 	dirty pages before online log apply, because online log apply enables
 	redo logging(we can do further optimization here).
 	1. online add index: flush dirty pages right before row_log_apply().
 	2. table rebuild: flush dirty pages before row_log_table_apply().
 
-	we use bulk load to create all types of indexes except spatial index,
-	for which redo logging is enabled. If we create only spatial indexes,
-	we don't need to flush dirty pages at all. */
-	bool	need_flush_observer = (old_table != new_table);
-
-	for (i = 0; i < n_indexes; i++) {
-		if (!dict_index_is_spatial(indexes[i])) {
-			need_flush_observer = true;
-		}
-	}
-
-	FlushObserver*	flush_observer = NULL;
-	if (need_flush_observer) {
-		flush_observer = UT_NEW_NOKEY(
-			FlushObserver(new_table->space, trx, stage));
+	We use bulk load to create all types of indexes. */
+	FlushObserver*	flush_observer = UT_NEW_NOKEY(
+		FlushObserver(new_table->space, trx, stage));
 
-		trx_set_flush_observer(trx, flush_observer);
-	}
+	trx_set_flush_observer(trx, flush_observer);
 
 	merge_files = static_cast<merge_file_t*>(
 		ut_malloc_nokey(n_indexes * sizeof *merge_files));
@@ -4668,6 +5359,19 @@ row_merge_build_indexes(
 		merge_files[i].offset = 0;
 	}
 
+	/* Spatial indexes are sorted along a Hilbert curve, so that
+	they can be loaded bottom-up like the other indexes. */
+	spatial_sort_idx = static_cast<dict_index_t**>(
+		ut_zalloc_nokey(n_indexes * sizeof *spatial_sort_idx));
+
+	for (i = 0; i < n_indexes; i++) {
+		if (dict_index_is_spatial(indexes[i])) {
+			spatial_sort_idx[i]
+				= row_merge_create_spatial_sort_index(
+					indexes[i]);
+		}
+	}
+
 	total_static_cost = COST_BUILD_INDEX_STATIC * n_indexes + COST_READ_CLUSTERED_INDEX;
 	total_dynamic_cost = COST_BUILD_INDEX_DYNAMIC * n_indexes;
 	for (i = 0; i < n_indexes; i++) {
@@ -4727,12 +5431,22 @@ row_merge_build_indexes(
 
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, defaults, add_v, col_map, add_autoinc,
-		sequence, block, skip_pk_sort, &tmpfd, stage,
-		pct_cost, crypt_block, eval_table, drop_historical);
+	if (row_merge_pread_possible(old_table, new_table, indexes,
+				     n_indexes, add_v, drop_historical)
+	    && n_threads > 1) {
+		error = row_merge_pread_clustered_index(
+			trx, table, old_table, online, indexes,
+			merge_files, key_numbers, n_indexes, &tmpfd,
+			n_threads, pct_cost);
+	} else {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, spatial_sort_idx, psort_info,
+			merge_files, key_numbers,
+			n_indexes, defaults, add_v, col_map, add_autoinc,
+			sequence, block, skip_pk_sort, &tmpfd, stage,
+			pct_cost, crypt_block, eval_table, drop_historical);
+	}
 
 	stage->end_phase_read_pk();
 
@@ -4757,13 +5471,41 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
-	for (i = 0; i < n_indexes; i++) {
-		dict_index_t*	sort_idx = indexes[i];
+	if (n_threads > 1) {
+		built = static_cast<bool*>(
+			ut_malloc_nokey(n_indexes * sizeof *built));
+		built_err = static_cast<dberr_t*>(
+			ut_malloc_nokey(n_indexes * sizeof *built_err));
+		built_cost = static_cast<double*>(
+			ut_malloc_nokey(n_indexes * sizeof *built_cost));
 
-		if (dict_index_is_spatial(sort_idx)) {
-			continue;
+		for (i = 0; i < n_indexes; i++) {
+			built_cost[i] = merge_files[i].fd == OS_FILE_CLOSED
+				? 0
+				: (COST_BUILD_INDEX_STATIC +
+				   (total_dynamic_cost * merge_files[i].offset /
+				    total_index_blocks)) /
+				(total_static_cost + total_dynamic_cost)
+				* (PCT_COST_MERGESORT_INDEX
+				   + PCT_COST_INSERT_INDEX) * 100;
 		}
 
+		if (!row_merge_build_parallel(
+			    trx, old_table, indexes, n_indexes, merge_files,
+			    table, flush_observer, n_threads, pct_progress,
+			    built_cost, built, built_err)) {
+			ut_free(built);
+			ut_free(built_err);
+			ut_free(built_cost);
+			built = NULL;
+			built_err = NULL;
+			built_cost = NULL;
+		}
+	}
+
+	for (i = 0; i < n_indexes; i++) {
+		dict_index_t*	sort_idx = indexes[i];
+
 		if (indexes[i]->type & DICT_FTS) {
 			os_event_t	fts_parallel_merge_event;
 
@@ -4836,10 +5578,16 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (built && built[i]) {
+			/* The index was built by row_merge_build_parallel(). */
+			error = built_err[i];
+			pct_progress += built_cost[i];
 		} else if (merge_files[i].fd != OS_FILE_CLOSED) {
 			char	buf[NAME_LEN + 1];
+			dict_index_t*	merge_idx = spatial_sort_idx[i]
+				? spatial_sort_idx[i] : sort_idx;
 			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
+				merge_idx, table, col_map, 0};
 
 			pct_cost = (COST_BUILD_INDEX_STATIC +
 				(total_dynamic_cost * merge_files[i].offset /
@@ -4909,7 +5657,7 @@ row_merge_build_indexes(
 				}
 
 				error = row_merge_insert_index_tuples(
-					sort_idx, old_table,
+					sort_idx, merge_idx, old_table,
 					merge_files[i].fd, block, NULL,
 					&btr_bulk,
 					merge_files[i].n_rec, pct_progress, pct_cost,
@@ -4943,7 +5691,6 @@ row_merge_build_indexes(
 			ut_ad(sort_idx->online_status
 			      == ONLINE_INDEX_COMPLETE);
 		} else {
-			ut_ad(need_flush_observer);
 			if (global_system_variables.log_warnings > 2) {
 				sql_print_information(
 					"InnoDB: Online DDL : Applying"
@@ -4991,7 +5738,20 @@ row_merge_build_indexes(
 		dict_mem_index_free(fts_sort_idx);
 	}
 
+	if (spatial_sort_idx) {
+		for (i = 0; i < n_indexes; i++) {
+			if (spatial_sort_idx[i]) {
+				dict_mem_index_free(spatial_sort_idx[i]);
+			}
+		}
+
+		ut_free(spatial_sort_idx);
+	}
+
 	ut_free(merge_files);
+	ut_free(built);
+	ut_free(built_err);
+	ut_free(built_cost);
 
 	alloc.deallocate_large(block, &block_pfx, block_size);
 
@@ -5041,8 +5801,6 @@ row_merge_build_indexes(
 	DBUG_EXECUTE_IF("ib_index_crash_after_bulk_load", DBUG_SUICIDE(););
 
 	if (flush_observer != NULL) {
-		ut_ad(need_flush_observer);
-
 		DBUG_EXECUTE_IF("ib_index_build_fail_before_flush",
 			error = DB_INTERRUPTED;
 		);
@@ -5071,3 +5829,373 @@ row_merge_build_indexes(
 
 	DBUG_RETURN(error);
 }
+
+/** Buffered inserts into an empty table */
+struct row_merge_bulk_t {
+	/** transaction that wrote the TRX_UNDO_EMPTY record */
+	trx_id_t		trx_id;
+	/** trx_t::undo_no after the TRX_UNDO_EMPTY record was written */
+	undo_no_t		undo_no;
+	/** the table */
+	dict_table_t*		table;
+	/** MySQL table object, for reporting duplicates */
+	struct TABLE*		mysql_table;
+	/** number of indexes */
+	ulint			n_index;
+	/** the indexes */
+	dict_index_t**		indexes;
+	/** sort buffers of the indexes, or of the spatial sort indexes
+	of spatial indexes */
+	row_merge_buf_t**	bufs;
+	/** temporary files of the indexes */
+	merge_file_t*		files;
+	/** temporary file for merge sort */
+	pfs_os_file_t		tmpfd;
+	/** 3 buffers for writing and merging the files, or NULL */
+	row_merge_block_t*	block;
+	/** allocation of block */
+	ut_new_pfx_t		block_pfx;
+	/** encryption buffer, or NULL */
+	row_merge_block_t*	crypt_block;
+	/** allocation of crypt_block */
+	ut_new_pfx_t		crypt_pfx;
+	/** largest buffered AUTO_INCREMENT value, or 0 */
+	ib_uint64_t		autoinc;
+};
+
+/** Create a buffer for inserting into an empty table.
+@param[in]	trx		transaction that wrote TRX_UNDO_EMPTY
+@param[in,out]	table		empty table
+@param[in,out]	mysql_table	MySQL table, for reporting duplicates
+@return the buffer */
+row_merge_bulk_t*
+row_merge_bulk_create(
+	const trx_t*	trx,
+	dict_table_t*	table,
+	struct TABLE*	mysql_table)
+{
+	row_merge_bulk_t*	bulk = static_cast<row_merge_bulk_t*>(
+		ut_zalloc_nokey(sizeof *bulk));
+
+	bulk->trx_id = trx->id;
+	bulk->undo_no = trx->undo_no;
+	bulk->table = table;
+	bulk->mysql_table = mysql_table;
+	bulk->n_index = UT_LIST_GET_LEN(table->indexes);
+	bulk->indexes = static_cast<dict_index_t**>(
+		ut_zalloc_nokey(bulk->n_index * sizeof *bulk->indexes));
+	bulk->bufs = static_cast<row_merge_buf_t**>(
+		ut_zalloc_nokey(bulk->n_index * sizeof *bulk->bufs));
+	bulk->files = static_cast<merge_file_t*>(
+		ut_zalloc_nokey(bulk->n_index * sizeof *bulk->files));
+	bulk->tmpfd = OS_FILE_CLOSED;
+
+	ulint	i = 0;
+
+	for (dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+		bulk->indexes[i] = index;
+		bulk->bufs[i] = row_merge_buf_create(
+			dict_index_is_spatial(index)
+			? row_merge_create_spatial_sort_index(index)
+			: index);
+		bulk->files[i].fd = OS_FILE_CLOSED;
+	}
+
+	ut_ad(i == bulk->n_index);
+	return(bulk);
+}
+
+/** Get the size of an index entry in row_merge_block_t.
+@param[in]	index	index of the table
+@param[in]	entry	index entry
+@return size of the entry, including the encoded extra_size */
+static
+ulint
+row_merge_bulk_size(const dict_index_t* index, const dtuple_t* entry)
+{
+	ulint	extra_size;
+	ulint	size = rec_get_converted_size_temp(
+		index, entry->fields, entry->n_fields, &extra_size);
+
+	/* See row_merge_buf_encode(). The size includes extra_size. */
+	size += 1 + ((extra_size + 1) >= 0x80);
+
+	if (dict_index_is_spatial(index)) {
+		/* The entry will be preceded by its Hilbert value. */
+		size += ROW_MERGE_HILBERT_LEN;
+	}
+
+	return(size);
+}
+
+/** Determine if an index entry is small enough to be buffered.
+Larger records would not fit in the merge file buffers.
+@param[in]	index	index of the table
+@param[in]	entry	index entry
+@return whether row_merge_bulk_add() can buffer the entry */
+bool
+row_merge_bulk_fits(const dict_index_t* index, const dtuple_t* entry)
+{
+	ut_ad(entry->n_fields == dict_index_get_n_fields(index));
+
+	/* row_merge_read_rec() copies a record that spans two blocks
+	to a mrec_buf_t. */
+	return(row_merge_bulk_size(index, entry)
+	       < ut_min(srv_sort_buf_size, ulint(sizeof(mrec_buf_t))));
+}
+
+/** Sort the buffered entries of an index and append them to the
+temporary file of the index.
+@param[in,out]	bulk	bulk insert buffer
+@param[in]	i	position of the index in the table
+@param[in,out]	trx	transaction
+@return error code */
+static
+dberr_t
+row_merge_bulk_write(row_merge_bulk_t* bulk, ulint i, trx_t* trx)
+{
+	row_merge_buf_t*	buf = bulk->bufs[i];
+	merge_file_t*		file = &bulk->files[i];
+
+	if (bulk->block == NULL) {
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+		bulk->block = alloc.allocate_large(3 * srv_sort_buf_size,
+						   &bulk->block_pfx);
+		if (bulk->block == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		if (log_tmp_is_encrypted()) {
+			bulk->crypt_block = alloc.allocate_large(
+				3 * srv_sort_buf_size, &bulk->crypt_pfx);
+			if (bulk->crypt_block == NULL) {
+				return(DB_OUT_OF_MEMORY);
+			}
+		}
+	}
+
+	if (!row_merge_file_create_if_needed(
+		    file, &bulk->tmpfd, 0,
+		    thd_innodb_tmpdir(trx->mysql_thd))) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	if (dict_index_is_unique(buf->index)) {
+		row_merge_dup_t	dup = {
+			buf->index, bulk->mysql_table, NULL, 0};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			trx->error_info = buf->index;
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, bulk->block);
+
+	if (!row_merge_write(file->fd, file->offset++, bulk->block,
+			     bulk->crypt_block, bulk->table->space->id)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&bulk->block[0], srv_sort_buf_size);
+
+	file->n_rec += buf->n_tuples;
+	bulk->bufs[i] = row_merge_buf_empty(buf);
+	return(DB_SUCCESS);
+}
+
+/** Buffer an index entry. When the buffer of the index fills up,
+it is sorted and written to a temporary file.
+@param[in,out]	bulk	bulk insert buffer
+@param[in]	i	position of the index in the table
+@param[in]	entry	index entry, which must fit
+			(see row_merge_bulk_fits())
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_add(
+	row_merge_bulk_t*	bulk,
+	ulint			i,
+	const dtuple_t*		entry,
+	trx_t*			trx)
+{
+	ut_ad(i < bulk->n_index);
+	ut_ad(row_merge_bulk_fits(bulk->indexes[i], entry));
+
+	row_merge_buf_t*	buf = bulk->bufs[i];
+	const ulint		size = row_merge_bulk_size(
+		bulk->indexes[i], entry);
+
+	/* Reserve a byte for the end marker of row_merge_block_t. */
+	if (buf->n_tuples >= buf->max_tuples
+	    || buf->total_size + size >= srv_sort_buf_size) {
+		dberr_t	err = row_merge_bulk_write(bulk, i, trx);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		buf = bulk->bufs[i];
+	}
+
+	if (unsigned ai = i ? 0 : bulk->table->persistent_autoinc) {
+		const dfield_t*	dfield = dtuple_get_nth_field(entry, ai - 1);
+
+		if (!dfield_is_null(dfield)) {
+			ib_uint64_t	autoinc = row_parse_int(
+				static_cast<const byte*>(dfield->data),
+				dfield->len, dfield->type.mtype,
+				dfield->type.prtype & DATA_UNSIGNED);
+
+			if (autoinc > bulk->autoinc) {
+				bulk->autoinc = autoinc;
+			}
+		}
+	}
+
+	const ulint	n_fields = dict_index_get_n_fields(buf->index);
+	dfield_t*	field;
+
+	if (buf->index == bulk->indexes[i]) {
+		field = static_cast<dfield_t*>(
+			mem_heap_dup(buf->heap, entry->fields,
+				     n_fields * sizeof *entry->fields));
+	} else {
+		field = row_merge_spatial_sort_fields(
+			buf->index, entry, buf->heap);
+	}
+
+	buf->tuples[buf->n_tuples++].fields = field;
+	buf->total_size += size;
+
+	for (ulint n = n_fields; n--; ) {
+		dfield_dup(field++, buf->heap);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Sort the buffered index entries and load them into the indexes.
+Nothing is loaded if the TRX_UNDO_EMPTY record was rolled back.
+@param[in,out]	bulk	bulk insert buffer
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_apply(row_merge_bulk_t* bulk, trx_t* trx)
+{
+	if (trx->id != bulk->trx_id || trx->undo_no < bulk->undo_no) {
+		/* The statement or the whole transaction was rolled
+		back (for example, after a deadlock), and the table
+		was emptied again. */
+		return(DB_SUCCESS);
+	}
+
+	const ulint	space = bulk->table->space->id;
+	dberr_t		err = DB_SUCCESS;
+
+	for (ulint i = 0; err == DB_SUCCESS && i < bulk->n_index; i++) {
+		row_merge_buf_t*	buf = bulk->bufs[i];
+		merge_file_t*		file = &bulk->files[i];
+		dict_index_t*		index = bulk->indexes[i];
+		row_merge_dup_t		dup = {
+			buf->index, bulk->mysql_table, NULL, 0};
+		/* Write redo log for all pages, so that the index
+		does not need to be flushed before the commit. */
+		BtrBulk			btr_bulk(index, trx->id, NULL);
+
+		btr_bulk.init();
+
+		if (file->fd == OS_FILE_CLOSED) {
+			/* All entries fit in the sort buffer. */
+			row_merge_buf_sort(
+				buf, dict_index_is_unique(index)
+				? &dup : NULL);
+
+			err = dup.n_dup
+				? DB_DUPLICATE_KEY
+				: row_merge_insert_index_tuples(
+					index, buf->index, bulk->table,
+					OS_FILE_CLOSED,
+					NULL, buf, &btr_bulk, 0, 0, 0,
+					NULL, space);
+		} else {
+			if (buf->n_tuples) {
+				err = row_merge_bulk_write(bulk, i, trx);
+			}
+
+			if (err == DB_SUCCESS) {
+				if (!dict_index_is_unique(index)) {
+					dup.table = NULL;
+				}
+
+				err = row_merge_sort(
+					trx, &dup, file, bulk->block,
+					&bulk->tmpfd, false, 0, 0,
+					bulk->crypt_block, space);
+			}
+
+			if (err == DB_SUCCESS) {
+				err = row_merge_insert_index_tuples(
+					index, bulk->bufs[i]->index,
+					bulk->table, file->fd,
+					bulk->block, NULL, &btr_bulk,
+					file->n_rec, 0, 0,
+					bulk->crypt_block, space);
+			}
+		}
+
+		err = btr_bulk.finish(err);
+
+		if (err == DB_DUPLICATE_KEY) {
+			trx->error_info = index;
+		} else if (err == DB_SUCCESS && bulk->autoinc
+			   && dict_index_is_clust(index)) {
+			btr_write_autoinc(index, bulk->autoinc);
+		}
+	}
+
+	return(err);
+}
+
+/** Free a bulk insert buffer.
+@param[in,out]	bulk	bulk insert buffer */
+void
+row_merge_bulk_free(row_merge_bulk_t* bulk)
+{
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	for (ulint i = 0; i < bulk->n_index; i++) {
+		dict_index_t*	sort_index = bulk->bufs[i]->index;
+
+		row_merge_buf_free(bulk->bufs[i]);
+		row_merge_file_destroy(&bulk->files[i]);
+
+		if (sort_index != bulk->indexes[i]) {
+			dict_mem_index_free(sort_index);
+		}
+	}
+
+	row_merge_file_destroy_low(bulk->tmpfd);
+
+	if (bulk->block != NULL) {
+		alloc.deallocate_large(bulk->block, &bulk->block_pfx,
+				       3 * srv_sort_buf_size);
+	}
+
+	if (bulk->crypt_block != NULL) {
+		alloc.deallocate_large(bulk->crypt_block, &bulk->crypt_pfx,
+				       3 * srv_sort_buf_size);
+	}
+
+	ut_free(bulk->files);
+	ut_free(bulk->bufs);
+	ut_free(bulk->indexes);
+	ut_free(bulk);
+}
@@ -1165,7 +1165,7 @@ row_lock_table_autoinc_for_mysql(
 
 	/* If we already hold an AUTOINC lock on the table then do nothing.
 	Note: We peek at the value of the current owner without acquiring
-	the lock mutex. */
+	lock_sys.latch. */
 	if (trx == table->autoinc_trx) {
 
 		return(DB_SUCCESS);
@@ -1343,6 +1343,168 @@ set_tuple_col_8(dtuple_t* tuple, int col, uint64_t data, byte* buf) {
 	mach_write_to_8(dfield->data, data);
 }
 
+/** Determine if an insert can be buffered with row_merge_bulk_add().
+@param[in]	table	table
+@param[in]	trx	transaction
+@return whether the table is eligible and empty */
+static
+bool
+row_insert_bulk_possible(const dict_table_t* table, const trx_t* trx)
+{
+	/* The table will be locked exclusively until the transaction
+	commits. Like when loading the output of mysqldump, the user must
+	indicate that this is acceptable by SET unique_checks=0,
+	foreign_key_checks=0. Duplicates will still be detected when
+	the buffered rows are sorted. */
+	if (trx->check_unique_secondary || trx->check_foreigns
+	    || trx->duplicates) {
+		return(false);
+	}
+
+	if (table->is_temporary() || table->no_rollback()
+	    || is_system_tablespace(table->space->id)
+	    || table->fts || table->versioned() || table->is_instant()
+	    || table->skip_alter_undo) {
+		return(false);
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL; index = dict_table_get_next_index(index)) {
+		if (index->is_corrupted()
+		    || dict_index_is_online_ddl(index)
+		    || index->page == FIL_NULL) {
+			return(false);
+		}
+	}
+
+	mtr_t	mtr;
+	mtr.start();
+
+	const buf_block_t*	root = btr_root_block_get(
+		dict_table_get_first_index(table), RW_S_LATCH, &mtr);
+	const bool		empty = root
+		&& page_is_leaf(root->frame) && page_is_empty(root->frame);
+
+	mtr.commit();
+	return(empty);
+}
+
+/** Start buffering the inserts of a statement into an empty table.
+The table will be locked exclusively, and a TRX_UNDO_EMPTY record will
+be written, so that rolling back the statement empties the table.
+@param[in,out]	prebuilt	table handle, with prebuilt->ins_node
+@return error code */
+static
+dberr_t
+row_insert_bulk_start(row_prebuilt_t* prebuilt)
+{
+	trx_t*		trx	= prebuilt->trx;
+	dict_table_t*	table	= prebuilt->table;
+	ins_node_t*	node	= prebuilt->ins_node;
+	que_thr_t*	thr;
+	dberr_t		err;
+	ibool		was_lock_wait;
+
+	ut_ad(node->bulk == NULL);
+
+	if (!row_insert_bulk_possible(table, trx)) {
+		return(DB_SUCCESS);
+	}
+
+	thr = que_fork_get_first_thr(prebuilt->ins_graph);
+
+	que_thr_move_to_run_state_for_mysql(thr, trx);
+
+run_again:
+	thr->run_node = node;
+	thr->prev_node = node;
+
+	err = lock_table(0, table, LOCK_X, thr);
+
+	trx->error_state = err;
+
+	if (err != DB_SUCCESS) {
+		que_thr_stop_for_mysql(thr);
+
+		was_lock_wait = row_mysql_handle_errors(&err, trx, thr, NULL);
+
+		if (was_lock_wait) {
+			goto run_again;
+		}
+
+		return(err);
+	}
+
+	/* Some other transaction may have inserted rows while
+	we were waiting for the lock. */
+	if (row_insert_bulk_possible(table, trx)) {
+		roll_ptr_t	roll_ptr;
+
+		err = trx_undo_report_row_operation(
+			thr, dict_table_get_first_index(table), NULL, NULL,
+			0, NULL, NULL, &roll_ptr);
+
+		if (err == DB_SUCCESS) {
+			node->bulk = row_merge_bulk_create(
+				trx, table, prebuilt->m_mysql_table);
+		}
+	}
+
+	que_thr_stop_for_mysql_no_error(thr, trx);
+
+	return(err);
+}
+
+/** Verify the foreign key checks that were deferred while inserting
+the rows of a multi-row insert statement (see row_insert_for_mysql()).
+@param[in,out]	prebuilt	table handle, with ins_node->fk_batch
+@return error code or DB_SUCCESS */
+dberr_t
+row_insert_fk_batch_check(row_prebuilt_t* prebuilt)
+{
+	trx_t*		trx	= prebuilt->trx;
+	ins_node_t*	node	= prebuilt->ins_node;
+	que_thr_t*	thr;
+	dberr_t		err;
+	ibool		was_lock_wait;
+
+	ut_ad(node->fk_batch != NULL);
+
+	trx->op_info = "checking foreign keys";
+
+	thr = que_fork_get_first_thr(prebuilt->ins_graph);
+
+	que_thr_move_to_run_state_for_mysql(thr, trx);
+
+run_again:
+	thr->run_node = node;
+	thr->prev_node = node;
+
+	err = row_ins_fk_batch_check(node->fk_batch, thr);
+
+	trx->error_state = err;
+
+	if (err != DB_SUCCESS) {
+		que_thr_stop_for_mysql(thr);
+
+		thr->lock_state = QUE_THR_LOCK_ROW;
+
+		was_lock_wait = row_mysql_handle_errors(&err, trx, thr, NULL);
+
+		thr->lock_state = QUE_THR_LOCK_NOLOCK;
+
+		if (was_lock_wait) {
+			goto run_again;
+		}
+	} else {
+		que_thr_stop_for_mysql_no_error(thr, trx);
+	}
+
+	trx->op_info = "";
+
+	return(err);
+}
+
 /** Does an insert for MySQL.
 @param[in]	mysql_rec	row in the MySQL format
 @param[in,out]	prebuilt	prebuilt struct in MySQL handle
@@ -1406,6 +1568,31 @@ row_insert_for_mysql(
 	row_get_prebuilt_insert_row(prebuilt);
 	node = prebuilt->ins_node;
 
+	if (prebuilt->bulk_insert) {
+		/* Only the first row of a statement may start
+		buffering the inserts. */
+		prebuilt->bulk_insert = false;
+
+		if (!prebuilt->ignore_dup_key && ins_mode == ROW_INS_NORMAL) {
+			err = row_insert_bulk_start(prebuilt);
+
+			if (err != DB_SUCCESS) {
+				trx->op_info = "";
+				return(err);
+			}
+
+			/* Unless the rows are being loaded into an empty
+			table, defer the foreign key checks until the end
+			of the statement or until the memory limit of
+			row_ins_fk_batch_full() is reached. */
+			if (node->bulk == NULL) {
+				ut_ad(node->fk_batch == NULL);
+				node->fk_batch = row_ins_fk_batch_create(
+					table, trx);
+			}
+		}
+	}
+
 	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec,
 					  &blob_heap);
 
@@ -1476,6 +1663,13 @@ row_insert_for_mysql(
 		node->duplicate = NULL;
 		trx->op_info = "";
 
+		if (node->fk_batch != NULL) {
+			/* The statement will be rolled back, because
+			deferring is not possible with INSERT IGNORE. */
+			row_ins_fk_batch_free(node->fk_batch);
+			node->fk_batch = NULL;
+		}
+
 		if (blob_heap != NULL) {
 			mem_heap_free(blob_heap);
 		}
@@ -1570,6 +1764,10 @@ row_insert_for_mysql(
 	dict_stats_update_if_needed(table);
 	trx->op_info = "";
 
+	if (node->fk_batch != NULL && row_ins_fk_batch_full(node->fk_batch)) {
+		err = row_insert_fk_batch_check(prebuilt);
+	}
+
 	if (blob_heap != NULL) {
 		mem_heap_free(blob_heap);
 	}
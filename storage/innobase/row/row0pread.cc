@@ -0,0 +1,442 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel consistent read of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "os0thread.h"
+#include "rem0cmp.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	row_pread_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Number of key ranges to create per thread, so that the threads that
+happen to get small ranges can pick up more work */
+#define ROW_PREAD_RANGES_PER_THREAD	8
+
+/** Number of records to scan between checks for interruption; this is
+also the maximum number of records scanned in one mini-transaction */
+#define ROW_PREAD_CHECK_INTERVAL	1000
+
+/** Number of threads created by row_pread_scan() that are running or
+about to be started */
+static ulint	row_pread_n_threads;
+
+/** State of a row_pread_scan() that is shared between the threads */
+struct row_pread_t {
+	/** transaction whose read view is used */
+	trx_t*			trx;
+	/** whether to read the latest version of each record instead
+	of using the read view */
+	bool			latest;
+	/** the clustered index */
+	dict_index_t*		index;
+	/** callback for each visible record */
+	row_pread_func_t	func;
+	/** argument for func */
+	void*			arg;
+	/** start keys of the ranges; ranges[0] is NULL, meaning the
+	start of the index. Range i ends at ranges[i + 1], or at the end
+	of the index if i + 1 == n_ranges. */
+	const dtuple_t**	ranges;
+	/** number of ranges */
+	ulint			n_ranges;
+	/** number of ranges that have been assigned to threads */
+	ulint			n_assigned;
+	/** nonzero if the scan should be stopped */
+	ulint			abort;
+	/** outcome of each thread */
+	dberr_t*		errors;
+};
+
+/** Partition a clustered index into key ranges, based on the node pointers
+in the highest B-tree level that is expected to contain enough of them.
+@param[in]	index	clustered index
+@param[in]	n	desired number of ranges
+@param[in,out]	heap	memory heap for the range start keys
+@param[out]	ranges	start keys of the ranges (ranges[0] == NULL)
+@return	number of ranges */
+static
+ulint
+row_pread_split(
+	dict_index_t*		index,
+	ulint			n,
+	mem_heap_t*		heap,
+	const dtuple_t***	ranges)
+{
+	typedef std::vector<const dtuple_t*, ut_allocator<const dtuple_t*> >
+		dtuple_vector_t;
+
+	dtuple_vector_t	keys;
+	mtr_t		mtr;
+	mem_heap_t*	offsets_heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	rec_offs_init(offsets_);
+
+	keys.push_back(NULL);
+
+	mtr.start();
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	const page_size_t	page_size(dict_table_page_size(index->table));
+	buf_block_t*		block = btr_root_block_get(
+		index, RW_S_LATCH, &mtr);
+
+	if (!block) {
+		goto func_exit;
+	}
+
+	{
+		ulint	level = btr_page_get_level(block->frame);
+		ulint	n_recs = page_get_n_recs(block->frame);
+
+		/* Descend along the leftmost node pointers until the
+		level is expected to contain enough node pointers. */
+		while (level > 1 && n_recs < n) {
+			const rec_t*	rec = page_rec_get_next_const(
+				page_get_infimum_rec(block->frame));
+
+			offsets = rec_get_offsets(rec, index, offsets, false,
+						  ULINT_UNDEFINED,
+						  &offsets_heap);
+
+			block = btr_block_get(
+				page_id_t(index->table->space->id,
+					  btr_node_ptr_get_child_page_no(
+						  rec, offsets)),
+				page_size, RW_S_LATCH, index, &mtr);
+
+			ut_ad(btr_page_get_level(block->frame) == level - 1);
+			level--;
+			n_recs *= page_get_n_recs(block->frame);
+		}
+
+		if (!level) {
+			goto func_exit;
+		}
+
+		const ulint	n_fields
+			= dict_index_get_n_unique_in_tree_nonleaf(index);
+		const ulint	comp = page_is_comp(block->frame);
+
+		/* Every node pointer on this level, except the leftmost
+		one, is the start key of a range. */
+		for (;;) {
+			for (const rec_t* rec = page_rec_get_next_const(
+				     page_get_infimum_rec(block->frame));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+
+				if (rec_get_info_bits(rec, comp)
+				    & REC_INFO_MIN_REC_FLAG) {
+					continue;
+				}
+
+				keys.push_back(dict_index_build_data_tuple(
+						       rec, index, false,
+						       n_fields, heap));
+			}
+
+			ulint	next = btr_page_get_next(block->frame, &mtr);
+
+			if (next == FIL_NULL) {
+				break;
+			}
+
+			block = btr_block_get(
+				page_id_t(index->table->space->id, next),
+				page_size, RW_S_LATCH, index, &mtr);
+		}
+	}
+
+func_exit:
+	mtr.commit();
+
+	if (offsets_heap) {
+		mem_heap_free(offsets_heap);
+	}
+
+	*ranges = static_cast<const dtuple_t**>(
+		mem_heap_alloc(heap, keys.size() * sizeof **ranges));
+	std::copy(keys.begin(), keys.end(), *ranges);
+
+	return(keys.size());
+}
+
+/** Scan a key range of the clustered index.
+@param[in,out]	scan	shared state of the scan
+@param[in]	thread	index of the scanning thread
+@param[in]	start	start key of the range, or NULL for the start
+			of the index
+@param[in]	end	end key of the range (not included), or NULL for
+			the end of the index
+@return	error code */
+static
+dberr_t
+row_pread_range(
+	row_pread_t*	scan,
+	ulint		thread,
+	const dtuple_t*	start,
+	const dtuple_t*	end)
+{
+	dict_index_t*	index = scan->index;
+	trx_t*		trx = scan->trx;
+	const ulint	comp = dict_table_is_comp(index->table);
+	/* Read the latest version of each record also if a high
+	innodb_force_recovery forbids access to the undo logs, which
+	may be corrupted. */
+	const bool	latest = scan->latest
+		|| srv_force_recovery >= SRV_FORCE_NO_UNDO_LOG_SCAN;
+	mem_heap_t*	heap = NULL;
+	mem_heap_t*	vers_heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	ulint		cnt = ROW_PREAD_CHECK_INTERVAL;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	dberr_t		err;
+	rec_offs_init(offsets_);
+
+	mtr.start();
+
+	if (start) {
+		err = btr_pcur_open(index, start, PAGE_CUR_GE,
+				    BTR_SEARCH_LEAF, &pcur, &mtr);
+	} else {
+		err = btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	}
+
+	if (err != DB_SUCCESS) {
+		goto func_exit;
+	}
+
+	do {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		if (!page_rec_is_user_rec(rec)
+		    || rec_is_default_row(rec, index)) {
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets, true,
+					  ULINT_UNDEFINED, &heap);
+
+		/* PAGE_CUR_GE may position the cursor on the previous
+		page of the start key. */
+		if (start && cmp_dtuple_rec(start, rec, offsets) > 0) {
+			continue;
+		}
+
+		if (end && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+			break;
+		}
+
+		if (!latest && !lock_clust_rec_cons_read_sees(
+			    rec, index, offsets, &trx->read_view)) {
+			rec_t*	old_vers;
+
+			if (vers_heap) {
+				mem_heap_empty(vers_heap);
+			} else {
+				vers_heap = mem_heap_create(srv_page_size);
+			}
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, &trx->read_view,
+				&heap, vers_heap, &old_vers, NULL);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			rec = old_vers;
+		}
+
+		if (rec && !rec_get_deleted_flag(rec, comp)
+		    && !scan->func(rec, offsets, thread, scan->arg)) {
+			err = DB_END_OF_INDEX;
+			break;
+		}
+
+		if (--cnt) {
+			continue;
+		}
+
+		cnt = ROW_PREAD_CHECK_INTERVAL;
+
+		if (my_atomic_loadlint(&scan->abort)) {
+			break;
+		}
+
+		if (trx_is_interrupted(trx)) {
+			err = DB_INTERRUPTED;
+			break;
+		}
+
+		/* Do not let the mini-transaction memo grow without bound. */
+		btr_pcur_store_position(&pcur, &mtr);
+		mtr.commit();
+		mtr.start();
+		btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur, &mtr);
+	} while (btr_pcur_move_to_next(&pcur, &mtr));
+
+	btr_pcur_close(&pcur);
+func_exit:
+	mtr.commit();
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	if (vers_heap) {
+		mem_heap_free(vers_heap);
+	}
+
+	return(err);
+}
+
+/** Scan the ranges that have not been assigned to any thread yet,
+until all of them have been scanned or the scan is aborted.
+@param[in,out]	arg	row_pread_t
+@param[in]	id	index of the scanning thread */
+static
+void
+row_pread_ranges(void* arg, ulint id)
+{
+	row_pread_t*	scan = static_cast<row_pread_t*>(arg);
+	dberr_t&	err = scan->errors[id];
+
+	while (!my_atomic_loadlint(&scan->abort)) {
+		ulint	i = my_atomic_addlint(&scan->n_assigned, 1);
+
+		if (i >= scan->n_ranges) {
+			return;
+		}
+
+		err = row_pread_range(
+			scan, id, scan->ranges[i],
+			i + 1 < scan->n_ranges ? scan->ranges[i + 1] : NULL);
+
+		if (err != DB_SUCCESS) {
+			my_atomic_addlint(&scan->abort, 1);
+			return;
+		}
+	}
+}
+
+/** Scan a clustered index in a consistent read, using several threads.
+The index is partitioned into key ranges based on the node pointers in the
+upper levels of the B-tree, and the ranges are handed out to the threads
+until all of them have been scanned.
+@param[in,out]	trx		transaction
+@param[in]	latest		whether to read the latest version of
+				each record instead of using the read
+				view of trx
+@param[in]	index		clustered index
+@param[in]	n_threads	maximum number of threads to use,
+				including the calling thread
+@param[in]	func		callback for each visible record
+@param[in,out]	arg		argument for func
+@return	error code
+@retval	DB_SUCCESS		if all ranges were scanned
+@retval	DB_INTERRUPTED		if the statement was killed
+@retval	DB_END_OF_INDEX		if func returned false */
+dberr_t
+row_pread_scan(
+	trx_t*			trx,
+	bool			latest,
+	dict_index_t*		index,
+	ulint			n_threads,
+	row_pread_func_t	func,
+	void*			arg)
+{
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(n_threads > 0);
+
+	mem_heap_t*	heap = mem_heap_create(1024);
+	row_pread_t	scan;
+
+	scan.trx = trx;
+	scan.latest = latest;
+	scan.index = index;
+	scan.func = func;
+	scan.arg = arg;
+	scan.n_assigned = 0;
+	scan.abort = 0;
+
+	if (n_threads > 1) {
+		scan.n_ranges = row_pread_split(
+			index, n_threads * ROW_PREAD_RANGES_PER_THREAD,
+			heap, &scan.ranges);
+	} else {
+		scan.ranges = static_cast<const dtuple_t**>(
+			mem_heap_zalloc(heap, sizeof *scan.ranges));
+		scan.n_ranges = 1;
+	}
+
+	/* Start at most one thread per range, in addition to the
+	calling thread, and respect ROW_PREAD_MAX_THREADS. */
+	ulint	n = std::min(n_threads, scan.n_ranges) - 1;
+
+	if (n) {
+		ulint	active = my_atomic_addlint(&row_pread_n_threads, n);
+
+		if (active + n > ROW_PREAD_MAX_THREADS) {
+			ulint	excess = std::min(
+				n, active + n - ROW_PREAD_MAX_THREADS);
+			my_atomic_addlint(&row_pread_n_threads,
+					  ulint(-excess));
+			n -= excess;
+		}
+	}
+
+	scan.errors = static_cast<dberr_t*>(
+		mem_heap_alloc(heap, (n + 1) * sizeof *scan.errors));
+
+	for (ulint i = 0; i <= n; i++) {
+		scan.errors[i] = DB_SUCCESS;
+	}
+
+	os_thread_run(row_pread_ranges, &scan, n, row_pread_thread_key, NULL);
+
+	if (n) {
+		my_atomic_addlint(&row_pread_n_threads, ulint(-n));
+	}
+
+	dberr_t	err = DB_SUCCESS;
+
+	for (ulint i = 0; i <= n && err == DB_SUCCESS; i++) {
+		err = scan.errors[i];
+	}
+
+	mem_heap_free(heap);
+
+	return(err);
+}
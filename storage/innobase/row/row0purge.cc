@@ -905,6 +905,7 @@ row_purge_parse_undo_rec(
 	node->rec_type = type;
 
 	switch (type) {
+	case TRX_UNDO_EMPTY:
 	case TRX_UNDO_RENAME_TABLE:
 		return false;
 	case TRX_UNDO_INSERT_DEFAULT:
@@ -47,6 +47,7 @@ Created 12/19/1997 Heikki Tuuri
 #include "row0vers.h"
 #include "rem0cmp.h"
 #include "lock0lock.h"
+#include "lock0hot.h"
 #include "eval0eval.h"
 #include "pars0sym.h"
 #include "pars0pars.h"
@@ -3883,6 +3884,77 @@ row_sel_try_search_shortcut_for_mysql(
 }
 #endif /* BTR_CUR_HASH_ADAPT */
 
+/** Evaluate the comparisons that were compiled from a pushed-down
+index condition.
+@param[in]	prebuilt	prebuilt struct for the table handle
+@param[in]	rec		record of prebuilt->index
+@param[in]	offsets		rec_get_offsets(rec, prebuilt->index)
+@return false if the record does not match the index condition;
+true if it may match */
+static
+bool
+row_search_idx_cond_pred_check(
+	const row_prebuilt_t*	prebuilt,
+	const rec_t*		rec,
+	const ulint*		offsets)
+{
+	for (ulint i = 0; i < prebuilt->idx_cond_n_pred; i++) {
+		const row_icp_pred_t*	pred = &prebuilt->idx_cond_pred[i];
+		ulint			len;
+		const byte*		data = rec_get_nth_cfield(
+			rec, prebuilt->index, offsets, pred->field_no, &len);
+
+		if (len == UNIV_SQL_NULL) {
+			/* A comparison with NULL is never true. */
+			return(false);
+		}
+
+		if (len != pred->len) {
+			ut_ad(0);
+			continue;
+		}
+
+		int	cmp = memcmp(data, pred->values, len);
+		bool	match;
+
+		switch (pred->op) {
+		case ROW_ICP_EQ:
+			match = !cmp;
+			break;
+		case ROW_ICP_NE:
+			match = cmp != 0;
+			break;
+		case ROW_ICP_LT:
+			match = cmp < 0;
+			break;
+		case ROW_ICP_LE:
+			match = cmp <= 0;
+			break;
+		case ROW_ICP_GT:
+			match = cmp > 0;
+			break;
+		case ROW_ICP_GE:
+			match = cmp >= 0;
+			break;
+		case ROW_ICP_IN:
+			for (ulint j = 1; cmp && j < pred->n_values; j++) {
+				cmp = memcmp(data, pred->values + j * len,
+					     len);
+			}
+			match = !cmp;
+			break;
+		default:
+			ut_error;
+		}
+
+		if (!match) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
 /*********************************************************************//**
 Check a pushed-down index condition.
 @return ICP_NO_MATCH, ICP_MATCH, or ICP_OUT_OF_RANGE */
@@ -3910,6 +3982,27 @@ row_search_idx_cond_check(
 
 	MONITOR_INC(MONITOR_ICP_ATTEMPTS);
 
+	if (prebuilt->idx_cond_n_pred
+	    && !row_search_idx_cond_pred_check(prebuilt, rec, offsets)) {
+		/* Skip the conversion to the MySQL format. Like
+		handler_index_cond_check(), stop at the end of the range. */
+		if (prebuilt->idx_cond_end) {
+			int	cmp = -cmp_dtuple_rec(prebuilt->idx_cond_end,
+						      rec, offsets);
+			if (!cmp) {
+				cmp = prebuilt->idx_cond_end_on_equal;
+			}
+
+			if (cmp > 0) {
+				MONITOR_INC(MONITOR_ICP_OUT_OF_RANGE);
+				return(ICP_OUT_OF_RANGE);
+			}
+		}
+
+		MONITOR_INC(MONITOR_ICP_NO_MATCH);
+		return(ICP_NO_MATCH);
+	}
+
 	/* Convert to MySQL format those fields that are needed for
 	evaluating the index condition. */
 
@@ -4201,6 +4294,8 @@ row_search_mvcc(
 	ibool		table_lock_waited		= FALSE;
 	byte*		next_buf			= 0;
 	bool		spatial_search			= false;
+	/* whether this call was admitted to a hot row queue */
+	bool		hot_row_entered			= false;
 
 	rec_offs_init(offsets_);
 
@@ -4352,6 +4447,27 @@ row_search_mvcc(
 		goto func_exit;
 	}
 
+	if (UNIV_UNLIKELY(prebuilt->hot_row_queue)
+	    && direction == 0
+	    && unique_search
+	    && dict_index_is_clust(index)
+	    && prebuilt->select_lock_type == LOCK_X
+	    && !prebuilt->table->no_rollback()) {
+		/* Wait for the turn of this transaction to lock the
+		row. The transaction must be started, so that
+		lock_trx_release_locks() will leave the queue. */
+		trx_start_if_not_started(trx, false);
+
+		err = lock_hot_row.enter(trx, index, search_tuple);
+
+		if (err == DB_SUCCESS_LOCKED_REC) {
+			hot_row_entered = true;
+			err = DB_SUCCESS;
+		} else if (err != DB_SUCCESS) {
+			goto func_exit;
+		}
+	}
+
 	mtr.start();
 
 #ifdef BTR_CUR_HASH_ADAPT
@@ -5724,6 +5840,20 @@ row_search_mvcc(
 		mem_heap_free(heap);
 	}
 
+	if (UNIV_UNLIKELY(hot_row_entered)) {
+		switch (err) {
+		case DB_SUCCESS:
+		case DB_RECORD_NOT_FOUND:
+		case DB_END_OF_INDEX:
+			break;
+		default:
+			/* The lock request failed, and only this statement
+			will be rolled back. Do not keep the row queued
+			while the transaction does not hold its lock. */
+			lock_hot_row.leave(trx, index, search_tuple);
+		}
+	}
+
 	/* Set or reset the "did semi-consistent read" flag on return.
 	The flag did_semi_consistent_read is set if and only if
 	the record being returned was fetched with a semi-consistent read. */
@@ -426,6 +426,7 @@ row_undo_ins_parse_undo_rec(
 		goto close_table;
 	case TRX_UNDO_INSERT_DEFAULT:
 	case TRX_UNDO_INSERT_REC:
+	case TRX_UNDO_EMPTY:
 		break;
 	case TRX_UNDO_RENAME_TABLE:
 		dict_table_t* table = node->table;
@@ -459,7 +460,9 @@ row_undo_ins_parse_undo_rec(
 		ut_ad(!node->table->skip_alter_undo);
 		clust_index = dict_table_get_first_index(node->table);
 
-		if (clust_index != NULL) {
+		if (node->rec_type == TRX_UNDO_EMPTY) {
+			/* All indexes will be emptied. */
+		} else if (clust_index != NULL) {
 			if (node->rec_type == TRX_UNDO_INSERT_REC) {
 				ptr = trx_undo_rec_get_row_ref(
 					ptr, clust_index, &node->ref,
@@ -582,6 +585,31 @@ row_undo_ins(
 	ut_ad(dict_index_is_clust(node->index));
 
 	switch (node->rec_type) {
+	case TRX_UNDO_EMPTY:
+		/* The table was empty before the bulk insert
+		(row_merge_bulk_apply()). Empty all indexes. */
+		err = DB_SUCCESS;
+
+		for (dict_index_t* index = node->index; index != NULL;
+		     index = dict_table_get_next_index(index)) {
+			log_free_check();
+			err = btr_clear(index);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+		}
+
+		if (err == DB_SUCCESS && node->table->stat_initialized) {
+			/* Not protected by dict_table_stats_lock(),
+			like dict_table_n_rows_dec() below. */
+			node->table->stat_n_rows = 0;
+
+			if (!dict_locked) {
+				dict_stats_update_if_needed(node->table);
+			}
+		}
+		break;
 	default:
 		ut_ad(!"wrong undo record type");
 	case TRX_UNDO_INSERT_REC:
@@ -2282,6 +2282,12 @@ row_upd_sec_index_entry(
 
 	index = node->index;
 
+	/* An update or delete counts as one modification; the insert of
+	the updated entry below bypasses row_ins_index_entry(). */
+	my_atomic_add64_explicit(
+		reinterpret_cast<int64*>(&index->stat_modified_counter), 1,
+		MY_MEMORY_ORDER_RELAXED);
+
 	referenced = row_upd_index_is_referenced(index, trx);
 #ifdef WITH_WSREP
 	bool foreign = wsrep_row_upd_index_is_foreign(index, trx);
@@ -3143,6 +3149,10 @@ row_upd_clust_step(
 					 btr_pcur_get_block(pcur),
 					 page_rec_get_heap_no(rec)));
 
+	my_atomic_add64_explicit(
+		reinterpret_cast<int64*>(&index->stat_modified_counter), 1,
+		MY_MEMORY_ORDER_RELAXED);
+
 	/* NOTE: the following function calls will also commit mtr */
 
 	if (node->is_delete == PLAIN_DELETE) {
@@ -43,6 +43,255 @@ Created 2/6/1997 Heikki Tuuri
 #include "rem0cmp.h"
 #include "lock0lock.h"
 #include "row0mysql.h"
+#include "srv0mon.h"
+
+/** The cache of old record versions */
+row_vers_cache_t	row_vers_cache;
+
+/** Create the cache.
+@param[in]	n_entries	number of cached versions,
+				or 0 to disable the cache */
+void
+row_vers_cache_t::create(ulint n_entries)
+{
+	ut_ad(!m_parts);
+
+	if (!n_entries) {
+		return;
+	}
+
+	m_n_entries = ut_max(n_entries / N_PARTS, ulint(1));
+	m_parts = static_cast<part_t*>(
+		ut_zalloc_nokey(N_PARTS * sizeof *m_parts));
+
+	for (ulint i = 0; i < N_PARTS; i++) {
+		part_t&	part = m_parts[i];
+
+		mutex_create(LATCH_ID_ROW_VERS_CACHE, &part.mutex);
+		part.entries = static_cast<entry_t*>(
+			ut_zalloc_nokey(m_n_entries * sizeof *part.entries));
+	}
+}
+
+/** Free the cache. */
+void
+row_vers_cache_t::close()
+{
+	if (!m_parts) {
+		return;
+	}
+
+	for (ulint i = 0; i < N_PARTS; i++) {
+		part_t&	part = m_parts[i];
+
+		for (ulint j = 0; j < m_n_entries; j++) {
+			ut_free(part.entries[j].buf);
+		}
+
+		ut_free(part.entries);
+		mutex_free(&part.mutex);
+	}
+
+	ut_free(m_parts);
+	m_parts = NULL;
+	m_n_entries = 0;
+}
+
+/** Copy the primary key of a clustered index record.
+@param[in]	index		clustered index
+@param[in]	rec		clustered index record
+@param[in]	offsets		rec_get_offsets(rec, index)
+@param[in,out]	heap		memory heap for the key
+@param[out]	key_len		length of the key
+@return the primary key, to be passed to find() and insert() */
+const byte*
+row_vers_cache_t::make_key(
+	const dict_index_t*	index,
+	const rec_t*		rec,
+	const ulint*		offsets,
+	mem_heap_t*		heap,
+	ulint*			key_len)
+{
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(rec_offs_validate(rec, index, offsets));
+
+	const ulint	n_uniq = dict_index_get_n_unique(index);
+	ulint		len;
+
+	/* The fields of the primary key are stored contiguously at
+	the start of the record. Prefix each of them with its length,
+	so that different keys cannot have the same image. */
+	ulint	end = rec_get_nth_field_offs(offsets, n_uniq - 1, &len);
+	ut_ad(len != UNIV_SQL_NULL);
+	end += len;
+
+	*key_len = 2 * n_uniq + end;
+
+	byte*	key = static_cast<byte*>(mem_heap_alloc(heap, *key_len));
+	byte*	b = key;
+
+	for (ulint i = 0; i < n_uniq; i++) {
+		rec_get_nth_field_offs(offsets, i, &len);
+		mach_write_to_2(b, len);
+		b += 2;
+	}
+
+	memcpy(b, rec, end);
+
+	return(key);
+}
+
+/** Look up the version of a clustered index record that a read
+view sees.
+@param[in]	index		clustered index
+@param[in]	key		make_key() of the newest version
+@param[in]	key_len		length of key
+@param[in]	trx_id		DB_TRX_ID of the newest version
+@param[in]	roll_ptr	DB_ROLL_PTR of the newest version
+@param[in]	view		read view
+@param[in,out]	heap		memory heap for *old_vers
+@param[out]	old_vers	copy of the version, or NULL if
+				the record does not exist in the view
+@return whether the version was found in the cache */
+bool
+row_vers_cache_t::find(
+	const dict_index_t*	index,
+	const byte*		key,
+	ulint			key_len,
+	trx_id_t		trx_id,
+	roll_ptr_t		roll_ptr,
+	const ReadView*		view,
+	mem_heap_t*		heap,
+	rec_t**			old_vers) const
+{
+	ut_ad(enabled());
+	ut_ad(dict_index_is_clust(index));
+
+	const trx_id_t	low_limit_id = view->low_limit_id();
+	part_t*		part;
+	entry_t*	entry = get(index->id, trx_id, roll_ptr,
+				    low_limit_id, &part);
+
+	mutex_enter(&part->mutex);
+
+	if (entry->low_limit_id != low_limit_id
+	    || entry->index_id != index->id
+	    || entry->trx_id != trx_id
+	    || entry->roll_ptr != roll_ptr
+	    || entry->key_len != key_len
+	    || memcmp(entry->buf, key, key_len)) {
+		mutex_exit(&part->mutex);
+		return(false);
+	}
+
+	if (entry->size) {
+		byte*	buf = static_cast<byte*>(
+			mem_heap_alloc(heap, entry->size));
+		memcpy(buf, entry->buf + key_len, entry->size);
+		*old_vers = buf + entry->extra_size;
+	} else {
+		*old_vers = NULL;
+	}
+
+	mutex_exit(&part->mutex);
+	return(true);
+}
+
+/** Store the version of a clustered index record that a read
+view sees.
+@param[in]	index		clustered index
+@param[in]	key		make_key() of the newest version
+@param[in]	key_len		length of key
+@param[in]	trx_id		DB_TRX_ID of the newest version
+@param[in]	roll_ptr	DB_ROLL_PTR of the newest version
+@param[in]	view		read view
+@param[in]	old_vers	the version, or NULL if the record
+				does not exist in the view
+@param[in]	offsets		rec_get_offsets(old_vers, index) */
+void
+row_vers_cache_t::insert(
+	const dict_index_t*	index,
+	const byte*		key,
+	ulint			key_len,
+	trx_id_t		trx_id,
+	roll_ptr_t		roll_ptr,
+	const ReadView*		view,
+	const rec_t*		old_vers,
+	const ulint*		offsets)
+{
+	ut_ad(enabled());
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(!old_vers || rec_offs_validate(old_vers, index, offsets));
+
+	ulint	size = 0;
+	ulint	extra_size = 0;
+
+	if (old_vers) {
+		size = rec_offs_size(offsets);
+		extra_size = rec_offs_extra_size(offsets);
+	}
+
+	/* Copy the key and the record before acquiring the mutex. */
+	byte*	buf = static_cast<byte*>(ut_malloc_nokey(key_len + size));
+
+	if (!buf) {
+		return;
+	}
+
+	memcpy(buf, key, key_len);
+
+	if (old_vers) {
+		memcpy(buf + key_len, old_vers - extra_size, size);
+	}
+
+	const trx_id_t	low_limit_id = view->low_limit_id();
+	part_t*		part;
+	entry_t*	entry = get(index->id, trx_id, roll_ptr,
+				    low_limit_id, &part);
+
+	mutex_enter(&part->mutex);
+	byte*	old_buf = entry->buf;
+	entry->index_id = index->id;
+	entry->trx_id = trx_id;
+	entry->roll_ptr = roll_ptr;
+	entry->low_limit_id = low_limit_id;
+	entry->buf = buf;
+	entry->key_len = key_len;
+	entry->size = size;
+	entry->extra_size = extra_size;
+	mutex_exit(&part->mutex);
+
+	ut_free(old_buf);
+}
+
+/** Remove the entries that no read view can look up any more.
+@param[in]	limit	low_limit_id() of the oldest read view */
+void
+row_vers_cache_t::prune(trx_id_t limit)
+{
+	if (!m_parts) {
+		return;
+	}
+
+	/* ReadView::low_limit_id() of new views is never smaller than
+	that of the oldest view. */
+	for (ulint i = 0; i < N_PARTS; i++) {
+		part_t&	part = m_parts[i];
+
+		mutex_enter(&part.mutex);
+
+		for (ulint j = 0; j < m_n_entries; j++) {
+			entry_t*	entry = &part.entries[j];
+
+			if (entry->low_limit_id
+			    && entry->low_limit_id < limit) {
+				discard(entry);
+			}
+		}
+
+		mutex_exit(&part.mutex);
+	}
+}
 
 /** Check whether all non-virtual index fields are equal.
 @param[in]	index	the secondary index
@@ -1106,6 +1355,35 @@ row_vers_build_for_consistent_read(
 
 	ut_ad(!vrow || !(*vrow));
 
+	/* The cache does not store the values of virtual columns. */
+	const bool	use_cache = !vrow && row_vers_cache.enabled();
+	const trx_id_t	rec_trx_id = trx_id;
+	roll_ptr_t	roll_ptr = 0;
+	const byte*	key = NULL;
+	ulint		key_len = 0;
+
+	if (use_cache) {
+		roll_ptr = row_get_rec_roll_ptr(rec, index, *offsets);
+		key = row_vers_cache_t::make_key(index, rec, *offsets,
+						 in_heap, &key_len);
+
+		if (row_vers_cache.find(index, key, key_len,
+					rec_trx_id, roll_ptr, view,
+					in_heap, old_vers)) {
+			MONITOR_INC(MONITOR_VERS_CACHE_HIT);
+
+			if (*old_vers) {
+				*offsets = rec_get_offsets(
+					*old_vers, index, *offsets, true,
+					ULINT_UNDEFINED, offset_heap);
+			}
+
+			return(DB_SUCCESS);
+		}
+
+		MONITOR_INC(MONITOR_VERS_CACHE_MISS);
+	}
+
 	version = rec;
 
 	for (;;) {
@@ -1169,6 +1447,12 @@ row_vers_build_for_consistent_read(
 		version = prev_version;
 	}
 
+	if (use_cache && err == DB_SUCCESS) {
+		row_vers_cache.insert(index, key, key_len,
+				      rec_trx_id, roll_ptr, view,
+				      *old_vers, *offsets);
+	}
+
 	mem_heap_free(heap);
 
 	return(err);
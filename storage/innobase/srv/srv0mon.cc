@@ -108,6 +108,11 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TABLELOCK_WAIT},
 
+	{"lock_hot_row_waits", "lock",
+	 "Number of times waited in a hot row queue",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_HOT_ROW_WAIT},
+
 	{"lock_rec_lock_requests", "lock",
 	 "Number of record locks requested",
 	 MONITOR_NONE,
@@ -225,6 +230,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED},
 
+	{"buffer_mrr_prefetch", "buffer",
+	 "Number of clustered index leaf pages read ahead for"
+	 " rowid-ordered DS-MRR",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_MRR_PREFETCH},
+
 	{"buffer_pool_pages_total", "buffer",
 	 "Total buffer pool size in pages (innodb_buffer_pool_pages_total)",
 	 static_cast<monitor_type_t>(
@@ -629,6 +640,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_SET_MEMBER, MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	 MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL},
 
+	{"buffer_LRU_second_chance", "buffer",
+	 "Pages moved to the start of the LRU list by an LRU scan"
+	 " because they were accessed after becoming too old",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_SECOND_CHANCE},
+
 	/* ========== Counters for Buffer Page I/O ========== */
 	{"module_buffer_page", "buffer_page_io", "Buffer Page I/O Module",
 	 static_cast<monitor_type_t>(
@@ -833,6 +850,17 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT),
 	 MONITOR_DEFAULT_START, MONITOR_RSEG_CUR_SIZE},
 
+	{"trx_old_version_cache_hits", "transaction",
+	 "Number of old row versions found in the old version cache",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_VERS_CACHE_HIT},
+
+	{"trx_old_version_cache_misses", "transaction",
+	 "Number of old row versions built from undo logs and not found"
+	 " in the old version cache",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_VERS_CACHE_MISS},
+
 	/* ========== Counters for Purge Module ========== */
 	{"module_purge", "purge", "Purge Module",
 	 MONITOR_MODULE,
@@ -957,6 +985,67 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_PADDED},
 
+	{"log_buf_reserve_waits", "recovery",
+	 "Number of times a log buffer reservation waited for a free copy slot",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_BUF_RESERVE_WAITS},
+
+	{"log_buf_copy_waits", "recovery",
+	 "Number of times a log write waited for concurrent log buffer copies",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_BUF_COPY_WAITS},
+
+	{"log_buf_copy_usec", "recovery",
+	 "Time (in microseconds) spent copying mini-transaction logs to the log buffer",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_BUF_COPY_TIME},
+
+	{"log_write_waits", "recovery",
+	 "Number of times a thread waited for the redo log to be written",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_WRITE_WAITS},
+
+	{"log_write_wait_usec", "recovery",
+	 "Time (in microseconds) spent waiting for the redo log to be written",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_WRITE_WAIT_TIME},
+
+	{"log_flush_waits", "recovery",
+	 "Number of times a thread waited for the redo log to be flushed",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAITS},
+
+	{"log_flush_wait_usec", "recovery",
+	 "Time (in microseconds) spent waiting for the redo log to be flushed",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_TIME},
+
+	{"log_flush_wait_lt_100us", "recovery",
+	 "Number of redo log flush waits that took less than 100 microseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_100US},
+
+	{"log_flush_wait_lt_1ms", "recovery",
+	 "Number of redo log flush waits that took 100 microseconds"
+	 " to 1 millisecond",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_1MS},
+
+	{"log_flush_wait_lt_10ms", "recovery",
+	 "Number of redo log flush waits that took 1 to 10 milliseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_10MS},
+
+	{"log_flush_wait_lt_100ms", "recovery",
+	 "Number of redo log flush waits that took 10 to 100 milliseconds",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_100MS},
+
+	{"log_flush_wait_ge_100ms", "recovery",
+	 "Number of redo log flush waits that took 100 milliseconds or more",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_FLUSH_WAIT_LONG},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
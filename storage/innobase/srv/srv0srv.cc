@@ -169,11 +169,18 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
+#ifdef LINUX_IO_URING
+/** innodb_use_io_uring: whether to use io_uring instead of libaio
+for the native aio on Linux */
+my_bool	srv_use_io_uring;
+#endif /* LINUX_IO_URING */
 my_bool	srv_numa_interleave;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
 ulong	innodb_compression_algorithm;
+/** innodb_zstd_dictionary; @see fil_zstd_init() */
+char*	srv_zstd_dictionary;
 
 #ifdef UNIV_DEBUG
 /** Used by SET GLOBAL innodb_master_thread_disabled_debug = X. */
@@ -201,6 +208,9 @@ ulong		srv_page_size;
 ulong		srv_page_size_shift;
 /** innodb_log_write_ahead_size */
 ulong		srv_log_write_ahead_size;
+/** innodb_log_writer_threads; whether log_write_up_to() waits for
+log_writer_thread and log_flusher_thread */
+my_bool		srv_log_writer_threads;
 
 page_size_t	univ_page_size(0, 0, false);
 
@@ -316,6 +326,10 @@ ulong	srv_n_purge_threads;
 /** innodb_purge_batch_size, in pages */
 ulong	srv_purge_batch_size;
 
+/** innodb_old_version_cache_size; the number of reconstructed old
+versions of clustered index records to cache, or 0 to disable the cache */
+ulong	srv_old_version_cache_size;
+
 /** innodb_stats_method decides how InnoDB treats
 NULL value when collecting statistics. By default, it is set to
 SRV_STATS_NULLS_EQUAL(0), ie. all NULL value are treated equal */
@@ -369,6 +383,13 @@ my_bool		srv_stats_include_delete_marked;
 unsigned long long	srv_stats_persistent_sample_pages;
 /** innodb_stats_auto_recalc */
 my_bool		srv_stats_auto_recalc;
+/** innodb_stats_analyze_threads; the number of threads that analyze the
+indexes of a table when calculating persistent statistics */
+ulong		srv_stats_analyze_threads;
+/** innodb_stats_auto_recalc_incremental; whether the automatic
+recalculation only analyzes the secondary indexes that were modified
+too much since their persistent statistics were calculated */
+my_bool		srv_stats_auto_recalc_incremental;
 
 /** innodb_stats_modified_counter; The number of rows modified before
 we calculate new statistics (default 0 = current limits) */
@@ -528,9 +549,9 @@ lock			--	semaphore;
 kernel			--	kernel;
 
 query thread execution:
-(a) without lock mutex
+(a) without lock_sys.latch
 reserved		--	process executing in user mode;
-(b) with lock mutex reserved
+(b) with lock_sys.latch reserved
 			--	process executing in kernel mode;
 
 The server has several backgroind threads all running at the same
@@ -642,6 +663,10 @@ and/or load it during startup. */
 char	srv_buffer_pool_dump_at_shutdown = TRUE;
 char	srv_buffer_pool_load_at_startup = TRUE;
 
+/** Whether buf_page_get_gen() accounts the accesses of the pages in
+INFORMATION_SCHEMA.INNODB_BUFFER_POOL_INDEX_STATS */
+my_bool	srv_buf_pool_index_stats;
+
 /** Slot index in the srv_sys.sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -1242,7 +1267,7 @@ srv_printf_innodb_monitor(
 	/* Only if lock_print_info_summary proceeds correctly,
 	before we call the lock_print_info_all_transactions
 	to print all the lock information. IMPORTANT NOTE: This
-	function acquires the lock mutex on success. */
+	function acquires lock_sys.latch on success. */
 	ret = lock_print_info_summary(file, nowait);
 
 	if (ret) {
@@ -1255,8 +1280,8 @@ srv_printf_innodb_monitor(
 			}
 		}
 
-		/* NOTE: If we get here then we have the lock mutex. This
-		function will release the lock mutex that we acquired when
+		/* NOTE: If we get here then we have lock_sys.latch. This
+		function will release lock_sys.latch that we acquired when
 		we called the lock_print_info_summary() function earlier. */
 
 		lock_print_info_all_transactions(file);
@@ -1698,7 +1723,7 @@ DECLARE_THREAD(srv_monitor_thread)(void*)
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys.mutex
+			ensure we will not be blocked by lock_sys.latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!last_srv_print_monitor) {
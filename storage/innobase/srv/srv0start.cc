@@ -60,6 +60,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "os0thread.h"
 #include "fil0fil.h"
 #include "fil0crypt.h"
+#include "fil0pagecompress.h"
 #include "fsp0fsp.h"
 #include "rem0rec.h"
 #include "mtr0mtr.h"
@@ -88,6 +89,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "dict0stats_bg.h"
 #include "que0que.h"
 #include "lock0lock.h"
+#include "lock0hot.h"
 #include "trx0roll.h"
 #include "trx0purge.h"
 #include "lock0lock.h"
@@ -100,6 +102,8 @@ Created 2/16/1996 Heikki Tuuri
 #include "row0upd.h"
 #include "row0row.h"
 #include "row0mysql.h"
+#include "row0vers.h"
+#include "row0pread.h"
 #include "row0trunc.h"
 #include "btr0pcur.h"
 #include "os0event.h"
@@ -209,6 +213,7 @@ mysql_pfs_key_t	io_read_thread_key;
 mysql_pfs_key_t	io_write_thread_key;
 mysql_pfs_key_t	srv_error_monitor_thread_key;
 mysql_pfs_key_t	srv_lock_timeout_thread_key;
+mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 mysql_pfs_key_t	srv_master_thread_key;
 mysql_pfs_key_t	srv_monitor_thread_key;
 mysql_pfs_key_t	srv_purge_thread_key;
@@ -1197,8 +1202,10 @@ srv_shutdown_all_bg_threads()
 		HERE OR EARLIER */
 
 		if (srv_start_state_is_set(SRV_START_STATE_LOCK_SYS)) {
-			/* a. Let the lock timeout thread exit */
+			/* a. Let the lock timeout and deadlock detector
+			threads exit */
 			os_event_set(lock_sys.timeout_event);
+			os_event_set(lock_sys.deadlock_event);
 		}
 
 		if (!srv_read_only_mode) {
@@ -1223,6 +1230,11 @@ srv_shutdown_all_bg_threads()
 			if (log_scrub_thread_active) {
 				os_event_set(log_scrub_event);
 			}
+
+			if (log_sys.n_writer_threads) {
+				os_event_set(log_sys.writer_event);
+				os_event_set(log_sys.flusher_event);
+			}
 		}
 
 		if (srv_start_state_is_set(SRV_START_STATE_IO)) {
@@ -1504,7 +1516,10 @@ dberr_t srv_start(bool create_new_db)
 
 	srv_max_n_threads = 1   /* io_ibuf_thread */
 			    + 1 /* io_log_thread */
+			    + 1 /* log_writer_thread */
+			    + 1 /* log_flusher_thread */
 			    + 1 /* lock_wait_timeout_thread */
+			    + 1 /* lock_deadlock_detect_thread */
 			    + 1 /* srv_error_monitor_thread */
 			    + 1 /* srv_monitor_thread */
 			    + 1 /* srv_master_thread */
@@ -1514,10 +1529,12 @@ dberr_t srv_start(bool create_new_db)
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
 			    + 1 /* trx_rollback_all_recovered */
+			    + ROW_PREAD_MAX_THREADS /* row_pread_scan() */
 			    + 128 /* added as margin, for use of
 				  InnoDB Memcached etc. */
 			    + max_connections
 			    + srv_n_read_io_threads
+			    + srv_n_read_io_threads /* recv_apply_thread */
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
 			    + srv_n_page_cleaners
@@ -1605,6 +1622,10 @@ dberr_t srv_start(bool create_new_db)
 
 	fil_system.create(srv_file_per_table ? 50000 : 5000);
 
+	if (!fil_zstd_init()) {
+		return(srv_init_abort(DB_ERROR));
+	}
+
 	double	size;
 	char	unit;
 
@@ -1657,6 +1678,8 @@ dberr_t srv_start(bool create_new_db)
 	log_sys.create();
 	recv_sys_init();
 	lock_sys.create(srv_lock_table_size);
+	lock_hot_row.create();
+	row_vers_cache.create(srv_old_version_cache_size);
 
 	/* Create i/o-handler threads: */
 
@@ -2357,6 +2380,10 @@ dberr_t srv_start(bool create_new_db)
 	srv_startup_is_before_trx_rollback_phase = false;
 
 	if (!srv_read_only_mode) {
+		/* Create the threads which write and flush the redo log
+		on behalf of committing transactions */
+		log_writer_threads_start();
+
 		/* Create the thread which watches the timeouts
 		for lock waits */
 		thread_handles[2 + SRV_MAX_N_IO_THREADS] = os_thread_create(
@@ -2365,6 +2392,14 @@ dberr_t srv_start(bool create_new_db)
 		thread_started[2 + SRV_MAX_N_IO_THREADS] = true;
 		lock_sys.timeout_thread_active = true;
 
+		/* Create the thread which resolves deadlocks between
+		the lock waits */
+		thread_handles[SRV_MAX_N_IO_THREADS] = os_thread_create(
+			lock_deadlock_detect_thread,
+			NULL, thread_ids + SRV_MAX_N_IO_THREADS);
+		thread_started[SRV_MAX_N_IO_THREADS] = true;
+		lock_sys.deadlock_thread_active = true;
+
 		/* Create the thread which warns of long semaphore waits */
 		srv_error_monitor_active = true;
 		thread_handles[3 + SRV_MAX_N_IO_THREADS] = os_thread_create(
@@ -2679,6 +2714,8 @@ void innodb_shutdown()
 		buf_dblwr_free();
 	}
 	lock_sys.close();
+	lock_hot_row.close();
+	row_vers_cache.close();
 	trx_pool_close();
 
 	if (!srv_read_only_mode) {
@@ -2695,6 +2732,7 @@ void innodb_shutdown()
 	row_mysql_close();
 	srv_free();
 	fil_system.close();
+	fil_zstd_close();
 
 	/* 4. Free all allocated memory */
 
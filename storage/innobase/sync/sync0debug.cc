@@ -457,6 +457,8 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(RW_LOCK_NOT_LOCKED);
 	LEVEL_MAP_INSERT(SYNC_MONITOR_MUTEX);
 	LEVEL_MAP_INSERT(SYNC_ANY_LATCH);
+	LEVEL_MAP_INSERT(SYNC_ROW_VERS_CACHE);
+	LEVEL_MAP_INSERT(SYNC_TRX_SERIALISATION);
 	LEVEL_MAP_INSERT(SYNC_DOUBLEWRITE);
 	LEVEL_MAP_INSERT(SYNC_BUF_FLUSH_LIST);
 	LEVEL_MAP_INSERT(SYNC_BUF_BLOCK);
@@ -482,6 +484,7 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(SYNC_TRX);
 	LEVEL_MAP_INSERT(SYNC_RW_TRX_HASH_ELEMENT);
 	LEVEL_MAP_INSERT(SYNC_TRX_SYS);
+	LEVEL_MAP_INSERT(SYNC_LOCK_SYS_SHARD);
 	LEVEL_MAP_INSERT(SYNC_LOCK_SYS);
 	LEVEL_MAP_INSERT(SYNC_LOCK_WAIT_SYS);
 	LEVEL_MAP_INSERT(SYNC_INDEX_ONLINE_LOG);
@@ -760,9 +763,12 @@ LatchDebug::check_order(
 	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_SYS_SHARD:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_RW_TRX_HASH_ELEMENT:
 	case SYNC_TRX_SYS:
+	case SYNC_ROW_VERS_CACHE:
+	case SYNC_TRX_SERIALISATION:
 	case SYNC_IBUF_BITMAP_MUTEX:
 	case SYNC_REDO_RSEG:
 	case SYNC_NOREDO_RSEG:
@@ -809,7 +815,7 @@ LatchDebug::check_order(
 
 	case SYNC_TRX:
 
-		/* Either the thread must own the lock_sys.mutex, or
+		/* Either the thread must own the lock_sys.latch, or
 		it is allowed to own only ONE trx_t::mutex. */
 
 		if (less(latches, level) != NULL) {
@@ -1404,13 +1410,25 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(TRX, SYNC_TRX, trx_mutex_key);
 
-	LATCH_ADD_MUTEX(LOCK_SYS, SYNC_LOCK_SYS, lock_mutex_key);
+	LATCH_ADD_RWLOCK(LOCK_SYS, SYNC_LOCK_SYS, lock_sys_latch_key);
+
+	LATCH_ADD_MUTEX(LOCK_SYS_SHARD, SYNC_LOCK_SYS_SHARD,
+			lock_sys_shard_mutex_key);
 
 	LATCH_ADD_MUTEX(LOCK_SYS_WAIT, SYNC_LOCK_WAIT_SYS,
 			lock_wait_mutex_key);
 
+	LATCH_ADD_MUTEX(LOCK_HOT_ROW, SYNC_NO_ORDER_CHECK,
+			lock_hot_row_mutex_key);
+
 	LATCH_ADD_MUTEX(TRX_SYS, SYNC_TRX_SYS, trx_sys_mutex_key);
 
+	LATCH_ADD_MUTEX(TRX_SYS_SERIALISATION, SYNC_TRX_SERIALISATION,
+			trx_sys_serialisation_mutex_key);
+
+	LATCH_ADD_MUTEX(ROW_VERS_CACHE, SYNC_ROW_VERS_CACHE,
+			row_vers_cache_mutex_key);
+
 	LATCH_ADD_MUTEX(SRV_SYS, SYNC_THREADS, srv_sys_mutex_key);
 
 	LATCH_ADD_MUTEX(SRV_SYS_TASKS, SYNC_ANY_LATCH, srv_threads_mutex_key);
@@ -83,9 +83,12 @@ mysql_pfs_key_t	buf_dblwr_mutex_key;
 mysql_pfs_key_t	trx_mutex_key;
 mysql_pfs_key_t	trx_pool_mutex_key;
 mysql_pfs_key_t	trx_pool_manager_mutex_key;
-mysql_pfs_key_t	lock_mutex_key;
+mysql_pfs_key_t	lock_sys_shard_mutex_key;
 mysql_pfs_key_t	lock_wait_mutex_key;
+mysql_pfs_key_t	lock_hot_row_mutex_key;
 mysql_pfs_key_t	trx_sys_mutex_key;
+mysql_pfs_key_t	trx_sys_serialisation_mutex_key;
+mysql_pfs_key_t	row_vers_cache_mutex_key;
 mysql_pfs_key_t	srv_sys_mutex_key;
 mysql_pfs_key_t	srv_threads_mutex_key;
 mysql_pfs_key_t	event_mutex_key;
@@ -108,6 +111,7 @@ mysql_pfs_key_t	dict_table_stats_key;
 mysql_pfs_key_t	hash_table_locks_key;
 mysql_pfs_key_t	index_tree_rw_lock_key;
 mysql_pfs_key_t	index_online_log_key;
+mysql_pfs_key_t	lock_sys_latch_key;
 mysql_pfs_key_t	fil_space_latch_key;
 mysql_pfs_key_t	fts_cache_rw_lock_key;
 mysql_pfs_key_t	fts_cache_init_rw_lock_key;
@@ -35,6 +35,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "que0que.h"
 #include "row0purge.h"
 #include "row0upd.h"
+#include "row0vers.h"
 #include "srv0mon.h"
 #include "fsp0sysspace.h"
 #include "srv0srv.h"
@@ -1549,6 +1550,10 @@ trx_purge(
 	trx_sys.clone_oldest_view();
 	rw_lock_x_unlock(&purge_sys.latch);
 
+	/* Discard the cached record versions that only older read views
+	could have looked up. */
+	row_vers_cache.prune(purge_sys.view.low_limit_id());
+
 #ifdef UNIV_DEBUG
 	if (srv_purge_view_update_only_debug) {
 		return(0);
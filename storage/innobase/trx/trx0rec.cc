@@ -469,7 +469,8 @@ trx_undo_page_report_insert(
 	trx_t*		trx,		/*!< in: transaction */
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: index entry which will be
-					inserted to the clustered index */
+					inserted to the clustered index,
+					or NULL for TRX_UNDO_EMPTY */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	ulint		first_free;
@@ -499,9 +500,15 @@ trx_undo_page_report_insert(
 	ptr += 2;
 
 	/* Store first some general parameters to the undo log */
-	*ptr++ = TRX_UNDO_INSERT_REC;
+	*ptr++ = clust_entry ? TRX_UNDO_INSERT_REC : TRX_UNDO_EMPTY;
 	ptr += mach_u64_write_much_compressed(ptr, trx->undo_no);
 	ptr += mach_u64_write_much_compressed(ptr, index->table->id);
+
+	if (!clust_entry) {
+		/* The table was empty before the bulk insert;
+		no primary key is needed for rolling it back. */
+		goto done;
+	}
 	/*----------------------------------------*/
 	/* Store then the fields required to uniquely determine the record
 	to be inserted in the clustered index */
@@ -1960,7 +1967,8 @@ trx_undo_report_row_operation(
 					may contain a clustered index
 					record tuple that also contains
 					virtual columns of the table;
-					otherwise, NULL */
+					otherwise, NULL (TRX_UNDO_EMPTY
+					if also rec is NULL) */
 	const upd_t*	update,		/*!< in: in the case of an update,
 					the update vector, otherwise NULL */
 	ulint		cmpl_info,	/*!< in: compiler info on secondary
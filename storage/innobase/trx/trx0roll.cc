@@ -1027,6 +1027,7 @@ trx_roll_pop_top_rec_of_trx(trx_t* trx, roll_ptr_t* roll_ptr, mem_heap_t* heap)
 		this record can only be present in the main undo log. */
 		ut_ad(undo == update);
 		/* fall through */
+	case TRX_UNDO_EMPTY:
 	case TRX_UNDO_RENAME_TABLE:
 		ut_ad(undo == insert || undo == update);
 		/* fall through */
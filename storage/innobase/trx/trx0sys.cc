@@ -43,6 +43,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "log0recv.h"
 #include "os0file.h"
 #include "fsp0sysspace.h"
+#include "sync0sync.h"
 
 #include <mysql/service_wsrep.h>
 
@@ -217,10 +218,198 @@ trx_sys_t::create()
 	ut_ad(!is_initialised());
 	m_initialised = true;
 	mutex_create(LATCH_ID_TRX_SYS, &mutex);
+	mutex_create(LATCH_ID_TRX_SYS_SERIALISATION, &serialisation_mutex);
 	UT_LIST_INIT(trx_list, &trx_t::trx_list);
+	UT_LIST_INIT(serialisation_list, &trx_t::no_list);
 	my_atomic_store32(&rseg_history_len, 0);
+	m_min_serialised_no = TRX_ID_MAX;
+	m_min_active_id = 0;
 
 	rw_trx_hash.init();
+	csn_map.create();
+}
+
+/** Create the commit sequence number map. */
+void trx_csn_map_t::create()
+{
+	m_slots = static_cast<slot_t*>(
+		ut_zalloc_nokey(N_SLOTS * sizeof *m_slots));
+	m_n_overflow = 0;
+	m_oldest = 0;
+	lf_hash_init(&m_overflow, sizeof(overflow_entry_t), LF_HASH_UNIQUE,
+		     0, sizeof(trx_id_t), 0, &my_charset_bin);
+}
+
+/** Free the commit sequence number map. */
+void trx_csn_map_t::close()
+{
+	lf_hash_destroy(&m_overflow);
+	ut_free(m_slots);
+	m_slots = NULL;
+}
+
+/** Register an active transaction.
+@param[in]	id	transaction identifier */
+void trx_csn_map_t::insert(trx_id_t id)
+{
+	slot_t&		slot = get_slot(id);
+	trx_id_t	old_id = lock_slot(slot);
+
+	ut_ad(old_id != id);
+
+	if (old_id) {
+		/* Keep the evicted entry unless it is visible in
+		every read view. */
+		overflow_entry_t	entry = { old_id, slot.csn };
+		trx_id_t		oldest = static_cast<trx_id_t>(
+			my_atomic_load64_explicit(
+				reinterpret_cast<int64*>(&m_oldest),
+				MY_MEMORY_ORDER_RELAXED));
+
+		if (entry.csn >= oldest) {
+			LF_PINS*	pins = lf_hash_get_pins(&m_overflow);
+			ut_a(pins);
+			int		res = lf_hash_insert(&m_overflow, pins,
+							     &entry);
+			ut_a(res == 0);
+			lf_hash_put_pins(pins);
+			/* Before the slot is released, so that
+			find() will not skip m_overflow. */
+			my_atomic_add32(&m_n_overflow, 1);
+		}
+	}
+
+	my_atomic_store64_explicit(reinterpret_cast<int64*>(&slot.csn),
+				   int64(TRX_ID_MAX), MY_MEMORY_ORDER_RELAXED);
+	unlock_slot(slot, id);
+}
+
+/** Assign a commit sequence number to a registered transaction.
+@param[in]	id	transaction identifier
+@param[in]	csn	commit sequence number */
+void trx_csn_map_t::commit(trx_id_t id, trx_id_t csn)
+{
+	slot_t&		slot = get_slot(id);
+	trx_id_t	slot_id = lock_slot(slot);
+
+	if (slot_id == id) {
+		ut_ad(slot.csn == TRX_ID_MAX);
+		my_atomic_store64_explicit(
+			reinterpret_cast<int64*>(&slot.csn), int64(csn),
+			MY_MEMORY_ORDER_RELAXED);
+		unlock_slot(slot, slot_id);
+		return;
+	}
+
+	unlock_slot(slot, slot_id);
+
+	/* The entry was evicted by a newer transaction. prune() does
+	not remove it, because it has not been committed. */
+	LF_PINS*		pins = lf_hash_get_pins(&m_overflow);
+	ut_a(pins);
+	overflow_entry_t*	entry = static_cast<overflow_entry_t*>(
+		lf_hash_search(&m_overflow, pins, &id, sizeof id));
+	ut_a(entry);
+	ut_ad(entry->csn == TRX_ID_MAX);
+	my_atomic_store64_explicit(reinterpret_cast<int64*>(&entry->csn),
+				   int64(csn), MY_MEMORY_ORDER_RELAXED);
+	lf_hash_search_unpin(pins);
+	lf_hash_put_pins(pins);
+}
+
+/** Look up an evicted commit sequence number.
+@param[in]	id	transaction identifier
+@return commit sequence number
+@retval	0	if the transaction is visible in every read view */
+trx_id_t trx_csn_map_t::find_overflow(trx_id_t id) const
+{
+	LF_PINS*		pins = lf_hash_get_pins(&m_overflow);
+	ut_a(pins);
+	overflow_entry_t*	entry = static_cast<overflow_entry_t*>(
+		lf_hash_search(&m_overflow, pins, &id, sizeof id));
+	trx_id_t		csn = 0;
+
+	if (entry) {
+		csn = static_cast<trx_id_t>(my_atomic_load64_explicit(
+			reinterpret_cast<int64*>(&entry->csn),
+			MY_MEMORY_ORDER_RELAXED));
+		lf_hash_search_unpin(pins);
+	}
+
+	lf_hash_put_pins(pins);
+	return(csn);
+}
+
+/** Arguments of trx_csn_map_t::prune_callback() */
+struct trx_csn_map_t::prune_arg_t {
+	/** sorted ReadView::low_limit_id() of the open views */
+	const trx_ids_t&	views;
+	/** ReadView::low_limit_id() of the purge view */
+	trx_id_t		limit;
+	/** the entries that no read view needs */
+	trx_ids_t		garbage;
+};
+
+/** Collect an evicted entry that no read view needs.
+@param[in]	entry	evicted entry
+@param[in,out]	arg	open read views and collected entries
+@return	0 to continue the iteration */
+my_bool trx_csn_map_t::prune_callback(overflow_entry_t* entry,
+				      prune_arg_t* arg)
+{
+	/* Read views that are created after limit will see the
+	transaction. The oldest open view that was created after the
+	transaction started is the only one that might not see it. */
+	const trx_id_t	csn = static_cast<trx_id_t>(
+		my_atomic_load64_explicit(
+			reinterpret_cast<int64*>(&entry->csn),
+			MY_MEMORY_ORDER_RELAXED));
+
+	if (csn < arg->limit) {
+		trx_ids_t::const_iterator v = std::upper_bound(
+			arg->views.begin(), arg->views.end(), entry->id);
+		if (v == arg->views.end() || *v > csn) {
+			arg->garbage.push_back(entry->id);
+		}
+	}
+
+	return(0);
+}
+
+/** Remove the evicted entries that no read view can need.
+@param[in]	views	sorted ReadView::low_limit_id() of the open views
+@param[in]	limit	ReadView::low_limit_id() of the purge view before
+			the open views were collected */
+void trx_csn_map_t::prune(const trx_ids_t& views, trx_id_t limit)
+{
+	my_atomic_store64_explicit(reinterpret_cast<int64*>(&m_oldest),
+				   int64(views.empty()
+					 ? limit
+					 : std::min(limit, views.front())),
+				   MY_MEMORY_ORDER_RELAXED);
+
+	if (!my_atomic_load32_explicit(&m_n_overflow,
+				       MY_MEMORY_ORDER_RELAXED)) {
+		return;
+	}
+
+	prune_arg_t	arg = { views, limit, trx_ids_t() };
+	LF_PINS*	pins = lf_hash_get_pins(&m_overflow);
+	ut_a(pins);
+
+	lf_hash_iterate(&m_overflow, pins,
+			reinterpret_cast<my_hash_walk_action>(prune_callback),
+			&arg);
+
+	for (trx_ids_t::const_iterator it = arg.garbage.begin();
+	     it != arg.garbage.end(); ++it) {
+		int	res = lf_hash_delete(&m_overflow, pins,
+					     &*it, sizeof *it);
+		ut_a(res == 0);
+		my_atomic_add32(&m_n_overflow, -1);
+	}
+
+	lf_hash_put_pins(pins);
 }
 
 /*****************************************************************//**
@@ -331,6 +520,7 @@ trx_sys_t::close()
 	}
 
 	rw_trx_hash.destroy();
+	csn_map.close();
 
 	/* There can't be any active transactions. */
 
@@ -345,6 +535,7 @@ trx_sys_t::close()
 	}
 
 	ut_a(UT_LIST_GET_LEN(trx_list) == 0);
+	mutex_free(&serialisation_mutex);
 	mutex_free(&mutex);
 	m_initialised = false;
 }
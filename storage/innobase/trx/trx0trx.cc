@@ -203,6 +203,10 @@ struct TrxFactory {
 
 		new(&trx->lock.table_locks) lock_pool_t();
 
+		new(&trx->lock.hot_rows) hot_row_list_t();
+
+		trx->lock.hot_row_event = os_event_create(0);
+
 		new(&trx->read_view) ReadView();
 
 		trx->rw_trx_hash_pins = 0;
@@ -278,6 +282,11 @@ struct TrxFactory {
 
 		trx->lock.table_locks.~lock_pool_t();
 
+		ut_ad(trx->lock.hot_rows.empty());
+		trx->lock.hot_rows.~hot_row_list_t();
+
+		os_event_destroy(trx->lock.hot_row_event);
+
 		trx->read_view.~ReadView();
 	}
 
@@ -308,6 +317,8 @@ struct TrxFactory {
 
 		ut_ad(trx->lock.table_locks.empty());
 
+		ut_ad(trx->lock.hot_rows.empty());
+
 		return(true);
 	}
 };
@@ -562,6 +573,9 @@ trx_resurrect_table_locks(
 	page_t*			undo_page;
 	trx_undo_rec_t*		undo_rec;
 	table_id_set		tables;
+	/* tables that the transaction bulk-inserted into while
+	they were empty (TRX_UNDO_EMPTY) */
+	table_id_set		empty_tables;
 
 	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE) ||
 	      trx_state_eq(trx, TRX_STATE_PREPARED));
@@ -599,6 +613,9 @@ trx_resurrect_table_locks(
 			undo_rec, &type, &cmpl_info,
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
+		if (type == TRX_UNDO_EMPTY) {
+			empty_tables.insert(table_id);
+		}
 
 		undo_rec = trx_undo_get_prev_rec(
 			undo_rec, undo->hdr_page_no,
@@ -624,11 +641,14 @@ trx_resurrect_table_locks(
 					trx_mod_tables_t::value_type(table,
 								     0));
 			}
-			lock_table_ix_resurrect(table, trx);
+			const bool empty = empty_tables.count(*i) != 0;
+			lock_table_resurrect(table, trx,
+					     empty ? LOCK_X : LOCK_IX);
 
 			DBUG_LOG("ib_trx",
 				 "resurrect " << ib::hex(trx->id)
-				 << " IX lock on " << table->name);
+				 << (empty ? " X" : " IX")
+				 << " lock on " << table->name);
 
 			dict_table_close(table, FALSE, FALSE);
 		}
@@ -701,6 +721,7 @@ static void trx_resurrect(trx_undo_t *undo, trx_rseg_t *rseg,
     trx->table_id= undo->table_id;
   }
 
+  trx_sys.csn_map.insert(trx->id);
   trx_sys.rw_trx_hash.insert(trx);
   trx_sys.rw_trx_hash.put_pins(trx);
   trx_resurrect_table_locks(trx, undo);
@@ -1298,7 +1319,7 @@ trx_commit_in_memory(
 		ut_a(!trx->is_recovered);
 		ut_ad(trx->rsegs.m_redo.rseg == NULL);
 
-		/* Note: We are asserting without holding the lock mutex. But
+		/* Note: We are asserting without holding lock_sys.latch. But
 		that is OK because this transaction is not waiting and cannot
 		be rolled back and no new locks can (or should not) be added
 		becuase it is flagged as a non-locking read-only transaction. */
@@ -1870,7 +1891,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys.mutex.
+The caller must hold lock_sys.latch.
 When possible, use trx_print() instead. */
 void
 trx_print_latched(
@@ -1890,7 +1911,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys.mutex. */
+Acquires and releases lock_sys.latch. */
 void
 trx_print(
 /*======*/
@@ -2149,7 +2170,7 @@ static my_bool trx_get_trx_by_xid_callback(rw_trx_hash_element_t *element,
 /**
   Finds PREPARED XA transaction by xid.
 
-  trx may have been committed, unless the caller is holding lock_sys.mutex.
+  trx may have been committed, unless the caller is holding lock_sys.latch.
 
   @param[in]  xid  X/Open XA transaction identifier
 